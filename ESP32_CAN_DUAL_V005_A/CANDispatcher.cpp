@@ -0,0 +1,69 @@
+// CANDispatcher.cpp
+// ===============================================================================
+// Implementation der Frame-Verteilung
+// ===============================================================================
+
+#include "CANDispatcher.h"
+#include <string.h>
+
+CANDispatcher::CANDispatcher() {
+    memset(consumers, 0, sizeof(consumers));
+    memset(routes, 0, sizeof(routes));
+    catchAll = 0;
+}
+
+bool CANDispatcher::subscribe(uint16_t functionMask, bool extended, CANFrameConsumer consumer, void* context) {
+    if (consumer == nullptr) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < CAN_DISPATCH_MAX_CONSUMERS; i++) {
+        if (consumers[i].fn != nullptr) {
+            continue;
+        }
+
+        consumers[i].fn = consumer;
+        consumers[i].context = context;
+        uint16_t bit = 1u << i;
+        if (functionMask == CAN_FC_ALL && extended) {
+            catchAll |= bit;
+            return true;
+        }
+        for (uint8_t fc = 0; fc < 16; fc++) {
+            if (functionMask & (1u << fc)) {
+                routes[fc] |= bit;
+            }
+        }
+        if (extended) {
+            routes[16] |= bit;
+        }
+        return true;
+    }
+    return false;
+}
+
+void CANDispatcher::unsubscribe(CANFrameConsumer consumer, void* context) {
+    for (uint8_t i = 0; i < CAN_DISPATCH_MAX_CONSUMERS; i++) {
+        if (consumers[i].fn != consumer || consumers[i].context != context) {
+            continue;
+        }
+
+        uint16_t bit = 1u << i;
+        for (uint8_t fc = 0; fc < 17; fc++) {
+            routes[fc] &= ~bit;
+        }
+        catchAll &= ~bit;
+        consumers[i].fn = nullptr;
+        consumers[i].context = nullptr;
+    }
+}
+
+uint8_t CANDispatcher::consumerCount() const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CAN_DISPATCH_MAX_CONSUMERS; i++) {
+        if (consumers[i].fn != nullptr) {
+            count++;
+        }
+    }
+    return count;
+}
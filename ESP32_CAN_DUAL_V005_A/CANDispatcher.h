@@ -0,0 +1,97 @@
+// CANDispatcher.h
+// ===============================================================================
+// Verteilung empfangener Frames an registrierte Verbraucher
+// Der CANopen-Funktionscode (obere 4 Bit der 11-Bit-ID, rxId >> 7) indiziert eine
+// Tabelle mit 16 Einträgen; jeder Eintrag ist eine Bitmaske der interessierten
+// Verbraucher. Pro Frame also ein Tabellenzugriff und nur Aufrufe an Verbraucher,
+// die den Funktionscode abonniert haben. Extended-Frames haben einen eigenen Eintrag.
+// Verbraucher aller Frames (Live-Monitor, Busstatistik) stehen in keiner Tabelle, sondern
+// werden nach den übrigen in einer eigenen Schleife aufgerufen: deren Durchlaufzahl ist
+// für jeden Frame gleich, Sprungvorhersage und indirekter Aufruf bleiben treffsicher.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define CAN_DISPATCH_MAX_CONSUMERS 16  // Bitbreite der Tabelleneinträge
+
+// CANopen-Funktionscodes (COB-ID >> 7)
+enum CANFunctionCode : uint8_t {
+    CAN_FC_NMT = 0,      // 0x000
+    CAN_FC_SYNC_EMCY,    // 0x080 (SYNC = Node 0, sonst EMCY)
+    CAN_FC_TIME,         // 0x100
+    CAN_FC_TPDO1,        // 0x180
+    CAN_FC_RPDO1,        // 0x200
+    CAN_FC_TPDO2,        // 0x280
+    CAN_FC_RPDO2,        // 0x300
+    CAN_FC_TPDO3,        // 0x380
+    CAN_FC_RPDO3,        // 0x400
+    CAN_FC_TPDO4,        // 0x480
+    CAN_FC_RPDO4,        // 0x500
+    CAN_FC_TSDO,         // 0x580 (SDO-Antworten)
+    CAN_FC_RSDO,         // 0x600 (SDO-Anfragen)
+    CAN_FC_UNUSED,       // 0x680
+    CAN_FC_NMT_EC,       // 0x700 (Heartbeat/Boot-up)
+    CAN_FC_LSS           // 0x780 (LSS u.a.)
+};
+
+#define CAN_FC_BIT(fc)   ((uint16_t)(1u << (fc)))
+#define CAN_FC_ALL       0xFFFF
+#define CAN_FC_TPDOS     (CAN_FC_BIT(CAN_FC_TPDO1) | CAN_FC_BIT(CAN_FC_TPDO2) | \
+                          CAN_FC_BIT(CAN_FC_TPDO3) | CAN_FC_BIT(CAN_FC_TPDO4))
+
+// Funktionscode eines Standard-Frames
+static inline uint8_t canFunctionCode(uint32_t id) {
+    return (id >> 7) & 0x0F;
+}
+
+// Verbraucher eines Frames
+typedef void (*CANFrameConsumer)(const CanFrame& frame, void* context);
+
+class CANDispatcher {
+public:
+    CANDispatcher();
+
+    // Verbraucher für die Funktionscodes in functionMask (CAN_FC_BIT) registrieren.
+    // Aufrufreihenfolge = Registrierungsreihenfolge (frei gewordene Plätze werden
+    // wiederverwendet), Verbraucher aller Frames (CAN_FC_ALL mit extended) zuletzt.
+    // false = Tabelle voll.
+    bool subscribe(uint16_t functionMask, bool extended, CANFrameConsumer consumer, void* context = nullptr);
+    void unsubscribe(CANFrameConsumer consumer, void* context = nullptr);
+
+    void dispatch(const CanFrame& frame) const {
+        uint16_t mask = routes[frame.ext ? 16 : canFunctionCode(frame.id)];
+        while (mask != 0) {
+            uint8_t i = __builtin_ctz(mask);
+            mask &= mask - 1;
+            consumers[i].fn(frame, consumers[i].context);
+        }
+        mask = catchAll;
+        while (mask != 0) {
+            uint8_t i = __builtin_ctz(mask);
+            mask &= mask - 1;
+            consumers[i].fn(frame, consumers[i].context);
+        }
+    }
+
+    void dispatchBurst(const CanFrame* frames, size_t count) const {
+        for (size_t i = 0; i < count; i++) {
+            dispatch(frames[i]);
+        }
+    }
+
+    uint8_t consumerCount() const;
+
+private:
+    struct Consumer {
+        CANFrameConsumer fn;
+        void* context;
+    };
+
+    Consumer consumers[CAN_DISPATCH_MAX_CONSUMERS];
+    uint16_t routes[17];  // 16 Funktionscodes + Extended-Frames
+    uint16_t catchAll;    // Verbraucher aller Frames
+};
@@ -0,0 +1,197 @@
+// CANFilter.cpp
+// ===============================================================================
+// Implementation des kompilierten Akzeptanzfilters
+// ===============================================================================
+
+#include "CANFilter.h"
+#include <string.h>
+
+bool CANFilterRule::hasNodeCondition() const {
+    return (nodes[0] & nodes[1] & nodes[2] & nodes[3]) != 0xFFFFFFFFUL;
+}
+
+bool CANFilterRule::matchesStandard(uint16_t id) const {
+    if (id < idMin || id > idMax) {
+        return false;
+    }
+    if (!(typeMask & CAN_FC_BIT(canFunctionCode(id)))) {
+        return false;
+    }
+    uint8_t nodeId = id & 0x7F;
+    return (nodes[nodeId >> 5] >> (nodeId & 31)) & 1;
+}
+
+CANFilter::CANFilter() : count(0), extRangeCount(0) {
+    compile();
+}
+
+CANFilterRule CANFilter::makeRule(bool include) {
+    CANFilterRule rule;
+    rule.include = include;
+    rule.idMin = 0;
+    rule.idMax = CAN_FILTER_EXT_MAX_ID;
+    rule.typeMask = CAN_FC_ALL;
+    memset(rule.nodes, 0xFF, sizeof(rule.nodes));
+    return rule;
+}
+
+void CANFilter::setNode(CANFilterRule& rule, uint8_t nodeId) {
+    rule.nodes[(nodeId >> 5) & 3] |= 1UL << (nodeId & 31);
+}
+
+void CANFilter::clearNodes(CANFilterRule& rule) {
+    memset(rule.nodes, 0, sizeof(rule.nodes));
+}
+
+bool CANFilter::addRule(const CANFilterRule& rule) {
+    return insertRule(count, rule);
+}
+
+bool CANFilter::insertRule(uint8_t index, const CANFilterRule& rule) {
+    if (count >= CAN_FILTER_MAX_RULES || index > count) {
+        return false;
+    }
+    for (uint8_t i = count; i > index; i--) {
+        rules[i] = rules[i - 1];
+    }
+    rules[index] = rule;
+    count++;
+    return true;
+}
+
+bool CANFilter::removeRule(uint8_t index) {
+    if (index >= count) {
+        return false;
+    }
+    for (uint8_t i = index; i + 1 < count; i++) {
+        rules[i] = rules[i + 1];
+    }
+    count--;
+    return true;
+}
+
+void CANFilter::clear() {
+    count = 0;
+}
+
+void CANFilter::compile() {
+    bool defaultAccept = true;
+    for (uint8_t i = 0; i < count; i++) {
+        if (rules[i].include) {
+            defaultAccept = false;
+            break;
+        }
+    }
+
+    compileStandard(defaultAccept);
+    compileExtended(defaultAccept);
+}
+
+void CANFilter::compileStandard(bool defaultAccept) {
+    memset(stdBitmap, defaultAccept ? 0xFF : 0x00, sizeof(stdBitmap));
+
+    for (uint8_t r = 0; r < count; r++) {
+        const CANFilterRule& rule = rules[r];
+        if (rule.idMin > CAN_FILTER_STD_MAX_ID) {
+            continue;
+        }
+        uint16_t last = rule.idMax > CAN_FILTER_STD_MAX_ID ? CAN_FILTER_STD_MAX_ID : rule.idMax;
+        for (uint16_t id = rule.idMin; id <= last; id++) {
+            if (!rule.matchesStandard(id)) {
+                continue;
+            }
+            if (rule.include) {
+                stdBitmap[id >> 5] |= 1UL << (id & 31);
+            } else {
+                stdBitmap[id >> 5] &= ~(1UL << (id & 31));
+            }
+        }
+    }
+}
+
+// Die Bereichsgrenzen aller Regeln zerlegen den 29-Bit-Raum in Elementarintervalle,
+// innerhalb derer das Ergebnis konstant ist. Jedes Intervall wird einmal ausgewertet,
+// benachbarte akzeptierte Intervalle werden zusammengefasst.
+void CANFilter::compileExtended(bool defaultAccept) {
+    uint32_t bounds[CAN_FILTER_MAX_EXT_RANGES];
+    uint8_t boundCount = 0;
+    bounds[boundCount++] = 0;
+
+    for (uint8_t r = 0; r < count; r++) {
+        const CANFilterRule& rule = rules[r];
+        if (rule.hasNodeCondition() || rule.hasTypeCondition()) {
+            continue;  // Gilt nur für 11-Bit-IDs
+        }
+        bounds[boundCount++] = rule.idMin;
+        if (rule.idMax < CAN_FILTER_EXT_MAX_ID) {
+            bounds[boundCount++] = rule.idMax + 1;
+        }
+    }
+
+    // Sortieren (wenige Einträge) und Duplikate entfernen
+    for (uint8_t i = 1; i < boundCount; i++) {
+        uint32_t value = bounds[i];
+        uint8_t j = i;
+        while (j > 0 && bounds[j - 1] > value) {
+            bounds[j] = bounds[j - 1];
+            j--;
+        }
+        bounds[j] = value;
+    }
+    uint8_t unique = 0;
+    for (uint8_t i = 0; i < boundCount; i++) {
+        if (unique == 0 || bounds[unique - 1] != bounds[i]) {
+            bounds[unique++] = bounds[i];
+        }
+    }
+
+    extRangeCount = 0;
+    for (uint8_t i = 0; i < unique; i++) {
+        uint32_t lo = bounds[i];
+        uint32_t hi = (i + 1 < unique) ? bounds[i + 1] - 1 : CAN_FILTER_EXT_MAX_ID;
+
+        bool accept = defaultAccept;
+        for (uint8_t r = 0; r < count; r++) {
+            const CANFilterRule& rule = rules[r];
+            if (!rule.hasNodeCondition() && !rule.hasTypeCondition() &&
+                lo >= rule.idMin && lo <= rule.idMax) {
+                accept = rule.include;
+            }
+        }
+        if (!accept) {
+            continue;
+        }
+
+        if (extRangeCount > 0 && extRanges[extRangeCount - 1].hi + 1 == lo) {
+            extRanges[extRangeCount - 1].hi = hi;
+        } else {
+            extRanges[extRangeCount].lo = lo;
+            extRanges[extRangeCount].hi = hi;
+            extRangeCount++;
+        }
+    }
+}
+
+bool CANFilter::acceptsExtended(uint32_t id) const {
+    uint8_t lo = 0;
+    uint8_t hi = extRangeCount;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (id > extRanges[mid].hi) {
+            lo = mid + 1;
+        } else if (id < extRanges[mid].lo) {
+            hi = mid;
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t CANFilter::acceptedStandardCount() const {
+    uint16_t accepted = 0;
+    for (uint8_t i = 0; i < (CAN_FILTER_STD_MAX_ID + 1) / 32; i++) {
+        accepted += __builtin_popcount(stdBitmap[i]);
+    }
+    return accepted;
+}
@@ -0,0 +1,93 @@
+// CANFilter.h
+// ===============================================================================
+// Kompilierter Akzeptanzfilter für den Live-Monitor
+// Beliebig viele Kombinationen aus ID-Bereich, Node-Menge und Nachrichtentyp werden als
+// geordnete Include-/Exclude-Regeln gesammelt und von compile() in
+//   - eine 2048-Bit-Tabelle für alle 11-Bit-IDs und
+//   - eine kurze, sortierte Liste akzeptierter Bereiche für 29-Bit-IDs
+// übersetzt. Die Prüfung pro Frame ist damit ein Bit-Zugriff (Standard-Frames) bzw.
+// eine binäre Suche über wenige Bereiche (Extended-Frames), unabhängig von der Regelzahl.
+//
+// Regelsemantik: Ohne Include-Regel ist alles zugelassen, sonst nichts. Die Regeln
+// werden der Reihenfolge nach angewendet, spätere überschreiben frühere. Innerhalb
+// einer Regel müssen alle Bedingungen (ID, Node, Typ) zutreffen. Node- und
+// Typbedingungen sind CANopen-Begriffe und gelten nur für 11-Bit-IDs.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+#include "CANDispatcher.h"
+
+#define CAN_FILTER_MAX_RULES      16
+#define CAN_FILTER_MAX_EXT_RANGES (2 * CAN_FILTER_MAX_RULES + 1)
+#define CAN_FILTER_STD_MAX_ID     0x7FF
+#define CAN_FILTER_EXT_MAX_ID     0x1FFFFFFF
+
+struct CANFilterRule {
+    bool include;          // true = zulassen, false = ausblenden
+    uint32_t idMin;        // ID-Bereich (inklusive)
+    uint32_t idMax;
+    uint16_t typeMask;     // Funktionscodes (CAN_FC_BIT), CAN_FC_ALL = jeder Typ
+    uint32_t nodes[4];     // Node-Menge 0-127 als Bitmaske, alle Bits = jeder Node
+
+    bool hasNodeCondition() const;
+    bool hasTypeCondition() const { return typeMask != CAN_FC_ALL; }
+    bool matchesStandard(uint16_t id) const;
+};
+
+class CANFilter {
+public:
+    CANFilter();
+
+    // Regel ohne Bedingungen (passt auf jeden Frame)
+    static CANFilterRule makeRule(bool include);
+
+    static void setNode(CANFilterRule& rule, uint8_t nodeId);
+    static void clearNodes(CANFilterRule& rule);
+
+    // Regeln verwalten; nach Änderungen compile() aufrufen
+    bool addRule(const CANFilterRule& rule);
+    bool insertRule(uint8_t index, const CANFilterRule& rule);  // Spätere Regeln rücken nach
+    bool removeRule(uint8_t index);
+    void clear();
+
+    uint8_t ruleCount() const { return count; }
+    CANFilterRule& rule(uint8_t index) { return rules[index]; }
+    const CANFilterRule& rule(uint8_t index) const { return rules[index]; }
+
+    // Regeln in Bitmap und Bereichsliste übersetzen
+    void compile();
+
+    bool accepts(const CanFrame& frame) const {
+        if (!frame.ext && frame.id <= CAN_FILTER_STD_MAX_ID) {
+            return (stdBitmap[frame.id >> 5] >> (frame.id & 31)) & 1;
+        }
+        return acceptsExtended(frame.id);
+    }
+
+    uint16_t acceptedStandardCount() const;
+    uint8_t extendedRangeCount() const { return extRangeCount; }
+
+    // Kompilierte Tabelle der 11-Bit-IDs (z.B. als Vorgabe für Hardwarefilter)
+    const uint32_t* standardBitmap() const { return stdBitmap; }
+
+private:
+    struct IdRange {
+        uint32_t lo;
+        uint32_t hi;
+    };
+
+    CANFilterRule rules[CAN_FILTER_MAX_RULES];
+    uint8_t count;
+
+    uint32_t stdBitmap[(CAN_FILTER_STD_MAX_ID + 1) / 32];
+    IdRange extRanges[CAN_FILTER_MAX_EXT_RANGES];  // Akzeptierte Bereiche, sortiert
+    uint8_t extRangeCount;
+
+    bool acceptsExtended(uint32_t id) const;
+    void compileStandard(bool defaultAccept);
+    void compileExtended(bool defaultAccept);
+};
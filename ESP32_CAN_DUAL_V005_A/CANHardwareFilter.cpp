@@ -0,0 +1,317 @@
+// CANHardwareFilter.cpp
+// ===============================================================================
+// Implementation der Akzeptanzfilter-Berechnung
+// ===============================================================================
+
+#include "CANHardwareFilter.h"
+#include <string.h>
+
+#define CAN_HW_STD_MASK 0x7FF
+
+namespace {
+
+struct Pattern {
+    uint16_t code;
+    uint16_t mask;  // 1 = Bit wird verglichen
+};
+
+int32_t patternSize(const Pattern& p) {
+    return (int32_t)1 << (11 - __builtin_popcount(p.mask & CAN_HW_STD_MASK));
+}
+
+// Kleinstes Muster, das beide Muster abdeckt
+Pattern mergePatterns(const Pattern& a, const Pattern& b) {
+    Pattern m;
+    m.mask = a.mask & b.mask & ~(a.code ^ b.code) & CAN_HW_STD_MASK;
+    m.code = a.code & m.mask;
+    return m;
+}
+
+bool patternCovers(const Pattern& outer, const Pattern& inner) {
+    return (inner.mask & outer.mask) == outer.mask && (inner.code & outer.mask) == outer.code;
+}
+
+// Zusätzlich durchgelassene IDs beim Zusammenlegen (Überlappungen ergeben negative Werte)
+int32_t mergeCost(const Pattern& a, const Pattern& b) {
+    return patternSize(mergePatterns(a, b)) - patternSize(a) - patternSize(b);
+}
+
+void removePattern(Pattern* list, uint8_t& count, uint8_t index) {
+    for (uint8_t i = index; i + 1 < count; i++) {
+        list[i] = list[i + 1];
+    }
+    count--;
+}
+
+// Liste voll: die günstigsten Nachbarn zusammenlegen (die Liste ist nach ID sortiert)
+void mergeCheapestNeighbours(Pattern* list, uint8_t& count) {
+    uint8_t best = 0;
+    int32_t bestCost = INT32_MAX;
+    for (uint8_t i = 0; i + 1 < count; i++) {
+        int32_t cost = mergeCost(list[i], list[i + 1]);
+        if (cost < bestCost) {
+            bestCost = cost;
+            best = i;
+        }
+    }
+    list[best] = mergePatterns(list[best], list[best + 1]);
+    removePattern(list, count, best + 1);
+}
+
+// Das günstigste Paar der ganzen Liste zusammenlegen und abgedeckte Muster entfernen
+void mergeCheapestPair(Pattern* list, uint8_t& count) {
+    uint8_t bestA = 0;
+    uint8_t bestB = 1;
+    int32_t bestCost = INT32_MAX;
+    for (uint8_t a = 0; a < count; a++) {
+        for (uint8_t b = a + 1; b < count; b++) {
+            int32_t cost = mergeCost(list[a], list[b]);
+            if (cost < bestCost) {
+                bestCost = cost;
+                bestA = a;
+                bestB = b;
+            }
+        }
+    }
+
+    Pattern merged = mergePatterns(list[bestA], list[bestB]);
+    list[bestA] = merged;
+    removePattern(list, count, bestB);
+
+    uint8_t i = 0;
+    while (i < count) {
+        if (i != bestA && patternCovers(merged, list[i])) {
+            removePattern(list, count, i);
+            if (i < bestA) {
+                bestA--;
+            }
+        } else {
+            i++;
+        }
+    }
+}
+
+uint16_t countPassed(const Pattern* list, uint8_t count) {
+    uint16_t passed = 0;
+    for (uint16_t id = 0; id < CAN_HW_FILTER_STD_IDS; id++) {
+        for (uint8_t i = 0; i < count; i++) {
+            if ((id & list[i].mask) == list[i].code) {
+                passed++;
+                break;
+            }
+        }
+    }
+    return passed;
+}
+
+// Alle Zuordnungen der Muster zu den Maskengruppen durchprobieren; die gemeinsame Maske
+// einer Gruppe ist die Schnittmenge der verglichenen Bits ihrer Muster
+void assignGroups(const Pattern* list, uint8_t count, const uint8_t* groupSizes, uint8_t groupCount,
+                  CANHardwareFilterPlan& best) {
+    uint32_t combinations = 1;
+    for (uint8_t i = 0; i < count; i++) {
+        combinations *= groupCount;
+    }
+
+    for (uint32_t combination = 0; combination < combinations; combination++) {
+        uint8_t groupOf[CAN_HW_FILTER_MAX_GROUPS * CAN_HW_FILTER_MAX_CODES];
+        uint8_t members[CAN_HW_FILTER_MAX_GROUPS] = {0};
+        uint16_t groupMask[CAN_HW_FILTER_MAX_GROUPS];
+        for (uint8_t g = 0; g < groupCount; g++) {
+            groupMask[g] = CAN_HW_STD_MASK;
+        }
+
+        bool fits = true;
+        uint32_t digits = combination;
+        for (uint8_t i = 0; i < count; i++) {
+            uint8_t g = digits % groupCount;
+            digits /= groupCount;
+            groupOf[i] = g;
+            groupMask[g] &= list[i].mask;
+            if (++members[g] > groupSizes[g] || members[g] > CAN_HW_FILTER_MAX_CODES) {
+                fits = false;
+                break;
+            }
+        }
+        if (!fits) {
+            continue;
+        }
+
+        Pattern widened[CAN_HW_FILTER_MAX_GROUPS * CAN_HW_FILTER_MAX_CODES];
+        for (uint8_t i = 0; i < count; i++) {
+            widened[i].mask = groupMask[groupOf[i]];
+            widened[i].code = list[i].code & widened[i].mask;
+        }
+
+        // Bei Gleichstand die Lösung mit weniger Gruppen (TWAI: Single Filter Mode)
+        uint8_t usedGroups = 0;
+        for (uint8_t g = 0; g < groupCount; g++) {
+            if (members[g] > 0) {
+                usedGroups = g + 1;
+            }
+        }
+        uint16_t passed = countPassed(widened, count);
+        if (passed > best.passedIds || (passed == best.passedIds && usedGroups >= best.groupCount)) {
+            continue;
+        }
+
+        best.acceptAll = false;
+        best.passedIds = passed;
+        best.groupCount = usedGroups;
+        for (uint8_t g = 0; g < groupCount; g++) {
+            best.mask[g] = groupMask[g];
+            best.codeCount[g] = 0;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            uint8_t g = groupOf[i];
+            best.code[g][best.codeCount[g]++] = widened[i].code;
+        }
+    }
+}
+
+}  // namespace
+
+// ===================================================================================
+// CANHardwareFilterPlan
+// ===================================================================================
+
+CANHardwareFilterPlan CANHardwareFilterPlan::acceptEverything() {
+    CANHardwareFilterPlan plan;
+    memset(&plan, 0, sizeof(plan));
+    plan.acceptAll = true;
+    plan.passedIds = CAN_HW_FILTER_STD_IDS;
+    return plan;
+}
+
+bool CANHardwareFilterPlan::operator==(const CANHardwareFilterPlan& other) const {
+    if (acceptAll || other.acceptAll) {
+        return acceptAll == other.acceptAll;
+    }
+    if (groupCount != other.groupCount) {
+        return false;
+    }
+    for (uint8_t g = 0; g < groupCount; g++) {
+        if (mask[g] != other.mask[g] || codeCount[g] != other.codeCount[g]) {
+            return false;
+        }
+        for (uint8_t i = 0; i < codeCount[g]; i++) {
+            if (code[g][i] != other.code[g][i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ===================================================================================
+// CANAcceptanceSet
+// ===================================================================================
+
+CANAcceptanceSet::CANAcceptanceSet() {
+    clear();
+}
+
+void CANAcceptanceSet::clear() {
+    memset(bitmap, 0, sizeof(bitmap));
+    extended = false;
+}
+
+void CANAcceptanceSet::acceptAll() {
+    memset(bitmap, 0xFF, sizeof(bitmap));
+    extended = true;
+}
+
+void CANAcceptanceSet::addStandard(uint16_t id) {
+    if (id < CAN_HW_FILTER_STD_IDS) {
+        bitmap[id >> 5] |= 1UL << (id & 31);
+    }
+}
+
+void CANAcceptanceSet::addFunctionCodes(uint16_t functionMask) {
+    // Ein Funktionscode umfasst 128 IDs = 4 Wörter der Tabelle
+    for (uint8_t fc = 0; fc < 16; fc++) {
+        if (functionMask & CAN_FC_BIT(fc)) {
+            memset(&bitmap[fc * 4], 0xFF, 4 * sizeof(bitmap[0]));
+        }
+    }
+}
+
+void CANAcceptanceSet::addBitmap(const uint32_t* other) {
+    for (size_t i = 0; i < CAN_HW_FILTER_STD_IDS / 32; i++) {
+        bitmap[i] |= other[i];
+    }
+}
+
+uint16_t CANAcceptanceSet::standardCount() const {
+    uint16_t total = 0;
+    for (size_t i = 0; i < CAN_HW_FILTER_STD_IDS / 32; i++) {
+        total += __builtin_popcount(bitmap[i]);
+    }
+    return total;
+}
+
+CANHardwareFilterPlan CANAcceptanceSet::plan(const uint8_t* groupSizes, uint8_t groupCount) const {
+    CANHardwareFilterPlan best = CANHardwareFilterPlan::acceptEverything();
+
+    uint8_t slots = 0;
+    if (groupCount > CAN_HW_FILTER_MAX_GROUPS) {
+        groupCount = CAN_HW_FILTER_MAX_GROUPS;
+    }
+    for (uint8_t g = 0; g < groupCount; g++) {
+        slots += groupSizes[g] > CAN_HW_FILTER_MAX_CODES ? CAN_HW_FILTER_MAX_CODES : groupSizes[g];
+    }
+    if (slots == 0 || extended) {
+        return best;
+    }
+
+    // 1. Zusammenhängende Läufe gewünschter IDs in ausgerichtete Blöcke zerlegen
+    Pattern work[CAN_HW_FILTER_WORK_SIZE];
+    uint8_t count = 0;
+    uint16_t id = 0;
+    while (id < CAN_HW_FILTER_STD_IDS) {
+        if (!containsStandard(id)) {
+            id++;
+            continue;
+        }
+        uint16_t end = id;
+        while (end + 1 < CAN_HW_FILTER_STD_IDS && containsStandard(end + 1)) {
+            end++;
+        }
+        while (id <= end) {
+            uint16_t size = id == 0 ? CAN_HW_FILTER_STD_IDS : (uint16_t)(id & -id);
+            while (id + size - 1 > end) {
+                size >>= 1;
+            }
+            if (count == CAN_HW_FILTER_WORK_SIZE) {
+                mergeCheapestNeighbours(work, count);
+            }
+            work[count].code = id;
+            work[count].mask = CAN_HW_STD_MASK & ~(size - 1);
+            count++;
+            id += size;
+        }
+    }
+
+    if (count == 0) {
+        // Nichts gewünscht: nur die ungenutzte ID 0x7FF durchlassen
+        work[0].code = CAN_HW_STD_MASK;
+        work[0].mask = CAN_HW_STD_MASK;
+        count = 1;
+    }
+
+    // 2. Gierig zusammenlegen; jede Stufe, die in die Filter passt, exakt bewerten
+    while (true) {
+        if (count <= slots) {
+            assignGroups(work, count, groupSizes, groupCount, best);
+        }
+        if (count == 1) {
+            break;
+        }
+        mergeCheapestPair(work, count);
+    }
+
+    if (best.passedIds >= CAN_HW_FILTER_STD_IDS) {
+        return CANHardwareFilterPlan::acceptEverything();
+    }
+    return best;
+}
@@ -0,0 +1,69 @@
+// CANHardwareFilter.h
+// ===============================================================================
+// Übersetzung einer gewünschten ID-Menge in Akzeptanzfilter der CAN-Controller
+// Die Controller prüfen Frames nach dem Schema (id & mask) == code. Der TWAI-Controller
+// hat dafür ein oder zwei Muster (Single/Dual Filter Mode), der MCP2515 zwei Masken mit
+// 2 (RXB0) bzw. 4 (RXB1) Filtern. plan() sucht die Muster, die alle gewünschten
+// Standard-IDs durchlassen und dabei möglichst wenige ungewünschte; den Rest sortiert
+// weiterhin der Softwarefilter aus.
+//
+// Vorgehen: Die gewünschten IDs werden in ausgerichtete Zweierpotenz-Blöcke zerlegt
+// (jeder Block ist ein exaktes Muster), danach werden gierig die Muster zusammengelegt,
+// deren Vereinigung am wenigsten zusätzliche IDs kostet. Für die letzten Stufen werden
+// alle Zuordnungen zu den Maskengruppen des Controllers exakt nachgezählt.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CANDispatcher.h"
+
+#define CAN_HW_FILTER_STD_IDS     2048
+#define CAN_HW_FILTER_MAX_GROUPS  2    // Masken (MCP2515: RXM0/RXM1, TWAI: Filter 1/2)
+#define CAN_HW_FILTER_MAX_CODES   4    // Filter je Maske (MCP2515 RXB1: RXF2-RXF5)
+#define CAN_HW_FILTER_WORK_SIZE   64   // Arbeitsliste der Zusammenlegung
+
+// Ergebnis von plan(): je Gruppe eine gemeinsame Maske und bis zu vier Codes.
+// Maskenbit 1 = Bit wird verglichen (MCP2515-Polarität; TWAI invertiert beim Setzen).
+struct CANHardwareFilterPlan {
+    bool acceptAll;                                              // Keine Eingrenzung in Hardware
+    uint8_t groupCount;                                          // Belegte Gruppen
+    uint16_t mask[CAN_HW_FILTER_MAX_GROUPS];
+    uint16_t code[CAN_HW_FILTER_MAX_GROUPS][CAN_HW_FILTER_MAX_CODES];
+    uint8_t codeCount[CAN_HW_FILTER_MAX_GROUPS];                 // 0 = Gruppe unbenutzt
+    uint16_t passedIds;                                          // Standard-IDs, die die Hardware durchlässt
+
+    static CANHardwareFilterPlan acceptEverything();
+    bool operator==(const CANHardwareFilterPlan& other) const;
+    bool operator!=(const CANHardwareFilterPlan& other) const { return !(*this == other); }
+};
+
+// Menge der Frames, die die Anwendung empfangen möchte
+class CANAcceptanceSet {
+public:
+    CANAcceptanceSet();  // Leere Menge
+
+    void clear();
+    void acceptAll();
+
+    void addStandard(uint16_t id);
+    void addFunctionCodes(uint16_t functionMask);        // Alle Node-IDs der Funktionscodes (CAN_FC_BIT)
+    void addBitmap(const uint32_t* bitmap);             // 2048-Bit-Tabelle, z.B. CANFilter::standardBitmap()
+    void addExtended() { extended = true; }
+
+    bool containsStandard(uint16_t id) const {
+        return id < CAN_HW_FILTER_STD_IDS && ((bitmap[id >> 5] >> (id & 31)) & 1);
+    }
+    bool containsExtended() const { return extended; }
+    uint16_t standardCount() const;
+
+    // Muster für einen Controller mit groupCount Masken zu je groupSizes[i] Filtern
+    // berechnen. Extended-Frames lassen sich mit den Standard-Mustern nicht getrennt
+    // eingrenzen; sind sie gewünscht, bleibt der Controller offen (acceptAll).
+    CANHardwareFilterPlan plan(const uint8_t* groupSizes, uint8_t groupCount) const;
+
+private:
+    uint32_t bitmap[CAN_HW_FILTER_STD_IDS / 32];
+    bool extended;
+};
@@ -0,0 +1,214 @@
+// CANHeartbeatMonitor.cpp
+// ===============================================================================
+// Implementation des Heartbeat-Consumers mit Timer-Rad
+// ===============================================================================
+
+#include "CANHeartbeatMonitor.h"
+#include <string.h>
+
+uint32_t HeartbeatNode::timeoutMs() const {
+    if (consumerTimeMs > 0) {
+        return consumerTimeMs;
+    }
+    if (periodUs == 0) {
+        return 0;
+    }
+    uint32_t timeout = (uint32_t)((uint64_t)periodUs * HB_AUTO_TIMEOUT_PERCENT / 100000);
+    return timeout < HB_MIN_TIMEOUT_MS ? HB_MIN_TIMEOUT_MS : timeout;
+}
+
+CANHeartbeatMonitor::CANHeartbeatMonitor()
+    : seenCount(0), currentTick(0), running(false), eventFn(nullptr), eventContext(nullptr) {
+    memset(nodes, 0, sizeof(nodes));
+    clear();
+}
+
+void CANHeartbeatMonitor::setEventCallback(EventFn fn, void* context) {
+    eventFn = fn;
+    eventContext = context;
+}
+
+void CANHeartbeatMonitor::clear() {
+    for (uint8_t id = 0; id < HB_MAX_NODES; id++) {
+        uint16_t consumerTime = nodes[id].consumerTimeMs;
+        memset(&nodes[id], 0, sizeof(HeartbeatNode));
+        nodes[id].state = NMT_STATE_UNKNOWN;
+        nodes[id].previousState = NMT_STATE_UNKNOWN;
+        nodes[id].consumerTimeMs = consumerTime;
+    }
+    memset(wheel, 0, sizeof(wheel));
+    memset(scheduled, 0, sizeof(scheduled));
+    seenCount = 0;
+}
+
+void CANHeartbeatMonitor::setConsumerTime(uint8_t nodeId, uint16_t timeMs) {
+    nodes[nodeId & 0x7F].consumerTimeMs = timeMs;
+    if (timeMs == 0 && nodes[nodeId & 0x7F].periodUs == 0) {
+        // Automatisch ohne bekannte Periode: nicht überwachen, bis zwei Heartbeats da sind
+        unschedule(nodeId & 0x7F);
+    }
+}
+
+uint8_t CANHeartbeatMonitor::timedOutCount() const {
+    uint8_t count = 0;
+    for (uint8_t id = 1; id < HB_MAX_NODES; id++) {
+        if (nodes[id].timedOut) {
+            count++;
+        }
+    }
+    return count;
+}
+
+const char* CANHeartbeatMonitor::stateName(uint8_t state) {
+    switch (state) {
+        case NMT_STATE_BOOTUP:          return "Boot-up";
+        case NMT_STATE_STOPPED:         return "Stopped";
+        case NMT_STATE_OPERATIONAL:     return "Operational";
+        case NMT_STATE_PRE_OPERATIONAL: return "Pre-Operational";
+        case NMT_STATE_UNKNOWN:         return "-";
+        default:                        return "Unbekannt";
+    }
+}
+
+void CANHeartbeatMonitor::emit(uint8_t nodeId, HeartbeatEvent event) {
+    if (eventFn != nullptr) {
+        eventFn(nodeId, event, nodes[nodeId], eventContext);
+    }
+}
+
+// ===================================================================================
+// Empfang
+// ===================================================================================
+void CANHeartbeatMonitor::handleFrame(const CanFrame& frame) {
+    if (frame.ext || (frame.id & 0x780) != 0x700 || frame.len < 1) {
+        return;
+    }
+    uint8_t nodeId = frame.id & 0x7F;
+    if (nodeId == 0) {
+        return;
+    }
+
+    HeartbeatNode& entry = nodes[nodeId];
+    uint8_t state = frame.data[0] & 0x7F;  // Bit 7 = Toggle-Bit bei Node Guarding
+    bool first = !entry.seen;
+    bool recovered = entry.timedOut;
+
+    if (state == NMT_STATE_BOOTUP) {
+        // Neustart: die Periode beginnt von vorn
+        entry.periodUs = 0;
+        entry.bootups++;
+    } else if (!first && !recovered && entry.state != NMT_STATE_BOOTUP) {
+        // Abstände über eine Boot-up-Nachricht oder einen Ausfall hinweg zählen nicht
+        uint32_t gap = (uint32_t)(frame.timestamp - entry.lastSeenUs);
+        // Gleitender Mittelwert mit Gewicht 1/8; der erste Abstand setzt den Startwert
+        entry.periodUs = entry.periodUs == 0 ? gap : entry.periodUs + ((int32_t)(gap - entry.periodUs) >> 3);
+    }
+
+    entry.previousState = entry.state;
+    entry.state = state;
+    entry.lastSeenUs = frame.timestamp;
+    entry.heartbeats++;
+    entry.timedOut = false;
+    if (first) {
+        entry.seen = true;
+        seenCount++;
+    }
+
+    if (!running) {
+        currentTick = (uint32_t)(frame.timestamp / HB_WHEEL_TICK_US);
+        running = true;
+    }
+    schedule(nodeId, frame.timestamp);
+
+    if (first) {
+        emit(nodeId, state == NMT_STATE_BOOTUP ? HB_EVENT_BOOTUP : HB_EVENT_NEW_NODE);
+    } else if (state == NMT_STATE_BOOTUP) {
+        emit(nodeId, HB_EVENT_BOOTUP);
+    } else if (recovered) {
+        emit(nodeId, HB_EVENT_RECOVERED);
+    } else if (state != entry.previousState) {
+        emit(nodeId, HB_EVENT_STATE_CHANGE);
+    }
+}
+
+// ===================================================================================
+// Timer-Rad
+// ===================================================================================
+void CANHeartbeatMonitor::unschedule(uint8_t nodeId) {
+    if (!scheduled[nodeId]) {
+        return;
+    }
+    if (prev[nodeId] != 0) {
+        next[prev[nodeId]] = next[nodeId];
+    } else {
+        wheel[deadlineTick[nodeId] & (HB_WHEEL_SLOTS - 1)] = next[nodeId];
+    }
+    if (next[nodeId] != 0) {
+        prev[next[nodeId]] = prev[nodeId];
+    }
+    scheduled[nodeId] = false;
+}
+
+void CANHeartbeatMonitor::schedule(uint8_t nodeId, uint64_t nowUs) {
+    unschedule(nodeId);
+
+    uint32_t timeout = nodes[nodeId].timeoutMs();
+    if (timeout == 0) {
+        return;
+    }
+
+    // Frist aufrunden, damit nie vor Ablauf der Überwachungszeit gemeldet wird;
+    // mindestens der nächste Tick, den advance() noch besucht. Die Abschneidung auf
+    // 32 Bit ist modulo 2^32 Ticks, alle Vergleiche laufen über Differenzen.
+    uint32_t tick = (uint32_t)((nowUs + timeout * 1000ULL + HB_WHEEL_TICK_US - 1) / HB_WHEEL_TICK_US);
+    if ((int32_t)(tick - currentTick) <= 0) {
+        tick = currentTick + 1;
+    }
+    uint8_t& head = wheel[tick & (HB_WHEEL_SLOTS - 1)];
+    deadlineTick[nodeId] = tick;
+    prev[nodeId] = 0;
+    next[nodeId] = head;
+    if (head != 0) {
+        prev[head] = nodeId;
+    }
+    head = nodeId;
+    scheduled[nodeId] = true;
+}
+
+void CANHeartbeatMonitor::expireSlot(uint32_t tick) {
+    uint8_t nodeId = wheel[tick & (HB_WHEEL_SLOTS - 1)];
+    while (nodeId != 0) {
+        uint8_t following = next[nodeId];
+        // Nur fällige Einträge; spätere Umdrehungen bleiben im Fach
+        if ((int32_t)(deadlineTick[nodeId] - tick) <= 0) {
+            unschedule(nodeId);
+            HeartbeatNode& entry = nodes[nodeId];
+            entry.timedOut = true;
+            entry.missed++;
+            emit(nodeId, HB_EVENT_TIMEOUT);
+        }
+        nodeId = following;
+    }
+}
+
+void CANHeartbeatMonitor::advance(uint64_t nowUs) {
+    uint32_t nowTick = (uint32_t)(nowUs / HB_WHEEL_TICK_US);
+    if (!running) {
+        currentTick = nowTick;
+        running = true;
+        return;
+    }
+
+    // Nach langer Pause genügt eine Umdrehung: danach wurde jedes Fach einmal besucht
+    uint32_t ticks = nowTick - currentTick;
+    if ((int32_t)ticks <= 0) {
+        return;
+    }
+    if (ticks > HB_WHEEL_SLOTS) {
+        currentTick = nowTick - HB_WHEEL_SLOTS;
+    }
+    while (currentTick != nowTick) {
+        currentTick++;
+        expireSlot(currentTick);
+    }
+}
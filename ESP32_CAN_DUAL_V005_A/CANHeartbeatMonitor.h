@@ -0,0 +1,115 @@
+// CANHeartbeatMonitor.h
+// ===============================================================================
+// Heartbeat-Consumer (Semantik von Objekt 0x1016)
+// Eine feste Tabelle mit 128 Einträgen (Index = Node-ID) hält je Node den zuletzt
+// gemeldeten NMT-Zustand, den Zeitpunkt des letzten Heartbeats, eine geschätzte
+// Periode und die Zahl verpasster Heartbeats. Antworten auf Node Guarding (Zustand
+// mit Toggle-Bit) werden wie Heartbeats ausgewertet.
+//
+// Zeitüberschreitungen prüft ein Timer-Rad: jeder überwachte Node hängt in genau einem
+// Fach (Frist / HB_WHEEL_TICK_MS modulo HB_WHEEL_SLOTS). advance() besucht nur die
+// Fächer der seit dem letzten Aufruf vergangenen Ticks statt aller Nodes; ein Heartbeat
+// hängt den Node in O(1) um. Fristen jenseits einer Radumdrehung bleiben im Fach
+// und werden bei späteren Umdrehungen erneut geprüft. Ticks werden aus der 64-Bit-
+// Mikrosekundenzeit gebildet und nur als Differenz verglichen, damit das Rad auch über
+// den Überlauf einer 32-Bit-Millisekundenzeit (49,7 Tage) hinweg weiterläuft.
+//
+// Überwachungszeit je Node: fest eingestellt (Consumer-Heartbeat-Zeit) oder automatisch
+// das HB_AUTO_TIMEOUT_PERCENT-fache der geschätzten Periode, sobald zwei Heartbeats
+// gesehen wurden.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define HB_MAX_NODES             128   // Node-IDs 0..127 (0 wird nicht benutzt)
+#define HB_WHEEL_SLOTS           128   // Fächer des Timer-Rads (Zweierpotenz)
+#define HB_WHEEL_TICK_MS         10    // Auflösung: eine Umdrehung = 1,28 s
+#define HB_WHEEL_TICK_US         (HB_WHEEL_TICK_MS * 1000ULL)
+#define HB_AUTO_TIMEOUT_PERCENT  150   // Automatische Überwachungszeit in % der Periode
+#define HB_MIN_TIMEOUT_MS        50    // Untergrenze der automatischen Überwachungszeit
+
+// NMT-Zustände im Heartbeat (CiA 301)
+enum CANNMTState : uint8_t {
+    NMT_STATE_BOOTUP          = 0x00,
+    NMT_STATE_STOPPED         = 0x04,
+    NMT_STATE_OPERATIONAL     = 0x05,
+    NMT_STATE_PRE_OPERATIONAL = 0x7F,
+    NMT_STATE_UNKNOWN         = 0xFF   // Noch kein Heartbeat
+};
+
+enum HeartbeatEvent : uint8_t {
+    HB_EVENT_NEW_NODE = 0,   // Erster Heartbeat eines Nodes
+    HB_EVENT_BOOTUP,         // Boot-up-Nachricht (Node neu gestartet)
+    HB_EVENT_STATE_CHANGE,   // Anderer NMT-Zustand
+    HB_EVENT_TIMEOUT,        // Überwachungszeit ohne Heartbeat abgelaufen
+    HB_EVENT_RECOVERED       // Heartbeat nach einer Zeitüberschreitung
+};
+
+struct HeartbeatNode {
+    uint8_t state;           // CANNMTState
+    uint8_t previousState;
+    bool seen;
+    bool timedOut;           // Seit der letzten Zeitüberschreitung kein Heartbeat
+    uint16_t consumerTimeMs; // Fest eingestellte Überwachungszeit (0 = automatisch)
+    uint32_t periodUs;       // Geschätzte Periode (gleitender Mittelwert, 0 = unbekannt)
+    uint64_t lastSeenUs;     // Zeitstempel des letzten Heartbeats
+    uint32_t heartbeats;
+    uint32_t missed;         // Zeitüberschreitungen
+    uint32_t bootups;
+
+    // Aktive Überwachungszeit in ms (0 = keine Überwachung)
+    uint32_t timeoutMs() const;
+};
+
+class CANHeartbeatMonitor {
+public:
+    typedef void (*EventFn)(uint8_t nodeId, HeartbeatEvent event, const HeartbeatNode& node, void* context);
+
+    CANHeartbeatMonitor();
+
+    void setEventCallback(EventFn fn, void* context);
+
+    // Alle Nodes vergessen (Einstellungen der Überwachungszeit bleiben erhalten)
+    void clear();
+
+    // Frame 0x700 + Node-ID übernehmen; andere Frames werden ignoriert
+    void handleFrame(const CanFrame& frame);
+
+    // Timer-Rad bis nowUs (Zeitbasis der Frame-Zeitstempel) weiterdrehen und
+    // abgelaufene Fristen melden
+    void advance(uint64_t nowUs);
+
+    // Feste Überwachungszeit (0 = automatisch aus der Periode); gilt ab dem nächsten Heartbeat
+    void setConsumerTime(uint8_t nodeId, uint16_t timeMs);
+
+    const HeartbeatNode& node(uint8_t nodeId) const { return nodes[nodeId & 0x7F]; }
+    uint8_t nodeCount() const { return seenCount; }
+    uint8_t timedOutCount() const;
+
+    static const char* stateName(uint8_t state);
+
+private:
+    HeartbeatNode nodes[HB_MAX_NODES];
+    uint8_t seenCount;
+
+    // Timer-Rad: doppelt verkettete Listen über Node-IDs (0 = Listenende, Node 0 gibt es nicht)
+    uint8_t wheel[HB_WHEEL_SLOTS];
+    uint8_t next[HB_MAX_NODES];
+    uint8_t prev[HB_MAX_NODES];
+    uint32_t deadlineTick[HB_MAX_NODES];
+    bool scheduled[HB_MAX_NODES];
+    uint32_t currentTick;
+    bool running;
+
+    EventFn eventFn;
+    void* eventContext;
+
+    void schedule(uint8_t nodeId, uint64_t nowUs);
+    void unschedule(uint8_t nodeId);
+    void expireSlot(uint32_t tick);
+    void emit(uint8_t nodeId, HeartbeatEvent event);
+};
@@ -0,0 +1,140 @@
+// CANIOChannel.h
+// ===============================================================================
+// Lock-freie Kopplung zwischen Anwendung und CAN-I/O-Task (Header-only)
+// Drei SPSC-Ringpuffer verbinden die beiden Seiten:
+//   - Sendeaufträge        Anwendung -> I/O-Task
+//   - Sendeergebnisse      I/O-Task  -> Anwendung
+//   - empfangene Frames    I/O-Task  -> Anwendung
+// Die I/O-Seite (ioStep) arbeitet mit jedem Treiber, der enqueueTx(), serviceTx() und
+// receiveBurst() wie CANInterface anbietet. Abschluss-Callbacks des Treibers laufen im
+// I/O-Task und legen nur das Ergebnis in den Ring; die Callbacks der Anwendung werden
+// erst auf ihrer Seite aufgerufen.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+#include "CANRingBuffer.h"
+
+#define CAN_IO_RX_QUEUE_SIZE  256  // Empfangene Frames (Zweierpotenz)
+#define CAN_IO_TX_QUEUE_SIZE  64   // Offene Sendeaufträge (Zweierpotenz)
+#define CAN_IO_RX_BURST       32   // Frames pro Abholung beim Treiber
+
+struct CANIOTxResult {
+    uint32_t seq;
+    bool success;
+};
+
+class CANIOChannel {
+public:
+    CANIOChannel() {
+        for (size_t i = 0; i < CAN_IO_TX_QUEUE_SIZE; i++) {
+            slots[i].owner = this;
+            slots[i].seq = 0;
+        }
+    }
+
+    // ===========================================================================
+    // Anwendungsseite
+    // Der Aufrufer sorgt dafür, dass höchstens CAN_IO_TX_QUEUE_SIZE - 1 Aufträge offen
+    // sind (abgeschickt, aber Ergebnis noch nicht abgeholt); seq identifiziert den
+    // Auftrag im Ergebnis.
+    // ===========================================================================
+
+    bool submitTx(const CanFrame& frame, uint32_t seq) {
+        TxCommand command;
+        command.frame = frame;
+        command.seq = seq;
+        return txQueue.push(command);
+    }
+
+    bool popTxResult(CANIOTxResult& result) {
+        return resultQueue.pop(result);
+    }
+
+    // Empfangene Frames; die Anwendung ist der einzige Consumer
+    CANRingBuffer<CanFrame, CAN_IO_RX_QUEUE_SIZE>& received() {
+        return rxQueue;
+    }
+
+    const CANRingBuffer<CanFrame, CAN_IO_RX_QUEUE_SIZE>& received() const {
+        return rxQueue;
+    }
+
+    // Alle Ringe leeren. Nur bei angehaltenem I/O-Task aufrufen.
+    void reset() {
+        TxCommand command;
+        while (txQueue.pop(command)) {
+        }
+        resultQueue.clear();
+        rxQueue.clear();
+    }
+
+    // ===========================================================================
+    // I/O-Seite: Aufträge an den Treiber übergeben, Sendequeue des Treibers bedienen
+    // und dessen Empfangspuffer in den Ring der Anwendung leeren.
+    // Liefert die Anzahl weitergereichter Frames (gesendet + empfangen).
+    // ===========================================================================
+    template <typename Port>
+    size_t ioStep(Port& port) {
+        size_t moved = 0;
+
+        TxCommand command;
+        while (txQueue.pop(command)) {
+            TxSlot& slot = slots[command.seq & TX_MASK];
+            slot.seq = command.seq;
+            if (!port.enqueueTx(command.frame, onTxDone, &slot)) {
+                reportTx(command.seq, false);  // Treiberqueue voll
+            }
+            moved++;
+        }
+
+        port.serviceTx();
+
+        CanFrame frames[CAN_IO_RX_BURST];
+        size_t count;
+        while ((count = port.receiveBurst(frames, CAN_IO_RX_BURST, 0)) > 0) {
+            for (size_t i = 0; i < count; i++) {
+                rxQueue.push(frames[i]);  // Bei vollem Ring zählt er den Überlauf
+            }
+            moved += count;
+            if (count < CAN_IO_RX_BURST) {
+                break;
+            }
+        }
+        return moved;
+    }
+
+private:
+    static constexpr uint32_t TX_MASK = CAN_IO_TX_QUEUE_SIZE - 1;
+
+    struct TxCommand {
+        CanFrame frame;
+        uint32_t seq;
+    };
+
+    // Kontext der Treiber-Callbacks; ein Platz je offenem Auftrag (seq & TX_MASK)
+    struct TxSlot {
+        CANIOChannel* owner;
+        uint32_t seq;
+    };
+
+    CANRingBuffer<TxCommand, CAN_IO_TX_QUEUE_SIZE> txQueue;
+    CANRingBuffer<CANIOTxResult, CAN_IO_TX_QUEUE_SIZE> resultQueue;
+    CANRingBuffer<CanFrame, CAN_IO_RX_QUEUE_SIZE> rxQueue;
+    TxSlot slots[CAN_IO_TX_QUEUE_SIZE];
+
+    void reportTx(uint32_t seq, bool success) {
+        CANIOTxResult result;
+        result.seq = seq;
+        result.success = success;
+        resultQueue.push(result);  // Kann nicht überlaufen: höchstens so viele Aufträge offen
+    }
+
+    static void onTxDone(const CanFrame& frame, bool success, void* context) {
+        TxSlot* slot = static_cast<TxSlot*>(context);
+        slot->owner->reportTx(slot->seq, success);
+    }
+};
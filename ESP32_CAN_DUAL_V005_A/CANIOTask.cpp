@@ -0,0 +1,231 @@
+// CANIOTask.cpp
+// ===============================================================================
+// Implementation des CAN-I/O-Tasks
+// ===============================================================================
+
+#include "CANIOTask.h"
+
+CANIOTaskInterface::CANIOTaskInterface(CANInterface* driver)
+    : driver(driver), taskHandle(nullptr), taskActive(false), pauseRequest(false),
+      taskPaused(false), txNextSeq(0), txOutstanding(0) {
+    memset(txState, CAN_TX_OK, sizeof(txState));
+
+    // Die Pipeline reicht bis in die Treiberqueue: mehr Frames gleichzeitig übergeben
+    txInFlightLimit = CAN_TX_INFLIGHT_LIMIT_MAX;
+}
+
+CANIOTaskInterface::~CANIOTaskInterface() {
+    end();
+    delete driver;
+}
+
+bool CANIOTaskInterface::begin(uint32_t baudrate) {
+    stopTask();
+
+    // Gespeicherten Hardwarefilter an den Treiber weiterreichen
+    if (!driver->begin(baudrate)) {
+        return false;
+    }
+    channel.reset();
+    return startTask();
+}
+
+void CANIOTaskInterface::end() {
+    stopTask();
+    driver->end();  // Meldet offene Treibersendungen als fehlgeschlagen in den Ergebnisring
+
+    cancelTx();
+    collectTxResults();
+    channel.reset();
+    txOutstanding = 0;
+}
+
+uint32_t CANIOTaskInterface::getRxOverrunCount() const {
+    return driver->getRxOverrunCount() + channel.received().overrunCount();
+}
+
+// Reine Registerlesezugriffe: der MCP2515-Treiber sichert den SPI-Bus selbst ab,
+// twai_get_status_info() ist threadsicher
+bool CANIOTaskInterface::getErrorCounters(CANErrorCounters& counters) {
+    return driver->getErrorCounters(counters);
+}
+
+bool CANIOTaskInterface::setAcceptanceFilter(const CANAcceptanceSet& wanted) {
+    pauseTask();
+    bool supported = driver->setAcceptanceFilter(wanted);
+    acceptancePlan = driver->getAcceptanceFilter();
+    resumeTask();
+    return supported;
+}
+
+// ===================================================================================
+// Empfang (Anwendungsseite)
+// ===================================================================================
+bool CANIOTaskInterface::receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) {
+    CanFrame frame;
+    if (!channel.received().pop(frame)) {
+        return false;
+    }
+
+    *id = frame.id;
+    *ext = frame.ext;
+    *len = frame.len;
+    memcpy(buf, frame.data, frame.len);
+    return true;
+}
+
+size_t CANIOTaskInterface::receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+    return popBurstWithTimeout(channel.received(), frames, max, timeoutUs);
+}
+
+bool CANIOTaskInterface::messageAvailable() {
+    return !channel.received().empty();
+}
+
+// ===================================================================================
+// Senden (Anwendungsseite)
+// Jeder Auftrag erhält eine fortlaufende Nummer; ihr Zustand liegt in txState, bis
+// das Ergebnis des I/O-Tasks abgeholt ist.
+// ===================================================================================
+void CANIOTaskInterface::collectTxResults() {
+    CANIOTxResult result;
+    while (channel.popTxResult(result)) {
+        uint8_t& state = txState[result.seq & (CAN_IO_TX_QUEUE_SIZE - 1)];
+        state = (state == TX_ABANDONED) ? CAN_TX_FAILED : (result.success ? CAN_TX_OK : CAN_TX_FAILED);
+        txOutstanding--;
+    }
+}
+
+CANTxStatus CANIOTaskInterface::startTransmit(const CanFrame& frame, uint32_t* handle) {
+    if (taskHandle == nullptr) {
+        return CAN_TX_FAILED;
+    }
+
+    collectTxResults();
+    if (txOutstanding >= CAN_IO_TX_QUEUE_SIZE - 1) {
+        return CAN_TX_BUSY;
+    }
+
+    uint32_t seq = txNextSeq;
+    if (!channel.submitTx(frame, seq)) {
+        return CAN_TX_BUSY;
+    }
+    txNextSeq++;
+    txOutstanding++;
+    txState[seq & (CAN_IO_TX_QUEUE_SIZE - 1)] = CAN_TX_PENDING;
+
+    xTaskNotifyGive(taskHandle);
+    *handle = seq;
+    return CAN_TX_PENDING;
+}
+
+CANTxStatus CANIOTaskInterface::pollTransmit(uint32_t handle) {
+    collectTxResults();
+    return (CANTxStatus)txState[handle & (CAN_IO_TX_QUEUE_SIZE - 1)];
+}
+
+void CANIOTaskInterface::abortTransmit(uint32_t handle) {
+    // Der Treiber bricht nach seinem eigenen Timeout ab; das Ergebnis wird verworfen
+    uint8_t& state = txState[handle & (CAN_IO_TX_QUEUE_SIZE - 1)];
+    if (state == CAN_TX_PENDING) {
+        state = TX_ABANDONED;
+    }
+}
+
+bool CANIOTaskInterface::sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) {
+    CanFrame frame;
+    frame.id = id;
+    frame.ext = ext;
+    frame.len = len > 8 ? 8 : len;
+    memcpy(frame.data, buf, frame.len);
+
+    // Blockierend über die Sendequeue des Proxys (Priorität, Busstatistik) und von
+    // dort über den I/O-Task; gewartet wird nur auf diesen Frame
+    return transmitBlocking(frame);
+}
+
+// ===================================================================================
+// I/O-Task
+// Wartet auf neue Sendeaufträge (Task-Notification) oder höchstens einen Tick und
+// bedient dann Treiber und Ringe. Nur hier wird der Treiber im Betrieb angesprochen.
+// ===================================================================================
+bool CANIOTaskInterface::startTask() {
+    if (taskHandle != nullptr) {
+        return true;
+    }
+
+    taskActive = true;
+    pauseRequest = false;
+    taskPaused = false;
+    if (xTaskCreatePinnedToCore(taskEntry, "can_io", CAN_IO_TASK_STACK, this,
+                                CAN_IO_TASK_PRIORITY, &taskHandle, CAN_IO_TASK_CORE) != pdPASS) {
+        Serial.println("[FEHLER] CAN-I/O-Task konnte nicht gestartet werden");
+        taskActive = false;
+        taskHandle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void CANIOTaskInterface::stopTask() {
+    if (taskHandle == nullptr) {
+        return;
+    }
+
+    taskActive = false;
+    xTaskNotifyGive(taskHandle);
+
+    // Warten, bis der Task sich selbst beendet hat
+    while (taskHandle != nullptr) {
+        vTaskDelay(1);
+    }
+}
+
+// Task an einer sicheren Stelle anhalten, damit die Anwendung den Treiber direkt
+// ansprechen kann (z.B. Filter setzen). Treiber-Callbacks laufen dann im Aufrufer.
+void CANIOTaskInterface::pauseTask() {
+    if (taskHandle == nullptr) {
+        return;
+    }
+
+    pauseRequest = true;
+    xTaskNotifyGive(taskHandle);
+    while (!taskPaused) {
+        vTaskDelay(1);
+    }
+}
+
+void CANIOTaskInterface::resumeTask() {
+    if (taskHandle == nullptr) {
+        return;
+    }
+
+    pauseRequest = false;
+    xTaskNotifyGive(taskHandle);
+    while (taskPaused) {
+        vTaskDelay(1);
+    }
+}
+
+void CANIOTaskInterface::taskEntry(void* arg) {
+    static_cast<CANIOTaskInterface*>(arg)->taskLoop();
+}
+
+void CANIOTaskInterface::taskLoop() {
+    while (taskActive) {
+        if (pauseRequest) {
+            taskPaused = true;
+            while (pauseRequest && taskActive) {
+                ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+            }
+            taskPaused = false;
+            continue;
+        }
+
+        ulTaskNotifyTake(pdTRUE, 1);
+        channel.ioStep(*driver);
+    }
+
+    taskHandle = nullptr;
+    vTaskDelete(NULL);
+}
@@ -0,0 +1,64 @@
+// CANIOTask.h
+// ===============================================================================
+// CAN-I/O-Task: Stellvertreter-Interface vor einem echten Treiber
+// Der Task auf CAN_IO_TASK_CORE besitzt den Treiber: er übergibt Sendeaufträge,
+// bedient dessen Sendequeue und leert den Empfangspuffer. Die Anwendung in loop()
+// sieht ein gewöhnliches CANInterface, dessen Frames über CANIOChannel (lock-freie
+// Ringe) laufen. Ein langsamer Display-Refresh oder eine blockierende SDO-Wartezeit in
+// loop() hält damit weder den Empfang noch laufende Sendungen auf; Abschluss-Callbacks
+// der Anwendung laufen weiterhin in ihrem eigenen serviceTx().
+// ===============================================================================
+
+#pragma once
+
+#include "CANInterface.h"
+#include "CANIOChannel.h"
+
+class CANIOTaskInterface : public CANInterface {
+public:
+    // Übernimmt den Treiber und gibt ihn im Destruktor frei
+    explicit CANIOTaskInterface(CANInterface* driver);
+    ~CANIOTaskInterface();
+
+    bool begin(uint32_t baudrate) override;
+    bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override;
+    bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override;
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0) override;
+    bool messageAvailable() override;
+    void end() override;
+    uint32_t getRxOverrunCount() const override;
+    bool getErrorCounters(CANErrorCounters& counters) override;
+
+    // Der Treiber wird dafür kurz angehalten (TWAI installiert z.B. neu)
+    bool setAcceptanceFilter(const CANAcceptanceSet& wanted) override;
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override;
+    CANTxStatus pollTransmit(uint32_t handle) override;
+    void abortTransmit(uint32_t handle) override;
+
+private:
+    static const uint8_t TX_ABANDONED = 0xFF;  // Abgebrochen, Ergebnis wird verworfen
+
+    CANInterface* driver;
+    CANIOChannel channel;
+
+    TaskHandle_t taskHandle;
+    volatile bool taskActive;
+    volatile bool pauseRequest;
+    volatile bool taskPaused;
+
+    // Anwendungsseite des Sendepfads
+    uint32_t txNextSeq;
+    uint32_t txOutstanding;                 // Abgeschickt, Ergebnis noch nicht abgeholt
+    uint8_t txState[CAN_IO_TX_QUEUE_SIZE];  // CANTxStatus bzw. TX_ABANDONED je seq
+
+    void collectTxResults();
+
+    bool startTask();
+    void stopTask();
+    void pauseTask();
+    void resumeTask();
+    void taskLoop();
+    static void taskEntry(void* arg);
+};
@@ -1,20 +1,274 @@
 #include "CANInterface.h"
+#include "SimCANInterface.h"
+#include "SocketCANInterface.h"
+#include "CANTimestamp.h"
+
+// Controller-Hardware und I/O-Task gibt es nur auf dem ESP32; im Host-Build
+// (host/) bleiben Simulation und SocketCAN
+#if defined(ESP32) || defined(ESP_PLATFORM)
 #include "MCP2515Interface.h"
 #include "ESP32CANInterface.h"
 #include "TJA1051Interface.h"
+#include "CANIOTask.h"
+
+// Echte Controller hinter den CAN-I/O-Task stellen
+static CANInterface* withIOTask(CANInterface* driver) {
+#if CAN_IO_TASK_ENABLED
+    return new CANIOTaskInterface(driver);
+#else
+    return driver;
+#endif
+}
+#endif
 
 CANInterface* CANInterface::createInstance(uint8_t controllerType) {
     switch (controllerType) {
+#if defined(ESP32) || defined(ESP_PLATFORM)
         case CAN_CONTROLLER_MCP2515:
-            return new MCP2515Interface(5, 4);  // CS = 5, INT = 4 (Standard-Werte)
+            return withIOTask(new MCP2515Interface(5, 4));  // CS = 5, INT = 4 (Standard-Werte)
             
         case CAN_CONTROLLER_ESP32CAN:
             return new ESP32CANInterface();
             
         case CAN_CONTROLLER_TJA1051:
-            return new TJA1051Interface(255);  // STBY = 26 (kann mit 255 deaktiviert werden)
+            return withIOTask(new TJA1051Interface(255));  // STBY = 26 (kann mit 255 deaktiviert werden)
+#endif
+            
+        case CAN_CONTROLLER_SIM:
+            return new SimCANInterface(simNetwork());  // Bus wird beim Zugriff abgespielt, kein I/O-Task
             
+#if defined(__linux__)
+        case CAN_CONTROLLER_SOCKETCAN: {
+            const char* name = getenv("CAN_INTERFACE");
+            return new SocketCANInterface(name != nullptr ? name : SOCKETCAN_DEFAULT_INTERFACE);
+        }
+#endif
+
         default:
             return nullptr;
     }
+}
+
+// Standardimplementierung für Treiber ohne eigenen Burst-Zugriff:
+// wiederholt receiveMessage() aufrufen, bis nichts mehr ansteht oder max erreicht ist
+size_t CANInterface::receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+    if (max == 0) {
+        return 0;
+    }
+
+    uint32_t start = micros();
+    while (!messageAvailable()) {
+        if (micros() - start >= timeoutUs) {
+            return 0;
+        }
+        yield();
+    }
+
+    size_t count = 0;
+    while (count < max && messageAvailable()) {
+        CanFrame& frame = frames[count];
+        if (!receiveMessage(&frame.id, &frame.ext, &frame.len, frame.data)) {
+            break;
+        }
+        frame.timestamp = canTimestampUs();  // Treiber ohne eigenen Zeitstempel: Abholzeitpunkt
+        count++;
+    }
+    return count;
+}
+
+// ===================================================================================
+// Hardware-Akzeptanzfilter
+// ===================================================================================
+bool CANInterface::setAcceptanceFilter(const CANAcceptanceSet& wanted) {
+    uint8_t groupSizes[CAN_HW_FILTER_MAX_GROUPS];
+    uint8_t groups = acceptanceFilterLayout(groupSizes);
+    if (groups == 0) {
+        return false;
+    }
+
+    CANHardwareFilterPlan plan = wanted.plan(groupSizes, groups);
+    if (plan == acceptancePlan) {
+        return true;  // Unverändert, z.B. kein Treiber-Neustart beim TWAI
+    }
+    if (!applyAcceptanceFilter(plan)) {
+        return false;
+    }
+    acceptancePlan = plan;
+    return true;
+}
+
+// ===================================================================================
+// Nicht blockierender Sendepfad
+// ===================================================================================
+bool CANInterface::enqueueTx(const CanFrame& frame, CANTxCallback callback, void* context) {
+    TxRequest request;
+    request.frame = frame;
+    if (request.frame.len > 8) {
+        request.frame.len = 8;
+    }
+    request.callback = callback;
+    request.context = context;
+
+    uint32_t key = CANTxQueue<TxRequest, CAN_TX_QUEUE_SIZE>::arbitrationKey(frame.id, frame.ext);
+    if (!txQueue.push(request, key)) {
+        txDropped++;
+        return false;
+    }
+    return true;
+}
+
+size_t CANInterface::sendBurst(const CanFrame* frames, size_t count, CANTxCallback callback, void* context) {
+    size_t queued = 0;
+    while (queued < count && enqueueTx(frames[queued], callback, context)) {
+        queued++;
+    }
+    serviceTx();
+    return queued;
+}
+
+void CANInterface::serviceTx() {
+    uint32_t now = millis();
+
+    // 1. Abschlüsse der übergebenen Frames einsammeln
+    uint8_t i = 0;
+    while (i < txInFlightCount) {
+        CANTxStatus status = pollTransmit(txInFlight[i].handle);
+        if (status == CAN_TX_PENDING && now - txInFlight[i].startMs >= CAN_TX_TIMEOUT_MS) {
+            abortTransmit(txInFlight[i].handle);
+            status = CAN_TX_FAILED;
+        }
+        if (status != CAN_TX_OK && status != CAN_TX_FAILED) {
+            i++;
+            continue;
+        }
+
+        TxRequest done = txInFlight[i].request;
+        for (uint8_t j = i + 1; j < txInFlightCount; j++) {
+            txInFlight[j - 1] = txInFlight[j];
+        }
+        txInFlightCount--;
+        completeTx(done, status == CAN_TX_OK);
+    }
+
+    // 2. Freie Sendepuffer des Controllers in Prioritätsreihenfolge füllen
+    while (!txQueue.empty() && txInFlightCount < txInFlightLimit) {
+        uint32_t handle = 0;
+        CANTxStatus status = startTransmit(txQueue.top().frame, &handle);
+        if (status == CAN_TX_BUSY) {
+            break;
+        }
+
+        TxRequest request = txQueue.top();
+        txQueue.pop();
+
+        if (status == CAN_TX_PENDING) {
+            TxInFlight& slot = txInFlight[txInFlightCount++];
+            slot.request = request;
+            slot.handle = handle;
+            slot.startMs = now;
+        } else {
+            completeTx(request, status == CAN_TX_OK);
+        }
+    }
+}
+
+void CANInterface::cancelTx() {
+    // Zuerst alles abräumen, dann melden: Callbacks dürfen neue Frames einreihen
+    uint8_t inFlight = txInFlightCount;
+    TxInFlight pending[CAN_TX_INFLIGHT_LIMIT_MAX];
+    for (uint8_t i = 0; i < inFlight; i++) {
+        abortTransmit(txInFlight[i].handle);
+        pending[i] = txInFlight[i];
+    }
+    txInFlightCount = 0;
+
+    for (uint8_t i = 0; i < inFlight; i++) {
+        completeTx(pending[i].request, false);
+    }
+    // Nur die beim Aufruf vorhandenen Frames melden, nicht die aus Callbacks nachgereihten
+    size_t queued = txQueue.size();
+    while (queued-- > 0 && !txQueue.empty()) {
+        TxRequest request = txQueue.top();
+        txQueue.pop();
+        completeTx(request, false);
+    }
+}
+
+// Abschluss eines blockierenden Auftrags: Ergebnis in die wartende Variable
+static void onBlockingTxDone(const CanFrame& frame, bool success, void* context) {
+    *static_cast<CANTxStatus*>(context) = success ? CAN_TX_OK : CAN_TX_FAILED;
+}
+
+bool CANInterface::transmitBlocking(const CanFrame& frame, uint32_t timeoutMs) {
+    CANTxStatus result = CAN_TX_PENDING;
+    uint32_t start = millis();
+
+    // Volle Queue: andere Aufträge abarbeiten lassen, bis Platz ist
+    while (!enqueueTx(frame, onBlockingTxDone, &result)) {
+        if (millis() - start >= timeoutMs) {
+            return false;
+        }
+        serviceTx();
+        vTaskDelay(1);
+    }
+
+    // serviceTx() meldet übergebene Frames spätestens nach CAN_TX_TIMEOUT_MS als
+    // fehlgeschlagen; bleibt der Frame länger in der Queue, nur ihn zurückziehen
+    while (true) {
+        serviceTx();
+        if (result != CAN_TX_PENDING) {
+            break;
+        }
+        if (millis() - start >= timeoutMs) {
+            withdrawTx(onBlockingTxDone, &result);
+            break;
+        }
+        vTaskDelay(1);
+    }
+    return result == CAN_TX_OK;
+}
+
+bool CANInterface::withdrawTx(CANTxCallback callback, void* context) {
+    for (uint8_t i = 0; i < txInFlightCount; i++) {
+        if (txInFlight[i].request.callback != callback || txInFlight[i].request.context != context) {
+            continue;
+        }
+        abortTransmit(txInFlight[i].handle);
+        TxRequest request = txInFlight[i].request;
+        for (uint8_t j = i + 1; j < txInFlightCount; j++) {
+            txInFlight[j - 1] = txInFlight[j];
+        }
+        txInFlightCount--;
+        completeTx(request, false);
+        return true;
+    }
+
+    TxRequest request;
+    bool found = txQueue.removeFirst([&](const TxRequest& queued) {
+        if (queued.callback != callback || queued.context != context) {
+            return false;
+        }
+        request = queued;
+        return true;
+    });
+    if (found) {
+        completeTx(request, false);
+    }
+    return found;
+}
+
+CANTxStatus CANInterface::startTransmit(const CanFrame& frame, uint32_t* handle) {
+    // Standard für Treiber ohne eigenen Sendepuffer-Zugriff: blockierend senden
+    CanFrame copy = frame;
+    *handle = 0;
+    return sendMessage(copy.id, copy.ext, copy.len, copy.data) ? CAN_TX_OK : CAN_TX_FAILED;
+}
+
+void CANInterface::completeTx(const TxRequest& request, bool success) {
+    if (success && txObserver != nullptr) {
+        txObserver(request.frame, true, txObserverContext);
+    }
+    if (request.callback != nullptr) {
+        request.callback(request.frame, success, request.context);
+    }
 }
\ No newline at end of file
@@ -2,18 +2,77 @@
 #pragma once
 
 #include <Arduino.h>
+#include "CanFrame.h"
+#include "CANTxQueue.h"
+#include "CANHardwareFilter.h"
 
 // Definiere die unterstützten CAN-Controller-Typen
 // CAN-Controller-Typen
 #define CAN_CONTROLLER_MCP2515     1
 #define CAN_CONTROLLER_ESP32CAN    2
 #define CAN_CONTROLLER_TJA1051     3
+#define CAN_CONTROLLER_SIM         4    // Simulierter Bus mit virtuellen Nodes (ohne Hardware)
+#define CAN_CONTROLLER_SOCKETCAN   5    // Linux-SocketCAN (nur Host-Build, Interface aus $CAN_INTERFACE)
 
 // Display-Controller-Typen
 #define DISPLAY_CONTROLLER_NONE            0
 #define DISPLAY_CONTROLLER_OLED_SSD1306    10
 #define DISPLAY_CONTROLLER_WAVESHARE_ESP32S3_TOUCH_LCD   11
 
+// Größe des Empfangs-Ringpuffers (Frames, Zweierpotenz)
+#define CAN_RX_RING_SIZE           256
+
+// Empfangstask der Treiber (füllt den Ringpuffer aus ISR/TWAI)
+#define CAN_RX_TASK_STACK          4096
+#define CAN_RX_TASK_PRIORITY       5
+#define CAN_RX_TASK_CORE           0
+
+// Maximale Anzahl Frames, die Monitor und Scanner pro Durchlauf abholen
+#define CAN_RX_BURST_SIZE          32
+
+// Software-Sendequeue (nicht blockierender Sendepfad)
+#define CAN_TX_QUEUE_SIZE          64   // Frames in der Software-Queue
+#define CAN_TX_INFLIGHT_MAX        4    // Gleichzeitig an den Controller übergebene Frames
+#define CAN_TX_INFLIGHT_LIMIT_MAX  16   // Obergrenze für Treiber mit tieferer Pipeline (I/O-Task)
+
+// CAN-I/O-Task: Treiber laufen hinter einem eigenen Task auf CAN_IO_TASK_CORE, die
+// Anwendung (loop auf dem anderen Kern) tauscht Frames nur über lock-freie Ringe aus
+#define CAN_IO_TASK_ENABLED        1
+#define CAN_IO_TASK_STACK          4096
+#define CAN_IO_TASK_PRIORITY       4    // Unter den Empfangstasks der Treiber
+#define CAN_IO_TASK_CORE           0
+#define CAN_TX_TIMEOUT_MS          100  // Danach gilt ein Frame als nicht gesendet (z.B. kein ACK)
+#define CAN_TX_BLOCKING_TIMEOUT_MS 1000 // sendMessage(): Platz in der Queue und Abschluss abwarten
+
+// Ergebnis der Übergabe eines Frames an den Controller
+enum CANTxStatus : uint8_t {
+    CAN_TX_BUSY = 0,    // Controller voll, später erneut versuchen
+    CAN_TX_PENDING,     // Übergeben, Abschluss wird über pollTransmit() gemeldet
+    CAN_TX_OK,          // Erfolgreich gesendet
+    CAN_TX_FAILED       // Senden fehlgeschlagen oder abgebrochen
+};
+
+// Abschluss-Callback für enqueueTx()/sendBurst()
+typedef void (*CANTxCallback)(const CanFrame& frame, bool success, void* context);
+
+// Fehlerzustand des Controllers (ISO 11898-1)
+enum CANBusState : uint8_t {
+    CAN_BUS_ERROR_ACTIVE = 0,
+    CAN_BUS_ERROR_WARNING,   // TEC oder REC >= 96
+    CAN_BUS_ERROR_PASSIVE,   // TEC oder REC >= 128
+    CAN_BUS_OFF,             // TEC > 255
+    CAN_BUS_STOPPED          // Controller nicht gestartet
+};
+
+// Fehlerzähler des Controllers; Zähler, die ein Controller nicht liefert, bleiben 0
+struct CANErrorCounters {
+    uint8_t txErrors;          // TEC
+    uint8_t rxErrors;          // REC
+    CANBusState state;
+    uint32_t busErrors;        // Erkannte Busfehler (TWAI)
+    uint32_t arbitrationLost;  // Verlorene Arbitrierungen (TWAI)
+    uint32_t rxMissed;         // Im Controller verlorene Frames (TWAI-Queue, MCP2515 RXnOVR)
+};
 
 class CANInterface {
 public:
@@ -28,12 +87,145 @@ public:
     // Nachricht empfangen
     virtual bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) = 0;
     
+    // Mehrere Nachrichten auf einmal empfangen (in ein Array des Aufrufers).
+    // Wartet höchstens timeoutUs auf den ersten Frame, liefert die Anzahl gelesener Frames.
+    virtual size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0);
+    
     // Prüfen, ob Nachrichten verfügbar sind
     virtual bool messageAvailable() = 0;
     
     // CAN-Interface herunterfahren
     virtual void end() = 0;
 
+    // Anzahl verlorener Frames, weil der Empfangspuffer voll war
+    virtual uint32_t getRxOverrunCount() const { return 0; }
+
+    // Fehlerzähler des Controllers lesen; false = vom Treiber nicht unterstützt
+    virtual bool getErrorCounters(CANErrorCounters& counters) { return false; }
+
+    // ===============================================================================
+    // Nicht blockierender Sendepfad
+    // Frames werden nach CAN-ID priorisiert (wie bei der Bus-Arbitrierung) und von
+    // serviceTx() an den Controller übergeben. Nur aus dem Anwendungskontext (loop)
+    // verwenden; Callbacks dürfen neue Frames einreihen, aber nicht serviceTx() aufrufen.
+    // ===============================================================================
+
+    // Einzelnen Frame einreihen. Liefert false, wenn die Queue voll ist.
+    bool enqueueTx(const CanFrame& frame, CANTxCallback callback = nullptr, void* context = nullptr);
+
+    // Mehrere Frames einreihen und sofort mit der Übergabe beginnen.
+    // Liefert die Anzahl eingereihter Frames.
+    size_t sendBurst(const CanFrame* frames, size_t count, CANTxCallback callback = nullptr, void* context = nullptr);
+
+    // Queue bedienen: freie Sendepuffer füllen und Abschlüsse melden
+    void serviceTx();
+
+    // Frames in Queue und beim Controller, die noch nicht abgeschlossen sind
+    size_t txPending() const { return txQueue.size() + txInFlightCount; }
+
+    // Anzahl abgewiesener Frames, weil die Sendequeue voll war
+    uint32_t getTxDropCount() const { return txDropped; }
+
+    // Beobachter für jeden erfolgreich über die Sendequeue gesendeten Frame (z.B.
+    // Busstatistik); wird vor dem Abschluss-Callback des Auftrags aufgerufen
+    void setTxObserver(CANTxCallback observer, void* context) {
+        txObserver = observer;
+        txObserverContext = context;
+    }
+
+    // ===============================================================================
+    // Hardware-Akzeptanzfilter
+    // Die gewünschte Frame-Menge wird auf die Masken/Filter des Controllers abgebildet,
+    // damit uninteressante Frames die CPU gar nicht erst erreichen. Was die Hardware
+    // nicht exakt trennen kann, muss weiterhin in Software gefiltert werden.
+    // Der Plan bleibt gespeichert und wird von begin() erneut gesetzt.
+    // ===============================================================================
+
+    // Liefert false, wenn der Controller keine Hardwarefilter hat
+    virtual bool setAcceptanceFilter(const CANAcceptanceSet& wanted);
+
+    // Aktuell gesetzter Filter (acceptAll = Controller nimmt alles an)
+    const CANHardwareFilterPlan& getAcceptanceFilter() const { return acceptancePlan; }
+
     // Factory-Methode zum Erstellen der richtigen Interface-Instanz
     static CANInterface* createInstance(uint8_t controllerType);
+
+protected:
+    // Frame an den Controller übergeben, ohne zu blockieren. handle identifiziert den
+    // Frame für pollTransmit()/abortTransmit(). Standard: blockierendes sendMessage().
+    virtual CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle);
+
+    // Status eines mit CAN_TX_PENDING übergebenen Frames abfragen
+    virtual CANTxStatus pollTransmit(uint32_t handle) { return CAN_TX_OK; }
+
+    // Übergebenen Frame nach Timeout zurückziehen (falls der Controller es kann)
+    virtual void abortTransmit(uint32_t handle) {}
+
+    // Alle offenen Sendungen als fehlgeschlagen melden und verwerfen (für end())
+    void cancelTx();
+
+    // Blockierendes sendMessage() für Treiber mit eigenem startTransmit(): der Frame
+    // läuft durch die Sendequeue (Priorität, Sendepuffer, txObserver), gewartet wird
+    // nur auf diesen Auftrag. Nach timeoutMs wird nur er zurückgezogen.
+    bool transmitBlocking(const CanFrame& frame, uint32_t timeoutMs = CAN_TX_BLOCKING_TIMEOUT_MS);
+
+    // Aufbau der Akzeptanzfilter: Anzahl Masken, groupSizes[i] = Filter je Maske.
+    // 0 = keine Hardwarefilter (Standard)
+    virtual uint8_t acceptanceFilterLayout(uint8_t* groupSizes) const { return 0; }
+
+    // Plan in den Controller schreiben. Vor begin() nur übernehmen, begin() setzt
+    // dann acceptancePlan.
+    virtual bool applyAcceptanceFilter(const CANHardwareFilterPlan& plan) { return false; }
+
+    CANHardwareFilterPlan acceptancePlan = CANHardwareFilterPlan::acceptEverything();
+
+    // Höchstens gleichzeitig an startTransmit() übergebene Frames (<= CAN_TX_INFLIGHT_LIMIT_MAX)
+    uint8_t txInFlightLimit = CAN_TX_INFLIGHT_MAX;
+
+    // Gemeinsame Burst-Entnahme für Treiber mit Empfangs-Ringpuffer
+    template <typename Ring>
+    static size_t popBurstWithTimeout(Ring& ring, CanFrame* frames, size_t max, uint32_t timeoutUs) {
+        if (ring.empty() && timeoutUs > 0) {
+            uint32_t start = micros();
+            while (ring.empty()) {
+                uint32_t elapsed = micros() - start;
+                if (elapsed >= timeoutUs) {
+                    return 0;
+                }
+                // Längere Wartezeiten an den Scheduler abgeben, kurze aktiv abwarten
+                if (timeoutUs - elapsed > 1000) {
+                    vTaskDelay(1);
+                } else {
+                    yield();
+                }
+            }
+        }
+        return ring.popBurst(frames, max);
+    }
+
+private:
+    struct TxRequest {
+        CanFrame frame;
+        CANTxCallback callback;
+        void* context;
+    };
+
+    struct TxInFlight {
+        TxRequest request;
+        uint32_t handle;
+        uint32_t startMs;
+    };
+
+    CANTxQueue<TxRequest, CAN_TX_QUEUE_SIZE> txQueue;
+    TxInFlight txInFlight[CAN_TX_INFLIGHT_LIMIT_MAX];  // In Übergabereihenfolge
+    uint8_t txInFlightCount = 0;
+    uint32_t txDropped = 0;
+    CANTxCallback txObserver = nullptr;
+    void* txObserverContext = nullptr;
+
+    void completeTx(const TxRequest& request, bool success);
+
+    // Auftrag mit diesem Callback/Kontext aus Queue oder Controller zurückziehen und
+    // als fehlgeschlagen melden
+    bool withdrawTx(CANTxCallback callback, void* context);
 };
\ No newline at end of file
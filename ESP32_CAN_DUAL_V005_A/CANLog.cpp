@@ -0,0 +1,305 @@
+// CANLog.cpp
+// ===============================================================================
+// Implementation der Log-Ausgabe (candump, ASC, SLCAN, Binär-Records)
+// ===============================================================================
+
+#include "CANLog.h"
+#include <string.h>
+
+namespace {
+
+const char HEX_DIGITS[] = "0123456789ABCDEF";
+
+const char ASC_HEADER[] =
+    "date Thu Jan  1 12:00:00.000 am 1970\n"
+    "base hex  timestamps absolute\n"
+    "no internal events logged\n"
+    "// version 7.0.0\n"
+    "Begin Triggerblock Thu Jan  1 12:00:00.000 am 1970\n"
+    "   0.000000 Start of measurement\n";
+
+const char ASC_TRAILER[] = "End TriggerBlock\n";
+
+char* putHex(char* out, uint32_t value, uint8_t digits) {
+    for (int8_t i = digits - 1; i >= 0; i--) {
+        out[i] = HEX_DIGITS[value & 0xF];
+        value >>= 4;
+    }
+    return out + digits;
+}
+
+char* putByte(char* out, uint8_t value) {
+    out[0] = HEX_DIGITS[value >> 4];
+    out[1] = HEX_DIGITS[value & 0xF];
+    return out + 2;
+}
+
+// Dezimalzahl, mit '0' oder ' ' auf mindestens width Stellen aufgefüllt
+char* putDecimal(char* out, uint32_t value, uint8_t width, char pad) {
+    char digits[10];
+    uint8_t count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    while (width > count) {
+        *out++ = pad;
+        width--;
+    }
+    while (count > 0) {
+        *out++ = digits[--count];
+    }
+    return out;
+}
+
+// Wert als Little Endian
+uint8_t* putLE32(uint8_t* out, uint32_t value) {
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = value >> 24;
+    return out + 4;
+}
+
+// Sekunden.Mikrosekunden
+char* putTime(char* out, uint64_t us, uint8_t secondsWidth, char pad) {
+    out = putDecimal(out, (uint32_t)(us / 1000000), secondsWidth, pad);
+    *out++ = '.';
+    return putDecimal(out, (uint32_t)(us % 1000000), 6, '0');
+}
+
+}  // namespace
+
+// ===================================================================================
+// Zeilenformate
+// ===================================================================================
+
+// (0000012.345678) can0 123#DEADBEEF   bzw. 12345678#... für Extended-IDs
+size_t formatCandumpLine(const CanFrame& frame, const char* interfaceName, char* out) {
+    char* p = out;
+    uint8_t len = frame.len > 8 ? 8 : frame.len;
+
+    *p++ = '(';
+    p = putTime(p, frame.timestamp, 10, '0');
+    *p++ = ')';
+    *p++ = ' ';
+    for (const char* name = interfaceName; *name != '\0' && p - out < 24; name++) {
+        *p++ = *name;
+    }
+    *p++ = ' ';
+    p = frame.ext ? putHex(p, frame.id & 0x1FFFFFFF, 8) : putHex(p, frame.id & 0x7FF, 3);
+    *p++ = '#';
+    for (uint8_t i = 0; i < len; i++) {
+        p = putByte(p, frame.data[i]);
+    }
+    *p++ = '\n';
+    return p - out;
+}
+
+//    12.345678 1  123             Rx   d 4 DE AD BE EF   (Extended-IDs mit Suffix 'x')
+size_t formatAscLine(const CanFrame& frame, uint64_t startUs, char* out) {
+    char* p = out;
+    uint8_t len = frame.len > 8 ? 8 : frame.len;
+    uint64_t elapsed = frame.timestamp > startUs ? frame.timestamp - startUs : 0;
+
+    p = putTime(p, elapsed, 4, ' ');
+    memcpy(p, " 1  ", 4);
+    p += 4;
+
+    char* idField = p;
+    if (frame.ext) {
+        p = putHex(p, frame.id & 0x1FFFFFFF, 8);
+        *p++ = 'x';
+    } else {
+        p = putHex(p, frame.id & 0x7FF, 3);
+    }
+    while (p - idField < 15) {
+        *p++ = ' ';
+    }
+
+    memcpy(p, " Rx   d ", 8);
+    p += 8;
+    *p++ = '0' + len;
+    for (uint8_t i = 0; i < len; i++) {
+        *p++ = ' ';
+        p = putByte(p, frame.data[i]);
+    }
+    *p++ = '\n';
+    return p - out;
+}
+
+// t1234DEADBEEF30D4\r   bzw. T12345678... für Extended-IDs; Zeitstempel in ms (0-59999)
+size_t formatSlcanLine(const CanFrame& frame, bool withTimestamp, char* out) {
+    char* p = out;
+    uint8_t len = frame.len > 8 ? 8 : frame.len;
+
+    if (frame.ext) {
+        *p++ = 'T';
+        p = putHex(p, frame.id & 0x1FFFFFFF, 8);
+    } else {
+        *p++ = 't';
+        p = putHex(p, frame.id & 0x7FF, 3);
+    }
+    *p++ = '0' + len;
+    for (uint8_t i = 0; i < len; i++) {
+        p = putByte(p, frame.data[i]);
+    }
+    if (withTimestamp) {
+        p = putHex(p, (uint32_t)((frame.timestamp / 1000) % 60000), 4);
+    }
+    *p++ = '\r';
+    return p - out;
+}
+
+// Record zusammensetzen, COBS-kodieren (kein 0x00 im Inhalt) und mit 0x00 abschließen
+size_t formatBinaryRecord(const CanFrame& frame, uint8_t flags, char* out) {
+    uint8_t record[CAN_LOG_RECORD_SIZE];
+    uint8_t len = frame.len > 8 ? 8 : frame.len;
+
+    record[0] = CAN_LOG_RECORD_FRAME;
+    record[1] = flags | (frame.ext ? CAN_LOG_FLAG_EXTENDED : 0);
+    record[2] = len;
+    putLE32(&record[3], frame.id);
+    putLE32(&record[7], (uint32_t)frame.timestamp);
+    memset(&record[11], 0, 8);
+    memcpy(&record[11], frame.data, len);
+    uint16_t crc = canLogCrc16(record, CAN_LOG_RECORD_SIZE - 2);
+    record[19] = crc & 0xFF;
+    record[20] = crc >> 8;
+
+    uint8_t* encoded = (uint8_t*)out;
+    uint8_t* code = encoded++;
+    uint8_t run = 1;
+    for (uint8_t i = 0; i < CAN_LOG_RECORD_SIZE; i++) {
+        if (record[i] == 0) {
+            *code = run;
+            code = encoded++;
+            run = 1;
+        } else {
+            *encoded++ = record[i];
+            run++;
+        }
+    }
+    *code = run;
+    *encoded++ = 0x00;
+    return encoded - (uint8_t*)out;
+}
+
+uint16_t canLogCrc16(const uint8_t* data, size_t length) {
+    // Halbbyte-Tabelle: 16 Einträge statt 8 Schiebeschritte pro Byte
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+        crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)];
+    }
+    return crc;
+}
+
+// ===================================================================================
+// CANLogWriter
+// ===================================================================================
+
+CANLogWriter::CANLogWriter()
+    : logFormat(CAN_LOG_OFF), sink(nullptr), sinkContext(nullptr), startTime(0), gapPending(false),
+      used(0), logged(0), dropped(0) {
+}
+
+void CANLogWriter::setSink(CANLogSink sink, void* context) {
+    this->sink = sink;
+    sinkContext = context;
+}
+
+void CANLogWriter::begin(CANLogFormat format, uint64_t startUs) {
+    startTime = startUs;
+    gapPending = false;
+    logged = 0;
+    dropped = 0;
+    logFormat = sink != nullptr ? format : CAN_LOG_OFF;
+
+    if (logFormat == CAN_LOG_ASC) {
+        append(ASC_HEADER, strlen(ASC_HEADER));
+    } else if (logFormat == CAN_LOG_BINARY) {
+        // Trennzeichen vorweg: vorangehender Klartext bildet ein eigenes, ungültiges Paket
+        append("", 1);
+    }
+}
+
+void CANLogWriter::end() {
+    if (logFormat == CAN_LOG_ASC) {
+        append(ASC_TRAILER, strlen(ASC_TRAILER));
+    }
+    logFormat = CAN_LOG_OFF;
+}
+
+bool CANLogWriter::log(const CanFrame& frame) {
+    if (logFormat == CAN_LOG_OFF) {
+        return false;
+    }
+
+    if (CAN_LOG_BUFFER_SIZE - used < CAN_LOG_MAX_LINE) {
+        flush();
+        if (CAN_LOG_BUFFER_SIZE - used < CAN_LOG_MAX_LINE) {
+            dropped++;
+            gapPending = true;
+            return false;
+        }
+    }
+
+    char* line = buffer + used;
+    switch (logFormat) {
+        case CAN_LOG_ASC:
+            used += formatAscLine(frame, startTime, line);
+            break;
+        case CAN_LOG_SLCAN:
+        case CAN_LOG_SLCAN_TS:
+            used += formatSlcanLine(frame, logFormat == CAN_LOG_SLCAN_TS, line);
+            break;
+        case CAN_LOG_BINARY:
+            used += formatBinaryRecord(frame, gapPending ? CAN_LOG_FLAG_GAP : 0, line);
+            gapPending = false;
+            break;
+        default:
+            used += formatCandumpLine(frame, "can0", line);
+            break;
+    }
+    logged++;
+
+    if (used >= CAN_LOG_FLUSH_THRESHOLD) {
+        flush();
+    }
+    return true;
+}
+
+bool CANLogWriter::append(const char* data, size_t len) {
+    if (len > CAN_LOG_BUFFER_SIZE - used) {
+        flush();
+        if (len > CAN_LOG_BUFFER_SIZE - used) {
+            return false;
+        }
+    }
+    memcpy(buffer + used, data, len);
+    used += len;
+    return true;
+}
+
+size_t CANLogWriter::flush() {
+    if (used == 0 || sink == nullptr) {
+        return used;
+    }
+
+    size_t written = sink(buffer, used, sinkContext);
+    if (written >= used) {
+        used = 0;
+    } else if (written > 0) {
+        // Rest nach vorne schieben; nur bei einem gerade vollen Ausgabekanal
+        memmove(buffer, buffer + written, used - written);
+        used -= written;
+    }
+    return used;
+}
@@ -0,0 +1,110 @@
+// CANLog.h
+// ===============================================================================
+// Maschinenlesbare Log-Ausgabe für den Live-Monitor
+// Formate:
+//   - candump -L (Linux can-utils):  (0000012.345678) can0 123#DEADBEEF
+//   - Vector ASC:                       12.345678 1  123             Rx   d 4 DE AD BE EF
+//   - SLCAN (Lawicel):               t1234DEADBEEF30D4\r   (Zeitstempel optional, ms 0-59999)
+//   - Binär: feste Records mit CRC, COBS-kodiert und durch 0x00 getrennt (siehe unten)
+// Die Textformate lassen sich direkt mit can-utils (canplayer, log2asc, slcand),
+// SavvyCAN oder CANalyzer weiterverarbeiten, das Binärformat mit tools/can_capture.py.
+// Die Zeilen werden ohne printf in einen vorallokierten Puffer geschrieben und in großen
+// Blöcken an eine Ausgabefunktion (Sink) übergeben. Nimmt der Sink gerade nichts an,
+// wächst der Puffer; ist er voll, wird der Frame verworfen und gezählt, statt den
+// Empfang aufzuhalten.
+//
+// Binär-Record (vor der COBS-Kodierung, Little Endian, 21 Byte):
+//   [0]      Typ (CAN_LOG_RECORD_FRAME)
+//   [1]      Flags (CAN_LOG_FLAG_*)
+//   [2]      DLC
+//   [3..6]   CAN-ID
+//   [7..10]  Zeitstempel in µs, untere 32 Bit (Überlauf nach ca. 71 min)
+//   [11..18] Daten, mit Nullen auf 8 Byte aufgefüllt
+//   [19..20] CRC-16/CCITT-FALSE über Byte 0-18
+// Auf der Leitung: COBS(Record) + 0x00, also höchstens 23 Byte pro Frame statt 30-51
+// Zeichen im Textformat. Ein Empfänger synchronisiert sich am nächsten 0x00.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define CAN_LOG_BUFFER_SIZE     4096  // Zwischenpuffer für formatierte Zeilen
+#define CAN_LOG_MAX_LINE        80    // Längste Zeile (ASC, Extended-ID, 8 Byte)
+#define CAN_LOG_FLUSH_THRESHOLD 1024  // Ab dieser Füllung schon während eines Bursts ausgeben
+
+#define CAN_LOG_RECORD_SIZE     21    // Binär-Record vor der COBS-Kodierung
+#define CAN_LOG_RECORD_FRAME    0x01
+#define CAN_LOG_FLAG_EXTENDED   0x01  // 29-Bit-ID
+#define CAN_LOG_FLAG_GAP        0x04  // Vor diesem Frame gingen Frames verloren
+
+enum CANLogFormat : uint8_t {
+    CAN_LOG_OFF = 0,
+    CAN_LOG_CANDUMP,  // candump -L
+    CAN_LOG_ASC,      // Vector ASC, Zeit relativ zum Log-Start
+    CAN_LOG_SLCAN,    // Lawicel-Empfangszeilen
+    CAN_LOG_SLCAN_TS, // Lawicel-Empfangszeilen mit Zeitstempel (Z1)
+    CAN_LOG_BINARY    // COBS-Records mit CRC
+};
+
+// Ausgabefunktion: übernimmt höchstens len Bytes und liefert die Anzahl übernommener
+// Bytes (0 = gerade kein Platz). Darf nicht blockieren.
+typedef size_t (*CANLogSink)(const char* data, size_t len, void* context);
+
+// Einzelne Zeilen/Records formatieren; out muss CAN_LOG_MAX_LINE Bytes fassen
+size_t formatCandumpLine(const CanFrame& frame, const char* interfaceName, char* out);
+size_t formatAscLine(const CanFrame& frame, uint64_t startUs, char* out);
+size_t formatSlcanLine(const CanFrame& frame, bool withTimestamp, char* out);
+size_t formatBinaryRecord(const CanFrame& frame, uint8_t flags, char* out);  // inkl. COBS und 0x00
+
+// CRC-16/CCITT-FALSE (Polynom 0x1021, Startwert 0xFFFF) der Binär-Records
+uint16_t canLogCrc16(const uint8_t* data, size_t length);
+
+class CANLogWriter {
+public:
+    CANLogWriter();
+
+    void setSink(CANLogSink sink, void* context);
+
+    // Log starten; bei ASC wird der Dateikopf geschrieben, ASC-Zeiten zählen ab startUs
+    void begin(CANLogFormat format, uint64_t startUs);
+    // Log beenden (ASC: Abschlusszeile anhängen); Restdaten mit flush() ausgeben
+    void end();
+
+    bool active() const { return logFormat != CAN_LOG_OFF; }
+    CANLogFormat format() const { return logFormat; }
+
+    // Frame formatieren und puffern; false = Puffer voll, Frame verworfen
+    bool log(const CanFrame& frame);
+
+    // Frames gingen außerhalb des Logs verloren (z.B. Empfangsüberlauf); der nächste
+    // Binär-Record trägt CAN_LOG_FLAG_GAP
+    void markGap() { gapPending = true; }
+
+    // Beliebige Daten in die Ausgabe einreihen (z.B. SLCAN-Antworten), damit sie nicht
+    // mitten in eine gepufferte Zeile geraten
+    bool append(const char* data, size_t len);
+
+    // Gepufferte Daten so weit wie möglich an den Sink übergeben. Liefert die Anzahl
+    // der danach noch wartenden Bytes.
+    size_t flush();
+    size_t pending() const { return used; }
+
+    uint32_t loggedCount() const { return logged; }
+    uint32_t droppedCount() const { return dropped; }
+
+private:
+    CANLogFormat logFormat;
+    CANLogSink sink;
+    void* sinkContext;
+    uint64_t startTime;
+    bool gapPending;
+
+    char buffer[CAN_LOG_BUFFER_SIZE];
+    size_t used;
+
+    uint32_t logged;
+    uint32_t dropped;
+};
@@ -0,0 +1,95 @@
+// CANRingBuffer.h
+// ===============================================================================
+// Lock-freier Single-Producer/Single-Consumer-Ringpuffer (Header-only)
+// Producer ist der CAN-Empfangstask (CAN_INT-ISR bzw. TWAI), Consumer die Anwendung.
+// Feste Größe (Zweierpotenz), vollständig vorallokiert, keine Sperren.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+template <typename T, size_t Capacity>
+class CANRingBuffer {
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                  "CANRingBuffer: Kapazität muss eine Zweierpotenz sein");
+
+public:
+    CANRingBuffer() : head(0), tail(0), overruns(0) {}
+
+    // Nur vom Producer aufrufen. Liefert false und zählt einen Überlauf, wenn voll.
+    bool push(const T& item) {
+        const uint32_t h = head.load(std::memory_order_relaxed);
+        const uint32_t t = tail.load(std::memory_order_acquire);
+        if (h - t >= Capacity) {
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        items[h & MASK] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Nur vom Consumer aufrufen.
+    bool pop(T& item) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t h = head.load(std::memory_order_acquire);
+        if (h == t) {
+            return false;
+        }
+        item = items[t & MASK];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Nur vom Consumer aufrufen: entnimmt bis zu maxItems Elemente auf einmal
+    size_t popBurst(T* out, size_t maxItems) {
+        const uint32_t t = tail.load(std::memory_order_relaxed);
+        const uint32_t h = head.load(std::memory_order_acquire);
+        size_t count = h - t;
+        if (count > maxItems) {
+            count = maxItems;
+        }
+        for (size_t i = 0; i < count; i++) {
+            out[i] = items[(t + i) & MASK];
+        }
+        tail.store(t + count, std::memory_order_release);
+        return count;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t size() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+    // Nur vom Consumer aufrufen: verwirft alle gepufferten Elemente
+    void clear() {
+        tail.store(head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Anzahl verworfener Elemente, weil der Puffer voll war
+    uint32_t overrunCount() const {
+        return overruns.load(std::memory_order_relaxed);
+    }
+
+    uint32_t resetOverrunCount() {
+        return overruns.exchange(0, std::memory_order_relaxed);
+    }
+
+private:
+    static constexpr uint32_t MASK = Capacity - 1;
+
+    T items[Capacity];
+    std::atomic<uint32_t> head;      // Schreibindex (frei laufend, nur Producer)
+    std::atomic<uint32_t> tail;      // Leseindex (frei laufend, nur Consumer)
+    std::atomic<uint32_t> overruns;  // Überlaufzähler
+};
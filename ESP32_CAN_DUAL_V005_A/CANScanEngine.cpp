@@ -0,0 +1,265 @@
+// CANScanEngine.cpp
+// ===============================================================================
+// Implementation des pipelined Node-Scanners
+// ===============================================================================
+
+#include "CANScanEngine.h"
+#include <string.h>
+
+// Objekte, die bei den Versuchen der Reihe nach abgefragt werden
+// (Gerätetyp, Fehlerregister, Identität)
+static const uint16_t scanObjects[] = {0x1000, 0x1001, 0x1018};
+
+CANScanEngine::CANScanEngine()
+    : sendFn(nullptr), sendContext(nullptr), foundFn(nullptr), foundContext(nullptr),
+      running(false), listening(false), listenEndMs(0), cursor(0), outstanding(0),
+      waiting(0), found(0), foundPassive(0), sent(0),
+      startMs(0), finishMs(0) {
+    memset(nodes, 0, sizeof(nodes));
+    cfg = defaultConfig(1, SCAN_MAX_NODE_ID);
+}
+
+CANScanEngine::Config CANScanEngine::defaultConfig(uint8_t firstId, uint8_t lastId) {
+    Config config;
+    config.firstId = firstId;
+    config.lastId = lastId;
+    config.window = SCAN_DEFAULT_WINDOW;
+    config.timeoutMs = SCAN_DEFAULT_TIMEOUT_MS;
+    config.retries = SCAN_DEFAULT_RETRIES;
+    config.listenMs = 0;
+    config.probe = true;
+    return config;
+}
+
+CANScanEngine::Config CANScanEngine::listenConfig(uint8_t firstId, uint8_t lastId, uint16_t listenMs, bool probe) {
+    Config config = defaultConfig(firstId, lastId);
+    config.listenMs = listenMs;
+    config.probe = probe;
+    return config;
+}
+
+void CANScanEngine::setSender(SendFn fn, void* context) {
+    sendFn = fn;
+    sendContext = context;
+}
+
+void CANScanEngine::setFoundCallback(FoundFn fn, void* context) {
+    foundFn = fn;
+    foundContext = context;
+}
+
+void CANScanEngine::begin(const Config& config, uint32_t nowMs) {
+    cfg = config;
+    if (cfg.firstId < 1) cfg.firstId = 1;
+    if (cfg.lastId > SCAN_MAX_NODE_ID) cfg.lastId = SCAN_MAX_NODE_ID;
+    if (cfg.window < 1) cfg.window = 1;
+
+    memset(nodes, 0, sizeof(nodes));
+    waiting = 0;
+    for (uint16_t id = cfg.firstId; id <= cfg.lastId; id++) {
+        nodes[id].state = NODE_WAITING;
+        waiting++;
+    }
+
+    cursor = cfg.firstId;
+    outstanding = 0;
+    found = 0;
+    foundPassive = 0;
+    sent = 0;
+    startMs = nowMs;
+    finishMs = nowMs;
+    running = waiting > 0;
+
+    // Ein reiner Hör-Scan ohne Dauer endet beim ersten poll()
+    listening = cfg.listenMs > 0 || !cfg.probe;
+    listenEndMs = nowMs + cfg.listenMs;
+}
+
+void CANScanEngine::poll(uint32_t nowMs) {
+    if (!running) {
+        return;
+    }
+
+    // Passive Hörphase: nichts senden, nur processFrame() trägt Nodes ein
+    if (listening) {
+        if ((int32_t)(nowMs - listenEndMs) < 0) {
+            return;
+        }
+        endListenPhase();
+        if (!cfg.probe) {
+            checkFinished(nowMs);
+            return;
+        }
+    }
+
+    // 1. Abgelaufene Anfragen: erneut einplanen oder als stumm markieren
+    if (outstanding > 0) {
+        for (uint16_t id = cfg.firstId; id <= cfg.lastId; id++) {
+            NodeEntry& node = nodes[id];
+            if (node.state != NODE_PENDING || (int32_t)(nowMs - node.deadlineMs) < 0) {
+                continue;
+            }
+            outstanding--;
+            if (node.attempts <= cfg.retries) {
+                node.state = NODE_WAITING;
+                waiting++;
+            } else {
+                node.state = NODE_SILENT;
+            }
+        }
+    }
+
+    // 2. Fenster auffüllen; der Cursor läuft rotierend über den Bereich, so dass
+    //    Wiederholungen erst nach dem ersten Durchlauf an die Reihe kommen
+    uint16_t span = cfg.lastId - cfg.firstId + 1;
+    for (uint16_t checked = 0; checked < span && waiting > 0 && outstanding < cfg.window; checked++) {
+        uint8_t id = cursor;
+        cursor = (cursor >= cfg.lastId) ? cfg.firstId : cursor + 1;
+
+        if (nodes[id].state != NODE_WAITING) {
+            continue;
+        }
+        if (!sendRequest(id, nowMs)) {
+            // Sendequeue voll: Cursor zurück, beim nächsten poll() erneut versuchen
+            cursor = id;
+            break;
+        }
+    }
+
+    checkFinished(nowMs);
+}
+
+bool CANScanEngine::processFrame(const CanFrame& frame, uint32_t nowMs) {
+    if (!running || frame.ext) {
+        return false;
+    }
+
+    uint8_t nodeId = frame.id & 0x7F;
+    uint16_t baseId = frame.id & 0x780;
+    if (nodeId < cfg.firstId || nodeId > cfg.lastId) {
+        return false;
+    }
+
+    // Antworten, die einen Node identifizieren
+    ScanFoundVia via;
+    if (baseId == COB_ID_TSDO_BASE) {
+        via = (frame.len > 0 && (frame.data[0] & 0xE0) == 0x80) ? SCAN_FOUND_SDO_ABORT : SCAN_FOUND_SDO;
+    } else if (baseId == COB_ID_HB_BASE) {
+        via = SCAN_FOUND_HEARTBEAT;
+    } else if (baseId == COB_ID_EMCY_BASE) {
+        via = SCAN_FOUND_EMCY;
+    } else if (baseId >= COB_ID_TPDO1 && baseId <= COB_ID_TPDO4 && baseId % 0x100 == 0x80) {
+        via = SCAN_FOUND_TPDO;
+    } else {
+        return false;
+    }
+
+    NodeEntry& node = nodes[nodeId];
+    if (node.state == NODE_FOUND) {
+        return false;
+    }
+    if (node.state == NODE_PENDING) {
+        outstanding--;
+    } else if (node.state == NODE_WAITING) {
+        waiting--;
+    }
+
+    node.state = NODE_FOUND;
+    if (listening) {
+        foundPassive++;
+    }
+    markFound(nodeId, via);
+    checkFinished(nowMs);
+    return true;
+}
+
+void CANScanEngine::requestSent(uint8_t nodeId, bool success, uint32_t nowMs) {
+    if (!running || nodeId < cfg.firstId || nodeId > cfg.lastId) {
+        return;
+    }
+
+    NodeEntry& node = nodes[nodeId];
+    if (node.state != NODE_PENDING) {
+        return;
+    }
+
+    // Bei Sendefehler sofort als abgelaufen behandeln
+    node.deadlineMs = success ? nowMs + cfg.timeoutMs : nowMs;
+}
+
+void CANScanEngine::cancel() {
+    running = false;
+}
+
+CANScanEngine::NodeState CANScanEngine::nodeState(uint8_t nodeId) const {
+    if (nodeId > SCAN_MAX_NODE_ID) {
+        return NODE_UNUSED;
+    }
+    return (NodeState)nodes[nodeId].state;
+}
+
+bool CANScanEngine::sendRequest(uint8_t nodeId, uint32_t nowMs) {
+    if (sendFn == nullptr) {
+        return false;
+    }
+
+    NodeEntry& node = nodes[nodeId];
+    uint16_t index = scanObjects[node.attempts % (sizeof(scanObjects) / sizeof(scanObjects[0]))];
+
+    // SDO-Upload-Anfrage (Initiate Upload)
+    CanFrame frame;
+    frame.id = COB_ID_RSDO_BASE + nodeId;
+    frame.ext = 0;
+    frame.len = 8;
+    memset(frame.data, 0, sizeof(frame.data));
+    frame.data[0] = 0x40;
+    frame.data[1] = index & 0xFF;
+    frame.data[2] = index >> 8;
+    frame.data[3] = 0x00;
+
+    if (!sendFn(frame, sendContext)) {
+        return false;
+    }
+    sent++;
+
+    // Die Antwort kann bereits im Sende-Callback verarbeitet worden sein (z.B. Simulation)
+    if (node.state != NODE_WAITING) {
+        return true;
+    }
+
+    node.state = NODE_PENDING;
+    node.attempts++;
+    node.deadlineMs = nowMs + cfg.timeoutMs;
+    waiting--;
+    outstanding++;
+    return true;
+}
+
+void CANScanEngine::markFound(uint8_t nodeId, ScanFoundVia via) {
+    found++;
+    if (foundFn != nullptr) {
+        foundFn(nodeId, via, foundContext);
+    }
+}
+
+void CANScanEngine::endListenPhase() {
+    listening = false;
+    if (cfg.probe) {
+        return;
+    }
+
+    // Reiner Hör-Scan: nie gesehene IDs gelten als stumm
+    for (uint16_t id = cfg.firstId; id <= cfg.lastId; id++) {
+        if (nodes[id].state == NODE_WAITING) {
+            nodes[id].state = NODE_SILENT;
+        }
+    }
+    waiting = 0;
+}
+
+void CANScanEngine::checkFinished(uint32_t nowMs) {
+    if (running && waiting == 0 && outstanding == 0) {
+        running = false;
+        finishMs = nowMs;
+    }
+}
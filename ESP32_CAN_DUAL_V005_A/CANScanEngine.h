@@ -0,0 +1,132 @@
+// CANScanEngine.h
+// ===============================================================================
+// Pipelined Node-Scanner
+// Sendet SDO-Upload-Anfragen an viele Node-IDs direkt hintereinander (begrenzt durch
+// ein Fenster offener Anfragen), ordnet die Antworten 0x580+ID in beliebiger
+// Reihenfolge über eine Zustandstabelle pro Node zu und wiederholt nur die Anfragen
+// an Nodes, die nicht geantwortet haben.
+//
+// Optional geht eine passive Hörphase voraus: Heartbeat/Boot-up, EMCY, TPDOs und
+// fremde SDO-Antworten gelten als Lebenszeichen. Danach werden nur noch die nie
+// gesehenen IDs aktiv abgefragt – oder gar keine (reiner Hör-Scan ohne Buslast).
+//
+// Die Engine sendet nicht selbst, sondern über einen Sende-Callback, und bekommt die
+// aktuelle Zeit übergeben.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+#include "CANopen.h"
+
+#define SCAN_MAX_NODE_ID          127
+#define SCAN_DEFAULT_WINDOW       32   // Gleichzeitig offene SDO-Anfragen
+#define SCAN_DEFAULT_TIMEOUT_MS   200  // Antwortzeit pro Anfrage (ab Sendezeitpunkt), reicht für langsame Antriebe
+#define SCAN_MIN_TIMEOUT_MS       5    // Grenzen für "scan timeout"
+#define SCAN_MAX_TIMEOUT_MS       5000
+#define SCAN_DEFAULT_RETRIES      2    // Wiederholungen für Nodes ohne Antwort
+#define SCAN_DEFAULT_LISTEN_MS    1500 // Hörphase: deckt übliche Heartbeat-Zeiten (1 s) ab
+
+// Woran ein Node erkannt wurde
+enum ScanFoundVia : uint8_t {
+    SCAN_FOUND_SDO = 0,     // SDO-Antwort
+    SCAN_FOUND_SDO_ABORT,   // SDO-Abort (Node existiert, Objekt nicht lesbar)
+    SCAN_FOUND_HEARTBEAT,   // Heartbeat/Boot-up
+    SCAN_FOUND_EMCY,        // Emergency
+    SCAN_FOUND_TPDO         // TPDO1-4
+};
+
+class CANScanEngine {
+public:
+    enum NodeState : uint8_t {
+        NODE_UNUSED = 0,  // Außerhalb des Scan-Bereichs
+        NODE_WAITING,     // Anfrage (erneut) zu senden
+        NODE_PENDING,     // Anfrage unterwegs, Antwort erwartet
+        NODE_FOUND,       // Node hat sich gemeldet
+        NODE_SILENT       // Keine Antwort nach allen Versuchen
+    };
+
+    struct Config {
+        uint8_t firstId;
+        uint8_t lastId;
+        uint8_t window;
+        uint16_t timeoutMs;
+        uint8_t retries;
+        uint16_t listenMs;  // Passive Hörphase vor der Abfrage (0 = sofort aktiv)
+        bool probe;         // Nach der Hörphase nie gesehene IDs aktiv abfragen
+    };
+
+    // Sendet einen Frame (z.B. über CANInterface::enqueueTx). false = später erneut versuchen.
+    typedef bool (*SendFn)(const CanFrame& frame, void* context);
+    // Meldet einen neu gefundenen Node
+    typedef void (*FoundFn)(uint8_t nodeId, ScanFoundVia via, void* context);
+
+    CANScanEngine();
+
+    static Config defaultConfig(uint8_t firstId, uint8_t lastId);
+
+    // Nur zuhören (listenMs > 0, probe = false) bzw. zuhören und Rest abfragen
+    static Config listenConfig(uint8_t firstId, uint8_t lastId, uint16_t listenMs, bool probe);
+
+    void setSender(SendFn fn, void* context);
+    void setFoundCallback(FoundFn fn, void* context);
+
+    // Scan vorbereiten; die ersten Anfragen gehen mit dem nächsten poll() raus
+    void begin(const Config& config, uint32_t nowMs);
+
+    // Zeitüberschreitungen auswerten und das Sendefenster auffüllen
+    void poll(uint32_t nowMs);
+
+    // Empfangenen Frame auswerten. Liefert true, wenn dadurch ein Node neu gefunden wurde.
+    bool processFrame(const CanFrame& frame, uint32_t nowMs);
+
+    // Rückmeldung der Sendequeue: Timeout ab dem tatsächlichen Sendezeitpunkt zählen
+    void requestSent(uint8_t nodeId, bool success, uint32_t nowMs);
+
+    // Scan abbrechen; offene Anfragen werden nicht mehr ausgewertet
+    void cancel();
+
+    bool isRunning() const { return running; }
+    bool isDone() const { return !running; }
+    bool isListening() const { return running && listening; }
+
+    NodeState nodeState(uint8_t nodeId) const;
+    uint8_t foundCount() const { return found; }
+    uint8_t passiveFoundCount() const { return foundPassive; }
+    uint8_t outstandingCount() const { return outstanding; }
+    uint16_t requestsSent() const { return sent; }
+    uint32_t elapsedMs() const { return finishMs - startMs; }
+
+private:
+    struct NodeEntry {
+        uint8_t state;
+        uint8_t attempts;
+        uint32_t deadlineMs;
+    };
+
+    NodeEntry nodes[SCAN_MAX_NODE_ID + 1];
+    Config cfg;
+    SendFn sendFn;
+    void* sendContext;
+    FoundFn foundFn;
+    void* foundContext;
+
+    bool running;
+    bool listening;       // Passive Hörphase aktiv
+    uint32_t listenEndMs;
+    uint8_t cursor;       // Nächste Node-ID für die Fenstervergabe (rotierend)
+    uint8_t outstanding;  // Anfragen im Zustand NODE_PENDING
+    uint8_t waiting;      // Nodes im Zustand NODE_WAITING
+    uint8_t found;
+    uint8_t foundPassive; // Davon in der Hörphase erkannt
+    uint16_t sent;
+    uint32_t startMs;
+    uint32_t finishMs;
+
+    bool sendRequest(uint8_t nodeId, uint32_t nowMs);
+    void markFound(uint8_t nodeId, ScanFoundVia via);
+    void endListenPhase();
+    void checkFinished(uint32_t nowMs);
+};
@@ -0,0 +1,343 @@
+// CANSimBus.cpp
+// ===============================================================================
+// Implementation des virtuellen CAN-Busses
+// ===============================================================================
+
+#include "CANSimBus.h"
+#include "CANStatistics.h"
+#include <string.h>
+
+#define CAN_SIM_BUS_OFF_BITS  (128 * 11)  // Rückkehr aus Bus-Off
+
+// Reihenfolge der Arbitrierung: 11-Bit-Basis-ID, dann IDE (Standard gewinnt), dann die
+// unteren 18 Bit der Extended-ID
+static uint32_t arbitrationKey(const CanFrame& frame) {
+    if (frame.ext) {
+        return (((frame.id >> 18) & 0x7FF) << 19) | (1UL << 18) | (frame.id & 0x3FFFF);
+    }
+    return (frame.id & 0x7FF) << 19;
+}
+
+CANSimBus::CANSimBus(uint32_t bitrate)
+    : busBitrate(bitrate), portCount(0), pendingCount(0), nextHandle(1),
+      clockUs(0), busFreeUs(0), errorPermille(0), forcedErrors(0), rngState(0x2545F491),
+      delivered(0), errors(0), busy(0), traceFn(nullptr), traceContext(nullptr) {
+    memset(ports, 0, sizeof(ports));
+    memset(pending, 0, sizeof(pending));
+}
+
+// ===================================================================================
+// Teilnehmer
+// ===================================================================================
+int CANSimBus::attach(CANSimParticipant* participant, uint32_t bitrate) {
+    for (int port = 0; port < CAN_SIM_MAX_PARTICIPANTS; port++) {
+        if (ports[port].participant == nullptr) {
+            memset(&ports[port], 0, sizeof(CANSimPortState));
+            ports[port].participant = participant;
+            ports[port].bitrate = bitrate;
+            if (port >= portCount) {
+                portCount = port + 1;
+            }
+            return port;
+        }
+    }
+    return -1;
+}
+
+void CANSimBus::detach(int port) {
+    if (port < 0 || port >= portCount) {
+        return;
+    }
+    // Offene Sendungen still verwerfen: der Teilnehmer gibt es nicht mehr
+    for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+        if (pending[i].used && pending[i].port == port) {
+            pending[i].used = false;
+            pendingCount--;
+        }
+    }
+    ports[port].participant = nullptr;
+    while (portCount > 0 && ports[portCount - 1].participant == nullptr) {
+        portCount--;
+    }
+}
+
+void CANSimBus::setPortBitrate(int port, uint32_t bitrate) {
+    if (port >= 0 && port < portCount) {
+        ports[port].bitrate = bitrate;
+    }
+}
+
+bool CANSimBus::online(int port, uint64_t nowUs) {
+    CANSimPortState& state = ports[port];
+    if (state.participant == nullptr) {
+        return false;
+    }
+    if (state.busOffUntilUs != 0) {
+        if (state.busOffUntilUs > nowUs) {
+            return false;
+        }
+        // 128 x 11 rezessive Bits abgewartet: wieder Error-Active
+        state.busOffUntilUs = 0;
+        state.txErrors = 0;
+        state.rxErrors = 0;
+    }
+    return true;
+}
+
+bool CANSimBus::listening(int port, uint64_t nowUs) {
+    return online(port, nowUs) && ports[port].bitrate == busBitrate;
+}
+
+// ===================================================================================
+// Senden
+// ===================================================================================
+uint32_t CANSimBus::transmit(int port, const CanFrame& frame, uint64_t readyUs) {
+    if (port < 0 || port >= portCount || pendingCount >= CAN_SIM_PENDING_FRAMES) {
+        return 0;
+    }
+    if (!online(port, readyUs > clockUs ? readyUs : clockUs)) {
+        return 0;  // Bus-Off: Controller nimmt keine Frames an
+    }
+    for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+        if (!pending[i].used) {
+            Pending& entry = pending[i];
+            entry.frame = frame;
+            entry.readyUs = readyUs;
+            entry.port = port;
+            entry.handle = nextHandle++;
+            if (nextHandle == 0) {
+                nextHandle = 1;
+            }
+            entry.used = true;
+            pendingCount++;
+            return entry.handle;
+        }
+    }
+    return 0;
+}
+
+bool CANSimBus::abort(uint32_t handle) {
+    for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+        if (pending[i].used && pending[i].handle == handle) {
+            pending[i].used = false;
+            pendingCount--;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CANSimBus::finish(Pending& entry, bool success) {
+    CANSimParticipant* owner = ports[entry.port].participant;
+    uint32_t handle = entry.handle;
+    entry.used = false;
+    pendingCount--;
+    if (owner != nullptr) {
+        owner->onTransmitted(handle, success);
+    }
+}
+
+// ===================================================================================
+// Fehler
+// ===================================================================================
+uint64_t CANSimBus::bitsToUs(uint32_t bits) const {
+    return ((uint64_t)bits * 1000000ULL + busBitrate - 1) / busBitrate;
+}
+
+bool CANSimBus::corrupt() {
+    if (forcedErrors > 0) {
+        forcedErrors--;
+        return true;
+    }
+    if (errorPermille == 0) {
+        return false;
+    }
+    // xorshift32: reproduzierbar über setSeed()
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState % 1000 < errorPermille;
+}
+
+void CANSimBus::transmitError(Pending& entry, uint64_t nowUs, bool ackError) {
+    int senderPort = entry.port;
+    CANSimPortState& sender = ports[senderPort];
+
+    // ACK-Fehler zählen im Error-Passive-Zustand nicht weiter (ISO 11898-1, Ausnahme 1)
+    if (!(ackError && sender.txErrors >= 128)) {
+        sender.txErrors += 8;
+    }
+    sender.busErrors++;
+    errors++;
+
+    if (traceFn != nullptr) {
+        CanFrame frame = entry.frame;
+        frame.timestamp = nowUs;
+        traceFn(frame, sender.participant, false, traceContext);
+    }
+
+    if (!ackError) {
+        for (int port = 0; port < portCount; port++) {
+            if (port != senderPort && online(port, nowUs)) {
+                if (ports[port].rxErrors < 255) {
+                    ports[port].rxErrors++;
+                }
+                ports[port].busErrors++;
+            }
+        }
+    }
+
+    if (sender.txErrors > 255) {
+        // Bus-Off: alle offenen Sendungen dieses Teilnehmers scheitern
+        sender.busOffUntilUs = nowUs + bitsToUs(CAN_SIM_BUS_OFF_BITS);
+        for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+            if (pending[i].used && pending[i].port == senderPort) {
+                finish(pending[i], false);
+            }
+        }
+    }
+}
+
+// ===================================================================================
+// Ablauf
+// ===================================================================================
+void CANSimBus::run(uint64_t untilUs) {
+    while (true) {
+        // Nächster Zeitgeber eines Teilnehmers
+        uint64_t timerUs = CAN_SIM_NEVER;
+        int timerPort = -1;
+        for (int port = 0; port < portCount; port++) {
+            if (ports[port].participant != nullptr) {
+                uint64_t due = ports[port].participant->nextTimerUs();
+                if (due < timerUs) {
+                    timerUs = due;
+                    timerPort = port;
+                }
+            }
+        }
+
+        // Nächster Buszugriff: frühester bereiter Frame, sobald der Bus frei ist
+        uint64_t readyUs = CAN_SIM_NEVER;
+        for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+            if (pending[i].used && pending[i].readyUs < readyUs) {
+                readyUs = pending[i].readyUs;
+            }
+        }
+        uint64_t startUs = readyUs == CAN_SIM_NEVER ? CAN_SIM_NEVER : (readyUs > busFreeUs ? readyUs : busFreeUs);
+
+        if (timerPort >= 0 && timerUs <= startUs) {
+            if (timerUs > untilUs) {
+                break;
+            }
+            if (timerUs > clockUs) {
+                clockUs = timerUs;
+            }
+            ports[timerPort].participant->onTimer(timerUs);
+            continue;
+        }
+        if (startUs == CAN_SIM_NEVER || startUs > untilUs) {
+            break;
+        }
+
+        // Arbitrierung unter allen zum Startzeitpunkt bereiten Frames
+        Pending* winner = nullptr;
+        uint32_t winnerKey = 0;
+        for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+            if (!pending[i].used || pending[i].readyUs > startUs) {
+                continue;
+            }
+            uint32_t key = arbitrationKey(pending[i].frame);
+            // Gleiche ID (z.B. Block-Segmente): in Sendereihenfolge wie die FIFO eines Controllers
+            bool earlier = winner != nullptr && key == winnerKey && (int32_t)(pending[i].handle - winner->handle) < 0;
+            if (winner == nullptr || key < winnerKey || earlier) {
+                if (winner != nullptr && winner->port != pending[i].port) {
+                    ports[winner->port].arbitrationLost++;
+                }
+                winner = &pending[i];
+                winnerKey = key;
+            } else if (pending[i].port != winner->port) {
+                ports[pending[i].port].arbitrationLost++;
+            }
+        }
+        if (winner == nullptr) {
+            break;
+        }
+
+        uint16_t bits = CANStatistics::frameBits(winner->frame);
+        uint64_t endUs = startUs + bitsToUs(bits);
+        if (endUs > untilUs) {
+            break;  // Frame noch auf dem Bus
+        }
+
+        // Fehlerfälle: falsche Bitrate des Senders, Störung, kein Empfänger für das ACK
+        bool ackAvailable = false;
+        for (int port = 0; port < portCount && !ackAvailable; port++) {
+            ackAvailable = port != winner->port && listening(port, startUs);
+        }
+        bool disturbed = ports[winner->port].bitrate != busBitrate || corrupt();
+        if (disturbed || !ackAvailable) {
+            // Störung etwa in Frame-Mitte erkannt, fehlendes ACK erst am Ende;
+            // danach Error-Flag, Delimiter und Intermission
+            uint64_t errorEndUs = startUs + bitsToUs((disturbed ? bits / 2 : bits) + 20);
+            busy += errorEndUs - startUs;
+            busFreeUs = errorEndUs;
+            clockUs = errorEndUs > clockUs ? errorEndUs : clockUs;
+            transmitError(*winner, errorEndUs, !disturbed);
+            continue;
+        }
+
+        busy += endUs - startUs;
+        busFreeUs = endUs;
+        clockUs = endUs > clockUs ? endUs : clockUs;
+
+        int senderPort = winner->port;
+        CanFrame frame = winner->frame;
+        frame.timestamp = endUs;
+        if (ports[senderPort].txErrors > 0) {
+            ports[senderPort].txErrors--;
+        }
+        if (traceFn != nullptr) {
+            traceFn(frame, ports[senderPort].participant, true, traceContext);
+        }
+        finish(*winner, true);
+
+        for (int port = 0; port < portCount; port++) {
+            if (port == senderPort || !online(port, endUs)) {
+                continue;
+            }
+            CANSimPortState& receiver = ports[port];
+            if (receiver.bitrate != busBitrate) {
+                // Falsche Bitrate: nur Fehler sehen
+                if (receiver.rxErrors < 255) {
+                    receiver.rxErrors++;
+                }
+                receiver.busErrors++;
+                continue;
+            }
+            if (receiver.rxErrors > 127) {
+                receiver.rxErrors = 120;
+            } else if (receiver.rxErrors > 0) {
+                receiver.rxErrors--;
+            }
+            receiver.participant->onFrame(frame);
+        }
+        delivered++;
+    }
+
+    if (untilUs > clockUs) {
+        clockUs = untilUs;
+    }
+}
+
+void CANSimBus::skipTo(uint64_t nowUs) {
+    if (nowUs <= clockUs) {
+        return;
+    }
+    for (size_t i = 0; i < CAN_SIM_PENDING_FRAMES; i++) {
+        if (pending[i].used) {
+            finish(pending[i], false);
+        }
+    }
+    clockUs = nowUs;
+    busFreeUs = nowUs;
+}
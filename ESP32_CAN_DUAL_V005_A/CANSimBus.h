@@ -0,0 +1,145 @@
+// CANSimBus.h
+// ===============================================================================
+// Virtueller CAN-Bus für Simulation und Tests ohne Hardware
+// Teilnehmer (simulierte Nodes, SimCANInterface) reichen Frames mit einem
+// Bereitschaftszeitpunkt ein. run() spielt den Bus bis zu einem Zeitpunkt ab: ist der
+// Bus frei, gewinnt unter den bereiten Frames die Arbitrierung wie auf dem echten Bus
+// (11-Bit-Basis-ID, bei Gleichstand Standard vor Extended, gleiche IDs in
+// Sendereihenfolge), der Frame belegt den Bus für seine exakte Bitlänge
+// (CANStatistics::frameBits) bei der eingestellten Bitrate und wird am Frame-Ende mit
+// diesem Zeitstempel an alle anderen Teilnehmer verteilt.
+//
+// Fehler: Frames können per Fehlerrate oder gezielt gestört werden (Error-Frame,
+// automatische Wiederholung). Ohne einen zweiten Teilnehmer fehlt das ACK. Teilnehmer
+// mit abweichender Bitrate empfangen nichts und stören den Bus beim Senden. TEC/REC
+// und Bus-Off (mit Rückkehr nach 128 x 11 rezessiven Bits) folgen ISO 11898-1 in
+// vereinfachter Form.
+//
+// Die Zeit wird übergeben (µs).
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define CAN_SIM_MAX_PARTICIPANTS  136   // 127 Nodes + Interfaces
+#define CAN_SIM_PENDING_FRAMES    192   // Gleichzeitig zum Senden bereitgestellte Frames
+#define CAN_SIM_NEVER             UINT64_MAX
+
+// Teilnehmer am virtuellen Bus
+class CANSimParticipant {
+public:
+    virtual ~CANSimParticipant() {}
+
+    // Frame eines anderen Teilnehmers (timestamp = Ende des Frames auf dem Bus)
+    virtual void onFrame(const CanFrame& frame) = 0;
+
+    // Eigene Sendung abgeschlossen (false = abgebrochen, z.B. Bus-Off)
+    virtual void onTransmitted(uint32_t handle, bool success) {}
+
+    // Eigener Zeitgeber (Heartbeat, Boot-up): nächster Zeitpunkt bzw. CAN_SIM_NEVER
+    virtual uint64_t nextTimerUs() const { return CAN_SIM_NEVER; }
+    virtual void onTimer(uint64_t nowUs) {}
+};
+
+// Beobachter für jeden abgeschlossenen Sendeversuch: erfolgreich zugestellt oder mit
+// Error-Frame abgebrochen (timestamp = Ende auf dem Bus)
+typedef void (*CANSimTraceFn)(const CanFrame& frame, CANSimParticipant* sender, bool success, void* context);
+
+// Fehlerzustand eines Teilnehmers
+struct CANSimPortState {
+    CANSimParticipant* participant;
+    uint32_t bitrate;
+    uint16_t txErrors;          // TEC (> 255 = Bus-Off)
+    uint8_t rxErrors;           // REC
+    uint64_t busOffUntilUs;     // Rückkehr aus Bus-Off
+    uint32_t busErrors;         // Miterlebte Error-Frames
+    uint32_t arbitrationLost;
+
+    bool busOff(uint64_t nowUs) const { return busOffUntilUs > nowUs; }
+};
+
+class CANSimBus {
+public:
+    explicit CANSimBus(uint32_t bitrate = 500000);
+
+    void setBitrate(uint32_t bitrate) { busBitrate = bitrate; }
+    uint32_t bitrate() const { return busBitrate; }
+
+    // Teilnehmer anmelden; bitrate = eingestellte Bitrate des Teilnehmers.
+    // Liefert die Portnummer oder -1, wenn kein Platz frei ist.
+    int attach(CANSimParticipant* participant, uint32_t bitrate);
+    void detach(int port);
+    void setPortBitrate(int port, uint32_t bitrate);
+
+    // Frame ab readyUs senden. Liefert ein Handle (!= 0) oder 0, wenn kein Platz frei ist.
+    uint32_t transmit(int port, const CanFrame& frame, uint64_t readyUs);
+    bool abort(uint32_t handle);
+    size_t pendingFrames() const { return pendingCount; }
+
+    // Bus bis untilUs abspielen: Zeitgeber der Teilnehmer, Arbitrierung, Zustellung
+    void run(uint64_t untilUs);
+    uint64_t now() const { return clockUs; }
+
+    // Uhr ohne Abspielen auf nowUs vorstellen, offene Sendungen scheitern (z.B. wenn der
+    // Bus lange nicht abgespielt wurde); Zeitgeber der Teilnehmer passt CANSimNetwork an
+    void skipTo(uint64_t nowUs);
+
+    // Fehlerinjektion: Anteil gestörter Frames in Promille bzw. die nächsten count Frames
+    void setErrorRate(uint16_t permille) { errorPermille = permille > 1000 ? 1000 : permille; }
+    uint16_t errorRate() const { return errorPermille; }
+    void injectErrors(uint16_t count) { forcedErrors += count; }
+    void setSeed(uint32_t seed) { rngState = seed != 0 ? seed : 1; }
+
+    const CANSimPortState& portState(int port) const { return ports[port]; }
+
+    // Mitschnitt aller Sendeversuche (z.B. Benchmarks: Frames je Teilnehmer zählen)
+    void setTrace(CANSimTraceFn fn, void* context) {
+        traceFn = fn;
+        traceContext = context;
+    }
+
+    uint32_t framesDelivered() const { return delivered; }
+    uint32_t errorFrames() const { return errors; }
+    uint64_t busyUs() const { return busy; }
+
+private:
+    struct Pending {
+        CanFrame frame;
+        uint64_t readyUs;
+        uint32_t handle;
+        uint8_t port;
+        bool used;
+    };
+
+    uint32_t busBitrate;
+    CANSimPortState ports[CAN_SIM_MAX_PARTICIPANTS];
+    int portCount;  // Höchste belegte Portnummer + 1
+
+    Pending pending[CAN_SIM_PENDING_FRAMES];
+    size_t pendingCount;
+    uint32_t nextHandle;
+
+    uint64_t clockUs;
+    uint64_t busFreeUs;
+
+    uint16_t errorPermille;
+    uint16_t forcedErrors;
+    uint32_t rngState;
+
+    uint32_t delivered;
+    uint32_t errors;
+    uint64_t busy;
+
+    CANSimTraceFn traceFn;
+    void* traceContext;
+
+    bool online(int port, uint64_t nowUs);
+    bool listening(int port, uint64_t nowUs);  // Online und mit der Bitrate des Busses
+    uint64_t bitsToUs(uint32_t bits) const;
+    bool corrupt();
+    void transmitError(Pending& entry, uint64_t nowUs, bool ackError);
+    void finish(Pending& entry, bool success);
+};
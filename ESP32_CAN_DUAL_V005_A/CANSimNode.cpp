@@ -0,0 +1,788 @@
+// CANSimNode.cpp
+// ===============================================================================
+// Implementation der simulierten CANopen-Slaves
+// ===============================================================================
+
+#include "CANSimNode.h"
+#include "CANHeartbeatMonitor.h"
+#include "CANopen.h"
+#include <string.h>
+
+CANSimNode::CANSimNode(CANSimBus& bus, uint8_t nodeId, uint16_t heartbeatMs)
+    : bus(bus), port(-1), nodeId(nodeId & 0x7F), nmtState(NMT_STATE_UNKNOWN),
+      heartbeatMs(heartbeatMs), responseDelayUs(CAN_SIM_RESPONSE_DELAY_US), bitrate(bus.bitrate()),
+      bootAtUs(CAN_SIM_NEVER), nextHeartbeatUs(CAN_SIM_NEVER), sdoCount(0),
+      objectCount(0), domainData(nullptr), domainLength(0), rxData(nullptr),
+      transferState(TRANSFER_IDLE), transferObject(nullptr), transferData(nullptr), transferLength(0),
+      transferPos(0), transferToggle(0), blockCrc(false), blockSize(0), blockSeq(0), blockSent(0),
+      blockLast(false), blockEnabled(true), dropSeq(0), abortOffset(0), abortCode(0) {
+    memset(objects, 0, sizeof(objects));
+    memset(valueBytes, 0, sizeof(valueBytes));
+
+    // Standard-Objektverzeichnis (Kommunikationsprofil, CiA 301)
+    setObject(0x1000, 0, 4, 0x00020192);               // Device Type
+    setObject(0x1001, 0, 1, 0x00);                     // Error Register
+    setText(0x1008, 0, "SimNode");                     // Gerätename (segmentiert)
+    setText(0x1009, 0, "1.0");                         // Hardwareversion (expedited)
+    setObject(0x1017, 0, 2, heartbeatMs, true);        // Producer Heartbeat Time
+    setObject(0x1018, 0, 1, 4);                        // Identity Object
+    setObject(0x1018, 1, 4, 0x00000000);               // Vendor-ID
+    setObject(0x1018, 2, 4, 0x53494D00);               // Produktcode "SIM"
+    setObject(0x1018, 3, 4, 0x00010000);               // Revision
+    setObject(0x1018, 4, 4, 1000 + this->nodeId);      // Seriennummer
+    setDomain(nullptr, 0);                             // Parameterblock (segmentiert/Block)
+
+    powerOn(bus.now());
+}
+
+CANSimNode::~CANSimNode() {
+    powerOff();
+    delete[] domainData;
+    delete[] rxData;
+}
+
+// ===================================================================================
+// Objektverzeichnis
+// ===================================================================================
+CANSimObject* CANSimNode::findObject(uint16_t index, uint8_t subIndex) {
+    for (uint8_t i = 0; i < objectCount; i++) {
+        if (objects[i].index == index && objects[i].subIndex == subIndex) {
+            return &objects[i];
+        }
+    }
+    return nullptr;
+}
+
+const CANSimObject* CANSimNode::object(uint16_t index, uint8_t subIndex) const {
+    return const_cast<CANSimNode*>(this)->findObject(index, subIndex);
+}
+
+bool CANSimNode::hasIndex(uint16_t index) const {
+    for (uint8_t i = 0; i < objectCount; i++) {
+        if (objects[i].index == index) {
+            return true;
+        }
+    }
+    return false;
+}
+
+CANSimObject* CANSimNode::addObject(uint16_t index, uint8_t subIndex) {
+    CANSimObject* entry = findObject(index, subIndex);
+    if (entry == nullptr) {
+        if (objectCount >= CAN_SIM_NODE_OBJECTS) {
+            return nullptr;
+        }
+        entry = &objects[objectCount++];
+        memset(entry, 0, sizeof(CANSimObject));
+        entry->index = index;
+        entry->subIndex = subIndex;
+    }
+    return entry;
+}
+
+bool CANSimNode::setObject(uint16_t index, uint8_t subIndex, uint8_t size, uint32_t value, bool writable) {
+    if (size != 1 && size != 2 && size != 4) {
+        return false;
+    }
+    CANSimObject* entry = addObject(index, subIndex);
+    if (entry == nullptr) {
+        return false;
+    }
+    entry->size = size;
+    entry->writable = writable;
+    entry->domain = false;
+    entry->value = size == 4 ? value : value & ((1UL << (size * 8)) - 1);
+    entry->text[0] = '\0';
+    if (index == 0x1017 && subIndex == 0) {
+        applyHeartbeat((uint16_t)entry->value, bus.now());
+    }
+    return true;
+}
+
+bool CANSimNode::setText(uint16_t index, uint8_t subIndex, const char* text) {
+    CANSimObject* entry = addObject(index, subIndex);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (transferObject == entry) {
+        endTransfer();  // Laufender Upload sähe sonst einen anderen Text
+    }
+    entry->size = 0;
+    entry->writable = false;
+    entry->domain = false;
+    entry->value = 0;
+    strncpy(entry->text, text, CAN_SIM_TEXT_SIZE);
+    entry->text[CAN_SIM_TEXT_SIZE] = '\0';
+    return true;
+}
+
+bool CANSimNode::setDomain(const uint8_t* data, size_t size) {
+    if (size > CAN_SIM_DOMAIN_SIZE) {
+        return false;
+    }
+    CANSimObject* entry = addObject(CAN_SIM_DOMAIN_INDEX, 0);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (transferObject == entry) {
+        endTransfer();
+    }
+    entry->size = 0;
+    entry->writable = true;
+    entry->domain = true;
+    entry->value = 0;
+    entry->text[0] = '\0';
+    if (size > 0) {
+        if (domainData == nullptr) {
+            domainData = new uint8_t[CAN_SIM_DOMAIN_SIZE];
+        }
+        memmove(domainData, data, size);
+    }
+    domainLength = (uint32_t)size;
+    return true;
+}
+
+// Daten eines Objekts als Upload-Quelle (Zahlenwerte little-endian)
+const uint8_t* CANSimNode::objectData(const CANSimObject* entry, uint32_t& length) {
+    if (entry->domain) {
+        length = domainLength;
+        return domainData;
+    }
+    if (entry->size == 0) {
+        length = (uint32_t)strlen(entry->text);
+        return (const uint8_t*)entry->text;
+    }
+    for (uint8_t i = 0; i < entry->size; i++) {
+        valueBytes[i] = (uint8_t)(entry->value >> (8 * i));
+    }
+    length = entry->size;
+    return valueBytes;
+}
+
+// ===================================================================================
+// Zustand und Zeitgeber
+// ===================================================================================
+void CANSimNode::setHeartbeat(uint16_t periodMs) {
+    setObject(0x1017, 0, 2, periodMs, true);
+}
+
+void CANSimNode::applyHeartbeat(uint16_t periodMs, uint64_t nowUs) {
+    heartbeatMs = periodMs;
+    // Während des Boot-ups plant onTimer() den ersten Heartbeat selbst ein
+    if (powered() && bootAtUs == CAN_SIM_NEVER) {
+        nextHeartbeatUs = periodMs > 0 ? nowUs + (uint64_t)periodMs * 1000 : CAN_SIM_NEVER;
+    }
+}
+
+void CANSimNode::setBitrate(uint32_t rate) {
+    bitrate = rate;
+    if (port >= 0) {
+        bus.setPortBitrate(port, rate);
+    }
+}
+
+void CANSimNode::powerOff() {
+    if (port >= 0) {
+        bus.detach(port);
+        port = -1;
+    }
+    nmtState = NMT_STATE_UNKNOWN;
+    bootAtUs = CAN_SIM_NEVER;
+    nextHeartbeatUs = CAN_SIM_NEVER;
+    endTransfer();
+}
+
+void CANSimNode::powerOn(uint64_t nowUs) {
+    if (port < 0) {
+        port = bus.attach(this, bitrate);
+        if (port < 0) {
+            return;  // Bus voll
+        }
+    }
+    reset(nowUs);
+}
+
+void CANSimNode::reset(uint64_t nowUs) {
+    nmtState = NMT_STATE_BOOTUP;
+    bootAtUs = nowUs + CAN_SIM_BOOT_DELAY_US;
+    nextHeartbeatUs = CAN_SIM_NEVER;
+    endTransfer();
+}
+
+void CANSimNode::resync(uint64_t nowUs) {
+    if (bootAtUs != CAN_SIM_NEVER && bootAtUs < nowUs) {
+        bootAtUs = nowUs;
+    }
+    if (nextHeartbeatUs != CAN_SIM_NEVER && nextHeartbeatUs < nowUs) {
+        nextHeartbeatUs = nowUs + (uint64_t)heartbeatMs * 1000;
+    }
+}
+
+uint64_t CANSimNode::nextTimerUs() const {
+    return bootAtUs < nextHeartbeatUs ? bootAtUs : nextHeartbeatUs;
+}
+
+void CANSimNode::onTimer(uint64_t nowUs) {
+    if (bootAtUs <= nowUs) {
+        // Boot-up, danach selbstständig nach Pre-Operational
+        uint8_t bootup = NMT_STATE_BOOTUP;
+        bootAtUs = CAN_SIM_NEVER;
+        send(COB_ID_HB_BASE + nodeId, &bootup, 1, nowUs);
+        nmtState = NMT_STATE_PRE_OPERATIONAL;
+        applyHeartbeat(heartbeatMs, nowUs);
+    } else if (nextHeartbeatUs <= nowUs) {
+        send(COB_ID_HB_BASE + nodeId, &nmtState, 1, nowUs);
+        uint64_t periodUs = (uint64_t)heartbeatMs * 1000;
+        nextHeartbeatUs += periodUs;
+        if (nextHeartbeatUs <= nowUs) {
+            nextHeartbeatUs = nowUs + periodUs;  // Nach langer Pause nicht nachholen
+        }
+    }
+}
+
+// ===================================================================================
+// Empfang
+// ===================================================================================
+void CANSimNode::send(uint32_t id, const uint8_t* data, uint8_t len, uint64_t readyUs) {
+    if (port < 0) {
+        return;
+    }
+    CanFrame frame = {};
+    frame.id = id;
+    frame.len = len;
+    memcpy(frame.data, data, len);
+    bus.transmit(port, frame, readyUs);
+}
+
+void CANSimNode::onFrame(const CanFrame& frame) {
+    if (frame.ext || bootAtUs != CAN_SIM_NEVER) {
+        return;  // Während des Boot-ups taub
+    }
+    if (frame.id == COB_ID_NMT) {
+        handleNMT(frame);
+    } else if (frame.id == (uint32_t)(COB_ID_RSDO_BASE + nodeId) && frame.len == 8 &&
+               nmtState != NMT_STATE_STOPPED) {
+        handleSDO(frame);
+    }
+}
+
+void CANSimNode::handleNMT(const CanFrame& frame) {
+    if (frame.len < 2 || (frame.data[1] != 0 && frame.data[1] != nodeId)) {
+        return;
+    }
+    switch (frame.data[0]) {
+        case NMT_CMD_START_NODE:
+            nmtState = NMT_STATE_OPERATIONAL;
+            break;
+        case NMT_CMD_STOP_NODE:
+            nmtState = NMT_STATE_STOPPED;
+            endTransfer();
+            break;
+        case NMT_CMD_ENTER_PREOP:
+            nmtState = NMT_STATE_PRE_OPERATIONAL;
+            break;
+        case NMT_CMD_RESET_NODE:
+        case NMT_CMD_RESET_COMM:
+            reset(frame.timestamp);
+            break;
+    }
+}
+
+// ===================================================================================
+// SDO-Server
+// ===================================================================================
+// CRC-16 des Block-Transfers (CCITT, Polynom 0x1021, Startwert 0), bitweise
+static uint16_t blockCrc16(const uint8_t* data, uint32_t length) {
+    uint16_t crc = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)(data[i] << 8);
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+void CANSimNode::sdoAbort(uint16_t index, uint8_t subIndex, uint32_t code, uint64_t readyUs) {
+    uint8_t response[8] = {0x80, (uint8_t)index, (uint8_t)(index >> 8), subIndex,
+                           (uint8_t)code, (uint8_t)(code >> 8), (uint8_t)(code >> 16), (uint8_t)(code >> 24)};
+    endTransfer();
+    send(COB_ID_TSDO_BASE + nodeId, response, 8, readyUs);
+}
+
+void CANSimNode::abortTransferAt(uint32_t offset, uint32_t code) {
+    abortOffset = offset;
+    abortCode = code;
+}
+
+// Eingeplanter Abbruch, sobald der laufende Transfer die Marke erreicht hat
+bool CANSimNode::injectedAbort(uint64_t readyUs) {
+    if (abortCode == 0 || transferPos < abortOffset) {
+        return false;
+    }
+    uint32_t code = abortCode;
+    abortCode = 0;
+    sdoAbort(transferObject->index, transferObject->subIndex, code, readyUs);
+    return true;
+}
+
+void CANSimNode::handleSDO(const CanFrame& frame) {
+    const uint8_t* request = frame.data;
+    uint8_t command = request[0];
+    uint16_t index = request[1] | (request[2] << 8);
+    uint8_t subIndex = request[3];
+    uint64_t readyUs = frame.timestamp + responseDelayUs;
+    sdoCount++;
+
+    // Block-Download: 0x81..0xFF sind Segmente (Endekennung + Sequenznummer)
+    if (transferState == TRANSFER_BLOCK_DOWNLOAD && command != 0x80) {
+        receiveBlockSegment(request, readyUs);
+        return;
+    }
+    if ((command >> 5) == 4) {  // Abort durch den Client
+        endTransfer();
+        return;
+    }
+    if (transferState != TRANSFER_IDLE && handleTransfer(frame, readyUs)) {
+        return;
+    }
+
+    // Neue Anfrage; ein liegen gebliebener Transfer ist damit beendet
+    endTransfer();
+    switch (command >> 5) {
+        case 2:  // Initiate Upload
+            initiateUpload(request, false, readyUs);
+            return;
+        case 1:  // Initiate Download
+            initiateDownload(request, false, readyUs);
+            return;
+        case 5:  // Initiate Block Upload (cs = 0)
+            if ((command & 0x03) == 0) {
+                initiateUpload(request, true, readyUs);
+                return;
+            }
+            break;
+        case 6:  // Initiate Block Download (cs = 0)
+            if ((command & 0x01) == 0) {
+                initiateDownload(request, true, readyUs);
+                return;
+            }
+            break;
+    }
+    sdoAbort(index, subIndex, CAN_SIM_ABORT_COMMAND, readyUs);
+}
+
+void CANSimNode::initiateUpload(const uint8_t* request, bool block, uint64_t readyUs) {
+    uint16_t index = request[1] | (request[2] << 8);
+    uint8_t subIndex = request[3];
+    CANSimObject* entry = findObject(index, subIndex);
+    if (entry == nullptr) {
+        sdoAbort(index, subIndex, hasIndex(index) ? CAN_SIM_ABORT_NO_SUBINDEX : CAN_SIM_ABORT_NO_OBJECT, readyUs);
+        return;
+    }
+    if (block && !blockEnabled) {
+        sdoAbort(index, subIndex, CAN_SIM_ABORT_COMMAND, readyUs);
+        return;
+    }
+
+    uint32_t length = 0;
+    const uint8_t* data = objectData(entry, length);
+    uint8_t response[8] = {0};
+    memcpy(response + 1, request + 1, 3);
+
+    // Block: Blockgröße des Clients; bis pst Bytes wird normal geantwortet (Protokollwechsel)
+    if (block) {
+        uint8_t size = request[4];
+        uint8_t pst = request[5];
+        if (size < 1 || size > 127) {
+            sdoAbort(index, subIndex, CAN_SIM_ABORT_BLOCK_SIZE, readyUs);
+            return;
+        }
+        if (pst == 0 || length > pst) {
+            response[0] = 0xC6;  // scs=6, sc=1 (CRC), s=1 (Größe angegeben)
+            for (uint8_t i = 0; i < 4; i++) {
+                response[4 + i] = (uint8_t)(length >> (8 * i));
+            }
+            transferState = TRANSFER_BLOCK_UPLOAD_START;
+            transferObject = entry;
+            transferData = data;
+            transferLength = length;
+            transferPos = 0;
+            blockCrc = (request[0] & 0x04) != 0;
+            blockSize = size;
+            blockLast = false;
+            send(COB_ID_TSDO_BASE + nodeId, response, 8, readyUs);
+            return;
+        }
+    }
+
+    if (length == 0) {
+        response[0] = 0x42;  // Leeres Objekt: expedited ohne Größenangabe
+    } else if (length <= 4) {
+        response[0] = 0x43 | ((4 - length) << 2);
+        memcpy(response + 4, data, length);
+    } else {
+        response[0] = 0x41;
+        for (uint8_t i = 0; i < 4; i++) {
+            response[4 + i] = (uint8_t)(length >> (8 * i));
+        }
+        transferState = TRANSFER_UPLOAD_SEGMENT;
+        transferObject = entry;
+        transferData = data;
+        transferLength = length;
+        transferPos = 0;
+        transferToggle = 0;
+    }
+    send(COB_ID_TSDO_BASE + nodeId, response, 8, readyUs);
+}
+
+void CANSimNode::initiateDownload(const uint8_t* request, bool block, uint64_t readyUs) {
+    uint16_t index = request[1] | (request[2] << 8);
+    uint8_t subIndex = request[3];
+    uint8_t command = request[0];
+    CANSimObject* entry = findObject(index, subIndex);
+    if (entry == nullptr) {
+        sdoAbort(index, subIndex, hasIndex(index) ? CAN_SIM_ABORT_NO_SUBINDEX : CAN_SIM_ABORT_NO_OBJECT, readyUs);
+        return;
+    }
+    if (block && !blockEnabled) {
+        sdoAbort(index, subIndex, CAN_SIM_ABORT_COMMAND, readyUs);
+        return;
+    }
+    if (!entry->writable) {
+        sdoAbort(index, subIndex, CAN_SIM_ABORT_READ_ONLY, readyUs);
+        return;
+    }
+
+    uint8_t response[8] = {0};
+    memcpy(response + 1, request + 1, 3);
+    uint32_t size = request[4] | (request[5] << 8) | (request[6] << 16) | ((uint32_t)request[7] << 24);
+
+    if (!block && (command & 0x02)) {
+        // Expedited; Zahlenwerte übernehmen die Objektgröße unabhängig von der Angabe
+        if (entry->domain) {
+            uint8_t bytes = (command & 0x01) ? 4 - ((command >> 2) & 0x03) : 4;
+            setDomain(request + 4, bytes);
+        } else {
+            setObject(index, subIndex, entry->size, size, true);
+        }
+        response[0] = 0x60;
+        send(COB_ID_TSDO_BASE + nodeId, response, 8, readyUs);
+        return;
+    }
+
+    // Segmentiert bzw. Block: nur in das Domain-Objekt, gesammelt und erst am Ende übernommen
+    bool sized = (command & (block ? 0x02 : 0x01)) != 0;
+    if (!entry->domain) {
+        sdoAbort(index, subIndex, CAN_SIM_ABORT_LENGTH, readyUs);
+        return;
+    }
+    if (sized && size > CAN_SIM_DOMAIN_SIZE) {
+        sdoAbort(index, subIndex, CAN_SIM_ABORT_OUT_OF_MEMORY, readyUs);
+        return;
+    }
+    if (rxData == nullptr) {
+        rxData = new uint8_t[CAN_SIM_DOMAIN_SIZE];
+    }
+    transferObject = entry;
+    transferLength = sized ? size : 0;
+    transferPos = 0;
+    transferToggle = 0;
+
+    if (block) {
+        response[0] = 0xA4;  // scs=5, sc=1 (CRC)
+        response[4] = CAN_SIM_BLOCK_SIZE;
+        transferState = TRANSFER_BLOCK_DOWNLOAD;
+        blockCrc = (command & 0x04) != 0;
+        blockSize = CAN_SIM_BLOCK_SIZE;
+        blockSeq = 0;
+        blockLast = false;
+    } else {
+        response[0] = 0x60;
+        transferState = TRANSFER_DOWNLOAD_SEGMENT;
+    }
+    send(COB_ID_TSDO_BASE + nodeId, response, 8, readyUs);
+}
+
+// Frame zum laufenden Transfer; false, wenn er nicht dazu passt (neue Anfrage)
+bool CANSimNode::handleTransfer(const CanFrame& frame, uint64_t readyUs) {
+    const uint8_t* request = frame.data;
+    uint8_t command = request[0];
+    uint8_t response[8] = {0};
+
+    switch (transferState) {
+        case TRANSFER_UPLOAD_SEGMENT: {
+            if ((command & 0xE0) != 0x60) {
+                return false;
+            }
+            if ((command & 0x10) != transferToggle) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_TOGGLE, readyUs);
+                return true;
+            }
+            if (injectedAbort(readyUs)) {
+                return true;
+            }
+            uint32_t remaining = transferLength - transferPos;
+            uint8_t count = remaining > 7 ? 7 : (uint8_t)remaining;
+            bool last = count == remaining;
+            response[0] = transferToggle | ((7 - count) << 1) | (last ? 0x01 : 0x00);
+            memcpy(response + 1, transferData + transferPos, count);
+            transferPos += count;
+            transferToggle ^= 0x10;
+            if (last) {
+                endTransfer();
+            }
+            break;
+        }
+
+        case TRANSFER_DOWNLOAD_SEGMENT: {
+            if ((command & 0xE0) != 0x00) {
+                return false;
+            }
+            if ((command & 0x10) != transferToggle) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_TOGGLE, readyUs);
+                return true;
+            }
+            uint8_t count = 7 - ((command >> 1) & 0x07);
+            if (transferPos + count > CAN_SIM_DOMAIN_SIZE) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_OUT_OF_MEMORY, readyUs);
+                return true;
+            }
+            memcpy(rxData + transferPos, request + 1, count);
+            transferPos += count;
+            if (injectedAbort(readyUs)) {
+                return true;
+            }
+            response[0] = 0x20 | transferToggle;
+            transferToggle ^= 0x10;
+            if (command & 0x01) {
+                if (transferLength != 0 && transferPos != transferLength) {
+                    sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_LENGTH, readyUs);
+                    return true;
+                }
+                setDomain(rxData, transferPos);
+                endTransfer();
+            }
+            break;
+        }
+
+        case TRANSFER_BLOCK_UPLOAD_START:
+            if (command != 0xA3) {
+                return false;
+            }
+            transferState = TRANSFER_BLOCK_UPLOAD;
+            sendUploadBlock(readyUs);
+            return true;
+
+        case TRANSFER_BLOCK_UPLOAD: {
+            // Quittung: ackseq = letztes lückenlos empfangenes Segment, neue Blockgröße
+            if (command != 0xA2) {
+                return false;
+            }
+            uint8_t ackSeq = request[1];
+            uint8_t size = request[2];
+            if (ackSeq > blockSent) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_SEQUENCE, readyUs);
+                return true;
+            }
+            if (size < 1 || size > 127) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_BLOCK_SIZE, readyUs);
+                return true;
+            }
+            bool complete = blockLast && ackSeq == blockSent;
+            transferPos += (uint32_t)ackSeq * 7;
+            if (transferPos > transferLength) {
+                transferPos = transferLength;
+            }
+            blockSize = size;
+            if (injectedAbort(readyUs)) {
+                return true;
+            }
+            if (!complete) {
+                sendUploadBlock(readyUs);  // Nächster Block bzw. Wiederholung ab ackseq
+                return true;
+            }
+            // End-Frame: ungenutzte Bytes im letzten Segment und CRC
+            uint32_t segments = transferLength == 0 ? 1 : (transferLength + 6) / 7;
+            uint8_t unused = (uint8_t)(segments * 7 - transferLength);
+            uint16_t crc = blockCrc ? blockCrc16(transferData, transferLength) : 0;
+            response[0] = 0xC1 | (unused << 2);
+            response[1] = (uint8_t)crc;
+            response[2] = (uint8_t)(crc >> 8);
+            transferState = TRANSFER_BLOCK_UPLOAD_END;
+            break;
+        }
+
+        case TRANSFER_BLOCK_UPLOAD_END:
+            if (command != 0xA1) {
+                return false;
+            }
+            endTransfer();
+            return true;
+
+        case TRANSFER_BLOCK_DOWNLOAD_END: {
+            // End Block Download: ungenutzte Bytes im letzten Segment und CRC
+            if ((command & 0xE3) != 0xC1) {
+                return false;
+            }
+            uint8_t unused = (command >> 2) & 0x07;
+            uint32_t total = transferPos >= unused ? transferPos - unused : 0;
+            uint16_t crc = request[1] | (request[2] << 8);
+            if (total > CAN_SIM_DOMAIN_SIZE) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_OUT_OF_MEMORY, readyUs);
+                return true;
+            }
+            if (transferLength != 0 && total != transferLength) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_LENGTH, readyUs);
+                return true;
+            }
+            if (blockCrc && blockCrc16(rxData, total) != crc) {
+                sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_CRC, readyUs);
+                return true;
+            }
+            setDomain(rxData, total);
+            endTransfer();
+            response[0] = 0xA1;
+            break;
+        }
+
+        default:
+            return false;
+    }
+
+    send(COB_ID_TSDO_BASE + nodeId, response, 8, readyUs);
+    return true;
+}
+
+// Block-Upload: Segmente ab transferPos ohne Einzelquittung, höchstens blockSize;
+// das letzte Segment des Objekts trägt die Endekennung
+void CANSimNode::sendUploadBlock(uint64_t readyUs) {
+    uint32_t offset = transferPos;
+    blockSent = 0;
+    blockLast = false;
+    while (blockSent < blockSize && !blockLast) {
+        uint32_t remaining = transferLength - offset;
+        uint8_t count = remaining > 7 ? 7 : (uint8_t)remaining;
+        blockLast = count == remaining;
+        blockSent++;
+
+        uint8_t segment[8] = {0};
+        segment[0] = (blockLast ? 0x80 : 0x00) | blockSent;
+        if (count > 0) {
+            memcpy(segment + 1, transferData + offset, count);
+        }
+        offset += count;
+        if (blockSent == dropSeq) {
+            dropSeq = 0;  // Verloren: der Client quittiert nur bis zur Lücke
+            continue;
+        }
+        send(COB_ID_TSDO_BASE + nodeId, segment, 8, readyUs);
+    }
+}
+
+// Block-Download: nur lückenlose Segmente übernehmen; am Blockende (bzw. beim letzten
+// Segment) bis zur Lücke quittieren, der Client wiederholt ab dort
+void CANSimNode::receiveBlockSegment(const uint8_t* segment, uint64_t readyUs) {
+    uint8_t seq = segment[0] & 0x7F;
+    bool last = (segment[0] & 0x80) != 0;
+    if (seq == dropSeq) {
+        dropSeq = 0;  // Verloren
+        return;
+    }
+
+    if (seq == blockSeq + 1 && !blockLast) {
+        uint32_t offset = transferPos + (uint32_t)blockSeq * 7;
+        if (offset >= CAN_SIM_DOMAIN_SIZE) {
+            sdoAbort(transferObject->index, transferObject->subIndex, CAN_SIM_ABORT_OUT_OF_MEMORY, readyUs);
+            return;
+        }
+        uint32_t room = CAN_SIM_DOMAIN_SIZE - offset;
+        memcpy(rxData + offset, segment + 1, room < 7 ? room : 7);
+        blockSeq = seq;
+        blockLast = last;
+    }
+    if (seq < blockSize && !last) {
+        return;
+    }
+
+    uint8_t ack[8] = {0xA2, blockSeq, CAN_SIM_BLOCK_SIZE, 0, 0, 0, 0, 0};
+    transferPos += (uint32_t)blockSeq * 7;
+    blockSeq = 0;
+    if (injectedAbort(readyUs)) {
+        return;
+    }
+    if (blockLast) {
+        transferState = TRANSFER_BLOCK_DOWNLOAD_END;
+    }
+    send(COB_ID_TSDO_BASE + nodeId, ack, 8, readyUs);
+}
+
+// ===================================================================================
+// Netzwerk
+// ===================================================================================
+CANSimNetwork::CANSimNetwork(uint32_t bitrate) : simBus(bitrate) {
+    memset(nodes, 0, sizeof(nodes));
+}
+
+CANSimNetwork::~CANSimNetwork() {
+    clear();
+}
+
+CANSimNode* CANSimNetwork::addNode(uint8_t nodeId, uint16_t heartbeatMs) {
+    if (nodeId < 1 || nodeId > 127) {
+        return nullptr;
+    }
+    removeNode(nodeId);
+    CANSimNode* node = new CANSimNode(simBus, nodeId, heartbeatMs);
+    if (!node->powered()) {
+        delete node;  // Kein Port mehr frei
+        return nullptr;
+    }
+    nodes[nodeId] = node;
+    return node;
+}
+
+uint8_t CANSimNetwork::addNodes(uint8_t first, uint8_t last, uint16_t heartbeatMs) {
+    uint8_t count = 0;
+    for (unsigned id = first; id <= last && id <= 127; id++) {
+        if (addNode((uint8_t)id, heartbeatMs) != nullptr) {
+            count++;
+        }
+    }
+    return count;
+}
+
+bool CANSimNetwork::removeNode(uint8_t nodeId) {
+    CANSimNode*& node = nodes[nodeId & 0x7F];
+    if (node == nullptr) {
+        return false;
+    }
+    delete node;
+    node = nullptr;
+    return true;
+}
+
+void CANSimNetwork::clear() {
+    for (uint8_t id = 1; id < 128; id++) {
+        removeNode(id);
+    }
+}
+
+void CANSimNetwork::skipTo(uint64_t nowUs) {
+    simBus.skipTo(nowUs);
+    for (uint8_t id = 1; id < 128; id++) {
+        if (nodes[id] != nullptr) {
+            nodes[id]->resync(nowUs);
+        }
+    }
+}
+
+uint8_t CANSimNetwork::nodeCount() const {
+    uint8_t count = 0;
+    for (uint8_t id = 1; id < 128; id++) {
+        if (nodes[id] != nullptr) {
+            count++;
+        }
+    }
+    return count;
+}
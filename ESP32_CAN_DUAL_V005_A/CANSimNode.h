@@ -0,0 +1,202 @@
+// CANSimNode.h
+// ===============================================================================
+// Simulierte CANopen-Slaves für den virtuellen Bus (CANSimBus)
+// Ein CANSimNode verhält sich nach außen wie ein einfaches CiA-301-Gerät:
+//   - Boot-up (0x700+ID, 0x00) nach dem Einschalten bzw. NMT-Reset, danach
+//     Pre-Operational; Heartbeat mit der Periode aus Objekt 0x1017
+//   - NMT Start/Stop/Pre-Operational/Reset (Broadcast oder eigene ID)
+//   - SDO-Server: Upload und Download expedited, segmentiert und als Block-Transfer
+//     mit CRC (Wiederholung ab dem letzten lückenlos empfangenen Segment), Abbruch
+//     mit CiA-301-Abortcodes; im Zustand Stopped keine SDO-Antworten
+// Das Objektverzeichnis ist eine kleine feste Tabelle und lässt sich per setObject()/
+// setText()/setDomain() skripten; powerOff()/powerOn() simulieren Ausfall und Neustart.
+// Für Tests des SDO-Clients lassen sich Block-Transfers abschalten, einzelne
+// Block-Segmente verlieren und Transfers nach n Bytes abbrechen.
+//
+// CANSimNetwork besitzt den Bus und bis zu 127 Nodes.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CANSimBus.h"
+
+#define CAN_SIM_NODE_OBJECTS        16     // Einträge im Objektverzeichnis je Node
+#define CAN_SIM_TEXT_SIZE           24     // Maximale Länge eines Textobjekts
+#define CAN_SIM_RESPONSE_DELAY_US   200    // Standard-Antwortzeit des SDO-Servers
+#define CAN_SIM_BOOT_DELAY_US       5000   // Einschalten bzw. Reset bis zum Boot-up
+#define CAN_SIM_DOMAIN_INDEX        0x2100 // Domain-Objekt (Parameterblock), Subindex 0
+#define CAN_SIM_DOMAIN_SIZE         512    // Maximale Länge des Domain-Objekts
+#define CAN_SIM_BLOCK_SIZE          16     // Segmente je Block beim Block-Download
+
+// SDO-Abortcodes (CiA 301)
+#define CAN_SIM_ABORT_TOGGLE        0x05030000UL
+#define CAN_SIM_ABORT_COMMAND       0x05040001UL
+#define CAN_SIM_ABORT_BLOCK_SIZE    0x05040002UL
+#define CAN_SIM_ABORT_SEQUENCE      0x05040003UL
+#define CAN_SIM_ABORT_CRC           0x05040004UL
+#define CAN_SIM_ABORT_OUT_OF_MEMORY 0x05040005UL
+#define CAN_SIM_ABORT_READ_ONLY     0x06010002UL
+#define CAN_SIM_ABORT_NO_OBJECT     0x06020000UL
+#define CAN_SIM_ABORT_LENGTH        0x06070010UL
+#define CAN_SIM_ABORT_NO_SUBINDEX   0x06090011UL
+
+// Eintrag im Objektverzeichnis; size = 0 kennzeichnet ein Textobjekt (VISIBLE_STRING)
+// bzw. mit domain das Domain-Objekt, dessen Daten der Node getrennt hält
+struct CANSimObject {
+    uint16_t index;
+    uint8_t subIndex;
+    uint8_t size;        // 1, 2 oder 4 Byte
+    bool writable;
+    bool domain;
+    uint32_t value;
+    char text[CAN_SIM_TEXT_SIZE + 1];
+};
+
+class CANSimNode : public CANSimParticipant {
+public:
+    // Legt das Standard-Objektverzeichnis an und schaltet den Node ein
+    CANSimNode(CANSimBus& bus, uint8_t nodeId, uint16_t heartbeatMs = 1000);
+    ~CANSimNode();
+
+    uint8_t id() const { return nodeId; }
+
+    // Objektverzeichnis skripten; false, wenn die Tabelle voll ist
+    bool setObject(uint16_t index, uint8_t subIndex, uint8_t size, uint32_t value, bool writable = false);
+    bool setText(uint16_t index, uint8_t subIndex, const char* text);
+    const CANSimObject* object(uint16_t index, uint8_t subIndex) const;
+
+    // Inhalt des Domain-Objekts (CAN_SIM_DOMAIN_INDEX); false, wenn size zu groß ist
+    bool setDomain(const uint8_t* data, size_t size);
+    const uint8_t* domain() const { return domainData; }
+    size_t domainSize() const { return domainLength; }
+
+    // Block-Transfers annehmen (sonst Abort CAN_SIM_ABORT_COMMAND wie bei Servern ohne)
+    void setBlockTransfer(bool enabled) { blockEnabled = enabled; }
+    // Fehlerinjektion: Block-Segment seq einmal verlieren (beim Senden bzw. Empfang)
+    void dropBlockSegment(uint8_t seq) { dropSeq = seq; }
+    // Fehlerinjektion: den nächsten Transfer abbrechen, sobald offset Bytes übertragen sind
+    void abortTransferAt(uint32_t offset, uint32_t code);
+
+    // Heartbeat-Periode in ms (0 = aus), entspricht Objekt 0x1017
+    void setHeartbeat(uint16_t periodMs);
+    uint16_t heartbeat() const { return heartbeatMs; }
+
+    void setResponseDelay(uint32_t delayUs) { responseDelayUs = delayUs; }
+    uint32_t responseDelay() const { return responseDelayUs; }
+
+    // Eingestellte Bitrate des Nodes (abweichend vom Bus = stört beim Senden)
+    void setBitrate(uint32_t bitrate);
+
+    // Ausfall (meldet sich vom Bus ab, kein ACK mehr) und Neustart mit Boot-up
+    void powerOff();
+    void powerOn(uint64_t nowUs);
+    bool powered() const { return port >= 0; }
+
+    // Zeitgeber nach CANSimBus::skipTo() nachziehen (verpasste Heartbeats entfallen)
+    void resync(uint64_t nowUs);
+
+    uint8_t state() const { return nmtState; }
+    uint32_t sdoRequests() const { return sdoCount; }
+
+    // CANSimParticipant
+    void onFrame(const CanFrame& frame) override;
+    uint64_t nextTimerUs() const override;
+    void onTimer(uint64_t nowUs) override;
+
+private:
+    CANSimBus& bus;
+    int port;
+    uint8_t nodeId;
+    uint8_t nmtState;
+    uint16_t heartbeatMs;
+    uint32_t responseDelayUs;
+    uint32_t bitrate;
+    uint64_t bootAtUs;          // Ausstehender Boot-up
+    uint64_t nextHeartbeatUs;
+    uint32_t sdoCount;
+
+    CANSimObject objects[CAN_SIM_NODE_OBJECTS];
+    uint8_t objectCount;
+
+    // Domain-Objekt und Empfangspuffer für Downloads, erst bei Bedarf angelegt
+    uint8_t* domainData;
+    uint32_t domainLength;
+    uint8_t* rxData;
+
+    // Laufender segmentierter bzw. Block-Transfer
+    enum TransferState : uint8_t {
+        TRANSFER_IDLE = 0,
+        TRANSFER_UPLOAD_SEGMENT,      // Segmentierter Upload, Segment-Anfragen erwartet
+        TRANSFER_DOWNLOAD_SEGMENT,    // Segmentierter Download, Segmente erwartet
+        TRANSFER_BLOCK_UPLOAD_START,  // Initiate beantwortet, Start Upload erwartet
+        TRANSFER_BLOCK_UPLOAD,        // Block gesendet, Quittung erwartet
+        TRANSFER_BLOCK_UPLOAD_END,    // End-Frame gesendet, Bestätigung erwartet
+        TRANSFER_BLOCK_DOWNLOAD,      // Segmente eines Blocks erwartet
+        TRANSFER_BLOCK_DOWNLOAD_END   // Alles quittiert, End-Frame mit CRC erwartet
+    };
+    uint8_t transferState;
+    CANSimObject* transferObject;
+    const uint8_t* transferData;  // Upload-Quelle
+    uint32_t transferLength;      // Upload: Objektlänge; Download: angekündigte Länge (0 = keine)
+    uint32_t transferPos;         // Übertragene (beim Block: quittierte) Bytes
+    uint8_t transferToggle;
+    uint8_t valueBytes[4];        // Zahlenwert als Upload-Quelle
+    bool blockCrc;
+    uint8_t blockSize;
+    uint8_t blockSeq;             // Download: letzte lückenlos empfangene Sequenznummer
+    uint8_t blockSent;            // Upload: Segmente im laufenden Block
+    bool blockLast;               // Segment mit Endekennung gesendet bzw. empfangen
+
+    bool blockEnabled;
+    uint8_t dropSeq;              // 0 = kein Segment verlieren
+    uint32_t abortOffset;
+    uint32_t abortCode;           // 0 = kein Abbruch eingeplant
+
+    CANSimObject* findObject(uint16_t index, uint8_t subIndex);
+    CANSimObject* addObject(uint16_t index, uint8_t subIndex);
+    bool hasIndex(uint16_t index) const;
+    const uint8_t* objectData(const CANSimObject* entry, uint32_t& length);
+
+    void reset(uint64_t nowUs);
+    void send(uint32_t id, const uint8_t* data, uint8_t len, uint64_t readyUs);
+    void handleNMT(const CanFrame& frame);
+    void handleSDO(const CanFrame& frame);
+    bool handleTransfer(const CanFrame& frame, uint64_t readyUs);
+    void initiateUpload(const uint8_t* request, bool block, uint64_t readyUs);
+    void initiateDownload(const uint8_t* request, bool block, uint64_t readyUs);
+    void sendUploadBlock(uint64_t readyUs);
+    void receiveBlockSegment(const uint8_t* segment, uint64_t readyUs);
+    bool injectedAbort(uint64_t readyUs);
+    void endTransfer() { transferState = TRANSFER_IDLE; transferObject = nullptr; }
+    void applyHeartbeat(uint16_t periodMs, uint64_t nowUs);
+    void sdoAbort(uint16_t index, uint8_t subIndex, uint32_t code, uint64_t readyUs);
+};
+
+// Bus mit simulierten Nodes
+class CANSimNetwork {
+public:
+    explicit CANSimNetwork(uint32_t bitrate = 500000);
+    ~CANSimNetwork();
+
+    CANSimBus& bus() { return simBus; }
+
+    // Node anlegen (vorhandener Node mit derselben ID wird ersetzt)
+    CANSimNode* addNode(uint8_t nodeId, uint16_t heartbeatMs = 1000);
+    // Nodes first..last anlegen; liefert die Anzahl
+    uint8_t addNodes(uint8_t first, uint8_t last, uint16_t heartbeatMs = 1000);
+    bool removeNode(uint8_t nodeId);
+    void clear();
+
+    CANSimNode* node(uint8_t nodeId) const { return nodes[nodeId & 0x7F]; }
+    uint8_t nodeCount() const;
+
+    void run(uint64_t untilUs) { simBus.run(untilUs); }
+    // Bus und Nodes ohne Abspielen auf nowUs vorstellen
+    void skipTo(uint64_t nowUs);
+
+private:
+    CANSimBus simBus;
+    CANSimNode* nodes[128];
+};
@@ -0,0 +1,202 @@
+// CANSlcan.cpp
+// ===============================================================================
+// Implementation des SLCAN-Befehlssatzes
+// ===============================================================================
+
+#include "CANSlcan.h"
+#include <string.h>
+
+namespace {
+
+// S0-S8
+const uint16_t SLCAN_BITRATES[] = {10, 20, 50, 100, 125, 250, 500, 800, 1000};
+
+int8_t hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool parseHex(const char* text, uint8_t digits, uint32_t& value) {
+    value = 0;
+    for (uint8_t i = 0; i < digits; i++) {
+        int8_t nibble = hexValue(text[i]);
+        if (nibble < 0) {
+            return false;
+        }
+        value = (value << 4) | nibble;
+    }
+    return true;
+}
+
+size_t reply1(char* reply, char c) {
+    reply[0] = c;
+    return 1;
+}
+
+}  // namespace
+
+SLCANSession::SLCANSession() : handlerContext(nullptr) {
+    memset(&handlers, 0, sizeof(handlers));
+    reset();
+}
+
+void SLCANSession::setHandlers(const SLCANHandlers& handlers, void* context) {
+    this->handlers = handlers;
+    handlerContext = context;
+}
+
+void SLCANSession::reset() {
+    channelOpen = false;
+    listenOnly = false;
+    timestamps = false;
+}
+
+bool SLCANSession::isSessionCommand(const char* line, size_t len) {
+    if (len == 0) {
+        return false;
+    }
+    switch (line[0]) {
+        case 'O':
+        case 'L':
+        case 'C':
+        case 'V':
+        case 'N':
+        case 'F':
+            return len == 1;
+        case 'S':
+            return len == 2 && line[1] >= '0' && line[1] <= '8';
+        case 'Z':
+            return len == 2 && (line[1] == '0' || line[1] == '1');
+        default:
+            return false;
+    }
+}
+
+size_t SLCANSession::handleCommand(const char* line, size_t len, char* reply) {
+    if (len == 0) {
+        return reply1(reply, SLCAN_OK);
+    }
+
+    switch (line[0]) {
+        case 'S': {
+            // Bitrate nur bei geschlossenem Kanal
+            if (channelOpen || len != 2 || line[1] < '0' || line[1] > '8') {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            uint16_t kbps = SLCAN_BITRATES[line[1] - '0'];
+            if (handlers.setBitrate != nullptr && !handlers.setBitrate(kbps, handlerContext)) {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            return reply1(reply, SLCAN_OK);
+        }
+
+        case 'O':
+        case 'L':
+            if (channelOpen) {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            listenOnly = line[0] == 'L';
+            if (handlers.open != nullptr && !handlers.open(listenOnly, timestamps, handlerContext)) {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            channelOpen = true;
+            return reply1(reply, SLCAN_OK);
+
+        case 'C':
+            if (channelOpen && handlers.close != nullptr) {
+                handlers.close(handlerContext);
+            }
+            channelOpen = false;
+            return reply1(reply, SLCAN_OK);
+
+        case 't':
+        case 'T': {
+            CanFrame frame;
+            if (!channelOpen || listenOnly || !parseFrame(line, len, frame) ||
+                handlers.transmit == nullptr || !handlers.transmit(frame, handlerContext)) {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            reply[0] = line[0] == 't' ? 'z' : 'Z';
+            reply[1] = SLCAN_OK;
+            return 2;
+        }
+
+        case 'Z':
+            if (channelOpen || len != 2 || (line[1] != '0' && line[1] != '1')) {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            timestamps = line[1] == '1';
+            return reply1(reply, SLCAN_OK);
+
+        case 'F': {
+            if (!channelOpen) {
+                return reply1(reply, SLCAN_ERROR);
+            }
+            static const char HEX[] = "0123456789ABCDEF";
+            uint8_t flags = handlers.status != nullptr ? handlers.status(handlerContext) : 0;
+            reply[0] = 'F';
+            reply[1] = HEX[flags >> 4];
+            reply[2] = HEX[flags & 0xF];
+            reply[3] = SLCAN_OK;
+            return 4;
+        }
+
+        case 'V':
+            memcpy(reply, "V0101\r", 6);
+            return 6;
+
+        case 'v':
+            memcpy(reply, "v0101\r", 6);
+            return 6;
+
+        case 'N':
+            memcpy(reply, "NESP1\r", 6);
+            return 6;
+
+        case 'M':
+        case 'm':
+            // Akzeptanzcode/-maske des SJA1000: angenommen, aber ohne Wirkung
+            return reply1(reply, SLCAN_OK);
+
+        default:
+            // r/R (Remote-Frames), s (BTR), unbekannte Befehle
+            return reply1(reply, SLCAN_ERROR);
+    }
+}
+
+// tiiildd...  bzw.  Tiiiiiiiildd...
+bool SLCANSession::parseFrame(const char* line, size_t len, CanFrame& frame) const {
+    bool extended = line[0] == 'T';
+    uint8_t idDigits = extended ? 8 : 3;
+    if (len < (size_t)idDigits + 2) {
+        return false;
+    }
+
+    uint32_t id;
+    uint32_t dlc;
+    if (!parseHex(line + 1, idDigits, id) || !parseHex(line + 1 + idDigits, 1, dlc) || dlc > 8) {
+        return false;
+    }
+    if (id > (extended ? 0x1FFFFFFFUL : 0x7FFUL)) {
+        return false;
+    }
+    if (len != 2 + idDigits + 2 * dlc) {
+        return false;
+    }
+
+    memset(&frame, 0, sizeof(frame));
+    frame.id = id;
+    frame.ext = extended ? 1 : 0;
+    frame.len = dlc;
+    const char* data = line + 2 + idDigits;
+    for (uint8_t i = 0; i < dlc; i++) {
+        uint32_t byte;
+        if (!parseHex(data + 2 * i, 2, byte)) {
+            return false;
+        }
+        frame.data[i] = byte;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+// CANSlcan.h
+// ===============================================================================
+// SLCAN-Befehlssatz (Lawicel CANUSB), damit das Gerät an der seriellen Schnittstelle
+// als gewöhnlicher CAN-Adapter erscheint (slcand/can-utils, SavvyCAN, python-can).
+// SLCANSession wertet einzelne Befehlszeilen (ohne abschließendes '\r') aus und liefert
+// die Antwort; Kanal öffnen/schließen, Bitrate und Senden übernimmt die Anwendung über
+// Callbacks. Die empfangenen Frames schreibt CANLogWriter im Format CAN_LOG_SLCAN bzw.
+// CAN_LOG_SLCAN_TS.
+//
+// Unterstützt: Sn, O, L, C, t, T, Z0/Z1, F, V, v, N, M/m (angenommen, Filterung über
+// "monitor filter"). Remote-Frames (r, R) und BTR-Register (s) werden abgelehnt.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define SLCAN_MAX_REPLY  8     // Längste Antwort ("V0101\r")
+#define SLCAN_OK         '\r'
+#define SLCAN_ERROR      '\a'  // BELL
+
+struct SLCANHandlers {
+    bool (*open)(bool listenOnly, bool timestamps, void* context);
+    void (*close)(void* context);
+    bool (*setBitrate)(uint16_t kbps, void* context);
+    bool (*transmit)(const CanFrame& frame, void* context);  // false = Sendequeue voll
+    uint8_t (*status)(void* context);                        // Lawicel-Statusbits für 'F'
+};
+
+class SLCANSession {
+public:
+    SLCANSession();
+
+    void setHandlers(const SLCANHandlers& handlers, void* context);
+
+    // Eine Befehlszeile auswerten; die Antwort (mindestens ein Zeichen) steht danach in
+    // reply (SLCAN_MAX_REPLY Bytes). Rückgabe: Länge der Antwort.
+    size_t handleCommand(const char* line, size_t len, char* reply);
+
+    bool isOpen() const { return channelOpen; }
+    void reset();  // Kanal gilt als geschlossen, Zeitstempel aus
+
+    // Zeile, mit der SLCAN-Software eine Sitzung beginnt (Sn, O, L, C, V, N, ...).
+    // Erlaubt das automatische Umschalten aus dem normalen Befehlsmodus.
+    static bool isSessionCommand(const char* line, size_t len);
+
+private:
+    SLCANHandlers handlers;
+    void* handlerContext;
+
+    bool channelOpen;
+    bool listenOnly;
+    bool timestamps;
+
+    bool parseFrame(const char* line, size_t len, CanFrame& frame) const;
+};
@@ -0,0 +1,295 @@
+// CANStatistics.cpp
+// ===============================================================================
+// Implementation der Busstatistik
+// ===============================================================================
+
+#include "CANStatistics.h"
+#include <string.h>
+
+namespace {
+
+// Bitstrom eines Frames: zählt Stuff-Bits und berechnet nebenbei die CRC-15.
+// Die Kopfbits laufen einzeln durch, die Datenbytes über Tabellen (je Byte ein Zugriff
+// für die CRC und einer für die Stuff-Bits).
+struct BitStuffer {
+    uint8_t last;
+    uint8_t run;
+    uint16_t stuffBits;
+    uint16_t crc;
+
+    BitStuffer() : last(2), run(0), stuffBits(0), crc(0) {}
+
+    void push(uint8_t bit) {
+        if (bit == last) {
+            if (++run == 5) {
+                // Nach fünf gleichen Bits folgt ein komplementäres Stuff-Bit
+                stuffBits++;
+                last = !bit;
+                run = 1;
+            }
+        } else {
+            last = bit;
+            run = 1;
+        }
+    }
+
+    // Bits von SOF bis Datenende gehen in die CRC ein (Polynom 0x4599)
+    void pushBits(uint32_t value, uint8_t count) {
+        for (int8_t i = count - 1; i >= 0; i--) {
+            uint8_t bit = (value >> i) & 1;
+            uint8_t feedback = bit ^ ((crc >> 14) & 1);
+            crc = (crc << 1) & 0x7FFF;
+            if (feedback) {
+                crc ^= 0x4599;
+            }
+            push(bit);
+        }
+    }
+
+    void pushByte(uint8_t value);
+
+    void pushCrc() {
+        uint16_t value = crc;
+        for (int8_t i = 14; i >= 0; i--) {
+            push((value >> i) & 1);
+        }
+    }
+};
+
+// Stuff-Zustand vor einem Byte: letztes Bit und Lauflänge 1-4 (3 Bit).
+// stuffTable[Zustand][Byte] = Stuff-Bits << 3 | Folgezustand
+uint8_t stuffTable[8][256];
+uint16_t crcTable[256];
+bool tablesReady = false;
+
+void buildTables() {
+    for (uint8_t state = 0; state < 8; state++) {
+        for (uint16_t value = 0; value < 256; value++) {
+            BitStuffer sim;
+            sim.last = state >> 2;
+            sim.run = (state & 0x03) + 1;
+            for (int8_t i = 7; i >= 0; i--) {
+                sim.push((value >> i) & 1);
+            }
+            stuffTable[state][value] = (sim.stuffBits << 3) | (sim.last << 2) | (sim.run - 1);
+        }
+    }
+    for (uint16_t value = 0; value < 256; value++) {
+        uint16_t crc = value << 7;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x4000) ? ((crc << 1) ^ 0x4599) : (crc << 1);
+        }
+        crcTable[value] = crc & 0x7FFF;
+    }
+    tablesReady = true;
+}
+
+void BitStuffer::pushByte(uint8_t value) {
+    crc = ((crc << 8) ^ crcTable[((crc >> 7) ^ value) & 0xFF]) & 0x7FFF;
+    uint8_t entry = stuffTable[(last << 2) | (run - 1)][value];
+    stuffBits += entry >> 3;
+    last = (entry >> 2) & 1;
+    run = (entry & 0x03) + 1;
+}
+
+}  // namespace
+
+// ===================================================================================
+// CANRateCounter
+// ===================================================================================
+
+void CANRateCounter::add(uint32_t w, uint32_t amount) {
+    if (w != window) {
+        if (w + 1 == window) {
+            previous += amount;  // Verspäteter Frame aus dem Fenster davor
+            return;
+        }
+        if ((int32_t)(w - window) < 0) {
+            w = window;          // Noch älter: dem laufenden Fenster zuschlagen
+        } else {
+            previous = (w == window + 1) ? current : 0;
+            current = 0;
+            window = w;
+        }
+    }
+    current += amount;
+}
+
+uint32_t CANRateCounter::lastComplete(uint32_t w) const {
+    if (w == window) {
+        return previous;
+    }
+    return (w == window + 1) ? current : 0;
+}
+
+// ===================================================================================
+// CANStatistics
+// ===================================================================================
+
+CANStatistics::CANStatistics() {
+    reset();
+}
+
+void CANStatistics::reset() {
+    windowEnd = 0;
+    windowIndex = 0;
+    rxCount = 0;
+    txCount = 0;
+    bitCount = 0;
+    untracked = 0;
+    memset(&bits, 0, sizeof(bits));
+    memset(&frames, 0, sizeof(frames));
+    peakBits = 0;
+    memset(ids, 0, sizeof(ids));
+    for (size_t i = 0; i < CAN_STATS_TABLE_SIZE; i++) {
+        ids[i].key = CAN_STATS_FREE;
+    }
+    idsUsed = 0;
+    memset(nodes, 0, sizeof(nodes));
+}
+
+uint16_t CANStatistics::frameBits(const CanFrame& frame) {
+    if (!tablesReady) {
+        buildTables();
+    }
+
+    uint8_t len = frame.len > 8 ? 8 : frame.len;
+    BitStuffer stuffer;
+
+    stuffer.pushBits(0, 1);                                  // SOF
+    if (frame.ext) {
+        stuffer.pushBits((frame.id >> 18) & 0x7FF, 11);      // Basis-ID
+        stuffer.pushBits(0x3, 2);                            // SRR, IDE
+        stuffer.pushBits(frame.id & 0x3FFFF, 18);            // ID-Erweiterung
+        stuffer.pushBits(0, 3);                              // RTR, r1, r0
+    } else {
+        stuffer.pushBits(frame.id & 0x7FF, 11);
+        stuffer.pushBits(0, 3);                              // RTR, IDE, r0
+    }
+    stuffer.pushBits(len, 4);                                // DLC
+    for (uint8_t i = 0; i < len; i++) {
+        stuffer.pushByte(frame.data[i]);
+    }
+    stuffer.pushCrc();
+
+    uint16_t stuffedFieldBits = (frame.ext ? 39 : 19) + 8 * len + 15;
+    // CRC-Delimiter, ACK-Slot, ACK-Delimiter, 7 Bit EOF, 3 Bit Intermission
+    return stuffedFieldBits + stuffer.stuffBits + 1 + 2 + 7 + 3;
+}
+
+uint32_t CANStatistics::windowAt(uint64_t timestampUs) const {
+    if (timestampUs < windowEnd) {
+        return (windowEnd - timestampUs > CAN_STATS_WINDOW_US) ? windowIndex - 1 : windowIndex;
+    }
+    return windowIndex + 1 + (uint32_t)((timestampUs - windowEnd) / CAN_STATS_WINDOW_US);
+}
+
+uint32_t CANStatistics::advanceWindow(uint64_t timestampUs) {
+    if (windowEnd == 0) {
+        // Erstes Fenster beginnt mit dem ersten Frame
+        windowEnd = timestampUs + CAN_STATS_WINDOW_US;
+        return windowIndex;
+    }
+    if (timestampUs >= windowEnd) {
+        uint32_t skipped = (uint32_t)((timestampUs - windowEnd) / CAN_STATS_WINDOW_US) + 1;
+        uint32_t completed = bits.lastComplete(windowIndex + 1);
+        if (completed > peakBits) {
+            peakBits = completed;
+        }
+        windowIndex += skipped;
+        windowEnd += (uint64_t)skipped * CAN_STATS_WINDOW_US;
+        return windowIndex;
+    }
+    return windowAt(timestampUs);
+}
+
+CANIdStatistics* CANStatistics::findOrInsert(uint32_t key) {
+    size_t slot = ((uint32_t)(key * 2654435761UL) >> 25) & (CAN_STATS_TABLE_SIZE - 1);
+    while (ids[slot].key != CAN_STATS_FREE) {
+        if (ids[slot].key == key) {
+            return &ids[slot];
+        }
+        slot = (slot + 1) & (CAN_STATS_TABLE_SIZE - 1);
+    }
+    if (idsUsed >= CAN_STATS_MAX_IDS) {
+        return nullptr;
+    }
+
+    CANIdStatistics& entry = ids[slot];
+    entry.key = key;
+    entry.minGap = UINT32_MAX;
+    idsUsed++;
+    return &entry;
+}
+
+void CANStatistics::recordFrame(const CanFrame& frame, bool transmitted, uint64_t timestampUs) {
+    uint32_t w = advanceWindow(timestampUs);
+    uint16_t frameLength = frameBits(frame);
+
+    if (transmitted) {
+        txCount++;
+    } else {
+        rxCount++;
+    }
+    bitCount += frameLength;
+    bits.add(w, frameLength);
+    frames.add(w, 1);
+
+    uint32_t key = frame.ext ? ((frame.id & 0x1FFFFFFF) | 0x80000000UL) : (frame.id & 0x7FF);
+    CANIdStatistics* entry = findOrInsert(key);
+    if (entry == nullptr) {
+        untracked++;
+    } else {
+        uint32_t now = (uint32_t)timestampUs;
+        if (entry->frames > 0) {
+            uint32_t gap = now - entry->lastSeen;
+            if (gap < entry->minGap) entry->minGap = gap;
+            if (gap > entry->maxGap) entry->maxGap = gap;
+            entry->gapSum += gap;
+            entry->gapCount++;
+        }
+        entry->lastSeen = now;
+        entry->frames++;
+        entry->rate.add(w, 1);
+    }
+
+    // CANopen-Node: Funktionscodes ab 0x080 mit Node-ID 1-127
+    if (!frame.ext && frame.id >= 0x080 && frame.id <= 0x7FF && (frame.id & 0x7F) != 0) {
+        NodeStatistics& node = nodes[frame.id & 0x7F];
+        node.frames++;
+        node.rate.add(w, 1);
+    }
+}
+
+uint16_t CANStatistics::busLoadPermille(uint64_t nowUs, uint32_t bitrate) const {
+    if (bitrate == 0) {
+        return 0;
+    }
+    uint64_t windowBits = (uint64_t)bitrate * CAN_STATS_WINDOW_US / 1000000;
+    uint32_t load = (uint32_t)((uint64_t)bits.lastComplete(windowAt(nowUs)) * 1000 / windowBits);
+    return load > 1000 ? 1000 : load;
+}
+
+uint16_t CANStatistics::peakLoadPermille(uint32_t bitrate) const {
+    if (bitrate == 0) {
+        return 0;
+    }
+    uint64_t windowBits = (uint64_t)bitrate * CAN_STATS_WINDOW_US / 1000000;
+    uint32_t load = (uint32_t)((uint64_t)peakBits * 1000 / windowBits);
+    return load > 1000 ? 1000 : load;
+}
+
+uint32_t CANStatistics::framesPerSecond(uint64_t nowUs) const {
+    return (uint32_t)((uint64_t)frames.lastComplete(windowAt(nowUs)) * 1000000 / CAN_STATS_WINDOW_US);
+}
+
+uint32_t CANStatistics::idRate(const CANIdStatistics& entry, uint64_t nowUs) const {
+    return (uint32_t)((uint64_t)entry.rate.lastComplete(windowAt(nowUs)) * 1000000 / CAN_STATS_WINDOW_US);
+}
+
+uint32_t CANStatistics::nodeRate(uint8_t node, uint64_t nowUs) const {
+    if (node >= CAN_STATS_NODES) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)nodes[node].rate.lastComplete(windowAt(nowUs)) * 1000000 / CAN_STATS_WINDOW_US);
+}
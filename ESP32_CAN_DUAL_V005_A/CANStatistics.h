@@ -0,0 +1,109 @@
+// CANStatistics.h
+// ===============================================================================
+// Busstatistik: Buslast, Frame-Raten und Empfangsabstände
+// Jeder empfangene und gesendete Frame wird mit recordFrame() gezählt. Die Buslast
+// beruht auf der exakten Bitlänge des Frames auf dem Bus (inklusive Stuff-Bits, CRC,
+// ACK, EOF und Intermission), die Raten auf Zählfenstern von CAN_STATS_WINDOW_US.
+//
+// Aufwand pro Frame konstant: Die Fenster werden erst beim nächsten Zugriff
+// weitergeschaltet (keine Schleife über alle Zähler), die Statistik je COB-ID liegt in
+// einer Hash-Tabelle mit offener Adressierung. Sind CAN_STATS_MAX_IDS IDs belegt,
+// zählen weitere nur noch in den Summen (untrackedFrames()).
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define CAN_STATS_WINDOW_US   1000000  // Zählfenster für Raten und Buslast (1 s)
+#define CAN_STATS_MAX_IDS     96       // Verfolgte COB-IDs
+#define CAN_STATS_TABLE_SIZE  128      // Hash-Tabelle (Zweierpotenz, > CAN_STATS_MAX_IDS)
+#define CAN_STATS_NODES       128
+
+// Zähler mit Fensterwechsel beim Zugriff
+struct CANRateCounter {
+    uint32_t window;    // Fenster, zu dem current gehört
+    uint32_t current;   // Summe im laufenden Fenster
+    uint32_t previous;  // Summe im Fenster davor
+
+    void add(uint32_t w, uint32_t amount);
+    uint32_t lastComplete(uint32_t w) const;  // Summe des letzten abgeschlossenen Fensters vor w
+};
+
+struct CANIdStatistics {
+    uint32_t key;        // ID, Bit 31 = Extended; CAN_STATS_FREE = unbelegt
+    uint32_t frames;     // Gesamtzahl
+    CANRateCounter rate;
+    uint32_t lastSeen;   // µs, untere 32 Bit
+    uint32_t minGap;     // Empfangsabstand in µs
+    uint32_t maxGap;
+    uint64_t gapSum;
+    uint32_t gapCount;
+
+    uint32_t id() const { return key & 0x7FFFFFFF; }
+    bool extended() const { return (key & 0x80000000UL) != 0; }
+    uint32_t averageGap() const { return gapCount > 0 ? (uint32_t)(gapSum / gapCount) : 0; }
+};
+
+class CANStatistics {
+public:
+    static const uint32_t CAN_STATS_FREE = 0xFFFFFFFF;
+
+    CANStatistics();
+
+    void reset();
+
+    // Frame zählen; timestampUs = Empfangszeit (Frame.timestamp) bzw. Sendezeit
+    void recordFrame(const CanFrame& frame, bool transmitted, uint64_t timestampUs);
+
+    // Exakte Länge auf dem Bus in Bit: SOF bis Intermission inklusive Stuff-Bits
+    static uint16_t frameBits(const CanFrame& frame);
+
+    // Werte des letzten abgeschlossenen Fensters zum Zeitpunkt nowUs
+    uint16_t busLoadPermille(uint64_t nowUs, uint32_t bitrate) const;
+    uint16_t peakLoadPermille(uint32_t bitrate) const;
+    uint32_t framesPerSecond(uint64_t nowUs) const;
+
+    uint32_t rxFrames() const { return rxCount; }
+    uint32_t txFrames() const { return txCount; }
+    uint64_t totalBits() const { return bitCount; }
+    uint32_t untrackedFrames() const { return untracked; }
+
+    // Statistik je COB-ID (Reihenfolge der Hash-Tabelle; unbelegte Plätze überspringen)
+    size_t idSlots() const { return CAN_STATS_TABLE_SIZE; }
+    const CANIdStatistics& idSlot(size_t index) const { return ids[index]; }
+    size_t idCount() const { return idsUsed; }
+    uint32_t idRate(const CANIdStatistics& entry, uint64_t nowUs) const;
+
+    // Frames je CANopen-Node (11-Bit-IDs ab 0x080 mit Node-ID 1-127)
+    uint32_t nodeFrames(uint8_t node) const { return node < CAN_STATS_NODES ? nodes[node].frames : 0; }
+    uint32_t nodeRate(uint8_t node, uint64_t nowUs) const;
+
+private:
+    struct NodeStatistics {
+        uint32_t frames;
+        CANRateCounter rate;
+    };
+
+    uint64_t windowEnd;     // Ende des laufenden Fensters in µs
+    uint32_t windowIndex;   // Nummer des laufenden Fensters
+
+    uint32_t rxCount;
+    uint32_t txCount;
+    uint64_t bitCount;
+    uint32_t untracked;
+
+    CANRateCounter bits;
+    CANRateCounter frames;
+    uint32_t peakBits;
+
+    CANIdStatistics ids[CAN_STATS_TABLE_SIZE];
+    size_t idsUsed;
+    NodeStatistics nodes[CAN_STATS_NODES];
+
+    uint32_t windowAt(uint64_t timestampUs) const;
+    uint32_t advanceWindow(uint64_t timestampUs);
+    CANIdStatistics* findOrInsert(uint32_t key);
+};
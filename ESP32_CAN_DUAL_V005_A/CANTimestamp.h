@@ -0,0 +1,26 @@
+// CANTimestamp.h
+// ===============================================================================
+// Gemeinsame Zeitbasis für Empfangszeitstempel (Mikrosekunden seit dem Start)
+// Auf dem ESP32 esp_timer_get_time() (64 Bit, auch aus ISRs nutzbar), auf einem
+// Host platformMicros64() (CLOCK_MONOTONIC bzw. die simulierte Zeit der Benchmarks).
+// Im Gegensatz zu millis() reicht die Auflösung für Heartbeat-Jitter,
+// SDO-Antwortzeiten und PDO-Zykluszeiten.
+// ===============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(ESP32) || defined(ESP_PLATFORM)
+#include "esp_timer.h"
+
+static inline uint64_t canTimestampUs() {
+    return (uint64_t)esp_timer_get_time();
+}
+#else
+#include "Platform.h"  // host/
+
+static inline uint64_t canTimestampUs() {
+    return platformMicros64();
+}
+#endif
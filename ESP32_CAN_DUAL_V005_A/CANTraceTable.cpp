@@ -0,0 +1,102 @@
+// CANTraceTable.cpp
+// ===============================================================================
+// Implementation der Trace-Tabelle für den Live-Monitor
+// ===============================================================================
+
+#include "CANTraceTable.h"
+#include <string.h>
+
+CANTraceTable::CANTraceTable() : changes(0) {
+    clear();
+}
+
+void CANTraceTable::clear() {
+    rows = 0;
+    memset(standardIndex, 0, sizeof(standardIndex));
+    memset(extendedIndex, 0, sizeof(extendedIndex));
+    changes++;
+    untracked = 0;
+}
+
+CANTraceRow* CANTraceTable::findOrInsert(const CanFrame& frame) {
+    uint8_t* slot;
+    if (frame.ext) {
+        // Lineares Sondieren; höchstens CAN_TRACE_MAX_ROWS Einträge, also immer ein freier Platz
+        uint32_t id = frame.id & 0x1FFFFFFF;
+        size_t index = ((uint32_t)(id * 2654435761UL) >> 25) & (CAN_TRACE_EXT_SLOTS - 1);
+        while (extendedIndex[index] != 0) {
+            CANTraceRow& candidate = table[extendedIndex[index] - 1];
+            if (candidate.id == id) {
+                return &candidate;
+            }
+            index = (index + 1) & (CAN_TRACE_EXT_SLOTS - 1);
+        }
+        slot = &extendedIndex[index];
+    } else {
+        slot = &standardIndex[frame.id & 0x7FF];
+        if (*slot != 0) {
+            return &table[*slot - 1];
+        }
+    }
+
+    if (rows >= CAN_TRACE_MAX_ROWS) {
+        return nullptr;
+    }
+
+    CANTraceRow& row = table[rows];
+    memset(&row, 0, sizeof(row));
+    row.id = frame.ext ? (frame.id & 0x1FFFFFFF) : (frame.id & 0x7FF);
+    row.ext = frame.ext;
+    *slot = ++rows;
+    return &row;
+}
+
+bool CANTraceTable::update(const CanFrame& frame) {
+    CANTraceRow* row = findOrInsert(frame);
+    if (row == nullptr) {
+        untracked++;
+        return false;
+    }
+
+    uint8_t len = frame.len > 8 ? 8 : frame.len;
+    if (row->count > 0) {
+        row->period = (uint32_t)(frame.timestamp - row->lastSeen);
+
+        // Geänderte Bytes (auch eine geänderte Länge) sammeln, solange die Markierung läuft
+        uint8_t diff = 0;
+        for (uint8_t i = 0; i < 8; i++) {
+            if ((i < len) != (i < row->len) || (i < len && frame.data[i] != row->data[i])) {
+                diff |= 1 << i;
+            }
+        }
+        if (diff != 0) {
+            row->changedMask = row->highlighted(frame.timestamp) | diff;
+            row->changedAt = frame.timestamp;
+        }
+    }
+
+    row->len = len;
+    memcpy(row->data, frame.data, len);
+    row->lastSeen = frame.timestamp;
+    row->count++;
+    changes++;
+    return true;
+}
+
+size_t CANTraceTable::sortedRows(uint8_t* order) const {
+    // Einfügesortierung über höchstens CAN_TRACE_MAX_ROWS Zeilen, nur beim Zeichnen
+    for (size_t i = 0; i < rows; i++) {
+        uint64_t key = ((uint64_t)table[i].ext << 32) | table[i].id;
+        size_t pos = i;
+        while (pos > 0) {
+            const CANTraceRow& previous = table[order[pos - 1]];
+            if ((((uint64_t)previous.ext << 32) | previous.id) <= key) {
+                break;
+            }
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+    return rows;
+}
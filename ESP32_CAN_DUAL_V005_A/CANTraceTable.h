@@ -0,0 +1,72 @@
+// CANTraceTable.h
+// ===============================================================================
+// Trace-Tabelle für den Live-Monitor: eine Zeile je COB-ID mit den letzten Daten
+// Statt jeden Frame einzeln anzuzeigen, merkt sich die Tabelle pro ID die letzten
+// Daten, die Anzahl, die Periode (Abstand der letzten beiden Frames) und welche Bytes
+// sich zuletzt geändert haben. Die Anzeige zeichnet die Tabelle mit fester Rate neu,
+// unabhängig davon, wie viele Frames auf dem Bus sind.
+//
+// update() kostet einen Array-Zugriff: 11-Bit-IDs werden direkt über eine Indextabelle
+// (2048 Byte) auf ihre Zeile abgebildet, Extended-IDs über eine kleine Hash-Tabelle.
+// Sind alle CAN_TRACE_MAX_ROWS Zeilen belegt, werden neue IDs nur gezählt.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "CanFrame.h"
+
+#define CAN_TRACE_MAX_ROWS        64       // Zeilen (verschiedene COB-IDs)
+#define CAN_TRACE_EXT_SLOTS       128      // Hash-Tabelle für Extended-IDs (Zweierpotenz, > MAX_ROWS)
+#define CAN_TRACE_HIGHLIGHT_US    1000000  // So lange gelten geänderte Bytes als neu
+
+struct CANTraceRow {
+    uint32_t id;
+    bool ext;
+    uint8_t len;
+    uint8_t data[8];
+    uint8_t changedMask;   // Bit n = Byte n hat sich innerhalb von CAN_TRACE_HIGHLIGHT_US geändert
+    uint32_t count;
+    uint32_t period;       // Abstand der letzten beiden Frames in µs (0 = erst ein Frame)
+    uint64_t lastSeen;     // Zeitstempel des letzten Frames in µs
+    uint64_t changedAt;    // Zeitpunkt der letzten Datenänderung in µs
+
+    // Geänderte Bytes zum Zeitpunkt nowUs (0, sobald die Markierung abgelaufen ist)
+    uint8_t highlighted(uint64_t nowUs) const {
+        return (nowUs - changedAt < CAN_TRACE_HIGHLIGHT_US) ? changedMask : 0;
+    }
+};
+
+class CANTraceTable {
+public:
+    CANTraceTable();
+
+    void clear();
+
+    // Frame übernehmen; false = Tabelle voll, ID nicht erfasst
+    bool update(const CanFrame& frame);
+
+    size_t rowCount() const { return rows; }
+    const CANTraceRow& row(size_t index) const { return table[index]; }
+
+    // Zeilenindizes nach ID sortiert (Standard- vor Extended-IDs); liefert die Anzahl
+    size_t sortedRows(uint8_t* order) const;
+
+    // Wird bei jeder Änderung erhöht; die Anzeige zeichnet nur bei neuem Stand neu
+    uint32_t version() const { return changes; }
+
+    uint32_t untrackedFrames() const { return untracked; }
+
+private:
+    CANTraceRow table[CAN_TRACE_MAX_ROWS];
+    size_t rows;
+
+    uint8_t standardIndex[2048];             // Zeile + 1 je 11-Bit-ID, 0 = keine
+    uint8_t extendedIndex[CAN_TRACE_EXT_SLOTS];
+
+    uint32_t changes;
+    uint32_t untracked;
+
+    CANTraceRow* findOrInsert(const CanFrame& frame);
+};
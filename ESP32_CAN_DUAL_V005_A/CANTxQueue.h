@@ -0,0 +1,142 @@
+// CANTxQueue.h
+// ===============================================================================
+// Software-Sendewarteschlange (Header-only)
+// Binärer Heap fester Größe, sortiert nach Arbitrierungspriorität der CAN-ID:
+// Die Frames verlassen die Queue in der Reihenfolge, in der sie auch die
+// Arbitrierung auf dem Bus gewinnen würden. Gleiche IDs bleiben in FIFO-Reihenfolge.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+template <typename Entry, size_t Capacity>
+class CANTxQueue {
+public:
+    CANTxQueue() : count(0), nextSeq(0) {}
+
+    // Arbitrierungsschlüssel: kleiner = höhere Priorität.
+    // Basis-ID (11 Bit) zuerst; bei gleicher Basis-ID gewinnt der Standard-Frame
+    // (dominantes RTR/IDE) gegen den Extended-Frame (rezessives SRR/IDE).
+    static uint32_t arbitrationKey(uint32_t id, uint8_t ext) {
+        if (!ext) {
+            return (id & 0x7FF) << 20;
+        }
+        return (((id >> 18) & 0x7FF) << 20) | (3UL << 18) | (id & 0x3FFFF);
+    }
+
+    bool push(const Entry& entry, uint32_t key) {
+        if (count >= Capacity) {
+            return false;
+        }
+        size_t i = count++;
+        slots[i].entry = entry;
+        slots[i].key = key;
+        slots[i].seq = nextSeq++;
+        siftUp(i);
+        return true;
+    }
+
+    // Frame mit der höchsten Priorität, ohne ihn zu entfernen
+    const Entry& top() const {
+        return slots[0].entry;
+    }
+
+    void pop() {
+        if (count == 0) {
+            return;
+        }
+        slots[0] = slots[--count];
+        siftDown(0);
+    }
+
+    bool empty() const {
+        return count == 0;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    static constexpr size_t capacity() {
+        return Capacity;
+    }
+
+    void clear() {
+        count = 0;
+    }
+
+    // Ersten Eintrag entfernen, auf den match(entry) zutrifft (z.B. einen einzelnen
+    // zurückgezogenen Auftrag); die übrigen behalten ihre Reihenfolge
+    template <typename Match>
+    bool removeFirst(Match match) {
+        for (size_t i = 0; i < count; i++) {
+            if (!match(slots[i].entry)) {
+                continue;
+            }
+            slots[i] = slots[--count];
+            if (i < count) {
+                if (i > 0 && before(slots[i], slots[(i - 1) / 2])) {
+                    siftUp(i);
+                } else {
+                    siftDown(i);
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Slot {
+        Entry entry;
+        uint32_t key;
+        uint32_t seq;  // Einfügereihenfolge für gleiche Schlüssel
+    };
+
+    Slot slots[Capacity];
+    size_t count;
+    uint32_t nextSeq;
+
+    bool before(const Slot& a, const Slot& b) const {
+        if (a.key != b.key) {
+            return a.key < b.key;
+        }
+        return (int32_t)(a.seq - b.seq) < 0;
+    }
+
+    void siftUp(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!before(slots[i], slots[parent])) {
+                break;
+            }
+            Slot tmp = slots[i];
+            slots[i] = slots[parent];
+            slots[parent] = tmp;
+            i = parent;
+        }
+    }
+
+    void siftDown(size_t i) {
+        while (true) {
+            size_t left = 2 * i + 1;
+            size_t right = left + 1;
+            size_t best = i;
+            if (left < count && before(slots[left], slots[best])) {
+                best = left;
+            }
+            if (right < count && before(slots[right], slots[best])) {
+                best = right;
+            }
+            if (best == i) {
+                break;
+            }
+            Slot tmp = slots[i];
+            slots[i] = slots[best];
+            slots[best] = tmp;
+            i = best;
+        }
+    }
+};
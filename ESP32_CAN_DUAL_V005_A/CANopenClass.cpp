@@ -9,18 +9,25 @@
 
 // Konstruktor mit Interface
 CANopen::CANopen(CANInterface* interface) : _intPin(0), _interface(interface) {
+    initSDOClient();
 }
 
 // Konstruktor mit intPin (für Kompatibilität)
 CANopen::CANopen(uint8_t intPin) : _intPin(intPin), _interface(nullptr) {
+    initSDOClient();
 }
 
 // Standardkonstruktor (für Kompatibilität)
 CANopen::CANopen() : _intPin(0), _interface(nullptr) {
+    initSDOClient();
 }
 
 // Interface setzen
 void CANopen::setCANInterface(CANInterface* interface) {
+    // Laufende Transfers gehören zum alten Interface
+    for (uint8_t nodeId = 1; nodeId < SDO_CLIENT_SLOTS; nodeId++) {
+        cancelSDO(nodeId);
+    }
     _interface = interface;
 }
 
@@ -69,6 +76,7 @@ bool CANopen::sendSync() {
 // ===================================================================================
 // Methode: readSDO
 // Beschreibung: Liest ein Objekt über SDO (SDO Upload Request)
+// Blockierend auf Basis des asynchronen Clients; fremde Frames gehen an den Frame-Handler.
 // ===================================================================================
 bool CANopen::readSDO(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t &value, uint32_t timeout) {
     // Prüfen, ob ein gültiges Interface vorhanden ist
@@ -77,129 +85,43 @@ bool CANopen::readSDO(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t
         return false;
     }
     
-    uint8_t request[8] = {
-        0x40,
-        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
-        subIndex,
-        0, 0, 0, 0
-    };
+    Serial.printf("[DEBUG] Sende SDO Read Request an Node %d: 0x%04X:%02X\n", nodeId, index, subIndex);
     
-    // Debug-Ausgabe hinzugefügt
-    Serial.print("[DEBUG] Sende SDO Read Request: ");
-    for (int i = 0; i < 8; i++) {
-        Serial.printf("%02X ", request[i]);
+    SDOFuture future;
+    if (!readSDOAsync(nodeId, index, subIndex, &future, timeout)) {
+        Serial.printf("[FEHLER] SDO-Anfrage an Node %d nicht möglich (Transfer aktiv oder Sendequeue voll)\n", nodeId);
+        return false;
     }
-    Serial.println();
     
-    // Anfrage senden
-    _interface->sendMessage(COB_ID_RSDO_BASE + nodeId, 0, 8, request);
-
-    // Auf Antwort warten
-    unsigned long start = millis();
-    while (millis() - start < timeout) {
-        if (_interface->messageAvailable()) {
-            uint32_t id;
-            uint8_t ext;
-            uint8_t len;
-            uint8_t buf[8];
-            
-            if (_interface->receiveMessage(&id, &ext, &len, buf)) {
-                // Debug-Ausgabe hinzugefügt
-                Serial.printf("[DEBUG] Empfangene Antwort von ID 0x%lX: ", id);
-                for (int i = 0; i < len; i++) {
-                    Serial.printf("%02X ", buf[i]);
-                }
-                Serial.println();
-                
-                if (id == (COB_ID_TSDO_BASE + nodeId)) {
-                    if ((buf[0] & 0xE0) == 0x80) {
-                        // Dies ist ein SDO Abort
-                        uint32_t abortCode = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (buf[7] << 24);
-                        Serial.printf("[FEHLER] SDO Abort Code: 0x%08X\n", abortCode);
-                        return false;
-                    } else if ((buf[0] & 0xE0) != 0x80) {
-                        value = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (buf[7] << 24);
-                        return true;
-                    }
-                }
-            }
-        }
+    switch (waitForSDO(future)) {
+        case SDO_RESULT_OK:
+            Serial.printf("[DEBUG] SDO-Antwort von Node %d: 0x%08X\n", nodeId, future.value);
+            value = future.value;
+            return true;
+        case SDO_RESULT_ABORT:
+            Serial.printf("[FEHLER] SDO Abort Code: 0x%08X\n", future.abortCode);
+            return false;
+        case SDO_RESULT_TIMEOUT:
+            Serial.println("[FEHLER] SDO Timeout bei Leseanfrage");
+            return false;
+        default:
+            Serial.printf("[FEHLER] SDO-Leseanfrage fehlgeschlagen: %s\n", sdoResultName(future.result));
+            return false;
     }
-    Serial.println("[FEHLER] SDO Timeout bei Leseanfrage");
-    return false;
 }
 
 // ===================================================================================
 // Methode: writeSDO
 // Beschreibung: Schreibt ein Objekt über SDO (SDO Download Request)
-// ÄNDERUNG: Verbesserte Fehlerbehandlung und Debugausgaben hinzugefügt
 // ===================================================================================
 bool CANopen::writeSDO(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size) {
-    // Prüfen, ob ein gültiges Interface vorhanden ist
-    if (_interface == nullptr) {
-        Serial.println("[FEHLER] Kein CAN-Interface gesetzt");
-        return false;
-    }
-    
-    uint8_t command = 0x23 | ((4 - size) << 2); // SDO Command Specifier
-    uint8_t data[8] = {
-        command,
-        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
-        subIndex,
-        (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF), (uint8_t)((value >> 24) & 0xFF)
-    };
-    
-    // Debug-Ausgabe hinzugefügt
-    Serial.print("[DEBUG] Sende SDO Write Request: ");
-    for (int i = 0; i < 8; i++) {
-        Serial.printf("%02X ", data[i]);
-    }
-    Serial.println();
-    
-    // Nachricht senden
-    if (!_interface->sendMessage(COB_ID_RSDO_BASE + nodeId, 0, 8, data)) {
-        Serial.println("[FEHLER] CAN-Nachricht konnte nicht gesendet werden");
-        return false;
-    }
-
-    // Auf Antwort warten mit verbesserter Fehlerbehandlung
-    unsigned long start = millis();
-    while (millis() - start < 1000) {
-        if (_interface->messageAvailable()) {
-            uint32_t id;
-            uint8_t ext;
-            uint8_t len;
-            uint8_t buf[8];
-            
-            if (_interface->receiveMessage(&id, &ext, &len, buf)) {
-                // Debug-Ausgabe hinzugefügt
-                Serial.printf("[DEBUG] Empfangene Antwort von ID 0x%lX: ", id);
-                for (int i = 0; i < len; i++) {
-                    Serial.printf("%02X ", buf[i]);
-                }
-                Serial.println();
-                
-                if (id == (COB_ID_TSDO_BASE + nodeId)) {
-                    if ((buf[0] & 0xE0) == 0x80) {
-                        // Dies ist ein SDO Abort
-                        uint32_t abortCode = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (buf[7] << 24);
-                        Serial.printf("[FEHLER] SDO Abort Code: 0x%08X\n", abortCode);
-                        return false;
-                    } else if ((buf[0] & 0xE0) != 0x80) {
-                        return true;
-                    }
-                }
-            }
-        }
-    }
-    Serial.println("[FEHLER] SDO Timeout bei Schreibanfrage");
-    return false;
+    return writeSDOWithTimeout(nodeId, index, subIndex, value, size, SDO_DEFAULT_TIMEOUT_MS);
 }
 
 // ===================================================================================
 // Methode: writeSDOWithTimeout
 // Beschreibung: Schreibt ein Objekt über SDO mit anpassbarem Timeout
+// Blockierend auf Basis des asynchronen Clients; fremde Frames gehen an den Frame-Handler.
 // ===================================================================================
 bool CANopen::writeSDOWithTimeout(uint8_t nodeId, uint16_t index, uint8_t subIndex, 
                                uint32_t value, uint8_t size, uint32_t timeout) {
@@ -209,61 +131,30 @@ bool CANopen::writeSDOWithTimeout(uint8_t nodeId, uint16_t index, uint8_t subInd
         return false;
     }
     
-    uint8_t command = 0x23 | ((4 - size) << 2); // SDO Command Specifier
-    uint8_t data[8] = {
-        command,
-        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
-        subIndex,
-        (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF),
-        (uint8_t)((value >> 16) & 0xFF), (uint8_t)((value >> 24) & 0xFF)
-    };
-    
-    // Debug-Ausgabe
-    Serial.print("[DEBUG] Sende SDO Write Request: ");
-    for (int i = 0; i < 8; i++) {
-        Serial.printf("%02X ", data[i]);
-    }
-    Serial.println();
+    Serial.printf("[DEBUG] Sende SDO Write Request an Node %d: 0x%04X:%02X = 0x%08X (%d Byte)\n",
+                  nodeId, index, subIndex, value, size);
     
-    // Nachricht senden
-    if (!_interface->sendMessage(COB_ID_RSDO_BASE + nodeId, 0, 8, data)) {
-        Serial.println("[FEHLER] CAN-Nachricht konnte nicht gesendet werden");
+    SDOFuture future;
+    if (!writeSDOAsync(nodeId, index, subIndex, value, size, &future, timeout)) {
+        Serial.printf("[FEHLER] SDO-Anfrage an Node %d nicht möglich (Transfer aktiv oder Sendequeue voll)\n", nodeId);
         return false;
     }
-
-    // Auf Antwort warten mit anpassbarem Timeout
-    unsigned long start = millis();
-    while (millis() - start < timeout) {
-        if (_interface->messageAvailable()) {
-            uint32_t id;
-            uint8_t ext;
-            uint8_t len;
-            uint8_t buf[8];
-            
-            if (_interface->receiveMessage(&id, &ext, &len, buf)) {
-                // Debug-Ausgabe
-                Serial.printf("[DEBUG] Empfangene Antwort von ID 0x%lX: ", id);
-                for (int i = 0; i < len; i++) {
-                    Serial.printf("%02X ", buf[i]);
-                }
-                Serial.println();
-                
-                if (id == (COB_ID_TSDO_BASE + nodeId)) {
-                    if ((buf[0] & 0xE0) == 0x80) {
-                        // Dies ist ein SDO Abort
-                        uint32_t abortCode = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (buf[7] << 24);
-                        Serial.printf("[FEHLER] SDO Abort Code: 0x%08X\n", abortCode);
-                        return false;
-                    } else if ((buf[0] & 0xE0) != 0x80) {
-                        return true;
-                    }
-                }
-            }
-        }
+    
+    switch (waitForSDO(future)) {
+        case SDO_RESULT_OK:
+            return true;
+        case SDO_RESULT_ABORT:
+            Serial.printf("[FEHLER] SDO Abort Code: 0x%08X\n", future.abortCode);
+            return false;
+        case SDO_RESULT_TIMEOUT:
+            Serial.println("[FEHLER] SDO Timeout bei Schreibanfrage");
+            return false;
+        default:
+            Serial.printf("[FEHLER] SDO-Schreibanfrage fehlgeschlagen: %s\n", sdoResultName(future.result));
+            return false;
     }
-    Serial.println("[FEHLER] SDO Timeout bei Schreibanfrage");
-    return false;
 }
+
 // ===================================================================================
 // Methode: changeNodeId
 // Beschreibung:
@@ -344,28 +235,812 @@ bool CANopen::changeNodeId(uint8_t oldId, uint8_t newId, bool storeInEeprom, uin
     // Auf neuen Heartbeat warten
     unsigned long start = millis();
     while (millis() - start < timeout) {
-        if (_interface->messageAvailable()) {
-            uint32_t id;
-            uint8_t ext;
-            uint8_t len;
-            uint8_t buf[8];
+        _interface->serviceTx();
+        
+        CanFrame frames[CAN_RX_BURST_SIZE];
+        size_t count = _interface->receiveBurst(frames, CAN_RX_BURST_SIZE, 1000);
+        for (size_t i = 0; i < count; i++) {
+            CanFrame& frame = frames[i];
             
-            if (_interface->receiveMessage(&id, &ext, &len, buf)) {
-                // Debug-Ausgabe für alle empfangenen Nachrichten
-                Serial.printf("[DEBUG] Empfangene Nachricht ID 0x%lX: ", id);
-                for (int i = 0; i < len; i++) {
-                    Serial.printf("%02X ", buf[i]);
-                }
-                Serial.println();
-                
-                if ((id & 0x780) == COB_ID_HB_BASE && (id & 0x7F) == newId) {
-                    Serial.printf("[OK] Neue Node-ID %d antwortet.\n", newId);
-                    return true;
-                }
+            // Debug-Ausgabe für alle empfangenen Nachrichten
+            Serial.printf("[DEBUG] Empfangene Nachricht ID 0x%lX: ", frame.id);
+            for (int b = 0; b < frame.len; b++) {
+                Serial.printf("%02X ", frame.data[b]);
+            }
+            Serial.println();
+            
+            if ((frame.id & 0x780) == COB_ID_HB_BASE && (frame.id & 0x7F) == newId) {
+                Serial.printf("[OK] Neue Node-ID %d antwortet.\n", newId);
+                return true;
+            }
+            
+            // Andere Frames weiterreichen (laufende Transfers, Live-Monitor)
+            if (!processFrame(frame) && _frameHandler != nullptr) {
+                _frameHandler(frame);
             }
         }
+        tick();
     }
 
     Serial.println("[FEHLER] Neue Node-ID antwortet nicht.");
     return false;
-}
\ No newline at end of file
+}
+
+// ===================================================================================
+// Asynchroner SDO-Client
+// Jeder Server-Node hat einen eigenen Slot (Index = Node-ID). Anfragen gehen über die
+// Sendequeue des Interfaces, Antworten kommen über processFrame(), Timeouts über tick().
+// Der Slot ist bereits wieder frei, wenn der Callback aufgerufen wird; ein Callback
+// kann also direkt den nächsten Transfer zum selben Node starten.
+// ===================================================================================
+void CANopen::initSDOClient() {
+    memset(_sdoSlots, 0, sizeof(_sdoSlots));
+    _activeTransfers = 0;
+    _frameHandler = nullptr;
+}
+
+void CANopen::setFrameHandler(CANFrameHandler handler) {
+    _frameHandler = handler;
+}
+
+bool CANopen::readSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                           SDOCallback callback, void* context, uint32_t timeout) {
+    uint8_t request[8] = {
+        0x40,
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        subIndex,
+        0, 0, 0, 0
+    };
+    return startSDO(nodeId, SDO_SLOT_UPLOAD, index, subIndex, request, timeout, callback, context, nullptr);
+}
+
+bool CANopen::readSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                           SDOFuture* future, uint32_t timeout) {
+    uint8_t request[8] = {
+        0x40,
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        subIndex,
+        0, 0, 0, 0
+    };
+    return startSDO(nodeId, SDO_SLOT_UPLOAD, index, subIndex, request, timeout, nullptr, nullptr, future);
+}
+
+bool CANopen::writeSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size,
+                            SDOCallback callback, void* context, uint32_t timeout) {
+    if (size < 1 || size > 4) {
+        return false;
+    }
+    uint8_t request[8] = {
+        (uint8_t)(0x23 | ((4 - size) << 2)),  // Expedited Download mit Größenangabe
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        subIndex,
+        (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF),
+        (uint8_t)((value >> 16) & 0xFF), (uint8_t)((value >> 24) & 0xFF)
+    };
+    return startSDO(nodeId, SDO_SLOT_DOWNLOAD, index, subIndex, request, timeout, callback, context, nullptr);
+}
+
+bool CANopen::writeSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size,
+                            SDOFuture* future, uint32_t timeout) {
+    if (size < 1 || size > 4) {
+        return false;
+    }
+    uint8_t request[8] = {
+        (uint8_t)(0x23 | ((4 - size) << 2)),  // Expedited Download mit Größenangabe
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        subIndex,
+        (uint8_t)(value & 0xFF), (uint8_t)((value >> 8) & 0xFF),
+        (uint8_t)((value >> 16) & 0xFF), (uint8_t)((value >> 24) & 0xFF)
+    };
+    return startSDO(nodeId, SDO_SLOT_DOWNLOAD, index, subIndex, request, timeout, nullptr, nullptr, future);
+}
+
+bool CANopen::startSDO(uint8_t nodeId, SDOSlotState state, uint16_t index, uint8_t subIndex,
+                       const uint8_t* request, uint32_t timeout,
+                       SDOCallback callback, void* context, SDOFuture* future) {
+    if (_interface == nullptr || nodeId == 0 || nodeId >= SDO_CLIENT_SLOTS) {
+        return false;
+    }
+
+    SDOSlot& slot = _sdoSlots[nodeId];
+    if (slot.state != SDO_SLOT_IDLE) {
+        return false;
+    }
+
+    CanFrame frame;
+    frame.id = COB_ID_RSDO_BASE + nodeId;
+    frame.ext = 0;
+    frame.len = 8;
+    memcpy(frame.data, request, 8);
+
+    // Slot vor dem Einreihen belegen: der Sende-Callback kann ihn bereits betreffen
+    slot.state = state;
+    slot.index = index;
+    slot.subIndex = subIndex;
+    slot.deadline = millis() + timeout;
+    slot.callback = callback;
+    slot.context = context;
+    slot.future = future;
+    slot.timeout = timeout;
+    slot.rxBuffer = nullptr;
+    slot.txData = nullptr;
+    slot.size = 0;
+    slot.pos = 0;
+    slot.blockStart = 0;
+    slot.toggle = 0;
+    slot.seqNo = 0;
+    slot.blockSize = 0;
+    slot.txInFlight = 0;
+    slot.crc = false;
+    slot.lastSeen = false;
+    if (future != nullptr) {
+        future->done = false;
+        future->result = SDO_RESULT_OK;
+        future->value = 0;
+        future->abortCode = 0;
+    }
+    _activeTransfers++;
+
+    if (!_interface->enqueueTx(frame, onSDOTxComplete, this)) {
+        slot.state = SDO_SLOT_IDLE;
+        _activeTransfers--;
+        return false;
+    }
+    return true;
+}
+
+bool CANopen::processFrame(const CanFrame& frame) {
+    if (_activeTransfers == 0 || frame.ext || (frame.id & 0x780) != COB_ID_TSDO_BASE) {
+        return false;
+    }
+
+    uint8_t nodeId = frame.id & 0x7F;
+    SDOSlot& slot = _sdoSlots[nodeId];
+    if (slot.state == SDO_SLOT_IDLE || frame.len < 1) {
+        return false;
+    }
+
+    uint8_t cs = frame.data[0];
+    bool initiate = slot.state == SDO_SLOT_UPLOAD || slot.state == SDO_SLOT_DOWNLOAD ||
+                    slot.state == SDO_SLOT_BLOCK_UPLOAD_INIT || slot.state == SDO_SLOT_BLOCK_DOWNLOAD_INIT;
+
+    // Beim Block-Upload sind 0x81..0xFF gültige Segmente (Endekennung + Sequenznummer)
+    bool isAbort = (slot.state == SDO_SLOT_BLOCK_UPLOAD) ? cs == 0x80 : (cs & 0xE0) == 0x80;
+
+    // Initiate-Antworten und Aborts in dieser Phase müssen zum angefragten Objekt gehören
+    if (initiate) {
+        if (frame.len < 4) {
+            return false;
+        }
+        uint16_t index = frame.data[1] | (frame.data[2] << 8);
+        if (index != slot.index || frame.data[3] != slot.subIndex) {
+            return false;
+        }
+    }
+
+    uint32_t payload = frame.data[4] | (frame.data[5] << 8) | (frame.data[6] << 16) | ((uint32_t)frame.data[7] << 24);
+
+    // SDO Abort
+    if (isAbort) {
+        finishSDO(nodeId, SDO_RESULT_ABORT, payload);
+        return true;
+    }
+
+    slot.deadline = millis() + slot.timeout;
+
+    switch (slot.state) {
+        case SDO_SLOT_UPLOAD:
+            // Initiate Upload Response
+            if ((cs & 0xE0) != 0x40) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+            } else if (cs & 0x02) {
+                // Expedited: n = Anzahl ungenutzter Bytes (falls angegeben)
+                uint8_t bytes = (cs & 0x01) ? 4 - ((cs >> 2) & 0x03) : 4;
+                if (slot.rxBuffer == nullptr) {
+                    if (bytes < 4) {
+                        payload &= 0xFFFFFFFFUL >> (8 * (4 - bytes));
+                    }
+                    finishSDO(nodeId, SDO_RESULT_OK, payload);
+                } else if (bytes > slot.size) {
+                    finishSDO(nodeId, SDO_RESULT_PROTOCOL, SDO_ABORT_OUT_OF_MEMORY);
+                } else {
+                    memcpy(slot.rxBuffer, &frame.data[4], bytes);
+                    finishSDO(nodeId, SDO_RESULT_OK, bytes);
+                }
+            } else if (slot.rxBuffer == nullptr || ((cs & 0x01) && payload > slot.size)) {
+                // Segmentiert, passt aber nicht in den Wert bzw. Puffer
+                abortSDO(nodeId, SDO_ABORT_OUT_OF_MEMORY);
+            } else {
+                // Segmentierter Upload: erstes Segment anfordern
+                uint8_t request[8] = {0x60, 0, 0, 0, 0, 0, 0, 0};
+                slot.state = SDO_SLOT_UPLOAD_SEGMENT;
+                if (!sendSDOFrame(nodeId, request)) {
+                    finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+                }
+            }
+            break;
+
+        case SDO_SLOT_DOWNLOAD:
+            // Initiate Download Response
+            if ((cs & 0xE0) != 0x60) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+            } else if (slot.txData != nullptr && slot.size > 4) {
+                slot.state = SDO_SLOT_DOWNLOAD_SEGMENT;
+                sendDownloadSegment(nodeId);
+            } else {
+                finishSDO(nodeId, SDO_RESULT_OK, slot.txData != nullptr ? slot.size : 0);
+            }
+            break;
+
+        case SDO_SLOT_BLOCK_UPLOAD_INIT: {
+            // Initiate Block Upload Response: scs=6, sc, s, ss=0
+            if ((cs & 0xE1) != 0xC0) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                break;
+            }
+            if ((cs & 0x02) && payload > slot.size) {
+                abortSDO(nodeId, SDO_ABORT_OUT_OF_MEMORY);
+                break;
+            }
+            uint8_t request[8] = {0xA3, 0, 0, 0, 0, 0, 0, 0};  // Start Upload
+            slot.crc = (cs & 0x04) != 0;
+            slot.blockSize = SDO_BLOCK_SIZE;
+            slot.state = SDO_SLOT_BLOCK_UPLOAD;
+            if (!sendSDOFrame(nodeId, request)) {
+                finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+            }
+            break;
+        }
+
+        case SDO_SLOT_BLOCK_DOWNLOAD_INIT:
+            // Initiate Block Download Response: scs=5, ss=0, Byte 4 = Blockgröße
+            if ((cs & 0xE3) != 0xA0 || frame.data[4] < 1 || frame.data[4] > 127) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                break;
+            }
+            slot.crc = (cs & 0x04) != 0;
+            slot.blockSize = frame.data[4];
+            slot.state = SDO_SLOT_BLOCK_DOWNLOAD;
+            pumpBlockDownload(nodeId);
+            break;
+
+        default:
+            processSegmentFrame(nodeId, frame);
+            break;
+    }
+    return true;
+}
+
+// Frames nach der Initiate-Phase (ohne Multiplexer)
+void CANopen::processSegmentFrame(uint8_t nodeId, const CanFrame& frame) {
+    SDOSlot& slot = _sdoSlots[nodeId];
+    uint8_t cs = frame.data[0];
+
+    switch (slot.state) {
+        case SDO_SLOT_UPLOAD_SEGMENT: {
+            // Upload Segment Response: scs=0, t, n (ungenutzte Bytes), c (letztes Segment)
+            if ((cs & 0xE0) != 0x00) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                return;
+            }
+            if (((cs >> 4) & 0x01) != slot.toggle) {
+                abortSDO(nodeId, SDO_ABORT_TOGGLE);
+                return;
+            }
+            uint8_t bytes = 7 - ((cs >> 1) & 0x07);
+            if (slot.pos + bytes > slot.size) {
+                abortSDO(nodeId, SDO_ABORT_OUT_OF_MEMORY);
+                return;
+            }
+            memcpy(slot.rxBuffer + slot.pos, &frame.data[1], bytes);
+            slot.pos += bytes;
+
+            if (cs & 0x01) {
+                finishSDO(nodeId, SDO_RESULT_OK, slot.pos);
+                return;
+            }
+            slot.toggle ^= 1;
+            uint8_t request[8] = {(uint8_t)(0x60 | (slot.toggle << 4)), 0, 0, 0, 0, 0, 0, 0};
+            if (!sendSDOFrame(nodeId, request)) {
+                finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+            }
+            return;
+        }
+
+        case SDO_SLOT_DOWNLOAD_SEGMENT:
+            // Download Segment Response: scs=1, t
+            if ((cs & 0xE0) != 0x20) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                return;
+            }
+            if (((cs >> 4) & 0x01) != slot.toggle) {
+                abortSDO(nodeId, SDO_ABORT_TOGGLE);
+                return;
+            }
+            if (slot.pos >= slot.size) {
+                finishSDO(nodeId, SDO_RESULT_OK, slot.size);
+                return;
+            }
+            slot.toggle ^= 1;
+            sendDownloadSegment(nodeId);
+            return;
+
+        case SDO_SLOT_BLOCK_UPLOAD: {
+            // Segment: Bit 7 = letztes Segment, Bit 0-6 = Sequenznummer
+            uint8_t seq = cs & 0x7F;
+            bool last = (cs & 0x80) != 0;
+
+            // Nur lückenlose Segmente übernehmen; nach einer Lücke wiederholt der Server
+            // ab der quittierten Sequenznummer
+            if (seq == slot.seqNo + 1 && !slot.lastSeen) {
+                if (slot.pos < slot.size) {
+                    uint32_t room = slot.size - slot.pos;
+                    memcpy(slot.rxBuffer + slot.pos, &frame.data[1], room < 7 ? room : 7);
+                }
+                slot.pos += 7;  // Ungenutzte Bytes des letzten Segments meldet der End-Frame
+                slot.seqNo = seq;
+                slot.lastSeen = last;
+            }
+
+            // Blockende (oder letztes Segment) quittieren
+            if (seq >= slot.blockSize || last) {
+                uint8_t ack[8] = {0xA2, slot.seqNo, SDO_BLOCK_SIZE, 0, 0, 0, 0, 0};
+                slot.seqNo = 0;
+                slot.blockSize = SDO_BLOCK_SIZE;
+                if (slot.lastSeen) {
+                    slot.state = SDO_SLOT_BLOCK_UPLOAD_END;
+                }
+                if (!sendSDOFrame(nodeId, ack)) {
+                    finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+                }
+            }
+            return;
+        }
+
+        case SDO_SLOT_BLOCK_UPLOAD_END: {
+            // End Block Upload: scs=6, n (ungenutzte Bytes im letzten Segment), ss=1, CRC
+            if ((cs & 0xE1) != 0xC1) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                return;
+            }
+            uint32_t total = slot.pos - ((cs >> 2) & 0x07);
+            if (total > slot.size) {
+                abortSDO(nodeId, SDO_ABORT_OUT_OF_MEMORY);
+                return;
+            }
+            uint16_t crc = frame.data[1] | (frame.data[2] << 8);
+            if (slot.crc && sdoCrc16(slot.rxBuffer, total) != crc) {
+                abortSDO(nodeId, SDO_ABORT_CRC);
+                return;
+            }
+            uint8_t response[8] = {0xA1, 0, 0, 0, 0, 0, 0, 0};
+            sendSDOFrame(nodeId, response);
+            finishSDO(nodeId, SDO_RESULT_OK, total);
+            return;
+        }
+
+        case SDO_SLOT_BLOCK_DOWNLOAD: {
+            // Block Download Response: scs=5, ss=2, ackseq, neue Blockgröße
+            if ((cs & 0xE3) != 0xA2) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                return;
+            }
+            uint8_t ackSeq = frame.data[1];
+            uint8_t nextBlockSize = frame.data[2];
+            if (ackSeq > slot.seqNo || nextBlockSize < 1 || nextBlockSize > 127) {
+                abortSDO(nodeId, SDO_ABORT_SEQUENCE);
+                return;
+            }
+
+            // Quittierte Segmente übernehmen, nicht quittierte im nächsten Block wiederholen
+            uint32_t acked = slot.blockStart + (uint32_t)ackSeq * 7;
+            slot.pos = acked < slot.size ? acked : slot.size;
+
+            if (slot.pos >= slot.size) {
+                // Alles übertragen: End-Frame mit ungenutzten Bytes des letzten Segments und CRC
+                uint8_t unused = (7 - slot.size % 7) % 7;
+                uint16_t crc = slot.crc ? sdoCrc16(slot.txData, slot.size) : 0;
+                uint8_t request[8] = {(uint8_t)(0xC1 | (unused << 2)),
+                                      (uint8_t)(crc & 0xFF), (uint8_t)(crc >> 8), 0, 0, 0, 0, 0};
+                slot.state = SDO_SLOT_BLOCK_DOWNLOAD_END;
+                if (!sendSDOFrame(nodeId, request)) {
+                    finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+                }
+                return;
+            }
+
+            slot.blockStart = slot.pos;
+            slot.seqNo = 0;
+            slot.blockSize = nextBlockSize;
+            slot.lastSeen = false;
+            pumpBlockDownload(nodeId);
+            return;
+        }
+
+        case SDO_SLOT_BLOCK_DOWNLOAD_END:
+            // End Block Download Response: scs=5, ss=1
+            if ((cs & 0xE3) != 0xA1) {
+                abortSDO(nodeId, SDO_ABORT_COMMAND);
+                return;
+            }
+            finishSDO(nodeId, SDO_RESULT_OK, slot.size);
+            return;
+
+        default:
+            return;
+    }
+}
+
+// Nächstes Segment eines segmentierten Downloads senden (bis zu 7 Bytes)
+void CANopen::sendDownloadSegment(uint8_t nodeId) {
+    SDOSlot& slot = _sdoSlots[nodeId];
+    uint32_t remaining = slot.size - slot.pos;
+    uint8_t bytes = remaining < 7 ? remaining : 7;
+    bool last = bytes == remaining;
+
+    // ccs=0, t, n (ungenutzte Bytes), c (letztes Segment)
+    uint8_t request[8] = {0};
+    request[0] = (slot.toggle << 4) | ((7 - bytes) << 1) | (last ? 0x01 : 0x00);
+    memcpy(&request[1], slot.txData + slot.pos, bytes);
+
+    if (!sendSDOFrame(nodeId, request)) {
+        finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+        return;
+    }
+    slot.pos += bytes;
+}
+
+// Block-Download: Segmente des laufenden Blocks ohne Einzelquittung nachschieben.
+// Höchstens SDO_BLOCK_TX_WINDOW Segmente liegen gleichzeitig in der Sendequeue,
+// damit andere Teilnehmer der Queue nicht blockiert werden.
+void CANopen::pumpBlockDownload(uint8_t nodeId) {
+    SDOSlot& slot = _sdoSlots[nodeId];
+
+    while (slot.state == SDO_SLOT_BLOCK_DOWNLOAD && !slot.lastSeen &&
+           slot.seqNo < slot.blockSize && slot.txInFlight < SDO_BLOCK_TX_WINDOW) {
+        uint32_t offset = slot.blockStart + (uint32_t)slot.seqNo * 7;
+        uint32_t remaining = slot.size - offset;
+        uint8_t bytes = remaining < 7 ? remaining : 7;
+        bool last = bytes == remaining;
+
+        uint8_t segment[8] = {0};
+        segment[0] = (last ? 0x80 : 0x00) | (slot.seqNo + 1);
+        memcpy(&segment[1], slot.txData + offset, bytes);
+
+        if (!sendSDOFrame(nodeId, segment)) {
+            return;  // Sendequeue voll: tick() bzw. der nächste Sendeabschluss macht weiter
+        }
+        slot.seqNo++;
+        slot.txInFlight++;
+        slot.lastSeen = last;
+    }
+}
+
+bool CANopen::sendSDOFrame(uint8_t nodeId, const uint8_t* data) {
+    CanFrame frame;
+    frame.id = COB_ID_RSDO_BASE + nodeId;
+    frame.ext = 0;
+    frame.len = 8;
+    memcpy(frame.data, data, 8);
+
+    if (!_interface->enqueueTx(frame, onSDOTxComplete, this)) {
+        return false;
+    }
+    _sdoSlots[nodeId].deadline = millis() + _sdoSlots[nodeId].timeout;
+    return true;
+}
+
+// Transfer mit SDO-Abort an den Server beenden
+void CANopen::abortSDO(uint8_t nodeId, uint32_t abortCode, SDOResult result) {
+    const SDOSlot& slot = _sdoSlots[nodeId];
+    uint8_t request[8] = {
+        0x80,
+        (uint8_t)(slot.index & 0xFF), (uint8_t)(slot.index >> 8),
+        slot.subIndex,
+        (uint8_t)(abortCode & 0xFF), (uint8_t)((abortCode >> 8) & 0xFF),
+        (uint8_t)((abortCode >> 16) & 0xFF), (uint8_t)((abortCode >> 24) & 0xFF)
+    };
+    sendSDOFrame(nodeId, request);  // Der Transfer endet auch, wenn der Abort nicht rausgeht
+    finishSDO(nodeId, result, abortCode);
+}
+
+void CANopen::tick() {
+    if (_activeTransfers == 0) {
+        return;
+    }
+
+    uint32_t now = millis();
+    for (uint8_t nodeId = 1; nodeId < SDO_CLIENT_SLOTS; nodeId++) {
+        const SDOSlot& slot = _sdoSlots[nodeId];
+        if (slot.state == SDO_SLOT_IDLE) {
+            continue;
+        }
+
+        if ((int32_t)(now - slot.deadline) >= 0) {
+            // Nach der Initiate-Phase kennt der Server den Transfer: per Abort beenden
+            if (slot.state == SDO_SLOT_UPLOAD || slot.state == SDO_SLOT_DOWNLOAD ||
+                slot.state == SDO_SLOT_BLOCK_UPLOAD_INIT || slot.state == SDO_SLOT_BLOCK_DOWNLOAD_INIT) {
+                finishSDO(nodeId, SDO_RESULT_TIMEOUT, 0);
+            } else {
+                abortSDO(nodeId, SDO_ABORT_TIMEOUT, SDO_RESULT_TIMEOUT);
+            }
+        } else if (slot.state == SDO_SLOT_BLOCK_DOWNLOAD && slot.txInFlight == 0) {
+            // Block-Download, der an einer vollen Sendequeue hängen geblieben ist
+            pumpBlockDownload(nodeId);
+        }
+    }
+}
+
+void CANopen::cancelSDO(uint8_t nodeId) {
+    if (nodeId >= SDO_CLIENT_SLOTS) {
+        return;
+    }
+
+    switch (_sdoSlots[nodeId].state) {
+        case SDO_SLOT_IDLE:
+            return;
+        case SDO_SLOT_UPLOAD:
+        case SDO_SLOT_DOWNLOAD:
+        case SDO_SLOT_BLOCK_UPLOAD_INIT:
+        case SDO_SLOT_BLOCK_DOWNLOAD_INIT:
+            finishSDO(nodeId, SDO_RESULT_CANCELLED, 0);
+            return;
+        default:
+            abortSDO(nodeId, SDO_ABORT_GENERAL, SDO_RESULT_CANCELLED);
+            return;
+    }
+}
+
+bool CANopen::isSDOBusy(uint8_t nodeId) const {
+    return nodeId < SDO_CLIENT_SLOTS && _sdoSlots[nodeId].state != SDO_SLOT_IDLE;
+}
+
+void CANopen::finishSDO(uint8_t nodeId, SDOResult result, uint32_t data) {
+    SDOSlot slot = _sdoSlots[nodeId];
+    _sdoSlots[nodeId].state = SDO_SLOT_IDLE;
+    _activeTransfers--;
+
+    if (slot.future != nullptr) {
+        slot.future->result = result;
+        if (result == SDO_RESULT_ABORT || result == SDO_RESULT_PROTOCOL) {
+            slot.future->abortCode = data;
+        } else {
+            slot.future->value = data;
+        }
+        slot.future->done = true;
+    }
+    if (slot.callback != nullptr) {
+        slot.callback(nodeId, slot.index, slot.subIndex, result, data, slot.context);
+    }
+}
+
+// Blockierendes Warten auf einen Transfer. Alle übrigen Frames werden weiterverarbeitet
+// (andere Transfers, Frame-Handler), statt wie früher verworfen zu werden.
+SDOResult CANopen::waitForSDO(SDOFuture& future) {
+    while (!future.done) {
+        _interface->serviceTx();
+
+        CanFrame frames[CAN_RX_BURST_SIZE];
+        size_t count = _interface->receiveBurst(frames, CAN_RX_BURST_SIZE, 1000);
+        for (size_t i = 0; i < count; i++) {
+            if (!processFrame(frames[i]) && _frameHandler != nullptr) {
+                _frameHandler(frames[i]);
+            }
+        }
+
+        tick();
+    }
+    return future.result;
+}
+
+void CANopen::onSDOTxComplete(const CanFrame& frame, bool success, void* context) {
+    CANopen* self = static_cast<CANopen*>(context);
+    uint8_t nodeId = frame.id - COB_ID_RSDO_BASE;
+    if (!self->isSDOBusy(nodeId)) {
+        return;
+    }
+
+    if (!success) {
+        self->finishSDO(nodeId, SDO_RESULT_SEND_ERROR, 0);
+        return;
+    }
+
+    // Block-Download: Platz in der Sendequeue für die nächsten Segmente
+    SDOSlot& slot = self->_sdoSlots[nodeId];
+    if (slot.state == SDO_SLOT_BLOCK_DOWNLOAD && slot.txInFlight > 0) {
+        slot.txInFlight--;
+        self->pumpBlockDownload(nodeId);
+    }
+}
+
+const char* CANopen::sdoResultName(SDOResult result) {
+    switch (result) {
+        case SDO_RESULT_OK:         return "OK";
+        case SDO_RESULT_ABORT:      return "Abort";
+        case SDO_RESULT_TIMEOUT:    return "Timeout";
+        case SDO_RESULT_SEND_ERROR: return "Sendefehler";
+        case SDO_RESULT_PROTOCOL:   return "Protokollfehler";
+        case SDO_RESULT_CANCELLED:  return "Abgebrochen";
+        default:                    return "Unbekannt";
+    }
+}
+
+uint16_t CANopen::sdoCrc16(const uint8_t* data, size_t length, uint16_t crc) {
+    // Halbbyte-Tabelle: 32 Byte statt 512 Byte für die volle Tabelle
+    static const uint16_t table[16] = {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+    };
+    for (size_t i = 0; i < length; i++) {
+        crc = (crc << 4) ^ table[((crc >> 12) ^ (data[i] >> 4)) & 0x0F];
+        crc = (crc << 4) ^ table[((crc >> 12) ^ data[i]) & 0x0F];
+    }
+    return crc;
+}
+
+// ===================================================================================
+// Puffer-Transfers (segmentiert und Block)
+// ===================================================================================
+bool CANopen::startBufferUpload(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                uint8_t* buffer, size_t capacity, bool block, uint32_t timeout,
+                                SDOCallback callback, void* context, SDOFuture* future) {
+    if (buffer == nullptr || capacity == 0) {
+        return false;
+    }
+
+    // Block: cc=1 (CRC), Blockgröße, pst=0 (kein Wechsel zum segmentierten Protokoll)
+    uint8_t request[8] = {
+        (uint8_t)(block ? 0xA4 : 0x40),
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        subIndex,
+        (uint8_t)(block ? SDO_BLOCK_SIZE : 0), 0, 0, 0
+    };
+    if (!startSDO(nodeId, block ? SDO_SLOT_BLOCK_UPLOAD_INIT : SDO_SLOT_UPLOAD, index, subIndex,
+                  request, timeout, callback, context, future)) {
+        return false;
+    }
+
+    _sdoSlots[nodeId].rxBuffer = buffer;
+    _sdoSlots[nodeId].size = capacity;
+    return true;
+}
+
+bool CANopen::startBufferDownload(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                  const uint8_t* data, size_t size, bool block, uint32_t timeout,
+                                  SDOCallback callback, void* context, SDOFuture* future) {
+    if (data == nullptr || size == 0) {
+        return false;
+    }
+
+    uint8_t request[8] = {
+        0,
+        (uint8_t)(index & 0xFF), (uint8_t)(index >> 8),
+        subIndex,
+        (uint8_t)(size & 0xFF), (uint8_t)((size >> 8) & 0xFF),
+        (uint8_t)((size >> 16) & 0xFF), (uint8_t)((size >> 24) & 0xFF)
+    };
+    SDOSlotState state = SDO_SLOT_DOWNLOAD;
+
+    if (size <= 4) {
+        // Passt in einen Expedited Download
+        request[0] = 0x23 | ((4 - size) << 2);
+        memset(&request[4], 0, 4);
+        memcpy(&request[4], data, size);
+    } else if (block) {
+        request[0] = 0xC6;  // ccs=6, cc=1 (CRC), s=1 (Größe angegeben)
+        state = SDO_SLOT_BLOCK_DOWNLOAD_INIT;
+    } else {
+        request[0] = 0x21;  // Segmentiert, Größe angegeben
+    }
+
+    if (!startSDO(nodeId, state, index, subIndex, request, timeout, callback, context, future)) {
+        return false;
+    }
+
+    _sdoSlots[nodeId].txData = data;
+    _sdoSlots[nodeId].size = size;
+    return true;
+}
+
+bool CANopen::readSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                 uint8_t* buffer, size_t capacity, bool block,
+                                 SDOCallback callback, void* context, uint32_t timeout) {
+    return startBufferUpload(nodeId, index, subIndex, buffer, capacity, block, timeout,
+                             callback, context, nullptr);
+}
+
+bool CANopen::readSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                 uint8_t* buffer, size_t capacity, bool block,
+                                 SDOFuture* future, uint32_t timeout) {
+    return startBufferUpload(nodeId, index, subIndex, buffer, capacity, block, timeout,
+                             nullptr, nullptr, future);
+}
+
+bool CANopen::writeSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                  const uint8_t* data, size_t size, bool block,
+                                  SDOCallback callback, void* context, uint32_t timeout) {
+    return startBufferDownload(nodeId, index, subIndex, data, size, block, timeout,
+                               callback, context, nullptr);
+}
+
+bool CANopen::writeSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                                  const uint8_t* data, size_t size, bool block,
+                                  SDOFuture* future, uint32_t timeout) {
+    return startBufferDownload(nodeId, index, subIndex, data, size, block, timeout,
+                               nullptr, nullptr, future);
+}
+
+// ===================================================================================
+// Methode: readSDOBuffer
+// Beschreibung: Liest ein beliebig langes Objekt (segmentiert oder als Block-Upload)
+// ===================================================================================
+bool CANopen::readSDOBuffer(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                            uint8_t* buffer, size_t capacity, size_t& received,
+                            bool block, uint32_t timeout) {
+    received = 0;
+    if (_interface == nullptr) {
+        Serial.println("[FEHLER] Kein CAN-Interface gesetzt");
+        return false;
+    }
+
+    SDOFuture future;
+    if (!readSDOBufferAsync(nodeId, index, subIndex, buffer, capacity, block, &future, timeout)) {
+        Serial.printf("[FEHLER] SDO-Anfrage an Node %d nicht möglich (Transfer aktiv oder Sendequeue voll)\n", nodeId);
+        return false;
+    }
+
+    SDOResult result = waitForSDO(future);
+    if (block && result == SDO_RESULT_ABORT && future.abortCode == SDO_ABORT_COMMAND) {
+        Serial.printf("[INFO] Node %d unterstützt keinen Block-Upload, lese segmentiert\n", nodeId);
+        return readSDOBuffer(nodeId, index, subIndex, buffer, capacity, received, false, timeout);
+    }
+
+    switch (result) {
+        case SDO_RESULT_OK:
+            received = future.value;
+            return true;
+        case SDO_RESULT_ABORT:
+        case SDO_RESULT_PROTOCOL:
+            Serial.printf("[FEHLER] SDO %s, Abort Code: 0x%08X\n", sdoResultName(result), future.abortCode);
+            return false;
+        default:
+            Serial.printf("[FEHLER] SDO-Leseanfrage fehlgeschlagen: %s\n", sdoResultName(result));
+            return false;
+    }
+}
+
+// ===================================================================================
+// Methode: writeSDOBuffer
+// Beschreibung: Schreibt ein beliebig langes Objekt (segmentiert oder als Block-Download)
+// ===================================================================================
+bool CANopen::writeSDOBuffer(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                             const uint8_t* data, size_t size, bool block, uint32_t timeout) {
+    if (_interface == nullptr) {
+        Serial.println("[FEHLER] Kein CAN-Interface gesetzt");
+        return false;
+    }
+
+    SDOFuture future;
+    if (!writeSDOBufferAsync(nodeId, index, subIndex, data, size, block, &future, timeout)) {
+        Serial.printf("[FEHLER] SDO-Anfrage an Node %d nicht möglich (Transfer aktiv oder Sendequeue voll)\n", nodeId);
+        return false;
+    }
+
+    SDOResult result = waitForSDO(future);
+    if (block && size > 4 && result == SDO_RESULT_ABORT && future.abortCode == SDO_ABORT_COMMAND) {
+        Serial.printf("[INFO] Node %d unterstützt keinen Block-Download, schreibe segmentiert\n", nodeId);
+        return writeSDOBuffer(nodeId, index, subIndex, data, size, false, timeout);
+    }
+
+    switch (result) {
+        case SDO_RESULT_OK:
+            return true;
+        case SDO_RESULT_ABORT:
+        case SDO_RESULT_PROTOCOL:
+            Serial.printf("[FEHLER] SDO %s, Abort Code: 0x%08X\n", sdoResultName(result), future.abortCode);
+            return false;
+        default:
+            Serial.printf("[FEHLER] SDO-Schreibanfrage fehlgeschlagen: %s\n", sdoResultName(result));
+            return false;
+    }
+}
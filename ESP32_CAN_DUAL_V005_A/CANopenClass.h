@@ -38,6 +38,50 @@
 #define NMT_CMD_RESET_NODE      0x81
 #define NMT_CMD_RESET_COMM      0x82
 
+// ================================
+// Asynchroner SDO-Client
+// ================================
+#define SDO_CLIENT_SLOTS        128   // Ein Transfer-Slot pro Server-Node (Index = Node-ID)
+#define SDO_DEFAULT_TIMEOUT_MS  1000
+#define SDO_BLOCK_SIZE          127   // Segmente pro Block beim Block-Upload (Maximum)
+#define SDO_BLOCK_TX_WINDOW     8     // Block-Download: max. Segmente gleichzeitig in der Sendequeue
+
+// SDO-Abortcodes, die der Client selbst sendet
+#define SDO_ABORT_TOGGLE        0x05030000  // Toggle-Bit nicht alterniert
+#define SDO_ABORT_TIMEOUT       0x05040000  // SDO-Protokoll Timeout
+#define SDO_ABORT_COMMAND       0x05040001  // Ungültiger Command Specifier
+#define SDO_ABORT_SEQUENCE      0x05040003  // Ungültige Sequenznummer (Block)
+#define SDO_ABORT_CRC           0x05040004  // CRC-Fehler (Block)
+#define SDO_ABORT_OUT_OF_MEMORY 0x05040005  // Empfangspuffer zu klein
+#define SDO_ABORT_GENERAL       0x08000000  // Allgemeiner Fehler
+
+// Ergebnis eines SDO-Transfers
+enum SDOResult : uint8_t {
+    SDO_RESULT_OK = 0,
+    SDO_RESULT_ABORT,        // Server hat mit SDO-Abort geantwortet
+    SDO_RESULT_TIMEOUT,      // Keine Antwort innerhalb des Timeouts
+    SDO_RESULT_SEND_ERROR,   // Anfrage konnte nicht gesendet werden
+    SDO_RESULT_PROTOCOL,     // Unerwartete Antwort des Servers
+    SDO_RESULT_CANCELLED     // Vom Aufrufer abgebrochen
+};
+
+// Abschluss-Callback: data enthält den gelesenen Wert (bei Puffer-Transfers die Anzahl
+// übertragener Bytes) bzw. bei SDO_RESULT_ABORT/SDO_RESULT_PROTOCOL den Abortcode
+typedef void (*SDOCallback)(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                            SDOResult result, uint32_t data, void* context);
+
+// Alternative zum Callback: wird beim Abschluss ausgefüllt, done zeigt das Ende an
+struct SDOFuture {
+    volatile bool done;
+    SDOResult result;
+    uint32_t value;       // Gelesener Wert (Upload) bzw. Anzahl Bytes (Puffer-Transfer)
+    uint32_t abortCode;   // Bei SDO_RESULT_ABORT und SDO_RESULT_PROTOCOL
+};
+
+// Empfänger für Frames, die während eines blockierenden Aufrufs ankommen und nicht
+// zum laufenden Transfer gehören (z.B. Live-Monitor)
+typedef void (*CANFrameHandler)(CanFrame& frame);
+
 class CANopen {
 public:
     CANopen();
@@ -54,17 +98,144 @@ public:
     bool writeSDO(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size);
     bool writeSDOWithTimeout(uint8_t nodeId, uint16_t index, uint8_t subIndex, 
                           uint32_t value, uint8_t size, uint32_t timeout);
+
+    // Beliebig lange Objekte (z.B. Strings, Parameter-/Firmware-Blöcke): segmentiert oder
+    // als Block-Transfer mit CRC. Lehnt der Server den Block-Transfer ab, wird segmentiert
+    // wiederholt.
+    bool readSDOBuffer(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                       uint8_t* buffer, size_t capacity, size_t& received,
+                       bool block = false, uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool writeSDOBuffer(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                        const uint8_t* data, size_t size,
+                        bool block = false, uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
                           
     // Node-ID ändern
     bool changeNodeId(uint8_t oldId, uint8_t newId, bool storeInEeprom = true, uint16_t timeout = 5000);
+
+    // ===============================================================================
+    // Asynchroner SDO-Client (nicht blockierend)
+    // Pro Server-Node ist ein Transfer gleichzeitig möglich, verschiedene Nodes laufen
+    // parallel. Fortschritt über processFrame() (empfangene Frames) und tick() aus loop().
+    // Liefert false, wenn der Slot des Nodes belegt ist oder kein Interface gesetzt ist.
+    // ===============================================================================
+    bool readSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                      SDOCallback callback, void* context = nullptr,
+                      uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool readSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                      SDOFuture* future, uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool writeSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size,
+                       SDOCallback callback, void* context = nullptr,
+                       uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool writeSDOAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex, uint32_t value, uint8_t size,
+                       SDOFuture* future, uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+
+    // Puffer-Transfers: Upload nimmt expedited, segmentierte und Block-Antworten an.
+    // Download mit bis zu 4 Bytes geht expedited, sonst segmentiert bzw. als Block.
+    // Der Puffer muss bis zum Abschluss gültig bleiben; timeout gilt pro Protokollschritt.
+    bool readSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                            uint8_t* buffer, size_t capacity, bool block,
+                            SDOCallback callback, void* context = nullptr,
+                            uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool readSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                            uint8_t* buffer, size_t capacity, bool block,
+                            SDOFuture* future, uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool writeSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                             const uint8_t* data, size_t size, bool block,
+                             SDOCallback callback, void* context = nullptr,
+                             uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+    bool writeSDOBufferAsync(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                             const uint8_t* data, size_t size, bool block,
+                             SDOFuture* future, uint32_t timeout = SDO_DEFAULT_TIMEOUT_MS);
+
+    // Empfangenen Frame auswerten. Liefert true, wenn er zu einem laufenden Transfer gehörte.
+    bool processFrame(const CanFrame& frame);
+
+    // Timeouts prüfen
+    void tick();
+
+    // Laufenden Transfer eines Nodes abbrechen (meldet SDO_RESULT_CANCELLED).
+    // Segmentierte und Block-Transfers werden beim Server per SDO-Abort beendet.
+    void cancelSDO(uint8_t nodeId);
+
+    bool isSDOBusy(uint8_t nodeId) const;
+    uint8_t activeSDOTransfers() const { return _activeTransfers; }
+
+    // Empfänger für fremde Frames während blockierender Aufrufe
+    void setFrameHandler(CANFrameHandler handler);
  
     // Interface-Verwaltung
     void setCANInterface(CANInterface* interface);
     CANInterface* getCANInterface() const;
 
+    static const char* sdoResultName(SDOResult result);
+
+    // CRC-16 des SDO-Block-Transfers (CCITT, Polynom 0x1021, Startwert 0)
+    static uint16_t sdoCrc16(const uint8_t* data, size_t length, uint16_t crc = 0);
+
 private:
     uint8_t _intPin; // Interner Speicher für den Interrupt-Pin (für Kompatibilität)
     CANInterface* _interface; // Das zu verwendende CAN-Interface
+
+    enum SDOSlotState : uint8_t {
+        SDO_SLOT_IDLE = 0,
+        SDO_SLOT_UPLOAD,              // Initiate Upload gesendet, Antwort erwartet
+        SDO_SLOT_DOWNLOAD,            // Initiate Download gesendet, Antwort erwartet
+        SDO_SLOT_UPLOAD_SEGMENT,      // Upload Segment Request gesendet
+        SDO_SLOT_DOWNLOAD_SEGMENT,    // Download Segment gesendet
+        SDO_SLOT_BLOCK_UPLOAD_INIT,   // Initiate Block Upload gesendet
+        SDO_SLOT_BLOCK_UPLOAD,        // Segmente eines Blocks werden empfangen
+        SDO_SLOT_BLOCK_UPLOAD_END,    // Letzter Block quittiert, End-Frame erwartet
+        SDO_SLOT_BLOCK_DOWNLOAD_INIT, // Initiate Block Download gesendet
+        SDO_SLOT_BLOCK_DOWNLOAD,      // Segmente eines Blocks werden gesendet
+        SDO_SLOT_BLOCK_DOWNLOAD_END   // End-Frame mit CRC gesendet
+    };
+
+    struct SDOSlot {
+        uint8_t state;
+        uint8_t subIndex;
+        uint16_t index;
+        uint32_t deadline;
+        SDOCallback callback;
+        void* context;
+        SDOFuture* future;
+        uint32_t timeout;        // Pro Protokollschritt
+
+        // Puffer-Transfers (segmentiert/Block)
+        uint8_t* rxBuffer;       // Upload-Ziel (nullptr = 32-Bit-Wert)
+        const uint8_t* txData;   // Download-Quelle
+        uint32_t size;           // Kapazität (Upload) bzw. Länge (Download)
+        uint32_t pos;            // Bisher übertragene Bytes
+        uint32_t blockStart;     // Block-Download: pos am Anfang des laufenden Blocks
+        uint8_t toggle;          // Segmentiert: erwartetes/gesendetes Toggle-Bit
+        uint8_t seqNo;           // Block: letzte gesendete bzw. lückenlos empfangene Sequenznummer
+        uint8_t blockSize;       // Block: Segmente im laufenden Block
+        uint8_t txInFlight;      // Block-Download: Segmente in der Sendequeue
+        bool crc;                // Block: CRC von beiden Seiten unterstützt
+        bool lastSeen;           // Block: Segment mit Endekennung empfangen/gesendet
+    };
+
+    SDOSlot _sdoSlots[SDO_CLIENT_SLOTS];
+    uint8_t _activeTransfers;
+    CANFrameHandler _frameHandler;
+
+    void initSDOClient();
+    bool startSDO(uint8_t nodeId, SDOSlotState state, uint16_t index, uint8_t subIndex,
+                  const uint8_t* request, uint32_t timeout,
+                  SDOCallback callback, void* context, SDOFuture* future);
+    void finishSDO(uint8_t nodeId, SDOResult result, uint32_t data);
+    void abortSDO(uint8_t nodeId, uint32_t abortCode, SDOResult result = SDO_RESULT_PROTOCOL);
+    bool sendSDOFrame(uint8_t nodeId, const uint8_t* data);
+    void sendDownloadSegment(uint8_t nodeId);
+    void pumpBlockDownload(uint8_t nodeId);
+    void processSegmentFrame(uint8_t nodeId, const CanFrame& frame);
+    bool startBufferUpload(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                           uint8_t* buffer, size_t capacity, bool block, uint32_t timeout,
+                           SDOCallback callback, void* context, SDOFuture* future);
+    bool startBufferDownload(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                             const uint8_t* data, size_t size, bool block, uint32_t timeout,
+                             SDOCallback callback, void* context, SDOFuture* future);
+    SDOResult waitForSDO(SDOFuture& future);
+    static void onSDOTxComplete(const CanFrame& frame, bool success, void* context);
 };
 
 #endif
\ No newline at end of file
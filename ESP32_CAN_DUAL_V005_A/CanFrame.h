@@ -0,0 +1,16 @@
+// CanFrame.h
+// ===============================================================================
+// Kompakter CAN-Frame für Ringpuffer, Burst-Zugriffe und Sendequeue.
+// ===============================================================================
+
+#pragma once
+
+#include <stdint.h>
+
+struct CanFrame {
+    uint32_t id;
+    uint8_t ext;
+    uint8_t len;
+    uint8_t data[8];
+    uint64_t timestamp;  // Empfangszeitpunkt in µs (canTimestampUs), nur bei empfangenen Frames
+};
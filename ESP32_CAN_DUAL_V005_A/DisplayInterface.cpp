@@ -4,16 +4,22 @@
 // ===============================================================================
 
 #include "DisplayInterface.h"
+#if defined(ESP32) || defined(ESP_PLATFORM)
 #include "OLEDDisplay.h"
 #include "WaveshareDisplay.h"
+#endif
+
+RenderScheduler displayScheduler(RENDER_TARGET_FPS);
 
 DisplayInterface* DisplayInterface::createInstance(uint8_t displayType) {
     switch (displayType) {
+#if defined(ESP32) || defined(ESP_PLATFORM)
         case DISPLAY_CONTROLLER_OLED_SSD1306:
             return new OLEDDisplay();
             
         case DISPLAY_CONTROLLER_WAVESHARE_ESP32S3_TOUCH_LCD:
             return new WaveshareDisplay();
+#endif
             
         case DISPLAY_CONTROLLER_NONE:
         default:
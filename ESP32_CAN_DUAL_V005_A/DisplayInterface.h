@@ -7,6 +7,7 @@
 #pragma once
 
 #include <Arduino.h>
+#include "RenderScheduler.h"
 
 // Display-Controller-Typen
 #define DISPLAY_CONTROLLER_NONE                      0
@@ -46,6 +47,13 @@ public:
     virtual void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
     virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) = 0;
 
+    // Bildrate, mit der laufend aktualisierte Ansichten gezeichnet werden sollen
+    virtual uint16_t frameRate() const { return RENDER_TARGET_FPS; }
+
     // Factory-Methode zum Erstellen der richtigen Display-Instanz
     static DisplayInterface* createInstance(uint8_t displayType);
-};
\ No newline at end of file
+};
+
+// Gemeinsame Taktung für laufend aktualisierte Ansichten (Live-Monitor, Trace-Tabelle,
+// Scan-Fortschritt); wird aus loop() bedient. Einmalige Bildschirme zeichnen weiterhin sofort.
+extern RenderScheduler displayScheduler;
@@ -1,17 +1,36 @@
 #include <SPI.h>
+// Display- und MCP2515-Bibliotheken nur auf dem ESP32; im Host-Build (host/) läuft der
+// Sketch ohne Display über SocketCAN oder den simulierten Bus
+#if defined(ESP32) || defined(ESP_PLATFORM)
 #include <mcp_can.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>  // Für OLED (wird weiterhin für Rückwärtskompatibilität benötigt)
+#include <TFT_eSPI.h>           // Für Waveshare Display
+#endif
 #include "OLEDMenu.h"
 #include <Preferences.h>
 #include <Arduino.h>
-#include <TFT_eSPI.h>           // Für Waveshare Display
 #include "CANopen.h"
 #include "CANopenClass.h"
 #include "CANInterface.h"
+#include "CANFilter.h"
 #include "DisplayInterface.h"   // Neue abstrakte Display-Schnittstelle
+#if defined(ESP32) || defined(ESP_PLATFORM)
 #include "OLEDDisplay.h"        // Konkrete Implementierung für OLED
 #include "WaveshareDisplay.h"   // Konkrete Implementierung für Waveshare
+#else
+#define TFT_WHITE     0xFFFF    // RGB565-Farben aus TFT_eSPI für showStatusMessage()
+#define TFT_RED       0xF800
+#endif
+
+// Komponenten beim ersten Start: auf dem Host ohne Display am simulierten Bus
+#if defined(ESP32) || defined(ESP_PLATFORM)
+#define DEFAULT_CAN_TRANSCEIVER  CAN_CONTROLLER_MCP2515
+#define DEFAULT_DISPLAY_TYPE     DISPLAY_CONTROLLER_OLED_SSD1306
+#else
+#define DEFAULT_CAN_TRANSCEIVER  CAN_CONTROLLER_SIM
+#define DEFAULT_DISPLAY_TYPE     DISPLAY_CONTROLLER_NONE
+#endif
 #include "SystemProfiles.h"
 
 // Versionsinfo
@@ -22,6 +41,7 @@
 #define CAN_CS        5
 #define CAN_INT       4
 #define CAN_CLOCK     MCP_8MHZ
+#define SERIAL_TX_BUFFER_SIZE 4096  // Sendepuffer für die Log-Ausgabe des Live-Monitors
 constexpr int DISPLAY_OLED_WIDTH = 128;
 constexpr int DISPLAY_OLED_HEIGHT = 64;
 constexpr int DISPLAY_TFT_WIDTH = 800;
@@ -37,8 +57,8 @@ constexpr int DISPLAY_TFT_ERROR_BAR_HEIGHT = 30;
 // Globale Variablen für CAN und Display
 uint8_t currentNodeId = 127;  // Standardwert
 int currentBaudrate = 125;    // Standardwert in kbps
-uint8_t currentCANTransceiverType = CAN_CONTROLLER_MCP2515;
-uint8_t currentDisplayType = DISPLAY_CONTROLLER_OLED_SSD1306;
+uint8_t currentCANTransceiverType = DEFAULT_CAN_TRANSCEIVER;
+uint8_t currentDisplayType = DEFAULT_DISPLAY_TYPE;
 uint8_t scanStart = 1;        // Standardwert
 uint8_t scanEnd = 127;         // Standardwert
 bool scanning = false;
@@ -51,15 +71,14 @@ extern unsigned long lastActivityTime;
 
 // Globale Variablen für Filter
 bool filterEnabled = false;
-uint32_t filterIdMin = 0;
-uint32_t filterIdMax = 0xFFFFFFFF;
-uint8_t filterNodeId = 0;
-bool filterNodeEnabled = false;
-uint8_t filterType = 0; // 0=All, 1=PDO, 2=SDO, 3=EMCY, 4=NMT, 5=Heartbeat
+CANFilter monitorFilter;  // Regeln aus "monitor filter"
+static bool baseFilterRuleSet = false;  // Regel 0 ist die Include-Regel der Befehle id/node/type
 
 // Globale Objekte
+#if defined(ESP32) || defined(ESP_PLATFORM)
 MCP_CAN CAN(CAN_CS);
 Adafruit_SSD1306 display(DISPLAY_OLED_WIDTH, DISPLAY_OLED_HEIGHT, &Wire, -1);  // Alte Implementierung Standard
+#endif
 CANopen canopen(CAN_INT);
 Preferences preferences;
 
@@ -70,13 +89,20 @@ DisplayInterface* displayInterface = nullptr;
 // Globales TFT-Objekt für Unterstützung alter Code-Teile
 // HINWEIS: Dies ist nur ein Übergangsobjekt und sollte durch das Interface ersetzt werden
 // Macht noch Probleme wird in einer späteren Version angegangen
+#if defined(ESP32) || defined(ESP_PLATFORM)
 TFT_eSPI tft = TFT_eSPI();
+#endif
 
 // Funktionsdeklarationen
+bool isValidComponentCombination(uint8_t displayType, uint8_t canType);
+bool initializeDisplay();
+bool initializeCANInterface();
+bool recreateCANInterface(int baudrateKbps);
+const char* getTransceiverTypeName(uint8_t transceiverType);
+bool sendCanMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf);
 void showMessage(const char* msg);
 void showStatusMessage(const char* title, const char* message, bool isError = false);
 void scanNodes(int startID, int endID);
-bool tryScanNode(int id, bool extendedScan);
 void changeNodeId(uint8_t from, uint8_t to);
 extern void handleSerialCommands();
 void printHelpMenu();
@@ -100,6 +126,8 @@ bool updateESP32CANBaudrate(int newBaudrate);
 uint8_t getBaudrateIndex(int baudrateKbps);
 void handleTestNodeCommand(String command);
 bool testSingleNode(int nodeId, int maxAttempts, int timeoutMs);
+void startIdentityRead(uint8_t firstId, uint8_t lastId);
+void handleSDOCommand(String command);
 const char* getAppVersion();
 int getDisplayWidth();
 int getDisplayHeight();
@@ -114,6 +142,18 @@ extern void menuLoop();
 extern void processCANScanning();
 extern void processAutoBaudrate();
 extern void processCANMessage();
+extern void beginScanEngine(uint8_t firstId, uint8_t lastId, uint16_t listenMs, bool probe);
+extern bool serviceScanEngine();
+extern uint8_t scanEngineFoundCount();
+extern void forwardCANFrame(CanFrame& frame);
+extern void initCANDispatcher();
+extern void updateHardwareFilter(bool verbose);
+extern void serviceMonitorLog();
+extern void serviceTraceView();
+extern void attachBusStatistics(CANInterface* interface);
+extern bool busStatsEnabled;
+extern void serviceHeartbeatMonitor();
+extern bool heartbeatMonitorEnabled;
 
 // ===================================================================================
 // Funktion: saveSettings (aktualisiert)
@@ -151,8 +191,8 @@ void loadSettings() {
     unsigned long lastCrashTime = preferences.getULong("lastCrashTime", 0);
     
     // Komponententypen laden
-    currentCANTransceiverType = preferences.getUChar("canTransceiver", CAN_CONTROLLER_MCP2515);
-    currentDisplayType = preferences.getUChar("displayType", DISPLAY_CONTROLLER_OLED_SSD1306);
+    currentCANTransceiverType = preferences.getUChar("canTransceiver", DEFAULT_CAN_TRANSCEIVER);
+    currentDisplayType = preferences.getUChar("displayType", DEFAULT_DISPLAY_TYPE);
     
     // Prüfe die Kompatibilität der geladenen Konfiguration
     if (!isValidComponentCombination(currentDisplayType, currentCANTransceiverType)) {
@@ -219,6 +259,18 @@ bool isValidComponentCombination(uint8_t displayType, uint8_t canType) {
         return true;
     }
     
+    // Simulation belegt keine Pins und passt zu jedem Display
+    if (canType == CAN_CONTROLLER_SIM) {
+        return true;
+    }
+
+#if defined(__linux__)
+    // SocketCAN läuft auf einem Linux-Rechner, unabhängig vom Display
+    if (canType == CAN_CONTROLLER_SOCKETCAN) {
+        return true;
+    }
+#endif
+    
     // Alle anderen Kombinationen sind ungültig
     return false;
 }
@@ -227,8 +279,12 @@ bool isValidComponentCombination(uint8_t displayType, uint8_t canType) {
 // Beschreibung: Initialisiert das System, lädt Einstellungen und initialisiert CAN und Display
 // ===================================================================================
 void setup() {
+    // Großer Sendepuffer, damit die Log-Ausgabe des Live-Monitors nicht blockiert
+    Serial.setTxBufferSize(SERIAL_TX_BUFFER_SIZE);
     Serial.begin(115200);
+#if defined(ESP32) || defined(ESP_PLATFORM)
     Wire.begin();
+#endif
     
     // Gespeicherte Einstellungen laden
     loadSettings();
@@ -258,10 +314,11 @@ void setup() {
         lastErrorTime = millis();
     }
     
-    // CANopen-Klasse mit dem Interface verknüpfen
-    if (canInterface != nullptr) {
-        canopen.setCANInterface(canInterface);
-    }
+    // Empfangsverteilung an Scan-Engine, SDO-Client und Live-Monitor
+    initCANDispatcher();
+    
+    // Frames, die blockierende SDO-Aufrufe nicht selbst auswerten, gehen an den Dispatcher
+    canopen.setFrameHandler(forwardCANFrame);
 
     pinMode(BUTTON_UP, INPUT_PULLUP);
     pinMode(BUTTON_DOWN, INPUT_PULLUP);
@@ -294,6 +351,11 @@ void loop() {
     // Serielle Befehle verarbeiten
     handleSerialCommands();
 
+    // Sendequeue bedienen (freie Sendepuffer füllen, Abschlüsse melden)
+    if (canInterface != nullptr) {
+        canInterface->serviceTx();
+    }
+
     // Node-Scan durchführen, wenn angefordert
     if (scanning) {
         processCANScanning();
@@ -306,33 +368,63 @@ void loop() {
         // Hinweis: Das Zurücksetzen von autoBaudrateRequest erfolgt in processAutoBaudrate()
     }
 
-    // Live Monitor für CAN-Frames
-    if (liveMonitor && canInterface && canInterface->messageAvailable()) {
+    // Asynchrone SDO-Transfers: Zeitüberschreitungen melden
+    canopen.tick();
+
+    // Live Monitor für CAN-Frames; Empfang auch für laufende SDO-Transfers, die Busstatistik
+    // und die Heartbeat-Überwachung
+    if ((liveMonitor || busStatsEnabled || heartbeatMonitorEnabled || canopen.activeSDOTransfers() > 0) &&
+        canInterface && canInterface->messageAvailable()) {
         processCANMessage();
     }
+    serviceHeartbeatMonitor();
+    serviceMonitorLog();
+    serviceTraceView();
+    
+    // Vorgemerkte Displayansichten mit begrenzter Bildrate zeichnen
+    displayScheduler.service(millis());
 }
 
 
 
-// Funktion zur Initialisierung des CAN-Interfaces basierend auf dem aktuellen Transceiver-Typ
-bool initializeCANInterface() {
+// ===================================================================================
+// Funktion: recreateCANInterface
+// Beschreibung: Legt das CAN-Interface für den aktuellen Transceiver-Typ neu an und
+//               startet es mit der angegebenen Baudrate. Einzige Stelle, an der
+//               canInterface ersetzt wird: CANopen wird vor dem Löschen gelöst und
+//               danach neu verknüpft, Sendezähler und Hardwarefilter werden übernommen.
+// Rückgabe: false, wenn kein Interface angelegt oder gestartet werden konnte
+//           (canInterface ist dann nullptr bzw. nicht gestartet)
+// ===================================================================================
+bool recreateCANInterface(int baudrateKbps) {
     // Alte Instanz bereinigen, falls vorhanden
+    canopen.setCANInterface(nullptr);  // Laufende SDO-Transfers abbrechen
     if (canInterface != nullptr) {
+        canInterface->end();
         delete canInterface;
         canInterface = nullptr;
     }
     
     // Neue Instanz erstellen
     canInterface = CANInterface::createInstance(currentCANTransceiverType);
-    
     if (canInterface == nullptr) {
-        Serial.println("[FEHLER] Ungültiger Transceiver-Typ");
-        showStatusMessage("FEHLER", "Ungültiger Transceiver-Typ!", true);
         return false;
     }
     
-    // Interface mit aktueller Baudrate initialisieren
-    if (canInterface->begin(currentBaudrate * 1000)) {  // Umrechnung von kbps in bps
+    // CANopen-Klasse mit dem Interface verknüpfen
+    canopen.setCANInterface(canInterface);
+    attachBusStatistics(canInterface);
+    
+    if (!canInterface->begin((uint32_t)baudrateKbps * 1000UL)) {  // Umrechnung von kbps in bps
+        return false;
+    }
+    updateHardwareFilter(false);  // Aktiven Anzeigefilter in den neuen Controller übernehmen
+    return true;
+}
+
+// Funktion zur Initialisierung des CAN-Interfaces basierend auf dem aktuellen Transceiver-Typ
+bool initializeCANInterface() {
+    if (recreateCANInterface(currentBaudrate)) {
         Serial.printf("[INFO] CAN-Interface (%s) erfolgreich initialisiert bei %d kbps\n", 
                      getTransceiverTypeName(currentCANTransceiverType), 
                      currentBaudrate);
@@ -340,6 +432,10 @@ bool initializeCANInterface() {
                          String("Transceiver: " + String(getTransceiverTypeName(currentCANTransceiverType)) + 
                                "\nBaudrate: " + String(currentBaudrate) + " kbps").c_str());
         return true;
+    } else if (canInterface == nullptr) {
+        Serial.println("[FEHLER] Ungültiger Transceiver-Typ");
+        showStatusMessage("FEHLER", "Ungültiger Transceiver-Typ!", true);
+        return false;
     } else {
         Serial.println("[FEHLER] CAN-Interface Initialisierung fehlgeschlagen");
         showStatusMessage("FEHLER", "CAN-Interface\nInitialisierung fehlgeschlagen!", true);
@@ -356,6 +452,10 @@ const char* getTransceiverTypeName(uint8_t transceiverType) {
             return "ESP32CAN";
         case CAN_CONTROLLER_TJA1051:
             return "TJA1051";
+        case CAN_CONTROLLER_SIM:
+            return "Simulation";
+        case CAN_CONTROLLER_SOCKETCAN:
+            return "SocketCAN";
         case DISPLAY_CONTROLLER_OLED_SSD1306:
             return "OLED SSD1306";
         case DISPLAY_CONTROLLER_WAVESHARE_ESP32S3_TOUCH_LCD:
@@ -437,6 +537,9 @@ bool initializeDisplay() {
         return false;
     }
     
+    // Laufende Ansichten mit der Bildrate zeichnen, die das Display schafft
+    displayScheduler.setFrameRate(displayInterface->frameRate());
+    
     // Test-Nachricht anzeigen
     displayInterface->clear();
     displayInterface->setCursor(0, 0);
@@ -455,6 +558,7 @@ bool initializeDisplay() {
 // ===================================================================================
 void handleTransceiverCommand(String command) {
     // Die Funktion erwartet ein Command-Format wie: "can 1" oder "display 11"
+    command.trim();  // Der Parser übergibt den Rest nach "transceiver" mit führendem Leerzeichen
     
     int spacePos = command.indexOf(' ');
     
@@ -475,7 +579,11 @@ void handleTransceiverCommand(String command) {
         bool isValidCANType = 
             (newType == CAN_CONTROLLER_MCP2515) ||
             (newType == CAN_CONTROLLER_ESP32CAN) ||
-            (newType == CAN_CONTROLLER_TJA1051);
+            (newType == CAN_CONTROLLER_TJA1051) ||
+            (newType == CAN_CONTROLLER_SIM);
+#if defined(__linux__)
+        isValidCANType = isValidCANType || (newType == CAN_CONTROLLER_SOCKETCAN);
+#endif
         
         if (!isValidCANType) {
             Serial.println("[FEHLER] Ungültiger CAN-Controller-Typ!");
@@ -483,6 +591,10 @@ void handleTransceiverCommand(String command) {
             Serial.println("  1 = MCP2515");
             Serial.println("  2 = ESP32CAN");
             Serial.println("  3 = TJA1051");
+            Serial.println("  4 = Simulation");
+#if defined(__linux__)
+            Serial.println("  5 = SocketCAN (Linux, $CAN_INTERFACE)");
+#endif
             return;
         }
         
@@ -696,72 +808,43 @@ void scanNodes(int startID, int endID) {
         displayInterface->println("Scan...\n");
         displayInterface->display();
     } else {
+#if defined(ESP32) || defined(ESP_PLATFORM)
         // Fallback auf das alte display-Objekt für Kompatibilität
         display.clearDisplay();
         display.setCursor(0, 0);
         display.println("Scan...\n");
         display.display();
+#endif
     }
     
     Serial.printf("[INFO] Starte Node-Scan von %d bis %d bei %d kbps\n", startID, endID, currentBaudrate);
     
-    // Zähler für gefundene Nodes
-    int foundNodes = 0;
-    
     // Bereich prüfen und begrenzen
     if (startID < 1) startID = 1;
     if (endID > 127) endID = 127;
     
-    // Länger warten vor dem Start des Scans, damit der CAN-Bus bereit ist
+    // Kurz warten vor dem Start des Scans, damit der CAN-Bus bereit ist
     delay(200);
     
     // Live-Monitor-Modus während des Scans aktivieren
     bool wasMonitorActive = liveMonitor;
     liveMonitor = true;
     
-    // Erst die bekannten Node-IDs scannen (insbesondere Node 10)
-    int knownNodes[] = {10, 1, 2, 3, 4, 5};
-    int knownNodesCount = sizeof(knownNodes) / sizeof(knownNodes[0]);
-    
-    for (int i = 0; i < knownNodesCount; i++) {
-        int id = knownNodes[i];
-        
-        // Nur scannen, wenn die ID im angegebenen Bereich liegt
-        if (id < startID || id > endID) {
-            continue;
-        }
-        
-        Serial.printf("[SCAN] Scanne bekannte Node-ID %d mit erweitertem Timeout...\n", id);
-        
-        // Verschiedene SDO-Anfragen für diesen Node probieren
-        if (tryScanNode(id, true)) {
-            foundNodes++;
-        }
+    // Pipelined Scan: Anfragen an alle Nodes im Fenster, Antworten in beliebiger
+    // Reihenfolge, Wiederholungen nur für Nodes ohne Antwort
+    bool wasScanning = scanning;
+    scanning = true;
+    unsigned long scanStartTime = millis();
+    beginScanEngine(startID, endID, 0, true);
+    while (serviceScanEngine()) {
+        displayScheduler.service(millis());
+        yield();
     }
+    scanning = wasScanning;
+    displayScheduler.cancel();
     
-    // Jetzt den Rest des Bereichs scannen
-    for (int id = startID; id <= endID; id++) {
-        // Bekannte Nodes überspringen, die bereits gescannt wurden
-        bool isKnown = false;
-        for (int i = 0; i < knownNodesCount; i++) {
-            if (id == knownNodes[i]) {
-                isKnown = true;
-                break;
-            }
-        }
-        
-        if (isKnown) {
-            continue;
-        }
-        
-        // Normale Nodes mit Standardparametern scannen
-        if (tryScanNode(id, false)) {
-            foundNodes++;
-        }
-        
-        // Kurze Pause zwischen den Nodes
-        delay(20);
-    }
+    int foundNodes = scanEngineFoundCount();
+    Serial.printf("[INFO] Scan-Dauer: %lu ms\n", millis() - scanStartTime);
     
     // Live-Monitor-Modus zurücksetzen
     liveMonitor = wasMonitorActive;
@@ -776,6 +859,7 @@ void scanNodes(int startID, int endID) {
         displayInterface->printf("Baudrate: %d kbps", currentBaudrate);
         displayInterface->display();
     } else {
+#if defined(ESP32) || defined(ESP_PLATFORM)
         // Fallback auf das alte display-Objekt für Kompatibilität
         display.clearDisplay();
         display.setCursor(0, 0);
@@ -784,152 +868,11 @@ void scanNodes(int startID, int endID) {
         display.printf("Bereich: %d-%d\n", startID, endID);
         display.printf("Baudrate: %d kbps", currentBaudrate);
         display.display();
+#endif
     }
     
     Serial.printf("[INFO] Scan abgeschlossen. %d Nodes gefunden bei %d kbps.\n", foundNodes, currentBaudrate);
 }
-// ===================================================================================
-// Funktion: tryScanNode (aktualisiert für DisplayInterface)
-// Beschreibung: Hilfsfunktion zum Scannen eines einzelnen Nodes mit verschiedenen Methoden
-// ===================================================================================
-bool tryScanNode(int id, bool extendedScan) {
-    bool responded = false;
-    bool errorResponse = false;
-    
-    // Anzahl der Versuche und Timeout-Zeit
-    int maxAttempts = extendedScan ? 3 : 1;
-    int timeoutMs = extendedScan ? 300 : 200;
-    
-    Serial.printf("[SCAN] Frage Node %d ab... (%d Versuche, %dms Timeout)\n", id, maxAttempts, timeoutMs);
-    
-    // Mehrere Versuche mit verschiedenen Objekten
-    for (int attempt = 0; attempt < maxAttempts && !responded; attempt++) {
-        // Verschiedene SDO-Objekte probieren
-        uint16_t objectIndices[] = {0x1001, 0x1000, 0x1018};
-        
-        for (int objIdx = 0; objIdx < 3 && !responded; objIdx++) {
-            // SDO-Leseanfrage vorbereiten (Fehlerstatus, Gerätetyp oder Identität)
-            uint8_t sdo[8] = { 0x40, (uint8_t)(objectIndices[objIdx] & 0xFF), (uint8_t)(objectIndices[objIdx] >> 8), 0x00, 0, 0, 0, 0 };
-            
-            // Anfrage senden mit Fehlerbehandlung
-            if (!sendCanMessage(0x600 + id, 0, 8, sdo)) {
-                Serial.printf("[FEHLER] Konnte keine Anfrage an Node %d senden\n", id);
-                delay(30); // Kurze Pause vor dem nächsten Versuch
-                continue;
-            }
-            
-            // Auf Antwort warten mit Timeout
-            unsigned long start = millis();
-            
-            // Erst warten, ob ein Heartbeat oder Emergency auftaucht (passiv)
-            while (millis() - start < 50) {
-                if (canInterface->messageAvailable()) {
-                    uint32_t rxId;
-                    uint8_t ext = 0;
-                    uint8_t len = 0;
-                    uint8_t buf[8];
-                    
-                    if (!canInterface->receiveMessage(&rxId, &ext, &len, buf)) {
-                        continue;
-                    }
-                    
-                    // Heartbeat oder Emergency von diesem Node?
-                    if (rxId == (0x700 + id) || rxId == (0x080 + id)) {
-                        Serial.printf("[OK] Node %d gefunden über %s!\n", id, 
-                                    (rxId == (0x700 + id)) ? "Heartbeat" : "Emergency");
-                        
-                        // Ergebnis ausgeben mit dem DisplayInterface oder Fallback auf display
-                        if (displayInterface != nullptr) {
-                            displayInterface->printf("Node %d: OK (HB)\n", id);
-                            displayInterface->display();
-                        } else {
-                            display.printf("Node %d: OK (HB)\n", id);
-                            display.display();
-                        }
-                        
-                        responded = true;
-                        break;
-                    }
-                }
-            }
-            
-            // Dann auf die SDO-Antwort warten, wenn noch keine Antwort da ist
-            start = millis();
-            while (!responded && millis() - start < timeoutMs) {
-                if (canInterface->messageAvailable()) {
-                    uint32_t rxId;
-                    uint8_t ext = 0;
-                    uint8_t len = 0;
-                    uint8_t buf[8];
-                    
-                    // Antwort lesen mit Fehlerbehandlung
-                    if (!canInterface->receiveMessage(&rxId, &ext, &len, buf)) {
-                        continue;
-                    }
-                    
-                    // Prüfen, ob es sich um eine Antwort auf unsere SDO-Anfrage handelt
-                    if (rxId == (0x580 + id)) {
-                        // Prüfen, ob es eine Fehlerantwort ist (SDO Abort)
-                        if ((buf[0] & 0xE0) == 0x80) {
-                            uint32_t abortCode = buf[4] | (buf[5] << 8) | (buf[6] << 16) | (buf[7] << 24);
-                            Serial.printf("[OK] Node %d hat mit Fehler geantwortet! Abortcode: 0x%08X\n", id, abortCode);
-                            
-                            // Ergebnis ausgeben mit dem DisplayInterface oder Fallback auf display
-                            if (displayInterface != nullptr) {
-                                displayInterface->printf("Node %d: Err\n", id);
-                            } else {
-                                display.printf("Node %d: Err\n", id);
-                            }
-                            
-                            errorResponse = true;
-                        } else {
-                            // Reguläre Antwort
-                            Serial.printf("[OK] Node %d hat geantwortet! ObjIdx: 0x%04X\n", id, objectIndices[objIdx]);
-                            
-                            // Ergebnis ausgeben mit dem DisplayInterface oder Fallback auf display
-                            if (displayInterface != nullptr) {
-                                displayInterface->printf("Node %d: OK\n", id);
-                            } else {
-                                display.printf("Node %d: OK\n", id);
-                            }
-                        }
-                        
-                        // Display aktualisieren
-                        if (displayInterface != nullptr) {
-                            displayInterface->display();
-                        } else {
-                            display.display();
-                        }
-                        
-                        responded = true;
-                        break;
-                    }
-                }
-            }
-            
-            // Pause zwischen verschiedenen Objekten
-            if (!responded) {
-                delay(20);
-            }
-        }
-        
-        // Pause zwischen den Versuchen
-        if (!responded && attempt < maxAttempts - 1) {
-            delay(50);
-        }
-    }
-    
-    if (!responded) {
-        Serial.printf("[--] Node %d keine Antwort\n", id);
-        return false;
-    } else if (errorResponse) {
-        // Auch Fehlerantworten zählen als gefundene Nodes
-        return true;
-    } else {
-        return true;
-    }
-}
-
 
 // ===================================================================================
 // Funktion: handleModeCommand
@@ -1018,9 +961,27 @@ void printHelpMenu() {
     Serial.println("Verfügbare Befehle:");
     Serial.println("  help          → Diese Hilfe anzeigen");
     Serial.println("  scan          → Node-ID Scan starten");
+    Serial.println("  scan listen [ms] → Passiver Scan nur aus Busverkehr (HB/EMCY/TPDO), kein Senden");
+    Serial.println("  scan hybrid [ms] → Erst zuhören, dann nur nicht gesehene IDs abfragen");
+    Serial.println("  scan timeout [ms] → Antwortzeit pro SDO-Anfrage im Scan (Standard 200 ms)");
     Serial.println("  range x y     → Scan-Bereich setzen (z.B. 1 10)");
     Serial.println("  monitor on    → Live Monitor aktivieren");
     Serial.println("  monitor off   → Live Monitor deaktivieren");
+    Serial.println("  monitor log candump|asc|slcan|binary [baud] → Frames maschinenlesbar ausgeben (can-utils, SavvyCAN, tools/can_capture.py)");
+    Serial.println("  monitor view table|frames → Display: Tabelle je COB-ID (letzte Daten, geänderte Bytes) oder Einzelframes");
+    Serial.println("  monitor table [clear] → Trace-Tabelle seriell ausgeben bzw. leeren");
+    Serial.println("  stats [ids|nodes] → Busstatistik: Buslast, Frames/s je COB-ID bzw. Node, Fehlerzähler");
+    Serial.println("  stats reset|on|off → Statistik zurücksetzen bzw. ein-/ausschalten");
+    Serial.println("  hb            → Heartbeat-Überwachung: NMT-Zustand, Periode und Ausfälle je Node");
+    Serial.println("  hb timeout <node|all> <ms> → Überwachungszeit (0x1016) setzen, 0 = automatisch aus der Periode");
+    Serial.println("  hb clear|on|off|notify on|off → Tabelle leeren, Überwachung bzw. Displaymeldungen schalten");
+    Serial.println("  sim           → Simulierter Bus (CAN-Controller 4): Status und virtuelle Nodes");
+    Serial.println("  sim nodes a b [hb] | remove <n|all> | on|off <n> → Nodes anlegen, entfernen, ein-/ausschalten");
+    Serial.println("  sim hb|delay <n|all> <wert> | errors <promille> | inject [n] | bitrate <kbps> → Heartbeat, SDO-Antwortzeit, Busfehler, Bitrate");
+    Serial.println("  slcan         → SLCAN-Modus (Lawicel-Adapter für slcand/SavvyCAN), Ende mit 'slcan off'");
+    Serial.println("  monitor filter id|node|type x → Include-Regel 0 des Anzeigefilters setzen (z.B. id 0x180-0x1FF, node 5,7-9, type pdo,sdo)");
+    Serial.println("  monitor filter add include|exclude [id a-b] [node x] [type y] → Weitere Filterregel");
+    Serial.println("  monitor filter list|del n|reset → Filterregeln anzeigen, löschen, zurücksetzen");
     Serial.println("  change a b    → Node-ID a → b ändern (SDO)");
     Serial.println("  baudrate x y  → Baudrate ändern (nodeID x auf y kbps: 10, 20, 50, 100, 125, 250, 500, 800, 1000)");
     Serial.println("  localbaud x   → Lokale ESP32-Baudrate ändern (nur ESP32, ohne CANopen-Kommunikation)");
@@ -1028,6 +989,9 @@ void printHelpMenu() {
     Serial.println("  mode          → Zeigt Informationen zu Systemkonfigurationsprofilen");
     Serial.println("  mode x        → Wechselt zu Konfigurationsprofil x (1=OLED+MCP2515, 2=TFT+TJA1051)");
     Serial.println("  testnode x    → Einzelnen Node x intensiv testen (mit erweiterten Optionen)");
+    Serial.println("  ident [x y]   → Identität (0x1018) der Nodes x-y parallel lesen (Standard: Scan-Bereich)");
+    Serial.println("  sdo read n idx sub [block]        → Objekt beliebiger Länge lesen (idx hex, z.B. sdo read 5 1008 0)");
+    Serial.println("  sdo write n idx sub daten [block] → Objekt schreiben (daten: Hex-Bytes oder \"Text\")");
     Serial.println("  auto          → Automatische Baudratenerkennung starten");
     Serial.println("  info          → Aktuelle Einstellungen anzeigen");
     Serial.println("  save          → Einstellungen speichern");
@@ -1263,13 +1227,14 @@ bool testSingleNode(int nodeId, int maxAttempts, int timeoutMs) {
     Serial.println("[TEST] Warte auf Heartbeat oder Emergency...");
     unsigned long startListening = millis();
     while (millis() - startListening < 1000 && !responded) { // 1 Sekunde auf passive Nachrichten warten
-        if (!digitalRead(CAN_INT)) {
-            unsigned long rxId;
-            byte len;
-            byte buf[8];
+        if (canInterface != nullptr && canInterface->messageAvailable()) {
+            uint32_t rxId;
+            uint8_t ext = 0;
+            uint8_t len = 0;
+            uint8_t buf[8];
             
-            byte readStatus = CAN.readMsgBuf(&rxId, &len, buf);
-            if (readStatus != CAN_OK) {
+            // Frames kommen aus dem Empfangspuffer des Interfaces (CAN_INT bedient der Empfangstask)
+            if (!canInterface->receiveMessage(&rxId, &ext, &len, buf)) {
                 delay(1);
                 continue;
             }
@@ -1315,9 +1280,8 @@ bool testSingleNode(int nodeId, int maxAttempts, int timeoutMs) {
                 Serial.printf("[TEST] Sende SDO-Anfrage für Objekt 0x%04X (%s)...\n", 
                              objectIndices[objIdx], objectNames[objIdx]);
                 
-                byte result = CAN.sendMsgBuf(0x600 + nodeId, 0, 8, sdo);
-                if (result != CAN_OK) {
-                    Serial.printf("[TEST] Sendefehler: %d\n", result);
+                if (!sendCanMessage(0x600 + nodeId, 0, 8, sdo)) {
+                    Serial.println("[TEST] Sendefehler");
                     delay(50);
                     continue;
                 }
@@ -1325,13 +1289,13 @@ bool testSingleNode(int nodeId, int maxAttempts, int timeoutMs) {
                 // Auf Antwort warten
                 unsigned long start = millis();
                 while (millis() - start < timeoutMs && !responded) {
-                    if (!digitalRead(CAN_INT)) {
-                        unsigned long rxId;
-                        byte len;
-                        byte buf[8];
+                    if (canInterface != nullptr && canInterface->messageAvailable()) {
+                        uint32_t rxId;
+                        uint8_t ext = 0;
+                        uint8_t len = 0;
+                        uint8_t buf[8];
                         
-                        byte readStatus = CAN.readMsgBuf(&rxId, &len, buf);
-                        if (readStatus != CAN_OK) {
+                        if (!canInterface->receiveMessage(&rxId, &ext, &len, buf)) {
                             delay(1);
                             continue;
                         }
@@ -1438,6 +1402,9 @@ void printCurrentSettings() {
     Serial.printf("Display-Typ: %s (%d)\n", getTransceiverTypeName(currentDisplayType), currentDisplayType);
     Serial.printf("CAN-Controller: %s (%d)\n", getTransceiverTypeName(currentCANTransceiverType), currentCANTransceiverType);
     Serial.printf("Live Monitor: %s\n", liveMonitor ? "aktiviert" : "deaktiviert");
+    if (canInterface != nullptr) {
+        Serial.printf("RX-Überläufe: %lu\n", (unsigned long)canInterface->getRxOverrunCount());
+    }
     Serial.printf("System-Status: %s\n", systemError ? "Fehler" : "OK");
     Serial.println("=======================================");
 }
@@ -1497,19 +1464,151 @@ void systemReset() {
 // ===================================================================================
 // Funktion: handleMonitorFilterCommand
 // Beschreibung: Verarbeitet Filter-Befehle für den Live Monitor
+// Die Befehle id/node/type setzen Bedingungen der Regel 0 (wie bisher UND-verknüpft),
+// add/del verwalten weitere Include-/Exclude-Regeln. Nach jeder Änderung wird der
+// Filter neu kompiliert.
 // ===================================================================================
+
+// Einzelne ID oder Bereich (z.B. 0x180 oder 0x180-0x1FF) einlesen
+static bool parseFilterIdRange(String value, uint32_t& minId, uint32_t& maxId) {
+    int dashPos = value.indexOf('-');
+    String minStr = (dashPos > 0) ? value.substring(0, dashPos) : value;
+    String maxStr = (dashPos > 0) ? value.substring(dashPos + 1) : value;
+    minId = strtoul(minStr.c_str(), NULL, minStr.startsWith("0x") ? 16 : 10);
+    maxId = strtoul(maxStr.c_str(), NULL, maxStr.startsWith("0x") ? 16 : 10);
+    return minId <= maxId && maxId <= CAN_FILTER_EXT_MAX_ID;
+}
+
+// Node-Liste (z.B. 5 oder 5,7,10-12) in die Node-Menge der Regel übernehmen
+static bool parseFilterNodes(String value, CANFilterRule& rule) {
+    CANFilter::clearNodes(rule);
+    while (value.length() > 0) {
+        int comma = value.indexOf(',');
+        String item = (comma < 0) ? value : value.substring(0, comma);
+        value = (comma < 0) ? String("") : value.substring(comma + 1);
+        
+        int dashPos = item.indexOf('-');
+        int first = item.toInt();
+        int last = (dashPos > 0) ? item.substring(dashPos + 1).toInt() : first;
+        if (first < 1 || last > 127 || first > last) {
+            return false;
+        }
+        for (int node = first; node <= last; node++) {
+            CANFilter::setNode(rule, node);
+        }
+    }
+    return true;
+}
+
+// Typ-Liste (z.B. pdo,sdo) in eine Funktionscode-Maske übersetzen
+static bool parseFilterTypes(String value, uint16_t& typeMask) {
+    typeMask = 0;
+    while (value.length() > 0) {
+        int comma = value.indexOf(',');
+        String item = (comma < 0) ? value : value.substring(0, comma);
+        value = (comma < 0) ? String("") : value.substring(comma + 1);
+        
+        if (item == "pdo") {
+            typeMask |= CAN_FC_TPDOS | CAN_FC_BIT(CAN_FC_RPDO1) | CAN_FC_BIT(CAN_FC_RPDO2) |
+                        CAN_FC_BIT(CAN_FC_RPDO3) | CAN_FC_BIT(CAN_FC_RPDO4);
+        } else if (item == "tpdo") {
+            typeMask |= CAN_FC_TPDOS;
+        } else if (item == "rpdo") {
+            typeMask |= CAN_FC_BIT(CAN_FC_RPDO1) | CAN_FC_BIT(CAN_FC_RPDO2) |
+                        CAN_FC_BIT(CAN_FC_RPDO3) | CAN_FC_BIT(CAN_FC_RPDO4);
+        } else if (item == "sdo") {
+            typeMask |= CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_RSDO);
+        } else if (item == "emcy" || item == "sync") {
+            typeMask |= CAN_FC_BIT(CAN_FC_SYNC_EMCY);
+        } else if (item == "nmt") {
+            typeMask |= CAN_FC_BIT(CAN_FC_NMT);
+        } else if (item == "time") {
+            typeMask |= CAN_FC_BIT(CAN_FC_TIME);
+        } else if (item == "heartbeat") {
+            typeMask |= CAN_FC_BIT(CAN_FC_NMT_EC);
+        } else if (item == "lss") {
+            typeMask |= CAN_FC_BIT(CAN_FC_LSS);
+        } else {
+            return false;
+        }
+    }
+    return typeMask != 0;
+}
+
+static void printFilterRule(uint8_t index, const CANFilterRule& rule) {
+    Serial.printf("[FILTER] %d: %s", index, rule.include ? "include" : "exclude");
+    if (index == 0 && baseFilterRuleSet) {
+        Serial.print(" (id/node/type)");
+    }
+    if (rule.idMin != 0 || rule.idMax != CAN_FILTER_EXT_MAX_ID) {
+        Serial.printf(" id 0x%lX-0x%lX", (unsigned long)rule.idMin, (unsigned long)rule.idMax);
+    }
+    if (rule.hasNodeCondition()) {
+        Serial.print(" node");
+        for (int node = 0; node <= 127; node++) {
+            if ((rule.nodes[node >> 5] >> (node & 31)) & 1) {
+                Serial.printf(" %d", node);
+            }
+        }
+    }
+    if (rule.hasTypeCondition()) {
+        Serial.printf(" type-mask 0x%04X", rule.typeMask);
+    }
+    Serial.println();
+}
+
+// Filter neu kompilieren und aktivieren
+static void applyMonitorFilter() {
+    monitorFilter.compile();
+    filterEnabled = monitorFilter.ruleCount() > 0;
+    Serial.printf("[INFO] Filter: %d Regeln, %d von 2048 Standard-IDs, %d Extended-Bereiche zugelassen\n",
+                  monitorFilter.ruleCount(), monitorFilter.acceptedStandardCount(),
+                  monitorFilter.extendedRangeCount());
+    updateHardwareFilter(true);
+}
+
+// Include-Regel für die Befehle id/node/type. Fehlt sie (leerer Filter, gelöscht oder
+// nur Regeln aus "add"), wird sie als Regel 0 vor allen anderen eingefügt, damit
+// spätere add-Regeln weiter Vorrang haben. nullptr, wenn keine Regel mehr frei ist.
+static CANFilterRule* baseFilterRule() {
+    if (!baseFilterRuleSet) {
+        if (!monitorFilter.insertRule(0, CANFilter::makeRule(true))) {
+            Serial.printf("[FEHLER] Maximal %d Filterregeln\n", CAN_FILTER_MAX_RULES);
+            return nullptr;
+        }
+        baseFilterRuleSet = true;
+    }
+    return &monitorFilter.rule(0);
+}
+
+void resetMonitorFilter() {
+    monitorFilter.clear();
+    baseFilterRuleSet = false;
+    monitorFilter.compile();
+    filterEnabled = false;
+    updateHardwareFilter(false);
+}
+
 void handleMonitorFilterCommand(String command) {
+    command.trim();
+    
     if (command == "reset") {
         // Alle Filter zurücksetzen
-        filterEnabled = false;
-        filterIdMin = 0;
-        filterIdMax = 0xFFFFFFFF;
-        filterNodeEnabled = false;
-        filterType = 0;
+        resetMonitorFilter();
         Serial.println("[INFO] Alle Monitorfilter zurückgesetzt");
         return;
     }
     
+    if (command == "list") {
+        if (monitorFilter.ruleCount() == 0) {
+            Serial.println("[FILTER] Keine Regeln, alle Frames werden angezeigt");
+        }
+        for (uint8_t i = 0; i < monitorFilter.ruleCount(); i++) {
+            printFilterRule(i, monitorFilter.rule(i));
+        }
+        return;
+    }
+    
     int spacePos = command.indexOf(' ');
     if (spacePos <= 0) {
         Serial.println("[FEHLER] Ungültiger Filterbefehl. Beispiel: monitor filter id 0x180-0x1FF");
@@ -1518,89 +1617,110 @@ void handleMonitorFilterCommand(String command) {
     
     String filterCommand = command.substring(0, spacePos);
     String filterValue = command.substring(spacePos + 1);
+    filterValue.trim();
     
     if (filterCommand == "id") {
-        // ID-Bereich filtern
-        int dashPos = filterValue.indexOf('-');
-        if (dashPos > 0) {
-            // ID-Bereich (z.B. 0x180-0x1FF)
-            String minStr = filterValue.substring(0, dashPos);
-            String maxStr = filterValue.substring(dashPos + 1);
-            
-            // Hex-Strings in Zahlen umwandeln
-            uint32_t minId = 0, maxId = 0;
-            if (minStr.startsWith("0x")) {
-                minId = strtoul(minStr.c_str(), NULL, 16);
-            } else {
-                minId = minStr.toInt();
-            }
-            
-            if (maxStr.startsWith("0x")) {
-                maxId = strtoul(maxStr.c_str(), NULL, 16);
-            } else {
-                maxId = maxStr.toInt();
+        // ID-Bereich (z.B. 0x180-0x1FF) oder einzelne ID (z.B. 0x180)
+        uint32_t minId, maxId;
+        if (!parseFilterIdRange(filterValue, minId, maxId)) {
+            Serial.println("[FEHLER] Ungültiger ID-Bereich. Minimum muss kleiner als Maximum sein.");
+            return;
+        }
+        CANFilterRule* rule = baseFilterRule();
+        if (rule == nullptr) {
+            return;
+        }
+        rule->idMin = minId;
+        rule->idMax = maxId;
+        Serial.printf("[INFO] ID-Filter aktiviert: 0x%lX bis 0x%lX\n", (unsigned long)minId, (unsigned long)maxId);
+        applyMonitorFilter();
+    } else if (filterCommand == "node") {
+        // Nach Node-ID(s) filtern
+        CANFilterRule rule = CANFilter::makeRule(true);
+        if (!parseFilterNodes(filterValue, rule)) {
+            Serial.println("[FEHLER] Ungültige Node-ID. Gültige Werte: 1-127");
+            return;
+        }
+        CANFilterRule* base = baseFilterRule();
+        if (base == nullptr) {
+            return;
+        }
+        memcpy(base->nodes, rule.nodes, sizeof(rule.nodes));
+        Serial.printf("[INFO] Node-Filter aktiviert: %s\n", filterValue.c_str());
+        applyMonitorFilter();
+    } else if (filterCommand == "type") {
+        // Nach Typ(en) filtern
+        uint16_t typeMask;
+        if (!parseFilterTypes(filterValue, typeMask)) {
+            Serial.println("[FEHLER] Ungültiger Typ. Gültige Werte: pdo, tpdo, rpdo, sdo, emcy, sync, nmt, time, heartbeat, lss");
+            return;
+        }
+        CANFilterRule* base = baseFilterRule();
+        if (base == nullptr) {
+            return;
+        }
+        base->typeMask = typeMask;
+        Serial.printf("[INFO] Typ-Filter aktiviert: %s\n", filterValue.c_str());
+        applyMonitorFilter();
+    } else if (filterCommand == "add") {
+        // Format: add include|exclude [id a-b] [node liste] [type liste]
+        int space = filterValue.indexOf(' ');
+        String action = (space < 0) ? filterValue : filterValue.substring(0, space);
+        if (action != "include" && action != "exclude") {
+            Serial.println("[FEHLER] Syntax: monitor filter add include|exclude [id a-b] [node x,y-z] [type pdo,sdo,...]");
+            return;
+        }
+        
+        CANFilterRule rule = CANFilter::makeRule(action == "include");
+        String rest = (space < 0) ? String("") : filterValue.substring(space + 1);
+        rest.trim();
+        while (rest.length() > 0) {
+            int keyEnd = rest.indexOf(' ');
+            if (keyEnd < 0) {
+                Serial.println("[FEHLER] Wert fehlt für " + rest);
+                return;
             }
+            String key = rest.substring(0, keyEnd);
+            rest = rest.substring(keyEnd + 1);
+            rest.trim();
+            int valueEnd = rest.indexOf(' ');
+            String value = (valueEnd < 0) ? rest : rest.substring(0, valueEnd);
+            rest = (valueEnd < 0) ? String("") : rest.substring(valueEnd + 1);
+            rest.trim();
             
-            if (minId <= maxId) {
-                filterIdMin = minId;
-                filterIdMax = maxId;
-                filterEnabled = true;
-                Serial.printf("[INFO] ID-Filter aktiviert: 0x%lX bis 0x%lX\n", filterIdMin, filterIdMax);
-            } else {
-                Serial.println("[FEHLER] Ungültiger ID-Bereich. Minimum muss kleiner als Maximum sein.");
+            bool valid = false;
+            if (key == "id") {
+                valid = parseFilterIdRange(value, rule.idMin, rule.idMax);
+            } else if (key == "node") {
+                valid = parseFilterNodes(value, rule);
+            } else if (key == "type") {
+                valid = parseFilterTypes(value, rule.typeMask);
             }
-        } else {
-            // Einzelne ID (z.B. 0x180)
-            uint32_t singleId = 0;
-            if (filterValue.startsWith("0x")) {
-                singleId = strtoul(filterValue.c_str(), NULL, 16);
-            } else {
-                singleId = filterValue.toInt();
+            if (!valid) {
+                Serial.println("[FEHLER] Ungültige Bedingung: " + key + " " + value);
+                return;
             }
-            
-            filterIdMin = singleId;
-            filterIdMax = singleId;
-            filterEnabled = true;
-            Serial.printf("[INFO] ID-Filter aktiviert: 0x%lX\n", singleId);
         }
-    } else if (filterCommand == "node") {
-        // Nach Node-ID filtern
-        uint8_t nodeId = filterValue.toInt();
-        if (nodeId >= 1 && nodeId <= 127) {
-            filterNodeId = nodeId;
-            filterNodeEnabled = true;
-            filterEnabled = true;
-            Serial.printf("[INFO] Node-Filter aktiviert: %d\n", nodeId);
-        } else {
-            Serial.println("[FEHLER] Ungültige Node-ID. Gültige Werte: 1-127");
+        
+        if (!monitorFilter.addRule(rule)) {
+            Serial.printf("[FEHLER] Maximal %d Filterregeln\n", CAN_FILTER_MAX_RULES);
+            return;
         }
-    } else if (filterCommand == "type") {
-        // Nach Typ filtern
-        if (filterValue == "pdo") {
-            filterType = 1;
-            filterEnabled = true;
-            Serial.println("[INFO] Typ-Filter aktiviert: PDO");
-        } else if (filterValue == "sdo") {
-            filterType = 2;
-            filterEnabled = true;
-            Serial.println("[INFO] Typ-Filter aktiviert: SDO");
-        } else if (filterValue == "emcy") {
-            filterType = 3;
-            filterEnabled = true;
-            Serial.println("[INFO] Typ-Filter aktiviert: EMCY");
-        } else if (filterValue == "nmt") {
-            filterType = 4;
-            filterEnabled = true;
-            Serial.println("[INFO] Typ-Filter aktiviert: NMT");
-        } else if (filterValue == "heartbeat") {
-            filterType = 5;
-            filterEnabled = true;
-            Serial.println("[INFO] Typ-Filter aktiviert: Heartbeat");
-        } else {
-            Serial.println("[FEHLER] Ungültiger Typ. Gültige Werte: pdo, sdo, emcy, nmt, heartbeat");
+        printFilterRule(monitorFilter.ruleCount() - 1, rule);
+        applyMonitorFilter();
+    } else if (filterCommand == "del") {
+        int index = filterValue.toInt();
+        if (!monitorFilter.removeRule(index)) {
+            Serial.println("[FEHLER] Ungültige Regelnummer (siehe monitor filter list)");
+            return;
+        }
+        if (index == 0) {
+            baseFilterRuleSet = false;  // Nächstes id/node/type legt sie neu an
         }
+        Serial.printf("[INFO] Regel %d gelöscht\n", index);
+        applyMonitorFilter();
     } else {
-        Serial.println("[FEHLER] Unbekannter Filterbefehl. Gültige Befehle: id, node, type, reset");
+        Serial.println("[FEHLER] Unbekannter Filterbefehl. Gültige Befehle: id, node, type, add, del, list, reset");
     }
 }
 // ===================================================================================
@@ -1669,6 +1789,7 @@ uint8_t getBaudrateIndex(int baudrateKbps) {
     }
 }
 
+#if defined(ESP32) || defined(ESP_PLATFORM)
 // ===================================================================================
 // Funktion: convertBaudrateToCANSpeed
 // Beschreibung: Konvertiert Baudrate in kbps zu CAN_SPEED-Enum für MCP_CAN
@@ -1745,6 +1866,17 @@ ERROR_RETURN:
     }
     return false;
 }
+#else
+// Host-Build: ohne MCP_CAN-Objekt das aktive CAN-Interface mit der neuen Baudrate starten
+bool updateESP32CANBaudrate(int newBaudrate) {
+    if (canInterface != nullptr && canInterface->begin(newBaudrate * 1000)) {
+        Serial.printf("[INFO] CAN-Interface auf %d kbps umkonfiguriert\n", newBaudrate);
+        return true;
+    }
+    Serial.println("[FEHLER] CAN-Interface Rekonfiguration fehlgeschlagen!");
+    return false;
+}
+#endif
 // ===================================================================================
 // Funktion: changeCommunicationSettings
 // Beschreibung: Umfassende Funktion zum Ändern der Kommunikationseinstellungen
@@ -1817,13 +1949,7 @@ bool autoBaudrateDetection() {
         Serial.printf("[INFO] Teste Baudrate: %d kbps\n", baudrates[i]);
         
         // CAN-Interface auf diese Baudrate umkonfigurieren
-        if (canInterface != nullptr) {
-            delete canInterface;
-            canInterface = nullptr;
-        }
-        
-        canInterface = CANInterface::createInstance(currentCANTransceiverType);
-        if (canInterface == nullptr || !canInterface->begin(baudrates[i] * 1000)) {
+        if (!recreateCANInterface(baudrates[i])) {
             Serial.printf("[FEHLER] Konnte Interface nicht auf %d kbps umkonfigurieren\n", baudrates[i]);
             continue;
         }
@@ -1913,15 +2039,7 @@ bool autoBaudrateDetection() {
     Serial.println("[FEHLER] Keine Baudrate mit aktiven Geräten gefunden");
     
     // Interface neu initialisieren mit Standard-Baudrate
-    if (canInterface != nullptr) {
-        delete canInterface;
-        canInterface = nullptr;
-    }
-    
-    canInterface = CANInterface::createInstance(currentCANTransceiverType);
-    if (canInterface != nullptr) {
-        canInterface->begin(125 * 1000);  // 125 kbps als Standard
-    }
+    recreateCANInterface(125);  // 125 kbps als Standard
     
     currentBaudrate = 125;
     
@@ -1951,19 +2069,12 @@ bool scanSingleNode(int id, int baudrate, int maxAttempts, int timeoutMs) {
         // Auf Antwort warten mit Timeout
         unsigned long start = millis();
         while (millis() - start < timeoutMs) {
-            if (canInterface->messageAvailable()) {
-                uint32_t rxId;
-                uint8_t ext = 0;
-                uint8_t len = 0;
-                uint8_t buf[8];
-                
-                // Antwort lesen
-                if (!canInterface->receiveMessage(&rxId, &ext, &len, buf)) {
-                    continue;
-                }
-                
+            CanFrame frames[CAN_RX_BURST_SIZE];
+            size_t count = canInterface->receiveBurst(frames, CAN_RX_BURST_SIZE, 1000);
+            
+            for (size_t f = 0; f < count; f++) {
                 // Prüfen, ob es sich um eine Antwort auf unsere SDO-Anfrage handelt
-                if (rxId == (0x580 + id)) {
+                if (frames[f].id == (0x580 + id)) {
                     Serial.printf("[INFO] Node %d antwortet bei %d kbps! (Versuch %d)\n", 
                                   id, baudrate, attempt+1);
                     return true;
@@ -1979,3 +2090,191 @@ bool scanSingleNode(int id, int baudrate, int maxAttempts, int timeoutMs) {
     
     return false;
 }
+
+// ===================================================================================
+// Funktion: handleSDOCommand
+// Beschreibung: Lesen/Schreiben von Objekten beliebiger Länge (segmentiert oder Block)
+// Format: sdo read <node> <index hex> <sub> [block]
+//         sdo write <node> <index hex> <sub> <hexbytes|"text"> [block]
+// ===================================================================================
+#define SDO_CMD_BUFFER_SIZE 512
+
+void handleSDOCommand(String command) {
+    static uint8_t sdoBuffer[SDO_CMD_BUFFER_SIZE];
+    
+    command.trim();
+    bool block = command.endsWith(" block");
+    if (block) {
+        command = command.substring(0, command.length() - 6);
+        command.trim();
+    }
+    
+    bool isWrite = command.startsWith("write ");
+    if (!isWrite && !command.startsWith("read ")) {
+        Serial.println("[FEHLER] Syntax: sdo read <node> <index> <sub> [block]");
+        Serial.println("         Syntax: sdo write <node> <index> <sub> <hexbytes|\"text\"> [block]");
+        return;
+    }
+    
+    // Node, Index und Subindex zerlegen
+    String rest = command.substring(isWrite ? 6 : 5);
+    rest.trim();
+    String fields[3];
+    for (int i = 0; i < 3; i++) {
+        int space = rest.indexOf(' ');
+        fields[i] = (space < 0) ? rest : rest.substring(0, space);
+        rest = (space < 0) ? String("") : rest.substring(space + 1);
+        rest.trim();
+    }
+    
+    int nodeId = fields[0].toInt();
+    uint32_t index = strtoul(fields[1].c_str(), nullptr, 16);
+    uint32_t subIndex = strtoul(fields[2].c_str(), nullptr, 0);
+    if (nodeId < 1 || nodeId > 127 || fields[1].length() == 0 || index > 0xFFFF || subIndex > 0xFF) {
+        Serial.println("[FEHLER] Ungültige Node-ID, Index oder Subindex");
+        return;
+    }
+    
+    if (!isWrite) {
+        size_t received = 0;
+        Serial.printf("[CMD] Lese 0x%04X:%02X von Node %d (%s)...\n", index, subIndex, nodeId,
+                      block ? "Block" : "segmentiert");
+        unsigned long start = millis();
+        if (!canopen.readSDOBuffer(nodeId, index, subIndex, sdoBuffer, sizeof(sdoBuffer), received, block)) {
+            return;
+        }
+        
+        Serial.printf("[OK] %u Bytes in %lu ms:", (unsigned)received, millis() - start);
+        bool printable = true;
+        for (size_t i = 0; i < received; i++) {
+            if (i % 16 == 0) {
+                Serial.print("\n  ");
+            }
+            Serial.printf("%02X ", sdoBuffer[i]);
+            if ((sdoBuffer[i] < 0x20 || sdoBuffer[i] > 0x7E) && !(sdoBuffer[i] == 0 && i == received - 1)) {
+                printable = false;
+            }
+        }
+        Serial.println();
+        if (printable && received > 0) {
+            Serial.printf("  Text: \"%.*s\"\n", (int)received, (const char*)sdoBuffer);
+        }
+        return;
+    }
+    
+    // Daten: "Text" oder Hex-Bytes (Leerzeichen erlaubt)
+    size_t size = 0;
+    if (rest.startsWith("\"") && rest.endsWith("\"") && rest.length() >= 2) {
+        size = rest.length() - 2;
+        if (size > sizeof(sdoBuffer)) {
+            size = sizeof(sdoBuffer);
+        }
+        memcpy(sdoBuffer, rest.c_str() + 1, size);
+    } else {
+        rest.replace(" ", "");
+        if (rest.length() == 0 || rest.length() % 2 != 0 || rest.length() / 2 > sizeof(sdoBuffer)) {
+            Serial.println("[FEHLER] Daten als Hex-Bytes (z.B. 01A2FF) oder \"Text\" angeben");
+            return;
+        }
+        for (size_t i = 0; i < rest.length(); i += 2) {
+            char hex[3] = {rest[i], rest[i + 1], 0};
+            char* end = nullptr;
+            sdoBuffer[size++] = strtoul(hex, &end, 16);
+            if (*end != 0) {
+                Serial.println("[FEHLER] Ungültige Hex-Daten");
+                return;
+            }
+        }
+    }
+    if (size == 0) {
+        Serial.println("[FEHLER] Keine Daten angegeben");
+        return;
+    }
+    
+    Serial.printf("[CMD] Schreibe %u Bytes auf 0x%04X:%02X von Node %d (%s)...\n", (unsigned)size,
+                  index, subIndex, nodeId, block ? "Block" : "segmentiert");
+    unsigned long start = millis();
+    if (canopen.writeSDOBuffer(nodeId, index, subIndex, sdoBuffer, size, block)) {
+        Serial.printf("[OK] Geschrieben in %lu ms\n", millis() - start);
+    }
+}
+
+// ===================================================================================
+// Identitätsobjekt 0x1018 mehrerer Nodes parallel lesen
+// Pro Node läuft eine Kette aus vier asynchronen SDO-Uploads (Sub 1-4), alle Nodes
+// gleichzeitig. Neue Nodes werden gestartet, sobald in der Sendequeue Platz ist.
+// ===================================================================================
+#define IDENT_TIMEOUT_MS 200
+
+static uint32_t identValues[SDO_CLIENT_SLOTS][4];
+static uint8_t identNext = 0;      // Nächste noch nicht gestartete Node-ID
+static uint8_t identLast = 0;
+static uint8_t identRunning = 0;   // Nodes mit laufender Abfragekette
+static uint8_t identFound = 0;
+
+static void startNextIdentity();
+
+static void printIdentity(uint8_t nodeId, uint8_t count) {
+    static const char* const names[] = {"Hersteller", "Produkt", "Revision", "Seriennr."};
+    Serial.printf("[IDENT] Node %3d:", nodeId);
+    for (uint8_t i = 0; i < count; i++) {
+        Serial.printf(" %s 0x%08X", names[i], identValues[nodeId][i]);
+    }
+    Serial.println();
+}
+
+static void onIdentityRead(uint8_t nodeId, uint16_t index, uint8_t subIndex,
+                           SDOResult result, uint32_t data, void* context) {
+    if (result == SDO_RESULT_OK) {
+        identValues[nodeId][subIndex - 1] = data;
+        
+        // Nächsten Subindex direkt anfordern (Slot ist bereits wieder frei)
+        if (subIndex < 4 && canopen.readSDOAsync(nodeId, 0x1018, subIndex + 1, onIdentityRead,
+                                                 nullptr, IDENT_TIMEOUT_MS)) {
+            return;
+        }
+        identFound++;
+        printIdentity(nodeId, subIndex);
+    } else if (subIndex > 1) {
+        // Optionale Einträge fehlen: bisher gelesene Werte ausgeben
+        identFound++;
+        printIdentity(nodeId, subIndex - 1);
+    } else if (result != SDO_RESULT_TIMEOUT) {
+        Serial.printf("[IDENT] Node %3d: %s\n", nodeId, CANopen::sdoResultName(result));
+    }
+    
+    identRunning--;
+    startNextIdentity();
+    
+    if (identRunning == 0 && identNext > identLast) {
+        Serial.printf("[IDENT] Abgeschlossen, %d Nodes mit Identitätsobjekt\n", identFound);
+    }
+}
+
+static void startNextIdentity() {
+    while (identNext <= identLast) {
+        if (!canopen.readSDOAsync(identNext, 0x1018, 1, onIdentityRead, nullptr, IDENT_TIMEOUT_MS)) {
+            // Sendequeue voll: der nächste Abschluss startet weitere Nodes
+            if (identRunning > 0) {
+                return;
+            }
+            Serial.printf("[FEHLER] Abfrage von Node %d nicht möglich\n", identNext);
+        } else {
+            identRunning++;
+        }
+        identNext++;
+    }
+}
+
+void startIdentityRead(uint8_t firstId, uint8_t lastId) {
+    if (identRunning > 0) {
+        Serial.println("[FEHLER] Identitätsabfrage läuft bereits");
+        return;
+    }
+    
+    identNext = firstId;
+    identLast = lastId;
+    identFound = 0;
+    memset(identValues, 0, sizeof(identValues));
+    startNextIdentity();
+}
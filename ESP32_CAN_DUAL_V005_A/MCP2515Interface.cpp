@@ -1,15 +1,24 @@
 #include "MCP2515Interface.h"
+#include "CANTimestamp.h"
 
-MCP2515Interface::MCP2515Interface(uint8_t csPin, uint8_t intPin) 
-    : can(new MCP_CAN(csPin)), intPin(intPin) {
+MCP2515Interface::MCP2515Interface(uint8_t csPin, uint8_t intPin)
+    : can(new MCP_CAN(csPin)), csPin(csPin), intPin(intPin), rxTaskHandle(nullptr),
+      rxTaskActive(false), spiMutex(xSemaphoreCreateMutex()), irqTimestamp(0), txOwnedMask(0),
+      rxHardwareOverruns(0) {
     // Constructor initializes MCP_CAN with the given CS pin
 }
 
 MCP2515Interface::~MCP2515Interface() {
+    // Empfangstask beenden, bevor der Controller freigegeben wird
+    stopRxTask();
+
     // Free resources
     if (can) {
         delete can;
     }
+    if (spiMutex) {
+        vSemaphoreDelete(spiMutex);
+    }
 }
 
 // Helper method implementation moved inside the class
@@ -29,34 +38,493 @@ uint8_t MCP2515Interface::convertBaudrateToCANSpeed(int baudrateKbps) {
 }
 
 bool MCP2515Interface::begin(uint32_t baudrate) {
+    // Falls bereits aktiv: Empfangstask vor der Neukonfiguration anhalten
+    stopRxTask();
+
     // Convert baudrate to kbps and then to CAN speed
     uint8_t canSpeed = convertBaudrateToCANSpeed(baudrate / 1000);
-    
+
+    // Nach der Neuinitialisierung sind alle Sendepuffer frei
+    txOwnedMask = 0;
+
     // Initialize CAN bus
     if (can->begin(MCP_ANY, canSpeed, MCP_8MHZ) == CAN_OK) {
         can->setMode(MCP_NORMAL);
-        return true;
+        pinMode(intPin, INPUT);
+        // begin() schaltet die Filter ab (MCP_ANY); gespeicherten Hardwarefilter setzen
+        if (!acceptancePlan.acceptAll && !writeAcceptanceFilter(acceptancePlan)) {
+            acceptancePlan = CANHardwareFilterPlan::acceptEverything();
+        }
+        return startRxTask();
     }
     return false;
 }
 
+// Blockierend über die Sendequeue, damit txOwnedMask und txObserver jeden Frame sehen
 bool MCP2515Interface::sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) {
-    return can->sendMsgBuf(id, ext, len, buf) == CAN_OK;
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext;
+    frame.len = len > 8 ? 8 : len;
+    memcpy(frame.data, buf, frame.len);
+    return transmitBlocking(frame);
 }
 
 bool MCP2515Interface::receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) {
-    if (!messageAvailable()) {
+    CanFrame frame;
+    if (!rxRing.pop(frame)) {
         return false;
     }
-    
-    byte result = can->readMsgBuf(id, ext, len, buf);
-    return result == CAN_OK;
+
+    *id = frame.id;
+    *ext = frame.ext;
+    *len = frame.len;
+    memcpy(buf, frame.data, frame.len);
+    return true;
+}
+
+size_t MCP2515Interface::receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+    return popBurstWithTimeout(rxRing, frames, max, timeoutUs);
 }
 
 bool MCP2515Interface::messageAvailable() {
-    return !digitalRead(intPin);  // Check interrupt pin
+    return !rxRing.empty();
 }
 
 void MCP2515Interface::end() {
+    stopRxTask();
+    cancelTx();
+
+    xSemaphoreTake(spiMutex, portMAX_DELAY);
     can->setMode(MCP_SLEEP);
-}
\ No newline at end of file
+    xSemaphoreGive(spiMutex);
+}
+
+uint32_t MCP2515Interface::getRxOverrunCount() const {
+    return rxRing.overrunCount();
+}
+
+// TEC/REC und EFLG lesen; gesetzte Überlaufflags werden gezählt und zurückgesetzt
+bool MCP2515Interface::getErrorCounters(CANErrorCounters& counters) {
+    if (rxTaskHandle == nullptr) {
+        return false;
+    }
+
+    xSemaphoreTake(spiMutex, portMAX_DELAY);
+    SPI.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+    uint8_t tec = readRegister(MCP2515_REG_TEC);
+    uint8_t rec = readRegister(MCP2515_REG_REC);
+    uint8_t eflg = readRegister(MCP2515_REG_EFLG);
+    if (eflg & (MCP2515_EFLG_RX0OVR | MCP2515_EFLG_RX1OVR)) {
+        modifyRegister(MCP2515_REG_EFLG, MCP2515_EFLG_RX0OVR | MCP2515_EFLG_RX1OVR, 0x00);
+    }
+    SPI.endTransaction();
+    xSemaphoreGive(spiMutex);
+
+    if (eflg & MCP2515_EFLG_RX0OVR) rxHardwareOverruns++;
+    if (eflg & MCP2515_EFLG_RX1OVR) rxHardwareOverruns++;
+
+    counters = CANErrorCounters();
+    counters.txErrors = tec;
+    counters.rxErrors = rec;
+    counters.rxMissed = rxHardwareOverruns;
+    if (eflg & MCP2515_EFLG_TXBO) {
+        counters.state = CAN_BUS_OFF;
+    } else if (eflg & (MCP2515_EFLG_TXEP | MCP2515_EFLG_RXEP)) {
+        counters.state = CAN_BUS_ERROR_PASSIVE;
+    } else if (eflg & MCP2515_EFLG_EWARN) {
+        counters.state = CAN_BUS_ERROR_WARNING;
+    } else {
+        counters.state = CAN_BUS_ERROR_ACTIVE;
+    }
+    return true;
+}
+
+// ===================================================================================
+// Empfangstask
+// Die ISR auf CAN_INT weckt nur den Task; der SPI-Zugriff erfolgt im Task-Kontext.
+// Die beiden Hardware-Empfangspuffer des MCP2515 werden so sofort geleert, auch wenn
+// die loop() gerade mit dem Display beschäftigt ist.
+// ===================================================================================
+bool MCP2515Interface::startRxTask() {
+    if (rxTaskHandle != nullptr) {
+        return true;
+    }
+
+    rxRing.clear();
+    rxTaskActive = true;
+    if (xTaskCreatePinnedToCore(rxTaskEntry, "mcp2515_rx", CAN_RX_TASK_STACK, this,
+                                CAN_RX_TASK_PRIORITY, &rxTaskHandle, CAN_RX_TASK_CORE) != pdPASS) {
+        Serial.println("[FEHLER] MCP2515 Empfangstask konnte nicht gestartet werden");
+        rxTaskActive = false;
+        rxTaskHandle = nullptr;
+        return false;
+    }
+
+    attachInterruptArg(digitalPinToInterrupt(intPin), onCanInterrupt, this, FALLING);
+    return true;
+}
+
+void MCP2515Interface::stopRxTask() {
+    if (rxTaskHandle == nullptr) {
+        return;
+    }
+
+    detachInterrupt(digitalPinToInterrupt(intPin));
+    rxTaskActive = false;
+    xTaskNotifyGive(rxTaskHandle);
+
+    // Warten, bis der Task sich selbst beendet hat
+    while (rxTaskHandle != nullptr) {
+        vTaskDelay(1);
+    }
+}
+
+void IRAM_ATTR MCP2515Interface::onCanInterrupt(void* arg) {
+    MCP2515Interface* self = static_cast<MCP2515Interface*>(arg);
+    BaseType_t higherPriorityTaskWoken = pdFALSE;
+    // Empfangszeitpunkt, bevor der Task geweckt wird (32 Bit: auch über Kerne hinweg atomar)
+    self->irqTimestamp = (uint32_t)canTimestampUs();
+    if (self->rxTaskHandle != nullptr) {
+        vTaskNotifyGiveFromISR(self->rxTaskHandle, &higherPriorityTaskWoken);
+    }
+    portYIELD_FROM_ISR(higherPriorityTaskWoken);
+}
+
+void MCP2515Interface::rxTaskEntry(void* arg) {
+    static_cast<MCP2515Interface*>(arg)->rxTaskLoop();
+}
+
+void MCP2515Interface::rxTaskLoop() {
+    uint64_t lastStamp = 0;
+
+    while (rxTaskActive) {
+        // Auf Interrupt warten; das Timeout fängt verpasste Flanken ab
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(10));
+
+        // Solange INT aktiv ist, liegen Frames in RXB0/RXB1
+        while (rxTaskActive && !digitalRead(intPin)) {
+            CanFrame frames[2];
+
+            xSemaphoreTake(spiMutex, portMAX_DELAY);
+            size_t count = readRxBuffers(frames);
+            xSemaphoreGive(spiMutex);
+
+            if (count == 0) {
+                break;
+            }
+
+            // Zeitstempel der Interrupt-Flanke auf 64 Bit ergänzen; ist sie schon vergeben
+            // (weitere Frames bei weiterhin aktivem INT oder verpasste Flanke), den
+            // Lesezeitpunkt verwenden
+            uint64_t now = canTimestampUs();
+            uint64_t stamp = now - (uint32_t)((uint32_t)now - irqTimestamp);
+            if (stamp <= lastStamp) {
+                stamp = now;
+            }
+            lastStamp = stamp;
+
+            for (size_t i = 0; i < count; i++) {
+                frames[i].timestamp = stamp;
+                rxRing.push(frames[i]);  // Bei vollem Puffer zählt der Ring den Überlauf
+            }
+        }
+    }
+
+    rxTaskHandle = nullptr;
+    vTaskDelete(NULL);
+}
+// ===================================================================================
+// Direkter Empfangspfad
+// Statt readMsgBuf() (mehrere Registerzugriffe pro Frame) wird READ STATUS gelesen und
+// danach jeder volle Empfangspuffer mit einem READ RX BUFFER-Befehl komplett geholt.
+// Beide Puffer werden innerhalb einer SPI-Transaktion gelesen; das Lesen über
+// READ RX BUFFER löscht das zugehörige RXnIF-Flag automatisch.
+// ===================================================================================
+size_t MCP2515Interface::readRxBuffers(CanFrame* frames) {
+    size_t count = 0;
+
+    SPI.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_READ_STATUS);
+    uint8_t status = SPI.transfer(0x00);
+    digitalWrite(csPin, HIGH);
+
+    // Bit 0: RX0IF, Bit 1: RX1IF
+    if (status & 0x01) {
+        readRxBuffer(MCP2515_SPI_READ_RXB0, frames[count++]);
+    }
+    if (status & 0x02) {
+        readRxBuffer(MCP2515_SPI_READ_RXB1, frames[count++]);
+    }
+
+    SPI.endTransaction();
+    return count;
+}
+
+void MCP2515Interface::readRxBuffer(uint8_t instruction, CanFrame& frame) {
+    // SIDH, SIDL, EID8, EID0, DLC, D0..D7
+    uint8_t regs[13];
+
+    digitalWrite(csPin, LOW);
+    SPI.transfer(instruction);
+    for (uint8_t i = 0; i < sizeof(regs); i++) {
+        regs[i] = SPI.transfer(0x00);
+    }
+    digitalWrite(csPin, HIGH);
+
+    uint32_t id = ((uint32_t)regs[0] << 3) | (regs[1] >> 5);
+    frame.ext = (regs[1] & 0x08) ? 1 : 0;  // IDE
+    if (frame.ext) {
+        id = (id << 18) | ((uint32_t)(regs[1] & 0x03) << 16) | ((uint32_t)regs[2] << 8) | regs[3];
+    }
+    frame.id = id;
+
+    frame.len = regs[4] & 0x0F;
+    if (frame.len > 8) {
+        frame.len = 8;
+    }
+    memcpy(frame.data, &regs[5], frame.len);
+}
+
+uint8_t MCP2515Interface::readRegister(uint8_t address) {
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_READ);
+    SPI.transfer(address);
+    uint8_t value = SPI.transfer(0x00);
+    digitalWrite(csPin, HIGH);
+    return value;
+}
+
+void MCP2515Interface::writeRegisters(uint8_t address, const uint8_t* values, uint8_t count) {
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_WRITE);
+    SPI.transfer(address);
+    for (uint8_t i = 0; i < count; i++) {
+        SPI.transfer(values[i]);
+    }
+    digitalWrite(csPin, HIGH);
+}
+
+void MCP2515Interface::modifyRegister(uint8_t address, uint8_t mask, uint8_t value) {
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_BIT_MODIFY);
+    SPI.transfer(address);
+    SPI.transfer(mask);
+    SPI.transfer(value);
+    digitalWrite(csPin, HIGH);
+}
+
+// Betriebsart anfordern und warten, bis der Controller sie übernommen hat
+// (der Wechsel in den Konfigurationsmodus wartet das Ende eines laufenden Frames ab)
+bool MCP2515Interface::requestMode(uint8_t mode) {
+    modifyRegister(MCP2515_REG_CANCTRL, MCP2515_MODE_MASK, mode);
+    uint32_t start = millis();
+    while ((readRegister(MCP2515_REG_CANSTAT) & MCP2515_MODE_MASK) != mode) {
+        if (millis() - start >= MCP2515_MODE_TIMEOUT_MS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ===================================================================================
+// Hardware-Akzeptanzfilter
+// RXB0 prüft Maske RXM0 mit RXF0/RXF1, RXB1 Maske RXM1 mit RXF2-RXF5; ein gesetztes
+// Maskenbit wird verglichen. Die Filter nehmen nur Standard-Frames an (EXIDE = 0), die
+// EID-Bits der Maske bleiben 0, damit die Datenbytes nicht mitgeprüft werden.
+// Unbenutzte Filter einer Gruppe wiederholen deren ersten Code; eine leere Gruppe
+// wiederholt exakt einen Code der anderen Gruppe.
+// ===================================================================================
+uint8_t MCP2515Interface::acceptanceFilterLayout(uint8_t* groupSizes) const {
+    groupSizes[0] = 2;
+    groupSizes[1] = 4;
+    return 2;
+}
+
+bool MCP2515Interface::applyAcceptanceFilter(const CANHardwareFilterPlan& plan) {
+    if (rxTaskHandle == nullptr) {
+        return true;  // Noch nicht initialisiert: begin() setzt den Plan
+    }
+    return writeAcceptanceFilter(plan);
+}
+
+bool MCP2515Interface::writeAcceptanceFilter(const CANHardwareFilterPlan& plan) {
+    static const uint8_t filterAddress[2][4] = {
+        {0x00, 0x04, 0x00, 0x04},  // RXF0, RXF1 (Plätze 3/4 existieren nicht)
+        {0x08, 0x10, 0x14, 0x18}   // RXF2-RXF5
+    };
+    static const uint8_t filterCount[2] = {2, 4};
+
+    xSemaphoreTake(spiMutex, portMAX_DELAY);
+    SPI.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+
+    uint8_t previousMode = readRegister(MCP2515_REG_CANCTRL) & MCP2515_MODE_MASK;
+    bool ok = requestMode(MCP2515_MODE_CONFIG);
+
+    if (ok && plan.acceptAll) {
+        modifyRegister(MCP2515_REG_RXB0CTRL, MCP2515_RXBCTRL_RXM, MCP2515_RXBCTRL_RXM);
+        modifyRegister(MCP2515_REG_RXB0CTRL + 0x10, MCP2515_RXBCTRL_RXM, MCP2515_RXBCTRL_RXM);
+    } else if (ok) {
+        for (uint8_t g = 0; g < 2; g++) {
+            uint16_t mask = plan.mask[g];
+            uint16_t fill = plan.code[g][0];
+            if (g >= plan.groupCount || plan.codeCount[g] == 0) {
+                // Leere Gruppe: nur eine ID durchlassen, die die andere Gruppe ohnehin annimmt
+                uint8_t other = 1 - g;
+                mask = 0x7FF;
+                fill = plan.code[other][0];
+            }
+
+            uint8_t maskRegs[4] = {(uint8_t)(mask >> 3), (uint8_t)((mask & 0x07) << 5), 0, 0};
+            writeRegisters(MCP2515_REG_RXM0SIDH + 4 * g, maskRegs, sizeof(maskRegs));
+
+            for (uint8_t i = 0; i < filterCount[g]; i++) {
+                uint16_t code = (g < plan.groupCount && i < plan.codeCount[g]) ? plan.code[g][i] : fill;
+                uint8_t filterRegs[4] = {(uint8_t)(code >> 3), (uint8_t)((code & 0x07) << 5), 0, 0};
+                writeRegisters(filterAddress[g][i], filterRegs, sizeof(filterRegs));
+            }
+        }
+        modifyRegister(MCP2515_REG_RXB0CTRL, MCP2515_RXBCTRL_RXM, 0x00);
+        modifyRegister(MCP2515_REG_RXB0CTRL + 0x10, MCP2515_RXBCTRL_RXM, 0x00);
+    }
+
+    if (!requestMode(previousMode)) {
+        ok = false;
+    }
+
+    SPI.endTransaction();
+    xSemaphoreGive(spiMutex);
+
+    if (!ok) {
+        Serial.println("[FEHLER] MCP2515: Akzeptanzfilter konnten nicht gesetzt werden");
+    }
+    return ok;
+}
+
+// ===================================================================================
+// Nicht blockierender Sendepfad
+// Frame in einen freien TX-Puffer laden und per RTS starten, ohne auf den Abschluss zu
+// warten. Der MCP2515 sendet mehrere geladene Puffer nach TXP-Priorität, bei gleicher
+// Stufe den Puffer mit der höchsten Nummer zuerst. Die Stufe folgt aus der Lage der ID
+// in der Arbitrierungsreihenfolge (txPriority), sodass ein später eingereihter
+// wichtigerer Frame (NMT, SYNC, EMCY) die schon geladenen SDO- oder Heartbeat-Frames
+// überholt. Freie Puffer werden von TXB2 abwärts belegt: gemeinsam geladene Frames einer
+// Stufe gehen so in der Reihenfolge der (nach CAN-ID sortierten) Software-Queue hinaus.
+// ===================================================================================
+
+// TXP-Stufe (3 = höchste) nach CANopen-Funktionscode-Bereichen der 11-Bit-ID; bei
+// Extended-Frames zählen die oberen 11 Bit, mit denen sie gegen Standard-Frames arbitrieren
+static uint8_t txPriority(const CanFrame& frame) {
+    uint32_t baseId = frame.ext ? (frame.id >> 18) & 0x7FF : frame.id & 0x7FF;
+    if (baseId < 0x180) return 3;  // NMT, SYNC, EMCY, TIME
+    if (baseId < 0x580) return 2;  // PDOs
+    if (baseId < 0x700) return 1;  // SDO
+    return 0;                      // NMT Error Control, LSS
+}
+
+CANTxStatus MCP2515Interface::startTransmit(const CanFrame& frame, uint32_t* handle) {
+    uint8_t level = txPriority(frame);
+
+    xSemaphoreTake(spiMutex, portMAX_DELAY);
+    SPI.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+
+    // READ STATUS: Bit 2/4/6 = TXREQ von TXB0/1/2
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_READ_STATUS);
+    uint8_t status = SPI.transfer(0x00);
+    digitalWrite(csPin, HIGH);
+
+    int8_t buffer = -1;
+    for (int8_t n = MCP2515_TX_BUFFERS - 1; n >= 0; n--) {
+        if (!(status & (0x04 << (2 * n))) && !(txOwnedMask & (1 << n))) {
+            buffer = n;
+            break;
+        }
+    }
+
+    if (buffer < 0) {
+        SPI.endTransaction();
+        xSemaphoreGive(spiMutex);
+        return CAN_TX_BUSY;
+    }
+
+    uint8_t regs[5];
+    if (frame.ext) {
+        regs[0] = (uint8_t)(frame.id >> 21);
+        regs[1] = (uint8_t)((((frame.id >> 18) & 0x07) << 5) | 0x08 | ((frame.id >> 16) & 0x03));
+        regs[2] = (uint8_t)(frame.id >> 8);
+        regs[3] = (uint8_t)frame.id;
+    } else {
+        regs[0] = (uint8_t)(frame.id >> 3);
+        regs[1] = (uint8_t)((frame.id & 0x07) << 5);
+        regs[2] = 0;
+        regs[3] = 0;
+    }
+    regs[4] = frame.len & 0x0F;
+
+    // TXP-Priorität setzen
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_WRITE);
+    SPI.transfer(MCP2515_REG_TXB0CTRL + 0x10 * buffer);
+    SPI.transfer(level);
+    digitalWrite(csPin, HIGH);
+
+    // LOAD TX BUFFER: SIDH, SIDL, EID8, EID0, DLC, D0..D7
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_LOAD_TXB0 + 2 * buffer);
+    for (uint8_t i = 0; i < sizeof(regs); i++) {
+        SPI.transfer(regs[i]);
+    }
+    for (uint8_t i = 0; i < frame.len && i < 8; i++) {
+        SPI.transfer(frame.data[i]);
+    }
+    digitalWrite(csPin, HIGH);
+
+    // Request-To-Send
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_RTS | (1 << buffer));
+    digitalWrite(csPin, HIGH);
+
+    SPI.endTransaction();
+    xSemaphoreGive(spiMutex);
+
+    txOwnedMask |= (1 << buffer);
+    *handle = buffer;
+    return CAN_TX_PENDING;
+}
+
+CANTxStatus MCP2515Interface::pollTransmit(uint32_t handle) {
+    xSemaphoreTake(spiMutex, portMAX_DELAY);
+    SPI.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+    uint8_t ctrl = readRegister(MCP2515_REG_TXB0CTRL + 0x10 * handle);
+    SPI.endTransaction();
+    xSemaphoreGive(spiMutex);
+
+    // TXREQ bleibt gesetzt, solange der Controller (auch nach Fehlern) erneut sendet
+    if (ctrl & 0x08) {
+        return CAN_TX_PENDING;
+    }
+
+    txOwnedMask &= ~(1 << handle);
+    return (ctrl & 0x40) ? CAN_TX_FAILED : CAN_TX_OK;  // ABTF: Übertragung abgebrochen
+}
+
+void MCP2515Interface::abortTransmit(uint32_t handle) {
+    xSemaphoreTake(spiMutex, portMAX_DELAY);
+    SPI.beginTransaction(SPISettings(MCP2515_SPI_CLOCK, MSBFIRST, SPI_MODE0));
+
+    // BIT MODIFY: TXREQ löschen
+    digitalWrite(csPin, LOW);
+    SPI.transfer(MCP2515_SPI_BIT_MODIFY);
+    SPI.transfer(MCP2515_REG_TXB0CTRL + 0x10 * handle);
+    SPI.transfer(0x08);
+    SPI.transfer(0x00);
+    digitalWrite(csPin, HIGH);
+
+    SPI.endTransaction();
+    xSemaphoreGive(spiMutex);
+
+    txOwnedMask &= ~(1 << handle);
+}
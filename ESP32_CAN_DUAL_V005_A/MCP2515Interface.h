@@ -2,25 +2,96 @@
 #define MCP2515_INTERFACE_H
 
 #include "CANInterface.h"
+#include "CANRingBuffer.h"
 #include <mcp_can.h>
+#include <SPI.h>
+
+// MCP2515 SPI-Befehle für den direkten Empfangspfad (Datenblatt Kap. 12)
+#define MCP2515_SPI_READ_STATUS   0xA0
+#define MCP2515_SPI_READ_RXB0     0x90  // READ RX BUFFER ab RXB0SIDH, löscht RX0IF
+#define MCP2515_SPI_READ_RXB1     0x94  // READ RX BUFFER ab RXB1SIDH, löscht RX1IF
+#define MCP2515_SPI_WRITE         0x02
+#define MCP2515_SPI_READ          0x03
+#define MCP2515_SPI_BIT_MODIFY    0x05
+#define MCP2515_SPI_LOAD_TXB0     0x40  // LOAD TX BUFFER ab TXB0SIDH (TXB1: 0x42, TXB2: 0x44)
+#define MCP2515_SPI_RTS           0x80  // Request-To-Send, Bit n = TXBn
+#define MCP2515_REG_TXB0CTRL      0x30  // TXB1CTRL: 0x40, TXB2CTRL: 0x50
+#define MCP2515_TX_BUFFERS        3
+#define MCP2515_REG_RXF0SIDH      0x00  // RXF1: 0x04, RXF2: 0x08, RXF3-5: 0x10/0x14/0x18
+#define MCP2515_REG_RXM0SIDH      0x20  // RXM1: 0x24
+#define MCP2515_REG_CANSTAT       0x0E
+#define MCP2515_REG_CANCTRL       0x0F
+#define MCP2515_REG_TEC           0x1C
+#define MCP2515_REG_REC           0x1D
+#define MCP2515_REG_EFLG          0x2D
+#define MCP2515_EFLG_RX1OVR       0x80
+#define MCP2515_EFLG_RX0OVR       0x40
+#define MCP2515_EFLG_TXBO         0x20
+#define MCP2515_EFLG_TXEP         0x10
+#define MCP2515_EFLG_RXEP         0x08
+#define MCP2515_EFLG_EWARN        0x01
+#define MCP2515_REG_RXB0CTRL      0x60  // RXB1CTRL: 0x70
+#define MCP2515_RXBCTRL_RXM       0x60  // 11 = Masken/Filter aus, 00 = Filter aktiv
+#define MCP2515_MODE_MASK         0xE0  // REQOP (CANCTRL) bzw. OPMOD (CANSTAT)
+#define MCP2515_MODE_CONFIG       0x80
+#define MCP2515_MODE_TIMEOUT_MS   50
+#define MCP2515_SPI_CLOCK         10000000
 
 class MCP2515Interface : public CANInterface {
 private:
     MCP_CAN *can;
+    uint8_t csPin;
     uint8_t intPin;
-    
+
+    // Empfangspfad: CAN_INT-ISR weckt den Empfangstask, der den Ringpuffer füllt
+    CANRingBuffer<CanFrame, CAN_RX_RING_SIZE> rxRing;
+    TaskHandle_t rxTaskHandle;
+    volatile bool rxTaskActive;
+    SemaphoreHandle_t spiMutex;  // Schützt den SPI-Zugriff (Task vs. loop)
+    volatile uint32_t irqTimestamp;  // Untere 32 Bit von canTimestampUs() bei der letzten CAN_INT-Flanke
+
+    // Sendepfad: vom nicht blockierenden Pfad belegte TX-Puffer
+    uint8_t txOwnedMask;
+
+    uint32_t rxHardwareOverruns;  // Gezählte RX0OVR/RX1OVR-Flags
+
     // Private method for baudrate conversion
     uint8_t convertBaudrateToCANSpeed(int baudrateKbps);
-    
+
+    size_t readRxBuffers(CanFrame* frames);
+    void readRxBuffer(uint8_t instruction, CanFrame& frame);
+
+    uint8_t readRegister(uint8_t address);
+    void writeRegisters(uint8_t address, const uint8_t* values, uint8_t count);
+    void modifyRegister(uint8_t address, uint8_t mask, uint8_t value);
+    bool requestMode(uint8_t mode);
+    bool writeAcceptanceFilter(const CANHardwareFilterPlan& plan);
+
+    bool startRxTask();
+    void stopRxTask();
+    void rxTaskLoop();
+    static void rxTaskEntry(void* arg);
+    static void IRAM_ATTR onCanInterrupt(void* arg);
+
 public:
     MCP2515Interface(uint8_t csPin, uint8_t intPin);
     ~MCP2515Interface();
-    
+
     bool begin(uint32_t baudrate) override;
     bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override;
     bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override;
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0) override;
     bool messageAvailable() override;
     void end() override;
+    uint32_t getRxOverrunCount() const override;
+    bool getErrorCounters(CANErrorCounters& counters) override;
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override;
+    CANTxStatus pollTransmit(uint32_t handle) override;
+    void abortTransmit(uint32_t handle) override;
+    uint8_t acceptanceFilterLayout(uint8_t* groupSizes) const override;
+    bool applyAcceptanceFilter(const CANHardwareFilterPlan& plan) override;
 };
 
 #endif // MCP2515_INTERFACE_H
\ No newline at end of file
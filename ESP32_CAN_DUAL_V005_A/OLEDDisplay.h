@@ -1,6 +1,10 @@
 // OLEDDisplay.h
 // ===============================================================================
 // Konkrete Implementierung des DisplayInterface für OLED-Displays mit SSD1306
+//
+// display() übergibt das fertige Bild nur an einen Hintergrund-Task und kehrt sofort
+// zurück; der Task überträgt die geänderten Bereiche per I2C, während loop() schon das
+// nächste Bild zeichnet. Nach begin() gehört der I2C-Bus (Wire) diesem Task.
 // ===============================================================================
 
 #pragma once
@@ -9,24 +13,134 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
 
 #define OLED_ADDR  0x3C   // Typische Adresse für SSD1306-Displays
 #define SCREEN_WIDTH 128  // OLED-Display-Breite in Pixeln
 #define SCREEN_HEIGHT 64  // OLED-Display-Höhe in Pixeln
 #define OLED_RESET    -1  // Reset-Pin (-1 für gemeinsame Nutzung des Arduino-Reset)
+#define OLED_I2C_CLOCK         400000  // Takt während der Übertragung (wie Adafruit_SSD1306)
+#define OLED_I2C_RESTORE_CLOCK 100000  // Takt danach für andere I2C-Geräte
+#define OLED_I2C_CHUNK         31      // Datenbytes je I2C-Transfer (32 Byte Wire-Puffer minus Steuerbyte)
+#define OLED_FLUSH_TASK_STACK    2048
+#define OLED_FLUSH_TASK_PRIORITY 1     // Unter den CAN-Tasks
+#define OLED_FLUSH_TASK_CORE     0     // Nicht auf dem loop()-Kern
 
 class OLEDDisplay : public DisplayInterface {
 private:
     // Umbenennung der Display-Variable, um Konflikte zu vermeiden
     Adafruit_SSD1306 oledDisplay;
     bool initialized;
+
+    // Doppelpuffer: gezeichnet wird im Puffer von Adafruit_SSD1306, display() kopiert das
+    // fertige Bild nach frontBuffer. Der Flush-Task vergleicht frontBuffer mit shadow (Stand
+    // des Panels) und sendet nur die geänderten Spalten je Page. Kommen Bilder schneller als
+    // der Bus sie überträgt, wird jeweils das neueste gesendet.
+    uint8_t frontBuffer[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+    uint8_t shadow[SCREEN_WIDTH * SCREEN_HEIGHT / 8];
+    SemaphoreHandle_t frameMutex;      // Schützt frontBuffer und shadow
+    TaskHandle_t flushTaskHandle;
+    volatile bool flushTaskActive;
+
+    // Spalten first..last einer Page (8 Pixelzeilen) übertragen
+    void sendPageSpan(uint8_t page, uint8_t first, uint8_t last, const uint8_t* data) {
+        Wire.beginTransmission(OLED_ADDR);
+        Wire.write((uint8_t)0x00);                       // Steuerbyte: Befehle
+        Wire.write((uint8_t)SSD1306_COLUMNADDR);
+        Wire.write(first);
+        Wire.write(last);
+        Wire.write((uint8_t)SSD1306_PAGEADDR);
+        Wire.write(page);
+        Wire.write(page);
+        Wire.endTransmission();
+
+        size_t remaining = last - first + 1;
+        while (remaining > 0) {
+            size_t chunk = remaining > OLED_I2C_CHUNK ? OLED_I2C_CHUNK : remaining;
+            Wire.beginTransmission(OLED_ADDR);
+            Wire.write((uint8_t)0x40);                   // Steuerbyte: Daten
+            Wire.write(data, chunk);
+            Wire.endTransmission();
+            data += chunk;
+            remaining -= chunk;
+        }
+    }
+
+    // frontBuffer übertragen, soweit er sich vom Panel unterscheidet. Die Sperre gilt nur
+    // für den Vergleich einer Page, nicht für den I2C-Transfer.
+    void flushFrame() {
+        uint8_t span[SCREEN_WIDTH];
+        bool clockRaised = false;
+        for (uint8_t page = 0; page < SCREEN_HEIGHT / 8; page++) {
+            xSemaphoreTake(frameMutex, portMAX_DELAY);
+            const uint8_t* current = frontBuffer + page * SCREEN_WIDTH;
+            uint8_t* previous = shadow + page * SCREEN_WIDTH;
+
+            int first = 0;
+            while (first < SCREEN_WIDTH && current[first] == previous[first]) {
+                first++;
+            }
+            if (first == SCREEN_WIDTH) {
+                xSemaphoreGive(frameMutex);
+                continue;
+            }
+            int last = SCREEN_WIDTH - 1;
+            while (current[last] == previous[last]) {
+                last--;
+            }
+            memcpy(span, current + first, last - first + 1);
+            memcpy(previous + first, current + first, last - first + 1);
+            xSemaphoreGive(frameMutex);
+
+            if (!clockRaised) {
+                Wire.setClock(OLED_I2C_CLOCK);
+                clockRaised = true;
+            }
+            sendPageSpan(page, first, last, span);
+        }
+        if (clockRaised) {
+            Wire.setClock(OLED_I2C_RESTORE_CLOCK);
+        }
+    }
+
+    static void flushTaskEntry(void* arg) {
+        static_cast<OLEDDisplay*>(arg)->flushTaskLoop();
+    }
+
+    void flushTaskLoop() {
+        while (flushTaskActive) {
+            ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+            if (flushTaskActive) {
+                flushFrame();
+            }
+        }
+        flushTaskHandle = nullptr;
+        vTaskDelete(NULL);
+    }
+
+    void stopFlushTask() {
+        if (flushTaskHandle == nullptr) {
+            return;
+        }
+        flushTaskActive = false;
+        xTaskNotifyGive(flushTaskHandle);
+        while (flushTaskHandle != nullptr) {
+            vTaskDelay(1);
+        }
+    }
     
 public:
     OLEDDisplay() : oledDisplay(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET), 
-                    initialized(false) {}
+                    initialized(false), frameMutex(xSemaphoreCreateMutex()),
+                    flushTaskHandle(nullptr), flushTaskActive(false) {}
     
     ~OLEDDisplay() {
-        // Keine spezielle Bereinigung nötig
+        stopFlushTask();
+        if (frameMutex) {
+            vSemaphoreDelete(frameMutex);
+        }
     }
     
     bool begin() override {
@@ -45,6 +159,18 @@ public:
         oledDisplay.setCursor(0, 0);
         oledDisplay.display();
         
+        // Panel ist jetzt leer: Ausgangsstand für den Vergleich
+        memset(frontBuffer, 0, sizeof(frontBuffer));
+        memset(shadow, 0, sizeof(shadow));
+        
+        flushTaskActive = true;
+        if (xTaskCreatePinnedToCore(flushTaskEntry, "oled_flush", OLED_FLUSH_TASK_STACK, this,
+                                    OLED_FLUSH_TASK_PRIORITY, &flushTaskHandle, OLED_FLUSH_TASK_CORE) != pdPASS) {
+            Serial.println(F("[WARNUNG] OLED-Flush-Task nicht gestartet, übertrage im Aufrufer"));
+            flushTaskActive = false;
+            flushTaskHandle = nullptr;
+        }
+        
         initialized = true;
         return true;
     }
@@ -54,9 +180,20 @@ public:
         oledDisplay.setCursor(0, 0);
     }
     
-    // Korrigierte Implementierung der display-Methode
+    // Fertiges Bild übergeben; übertragen wird nur, was sich geändert hat: je Page
+    // (8 Pixelzeilen) der Spaltenbereich vom ersten bis zum letzten geänderten Byte.
+    // Unveränderte Bilder kosten keinen I2C-Transfer, eine geänderte Zeile im Menü ca.
+    // 130 statt 1024 Byte.
     void display() override {
-        oledDisplay.display();
+        xSemaphoreTake(frameMutex, portMAX_DELAY);
+        memcpy(frontBuffer, oledDisplay.getBuffer(), sizeof(frontBuffer));
+        xSemaphoreGive(frameMutex);
+        
+        if (flushTaskHandle != nullptr) {
+            xTaskNotifyGive(flushTaskHandle);
+        } else {
+            flushFrame();
+        }
     }
     
     void setCursor(int16_t x, int16_t y) override {
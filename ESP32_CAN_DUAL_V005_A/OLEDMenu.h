@@ -120,6 +120,9 @@ void startNodeTest();
 void changeNodeIdAction();
 void changeBaudrateAction();
 void toggleLiveMonitor();
+void showBusStatisticsAction();
+void showHeartbeatsAction();
+void toggleTraceView();
 void resetFilterAction();
 
 // Externe Variablen (definiert in OLEDMenu.cpp)
@@ -5,12 +5,15 @@
 
 #include "OLEDMenu.h"
 #include "CANopen.h"
+#include "CANInterface.h"
 
 // Zustandsvariablen für die Steuerung
 ControlSource activeSource = SOURCE_NONE;
 unsigned long lastActivityTime = 0;
 const unsigned long SOURCE_TIMEOUT = 3000; // 3 Sekunden Timeout
 constexpr int VERSION_DISPLAY_TIMEOUT_MS = 2000;
+constexpr int BUS_STATS_REFRESH_MS = 1000;
+constexpr int HEARTBEAT_REFRESH_MS = 500;
 
 // Zustandsvariablen für Buttons
 bool buttonUpPressed = false;
@@ -39,9 +42,14 @@ int inputMax = 127;
 int inputStep = 1;
 bool showingVersion = false;
 unsigned long versionDisplayStart = 0;
+bool showingBusStats = false;
+unsigned long busStatsDisplayTime = 0;
+bool showingHeartbeats = false;
+unsigned long heartbeatDisplayTime = 0;
 
 // Externe Referenzen zu Variablen aus dem Hauptprogramm
 extern DisplayInterface* displayInterface;
+extern CANInterface* canInterface;
 extern bool scanning;
 extern bool autoBaudrateRequest;
 extern bool liveMonitor;
@@ -66,6 +74,11 @@ extern void handleSerialCommands();
 extern void processCANScanning();
 extern void processAutoBaudrate();
 extern void processCANMessage();
+extern void resetMonitorFilter();
+extern void displayBusStatistics();
+extern void displayHeartbeatNodes();
+extern void setMonitorTraceView(bool enabled);
+extern bool monitorTraceViewActive();
 void showVersionAction();
 
 
@@ -111,6 +124,9 @@ MenuItem nodeTestMenuItems[] = {
 // Monitor-Menü-Elemente
 MenuItem monitorMenuItems[] = {
     {"Live Monitor", MENU_MONITOR, ACTION_EXECUTE, toggleLiveMonitor},
+    {"Tabellenansicht", MENU_MONITOR, ACTION_EXECUTE, toggleTraceView},
+    {"Busstatistik", MENU_MONITOR, ACTION_EXECUTE, showBusStatisticsAction},
+    {"Heartbeats", MENU_MONITOR, ACTION_EXECUTE, showHeartbeatsAction},
     {"Filter", MENU_MONITOR_FILTER, ACTION_SUBMENU, NULL},
     {"Zurueck", MENU_MAIN, ACTION_BACK, NULL}
 };
@@ -728,10 +744,10 @@ void startNodeScan() {
             return;
         }
         
-        // Scan-Prozess ausführen
+        // Scan-Prozess ausführen (die Scan-Engine arbeitet im Millisekundentakt)
         processCANScanning();
         
-        delay(50);
+        delay(1);
     }
     
     // Nach dem Scan zum Menü zurückkehren
@@ -895,10 +911,33 @@ void toggleLiveMonitor() {
     }
 }
 
+// Live-Monitor-Anzeige umschalten: Tabelle je COB-ID oder Einzelframes
+void toggleTraceView() {
+    setMonitorTraceView(!monitorTraceViewActive());
+    displayActionScreen("Monitor", monitorTraceViewActive() ? "Ansicht: Tabelle" : "Ansicht: Frames", 1000);
+    displayMenu();
+    activeSource = SOURCE_BUTTON;
+    lastActivityTime = millis();
+}
+
+// Busstatistik anzeigen; menuLoop() aktualisiert die Seite, jede Taste beendet sie
+void showBusStatisticsAction() {
+    displayBusStatistics();
+    showingBusStats = true;
+    busStatsDisplayTime = millis();
+}
+
+// Node-Liste der Heartbeat-Überwachung; menuLoop() aktualisiert sie, jede Taste beendet sie
+void showHeartbeatsAction() {
+    displayHeartbeatNodes();
+    showingHeartbeats = true;
+    heartbeatDisplayTime = millis();
+}
+
 // Filter zurücksetzen
 void resetFilterAction() {
-    // Filter zurücksetzen
-    filterEnabled = false;
+    // Filter zurücksetzen (alle Regeln)
+    resetMonitorFilter();
     
     // Bestätigung anzeigen
     displayActionScreen("Filter", "Filter zurueckgesetzt", 1000);
@@ -1036,6 +1075,38 @@ bool hasElapsed(unsigned long startTime, unsigned long durationMs) {
 
 // Hauptschleife für die Menüsteuerung
 void menuLoop() {
+    // Busstatistik-Seite: jede Taste kehrt zum Menü zurück (Druck nicht weiterreichen)
+    if (showingBusStats) {
+        if (buttonActivity()) {
+            while (buttonActivity()) {
+                delay(10);
+            }
+            showingBusStats = false;
+            displayMenu();
+            activeSource = SOURCE_BUTTON;
+            lastActivityTime = millis();
+        } else if (hasElapsed(busStatsDisplayTime, BUS_STATS_REFRESH_MS)) {
+            displayBusStatistics();
+            busStatsDisplayTime = millis();
+        }
+    }
+    
+    // Heartbeat-Seite: ebenso
+    if (showingHeartbeats) {
+        if (buttonActivity()) {
+            while (buttonActivity()) {
+                delay(10);
+            }
+            showingHeartbeats = false;
+            displayMenu();
+            activeSource = SOURCE_BUTTON;
+            lastActivityTime = millis();
+        } else if (hasElapsed(heartbeatDisplayTime, HEARTBEAT_REFRESH_MS)) {
+            displayHeartbeatNodes();
+            heartbeatDisplayTime = millis();
+        }
+    }
+
     // Button-Verarbeitung
     handleButtons();
     
@@ -1053,7 +1124,8 @@ void menuLoop() {
     }
     
     // Live-Monitor aktualisieren, wenn eine CAN-Nachricht verfügbar ist
-    if (liveMonitor && !digitalRead(CAN_INT)) {
+    // (CAN_INT wird vom Empfangstask bedient, daher den Ringpuffer abfragen)
+    if (liveMonitor && canInterface != nullptr && canInterface->messageAvailable()) {
         processCANMessage();
     }
 
@@ -0,0 +1,124 @@
+// RenderScheduler.cpp
+// ===============================================================================
+// Implementation von Bildraten-Taktung und Dirty-Regionen
+// ===============================================================================
+
+#include "RenderScheduler.h"
+
+// ===================================================================================
+// RenderScheduler
+// ===================================================================================
+
+RenderScheduler::RenderScheduler(uint16_t fps)
+    : lastFrameMs(0), anyFrame(false), pendingRender(nullptr), pendingContext(nullptr),
+      rendered(0), coalesced(0) {
+    setFrameRate(fps);
+}
+
+void RenderScheduler::setFrameRate(uint16_t framesPerSecond) {
+    fps = framesPerSecond == 0 ? 1 : framesPerSecond;
+    intervalMs = 1000 / fps;
+}
+
+void RenderScheduler::request(RenderCallback render, void* context) {
+    if (pendingRender != nullptr) {
+        coalesced++;
+    }
+    pendingRender = render;
+    pendingContext = context;
+}
+
+bool RenderScheduler::service(uint32_t nowMs) {
+    if (pendingRender == nullptr) {
+        return false;
+    }
+    if (anyFrame && nowMs - lastFrameMs < intervalMs) {
+        return false;
+    }
+
+    // Vor dem Zeichnen abräumen: die Ansicht darf selbst eine neue Anforderung stellen
+    RenderCallback render = pendingRender;
+    void* context = pendingContext;
+    pendingRender = nullptr;
+
+    lastFrameMs = nowMs;
+    anyFrame = true;
+    rendered++;
+    render(context);
+    return true;
+}
+
+// ===================================================================================
+// DirtyRegion
+// ===================================================================================
+
+DirtyRect DirtyRegion::merged(const DirtyRect& a, const DirtyRect& b) {
+    DirtyRect result;
+    result.x0 = a.x0 < b.x0 ? a.x0 : b.x0;
+    result.y0 = a.y0 < b.y0 ? a.y0 : b.y0;
+    result.x1 = a.x1 > b.x1 ? a.x1 : b.x1;
+    result.y1 = a.y1 > b.y1 ? a.y1 : b.y1;
+    return result;
+}
+
+// Überlappend oder direkt angrenzend, und die gemeinsame Hülle ist kaum größer als beide
+// zusammen (z.B. aufeinanderfolgende Textzeilen, nicht aber die Kanten eines Rahmens)
+bool DirtyRegion::touches(const DirtyRect& a, const DirtyRect& b) {
+    if (a.x0 > b.x1 || b.x0 > a.x1 || a.y0 > b.y1 || b.y0 > a.y1) {
+        return false;
+    }
+    int32_t parts = a.area() + b.area();
+    return merged(a, b).area() - parts <= parts / 4;
+}
+
+void DirtyRegion::add(int16_t x, int16_t y, int16_t w, int16_t h, int16_t width, int16_t height) {
+    DirtyRect rect;
+    rect.x0 = x < 0 ? 0 : x;
+    rect.y0 = y < 0 ? 0 : y;
+    rect.x1 = x + w > width ? width : x + w;
+    rect.y1 = y + h > height ? height : y + h;
+    if (rect.x1 <= rect.x0 || rect.y1 <= rect.y0) {
+        return;
+    }
+
+    // Mit berührenden Rechtecken verschmelzen, bis keines mehr berührt
+    bool grown = true;
+    while (grown) {
+        grown = false;
+        for (size_t i = 0; i < count; i++) {
+            if (touches(rects[i], rect)) {
+                rect = merged(rects[i], rect);
+                rects[i] = rects[--count];
+                grown = true;
+                break;
+            }
+        }
+    }
+
+    if (count < RENDER_DIRTY_RECTS) {
+        rects[count++] = rect;
+        return;
+    }
+
+    // Voll: mit dem Rechteck verschmelzen, dessen Fläche dabei am wenigsten wächst
+    size_t best = 0;
+    int32_t bestGrowth = INT32_MAX;
+    for (size_t i = 0; i < count; i++) {
+        int32_t growth = merged(rects[i], rect).area() - rects[i].area();
+        if (growth < bestGrowth) {
+            bestGrowth = growth;
+            best = i;
+        }
+    }
+    DirtyRect combined = merged(rects[best], rect);
+    rects[best] = rects[--count];
+    add(combined.x0, combined.y0, combined.x1 - combined.x0, combined.y1 - combined.y0, width, height);
+}
+
+int32_t DirtyRegion::area() const {
+    int32_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += rects[i].area();
+    }
+    return total;
+}
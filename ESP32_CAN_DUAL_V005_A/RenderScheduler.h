@@ -0,0 +1,81 @@
+// RenderScheduler.h
+// ===============================================================================
+// Taktung und Dirty-Regionen für die Displayausgabe
+//
+// RenderScheduler: Neuzeichnen wird nur angefordert (request()), gezeichnet wird aus
+// loop() höchstens mit der Ziel-Bildrate. Mehrere Anforderungen bis zum nächsten Bild
+// werden zusammengefasst, es zählt die zuletzt angeforderte Ansicht. Ein Burst von
+// CAN-Frames oder gefundenen Nodes kostet damit ein Bild statt eines pro Ereignis.
+//
+// DirtyRegion: sammelt die seit dem letzten Löschen bemalten Rechtecke, damit ein
+// Display ohne Framebuffer (TFT) beim nächsten clear() nur diese Flächen löschen muss.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RENDER_TARGET_FPS        10  // Standard-Bildrate für angeforderte Ansichten
+#define RENDER_DIRTY_RECTS       8   // Rechtecke je DirtyRegion, danach wird zusammengefasst
+
+// Zeichenfunktion einer Ansicht (zeichnet komplett und ruft display() auf)
+typedef void (*RenderCallback)(void* context);
+
+class RenderScheduler {
+public:
+    explicit RenderScheduler(uint16_t fps = RENDER_TARGET_FPS);
+
+    void setFrameRate(uint16_t fps);
+    uint16_t frameRate() const { return fps; }
+
+    // Ansicht zum Zeichnen vormerken; ersetzt eine noch nicht gezeichnete Anforderung
+    void request(RenderCallback render, void* context);
+    void cancel() { pendingRender = nullptr; }
+    bool pending() const { return pendingRender != nullptr; }
+
+    // Aus loop(): zeichnet die vorgemerkte Ansicht, wenn das Bildintervall abgelaufen
+    // ist. Liefert true, wenn gezeichnet wurde.
+    bool service(uint32_t nowMs);
+
+    uint32_t framesRendered() const { return rendered; }
+    uint32_t requestsCoalesced() const { return coalesced; }
+
+private:
+    uint16_t fps;
+    uint32_t intervalMs;
+    uint32_t lastFrameMs;
+    bool anyFrame;
+
+    RenderCallback pendingRender;
+    void* pendingContext;
+
+    uint32_t rendered;
+    uint32_t coalesced;
+};
+
+struct DirtyRect {
+    int16_t x0, y0, x1, y1;  // x1/y1 exklusiv
+
+    int32_t area() const { return (int32_t)(x1 - x0) * (y1 - y0); }
+};
+
+class DirtyRegion {
+public:
+    DirtyRegion() : count(0) {}
+
+    // Rechteck (x, y, w, h) hinzufügen; wird auf die Displayfläche begrenzt
+    void add(int16_t x, int16_t y, int16_t w, int16_t h, int16_t width, int16_t height);
+    void clear() { count = 0; }
+
+    size_t size() const { return count; }
+    const DirtyRect& rect(size_t index) const { return rects[index]; }
+    int32_t area() const;
+
+private:
+    DirtyRect rects[RENDER_DIRTY_RECTS];
+    size_t count;
+
+    static DirtyRect merged(const DirtyRect& a, const DirtyRect& b);
+    static bool touches(const DirtyRect& a, const DirtyRect& b);  // Zusammenfassen lohnt sich
+};
@@ -0,0 +1,229 @@
+// SimCANInterface.cpp
+#include "SimCANInterface.h"
+#include "CANTimestamp.h"
+
+CANSimNetwork& simNetwork() {
+    static CANSimNetwork* network = nullptr;
+    if (network == nullptr) {
+        network = new CANSimNetwork(CAN_SIM_DEFAULT_BITRATE);
+        // Busuhr auf die Zeitbasis der Zeitstempel setzen, bevor Nodes Zeitgeber planen
+        network->skipTo(canTimestampUs());
+        network->addNodes(1, CAN_SIM_DEFAULT_NODES, CAN_SIM_DEFAULT_HEARTBEAT_MS);
+    }
+    return *network;
+}
+
+SimCANInterface::SimCANInterface(CANSimNetwork& network)
+    : simNetwork(network), port(-1) {
+    memset(txSlots, 0, sizeof(txSlots));
+    txInFlightLimit = CAN_TX_INFLIGHT_LIMIT_MAX;
+}
+
+SimCANInterface::~SimCANInterface() {
+    end();
+}
+
+bool SimCANInterface::begin(uint32_t baudrate) {
+    if (baudrate == 0) {
+        return false;
+    }
+
+    if (port < 0) {
+        // Ohne Interface läuft der Bus nicht: die Zwischenzeit überspringen statt
+        // Heartbeats und Wiederholungen ohne ACK nachzuspielen
+        simNetwork.skipTo(canTimestampUs());
+        port = simNetwork.bus().attach(this, baudrate);
+        if (port < 0) {
+            Serial.println("[FEHLER] Simulation: kein freier Busanschluss");
+            return false;
+        }
+    } else {
+        advance();
+        simNetwork.bus().setPortBitrate(port, baudrate);
+    }
+    rxRing.clear();
+
+    Serial.printf("[INFO] Simulierter CAN-Bus: %lu kbit/s, %u Nodes\n",
+                  (unsigned long)(simNetwork.bus().bitrate() / 1000), simNetwork.nodeCount());
+    if (baudrate != simNetwork.bus().bitrate()) {
+        Serial.printf("[WARNUNG] Simulation: Interface mit %lu kbit/s, Bus mit %lu kbit/s - kein Empfang\n",
+                      (unsigned long)(baudrate / 1000), (unsigned long)(simNetwork.bus().bitrate() / 1000));
+    }
+    return true;
+}
+
+void SimCANInterface::advance() {
+    simNetwork.run(canTimestampUs());
+}
+
+// ===================================================================================
+// Empfang
+// ===================================================================================
+void SimCANInterface::onFrame(const CanFrame& frame) {
+    rxRing.push(frame);
+}
+
+bool SimCANInterface::receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) {
+    if (port < 0) return false;
+
+    advance();
+    CanFrame frame;
+    if (!rxRing.pop(frame)) return false;
+
+    *id = frame.id;
+    *ext = frame.ext;
+    *len = frame.len;
+    memcpy(buf, frame.data, frame.len);
+    return true;
+}
+
+size_t SimCANInterface::receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+    if (port < 0) return 0;
+
+    // Wartezeit auf den ersten Frame: der Bus muss dabei weiterlaufen
+    uint32_t start = micros();
+    advance();
+    while (rxRing.empty() && timeoutUs > 0 && micros() - start < timeoutUs) {
+        yield();
+        advance();
+    }
+    return rxRing.popBurst(frames, max);
+}
+
+bool SimCANInterface::messageAvailable() {
+    if (port < 0) return false;
+
+    advance();
+    return !rxRing.empty();
+}
+
+uint32_t SimCANInterface::getRxOverrunCount() const {
+    return rxRing.overrunCount();
+}
+
+// ===================================================================================
+// Senden
+// ===================================================================================
+SimCANInterface::TxSlot* SimCANInterface::findSlot(uint32_t handle) {
+    for (size_t i = 0; i < CAN_TX_INFLIGHT_LIMIT_MAX; i++) {
+        if (txSlots[i].handle == handle) {
+            return &txSlots[i];
+        }
+    }
+    return nullptr;
+}
+
+CANTxStatus SimCANInterface::startTransmit(const CanFrame& frame, uint32_t* handle) {
+    if (port < 0) return CAN_TX_FAILED;
+
+    TxSlot* slot = findSlot(0);
+    if (slot == nullptr) {
+        return CAN_TX_BUSY;
+    }
+
+    advance();
+    uint64_t now = simNetwork.bus().now();
+    uint32_t busHandle = simNetwork.bus().transmit(port, frame, now);
+    if (busHandle == 0) {
+        // Bus-Off nimmt nichts an, sonst ist nur der Puffer des Busses voll
+        return simNetwork.bus().portState(port).busOff(now) ? CAN_TX_FAILED : CAN_TX_BUSY;
+    }
+
+    slot->handle = busHandle;
+    slot->status = CAN_TX_PENDING;
+    *handle = busHandle;
+    return CAN_TX_PENDING;
+}
+
+void SimCANInterface::onTransmitted(uint32_t handle, bool success) {
+    TxSlot* slot = findSlot(handle);
+    if (slot != nullptr) {
+        slot->status = success ? CAN_TX_OK : CAN_TX_FAILED;
+    }
+}
+
+CANTxStatus SimCANInterface::pollTransmit(uint32_t handle) {
+    advance();
+    TxSlot* slot = findSlot(handle);
+    if (slot == nullptr) {
+        return CAN_TX_FAILED;
+    }
+    CANTxStatus status = slot->status;
+    if (status != CAN_TX_PENDING) {
+        slot->handle = 0;
+    }
+    return status;
+}
+
+void SimCANInterface::abortTransmit(uint32_t handle) {
+    simNetwork.bus().abort(handle);
+    TxSlot* slot = findSlot(handle);
+    if (slot != nullptr) {
+        slot->handle = 0;
+    }
+}
+
+bool SimCANInterface::sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext;
+    frame.len = len > 8 ? 8 : len;
+    memcpy(frame.data, buf, frame.len);
+
+    uint32_t handle = 0;
+    uint32_t start = millis();
+    CANTxStatus status;
+    while ((status = startTransmit(frame, &handle)) == CAN_TX_BUSY) {
+        if (millis() - start >= CAN_TX_TIMEOUT_MS) {
+            return false;
+        }
+        yield();
+    }
+
+    // Blockierend bis zum Ende des Frames auf dem Bus (oder kein ACK bis zum Timeout)
+    while (status == CAN_TX_PENDING) {
+        if (millis() - start >= CAN_TX_TIMEOUT_MS) {
+            abortTransmit(handle);
+            return false;
+        }
+        yield();
+        status = pollTransmit(handle);
+    }
+    return status == CAN_TX_OK;
+}
+
+// ===================================================================================
+// Fehlerzustand
+// ===================================================================================
+bool SimCANInterface::getErrorCounters(CANErrorCounters& counters) {
+    if (port < 0) return false;
+
+    advance();
+    const CANSimPortState& state = simNetwork.bus().portState(port);
+    counters = CANErrorCounters();
+    counters.txErrors = state.txErrors > 255 ? 255 : state.txErrors;
+    counters.rxErrors = state.rxErrors;
+    counters.busErrors = state.busErrors;
+    counters.arbitrationLost = state.arbitrationLost;
+
+    if (state.busOff(simNetwork.bus().now())) {
+        counters.state = CAN_BUS_OFF;
+    } else if (state.txErrors >= 128 || state.rxErrors >= 128) {
+        counters.state = CAN_BUS_ERROR_PASSIVE;
+    } else if (state.txErrors >= 96 || state.rxErrors >= 96) {
+        counters.state = CAN_BUS_ERROR_WARNING;
+    } else {
+        counters.state = CAN_BUS_ERROR_ACTIVE;
+    }
+    return true;
+}
+
+void SimCANInterface::end() {
+    cancelTx();
+    memset(txSlots, 0, sizeof(txSlots));
+
+    if (port >= 0) {
+        simNetwork.bus().detach(port);
+        port = -1;
+    }
+}
@@ -0,0 +1,69 @@
+// SimCANInterface.h
+// ===============================================================================
+// CAN-Interface auf dem virtuellen Bus (CAN_CONTROLLER_SIM)
+// Hängt sich als Teilnehmer an ein CANSimNetwork und verhält sich gegenüber Monitor,
+// Scanner und SDO-Client wie ein echter Controller: Empfangs-Ringpuffer mit
+// Zeitstempeln, nicht blockierender Sendepfad mit Abschlussmeldung, Fehlerzähler.
+// Der Bus läuft nicht in einem eigenen Task, sondern wird bei jedem Zugriff bis zur
+// aktuellen Zeit (canTimestampUs) abgespielt.
+//
+// Mit begin() eingestellte Bitrate ungleich der Busbitrate: nichts empfangen, beim
+// Senden Busfehler - damit lässt sich auch die automatische Bitratenerkennung testen.
+// ===============================================================================
+
+#pragma once
+
+#include "CANInterface.h"
+#include "CANRingBuffer.h"
+#include "CANSimNode.h"
+
+// Voreinstellung des gemeinsamen Simulationsnetzes (simNetwork())
+#define CAN_SIM_DEFAULT_BITRATE       500000
+#define CAN_SIM_DEFAULT_NODES         3      // Nodes 1..n
+#define CAN_SIM_DEFAULT_HEARTBEAT_MS  1000
+
+class SimCANInterface : public CANInterface, public CANSimParticipant {
+private:
+    CANSimNetwork& simNetwork;
+    int port;
+
+    CANRingBuffer<CanFrame, CAN_RX_RING_SIZE> rxRing;
+
+    // Übergebene Frames bis zur Abfrage durch pollTransmit() (handle 0 = frei)
+    struct TxSlot {
+        uint32_t handle;
+        CANTxStatus status;
+    };
+    TxSlot txSlots[CAN_TX_INFLIGHT_LIMIT_MAX];
+
+    // Bus bis jetzt abspielen
+    void advance();
+    TxSlot* findSlot(uint32_t handle);
+
+public:
+    explicit SimCANInterface(CANSimNetwork& network);
+    ~SimCANInterface();
+
+    bool begin(uint32_t baudrate) override;
+    bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override;
+    bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override;
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0) override;
+    bool messageAvailable() override;
+    void end() override;
+    uint32_t getRxOverrunCount() const override;
+    bool getErrorCounters(CANErrorCounters& counters) override;
+
+    CANSimNetwork& network() { return simNetwork; }
+
+    // CANSimParticipant
+    void onFrame(const CanFrame& frame) override;
+    void onTransmitted(uint32_t handle, bool success) override;
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override;
+    CANTxStatus pollTransmit(uint32_t handle) override;
+    void abortTransmit(uint32_t handle) override;
+};
+
+// Gemeinsames Simulationsnetz (beim ersten Aufruf mit den Voreinstellungen angelegt)
+CANSimNetwork& simNetwork();
@@ -0,0 +1,454 @@
+// SocketCANInterface.cpp
+#include "SocketCANInterface.h"
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/can/error.h>
+#include <linux/can/raw.h>
+#include "CANTimestamp.h"
+
+#ifndef CAN_ERR_CNT
+#define CAN_ERR_CNT 0x00000200U  // TEC/REC in data[6]/data[7] gültig (ab Linux 5.16)
+#endif
+
+SocketCANInterface::SocketCANInterface(const char* name)
+    : fd(-1), kernelDropped(0), nextTxHandle(1) {
+    snprintf(interfaceName, IFNAMSIZ, "%s", name);
+    memset(txEntries, 0, sizeof(txEntries));
+    errorCounters = CANErrorCounters();
+    errorCounters.state = CAN_BUS_STOPPED;
+    txInFlightLimit = SOCKETCAN_BATCH;
+}
+
+SocketCANInterface::~SocketCANInterface() {
+    end();
+}
+
+bool SocketCANInterface::begin(uint32_t baudrate) {
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+
+    fd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0) {
+        Serial.printf("[FEHLER] SocketCAN: socket() fehlgeschlagen: %s\n", strerror(errno));
+        return false;
+    }
+
+    struct ifreq ifr = {};
+    snprintf(ifr.ifr_name, IFNAMSIZ, "%s", interfaceName);
+    if (ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+        Serial.printf("[FEHLER] SocketCAN: Interface %s nicht gefunden\n", interfaceName);
+        end();
+        return false;
+    }
+    int ifindex = ifr.ifr_ifindex;
+    if (ioctl(fd, SIOCGIFFLAGS, &ifr) == 0 && !(ifr.ifr_flags & IFF_UP)) {
+        Serial.printf("[FEHLER] SocketCAN: %s ist nicht aktiv (ip link set %s up type can bitrate %lu)\n",
+                      interfaceName, interfaceName, (unsigned long)baudrate);
+        end();
+        return false;
+    }
+
+    // Fehlerframes für Zustand und Zähler, Kernel-Zeitstempel, Zähler verworfener Frames
+    can_err_mask_t errorMask = CAN_ERR_CRTL | CAN_ERR_BUSOFF | CAN_ERR_RESTARTED | CAN_ERR_LOSTARB |
+                               CAN_ERR_PROT | CAN_ERR_BUSERROR | CAN_ERR_ACK;
+    int one = 1;
+    int rcvbuf = SOCKETCAN_RCVBUF;
+    setsockopt(fd, SOL_CAN_RAW, CAN_RAW_ERR_FILTER, &errorMask, sizeof(errorMask));
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_can address = {};
+    address.can_family = AF_CAN;
+    address.can_ifindex = ifindex;
+    if (bind(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        Serial.printf("[FEHLER] SocketCAN: bind an %s fehlgeschlagen: %s\n", interfaceName, strerror(errno));
+        end();
+        return false;
+    }
+
+    rxRing.clear();
+    kernelDropped = 0;
+    errorCounters = CANErrorCounters();
+    errorCounters.state = CAN_BUS_ERROR_ACTIVE;
+
+    // Zuletzt gesetzten Akzeptanzfilter übernehmen
+    if (!applyAcceptanceFilter(acceptancePlan)) {
+        Serial.println("[WARNUNG] SocketCAN: Akzeptanzfilter nicht gesetzt, empfange alles");
+    }
+
+    Serial.printf("[INFO] SocketCAN %s geöffnet (Bitrate stellt das Netzwerkinterface ein, erwartet: %lu kbit/s)\n",
+                  interfaceName, (unsigned long)(baudrate / 1000));
+    return true;
+}
+
+void SocketCANInterface::end() {
+    cancelTx();
+    memset(txEntries, 0, sizeof(txEntries));
+
+    if (fd >= 0) {
+        close(fd);
+        fd = -1;
+    }
+    errorCounters.state = CAN_BUS_STOPPED;
+}
+
+// ===================================================================================
+// Empfang
+// recvmmsg holt bis zu SOCKETCAN_BATCH Frames pro Systemaufruf in den Ringpuffer.
+// SO_TIMESTAMP liefert CLOCK_REALTIME; umgerechnet wird mit dem Abstand zur
+// monotonen Zeitbasis zum Zeitpunkt des Abholens.
+// ===================================================================================
+bool SocketCANInterface::fillRx(uint32_t timeoutUs) {
+    if (fd < 0) {
+        return false;
+    }
+    size_t space = rxRing.capacity() - rxRing.size();
+    size_t batch = space < SOCKETCAN_BATCH ? space : SOCKETCAN_BATCH;
+    if (batch == 0) {
+        return true;
+    }
+
+    if (timeoutUs > 0) {
+        struct pollfd request = {fd, POLLIN, 0};
+        struct timespec timeout = {(time_t)(timeoutUs / 1000000), (long)(timeoutUs % 1000000) * 1000};
+        if (ppoll(&request, 1, &timeout, nullptr) <= 0) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < batch; i++) {
+        rxIov[i].iov_base = &rxFrames[i];
+        rxIov[i].iov_len = sizeof(struct can_frame);
+        memset(&rxMsgs[i].msg_hdr, 0, sizeof(rxMsgs[i].msg_hdr));
+        rxMsgs[i].msg_hdr.msg_iov = &rxIov[i];
+        rxMsgs[i].msg_hdr.msg_iovlen = 1;
+        rxMsgs[i].msg_hdr.msg_control = rxControl[i];
+        rxMsgs[i].msg_hdr.msg_controllen = sizeof(rxControl[i]);
+    }
+
+    int count = recvmmsg(fd, rxMsgs, batch, MSG_DONTWAIT, nullptr);
+    if (count <= 0) {
+        return false;
+    }
+
+    struct timespec realtime;
+    clock_gettime(CLOCK_REALTIME, &realtime);
+    uint64_t now = canTimestampUs();
+    int64_t offset = (int64_t)now - ((int64_t)realtime.tv_sec * 1000000 + realtime.tv_nsec / 1000);
+
+    for (int i = 0; i < count; i++) {
+        const struct can_frame& kernelFrame = rxFrames[i];
+        if (rxMsgs[i].msg_len < sizeof(struct can_frame)) {
+            continue;
+        }
+
+        uint64_t timestamp = now;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&rxMsgs[i].msg_hdr); cmsg != nullptr;
+             cmsg = CMSG_NXTHDR(&rxMsgs[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SCM_TIMESTAMP) {
+                struct timeval tv;
+                memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+                timestamp = (uint64_t)((int64_t)tv.tv_sec * 1000000 + tv.tv_usec + offset);
+            } else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                memcpy(&kernelDropped, CMSG_DATA(cmsg), sizeof(kernelDropped));
+            }
+        }
+
+        if (kernelFrame.can_id & CAN_ERR_FLAG) {
+            handleErrorFrame(kernelFrame);
+            continue;
+        }
+
+        // Remote-Frames kommen ohne Daten an (CanFrame kennt kein RTR-Bit)
+        CanFrame frame = {};
+        frame.ext = (kernelFrame.can_id & CAN_EFF_FLAG) ? 1 : 0;
+        frame.id = kernelFrame.can_id & (frame.ext ? CAN_EFF_MASK : CAN_SFF_MASK);
+        frame.len = kernelFrame.can_dlc > 8 ? 8 : kernelFrame.can_dlc;
+        if (!(kernelFrame.can_id & CAN_RTR_FLAG)) {
+            memcpy(frame.data, kernelFrame.data, frame.len);
+        }
+        frame.timestamp = timestamp;
+        rxRing.push(frame);
+    }
+    return true;
+}
+
+void SocketCANInterface::handleErrorFrame(const struct can_frame& frame) {
+    canid_t error = frame.can_id;
+
+    if (error & CAN_ERR_LOSTARB) {
+        errorCounters.arbitrationLost++;
+    }
+    if (error & (CAN_ERR_PROT | CAN_ERR_BUSERROR | CAN_ERR_ACK)) {
+        errorCounters.busErrors++;
+    }
+    if (error & CAN_ERR_CRTL) {
+        uint8_t status = frame.data[1];
+        if (status & CAN_ERR_CRTL_RX_OVERFLOW) {
+            errorCounters.rxMissed++;
+        }
+        if (status & (CAN_ERR_CRTL_RX_PASSIVE | CAN_ERR_CRTL_TX_PASSIVE)) {
+            errorCounters.state = CAN_BUS_ERROR_PASSIVE;
+        } else if (status & (CAN_ERR_CRTL_RX_WARNING | CAN_ERR_CRTL_TX_WARNING)) {
+            errorCounters.state = CAN_BUS_ERROR_WARNING;
+        } else if (status & CAN_ERR_CRTL_ACTIVE) {
+            errorCounters.state = CAN_BUS_ERROR_ACTIVE;
+        }
+    }
+    if (error & CAN_ERR_BUSOFF) {
+        errorCounters.state = CAN_BUS_OFF;
+    }
+    if (error & CAN_ERR_RESTARTED) {
+        errorCounters.state = CAN_BUS_ERROR_ACTIVE;
+    }
+    if (error & CAN_ERR_CNT) {
+        errorCounters.txErrors = frame.data[6];
+        errorCounters.rxErrors = frame.data[7];
+    }
+}
+
+bool SocketCANInterface::receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) {
+    if (rxRing.empty()) {
+        fillRx(0);
+    }
+
+    CanFrame frame;
+    if (!rxRing.pop(frame)) return false;
+
+    *id = frame.id;
+    *ext = frame.ext;
+    *len = frame.len;
+    memcpy(buf, frame.data, frame.len);
+    return true;
+}
+
+size_t SocketCANInterface::receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+    if (fd < 0) return 0;
+
+    flushTx();
+    if (rxRing.size() < max) {
+        fillRx(rxRing.empty() ? timeoutUs : 0);
+    }
+    return rxRing.popBurst(frames, max);
+}
+
+bool SocketCANInterface::messageAvailable() {
+    if (fd < 0) return false;
+
+    flushTx();
+    if (rxRing.empty()) {
+        fillRx(0);
+    }
+    return !rxRing.empty();
+}
+
+uint32_t SocketCANInterface::getRxOverrunCount() const {
+    return kernelDropped;
+}
+
+bool SocketCANInterface::getErrorCounters(CANErrorCounters& counters) {
+    if (fd < 0) return false;
+
+    fillRx(0);  // Anstehende Fehlerframes auswerten
+    counters = errorCounters;
+    return true;
+}
+
+// ===================================================================================
+// Senden
+// startTransmit() sammelt bis zu SOCKETCAN_BATCH Frames; flushTx() übergibt sie in
+// Prioritätsreihenfolge mit einem sendmmsg. Abgeschlossen heißt hier: vom Kernel
+// angenommen (die Sendequeue des Netzwerkinterfaces liegt danach beim Treiber).
+// ===================================================================================
+void SocketCANInterface::toKernelFrame(const CanFrame& frame, struct can_frame& out) {
+    memset(&out, 0, sizeof(out));
+    out.can_id = frame.ext ? ((frame.id & CAN_EFF_MASK) | CAN_EFF_FLAG) : (frame.id & CAN_SFF_MASK);
+    out.can_dlc = frame.len > 8 ? 8 : frame.len;
+    memcpy(out.data, frame.data, out.can_dlc);
+}
+
+SocketCANInterface::TxEntry* SocketCANInterface::findTx(uint32_t handle) {
+    for (size_t i = 0; i < SOCKETCAN_BATCH; i++) {
+        if (txEntries[i].used && txEntries[i].handle == handle) {
+            return &txEntries[i];
+        }
+    }
+    return nullptr;
+}
+
+void SocketCANInterface::flushTx() {
+    if (fd < 0) {
+        return;
+    }
+
+    // Offene Frames in Übergabereihenfolge (Handles steigen)
+    TxEntry* batch[SOCKETCAN_BATCH];
+    size_t count = 0;
+    for (size_t i = 0; i < SOCKETCAN_BATCH; i++) {
+        if (!txEntries[i].used || txEntries[i].status != CAN_TX_PENDING) {
+            continue;
+        }
+        size_t pos = count++;
+        while (pos > 0 && (int32_t)(batch[pos - 1]->handle - txEntries[i].handle) > 0) {
+            batch[pos] = batch[pos - 1];
+            pos--;
+        }
+        batch[pos] = &txEntries[i];
+    }
+    if (count == 0) {
+        return;
+    }
+
+    struct can_frame frames[SOCKETCAN_BATCH];
+    struct iovec iov[SOCKETCAN_BATCH];
+    struct mmsghdr msgs[SOCKETCAN_BATCH];
+    memset(msgs, 0, sizeof(msgs));
+    for (size_t i = 0; i < count; i++) {
+        toKernelFrame(batch[i]->frame, frames[i]);
+        iov[i].iov_base = &frames[i];
+        iov[i].iov_len = sizeof(struct can_frame);
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sent = sendmmsg(fd, msgs, count, MSG_DONTWAIT);
+    if (sent < 0) {
+        if (errno != EAGAIN && errno != ENOBUFS) {
+            batch[0]->status = CAN_TX_FAILED;  // Nicht den ganzen Stapel blockieren
+        }
+        return;  // Sendequeue voll: beim nächsten Aufruf erneut
+    }
+    for (int i = 0; i < sent; i++) {
+        batch[i]->status = CAN_TX_OK;
+    }
+}
+
+CANTxStatus SocketCANInterface::startTransmit(const CanFrame& frame, uint32_t* handle) {
+    if (fd < 0) return CAN_TX_FAILED;
+
+    TxEntry* entry = nullptr;
+    size_t used = 0;
+    for (size_t i = 0; i < SOCKETCAN_BATCH; i++) {
+        if (txEntries[i].used) {
+            used++;
+        } else if (entry == nullptr) {
+            entry = &txEntries[i];
+        }
+    }
+    if (entry == nullptr) {
+        return CAN_TX_BUSY;
+    }
+
+    entry->frame = frame;
+    entry->handle = nextTxHandle++;
+    entry->status = CAN_TX_PENDING;
+    entry->used = true;
+    *handle = entry->handle;
+
+    if (used + 1 == SOCKETCAN_BATCH) {
+        flushTx();  // Stapel voll
+    }
+    return CAN_TX_PENDING;
+}
+
+CANTxStatus SocketCANInterface::pollTransmit(uint32_t handle) {
+    flushTx();
+    TxEntry* entry = findTx(handle);
+    if (entry == nullptr) {
+        return CAN_TX_FAILED;
+    }
+    CANTxStatus status = entry->status;
+    if (status != CAN_TX_PENDING) {
+        entry->used = false;
+    }
+    return status;
+}
+
+void SocketCANInterface::abortTransmit(uint32_t handle) {
+    TxEntry* entry = findTx(handle);
+    if (entry != nullptr) {
+        entry->used = false;
+    }
+}
+
+bool SocketCANInterface::sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) {
+    if (fd < 0) return false;
+
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext;
+    frame.len = len > 8 ? 8 : len;
+    memcpy(frame.data, buf, frame.len);
+
+    struct can_frame kernelFrame;
+    toKernelFrame(frame, kernelFrame);
+    flushTx();  // Reihenfolge zu bereits gesammelten Frames wahren
+
+    uint64_t deadline = canTimestampUs() + CAN_TX_TIMEOUT_MS * 1000ULL;
+    while (true) {
+        if (write(fd, &kernelFrame, sizeof(kernelFrame)) == (ssize_t)sizeof(kernelFrame)) {
+            return true;
+        }
+        uint64_t now = canTimestampUs();
+        if ((errno != EAGAIN && errno != ENOBUFS) || now >= deadline) {
+            return false;
+        }
+        if (errno == EAGAIN) {
+            struct pollfd request = {fd, POLLOUT, 0};
+            poll(&request, 1, (int)((deadline - now + 999) / 1000));
+        } else {
+            usleep(100);  // ENOBUFS: Queue des Interfaces voll, poll() meldet das nicht
+        }
+    }
+}
+
+// ===================================================================================
+// Akzeptanzfilter: CAN_RAW_FILTER nimmt beliebig viele Muster; das Layout entspricht
+// der größten Gruppenzahl des Planers (2 Masken mit je 4 Codes)
+// ===================================================================================
+uint8_t SocketCANInterface::acceptanceFilterLayout(uint8_t* groupSizes) const {
+    groupSizes[0] = CAN_HW_FILTER_MAX_CODES;
+    groupSizes[1] = CAN_HW_FILTER_MAX_CODES;
+    return CAN_HW_FILTER_MAX_GROUPS;
+}
+
+bool SocketCANInterface::applyAcceptanceFilter(const CANHardwareFilterPlan& plan) {
+    if (fd < 0) {
+        return true;  // begin() setzt den Plan
+    }
+
+    struct can_filter filters[CAN_HW_FILTER_MAX_GROUPS * CAN_HW_FILTER_MAX_CODES];
+    size_t count = 0;
+    if (plan.acceptAll) {
+        filters[count].can_id = 0;
+        filters[count].can_mask = 0;
+        count++;
+    } else {
+        for (uint8_t g = 0; g < plan.groupCount; g++) {
+            for (uint8_t i = 0; i < plan.codeCount[g]; i++) {
+                // EFF-Bit in der Maske: nur Standard-Frames passen
+                filters[count].can_id = plan.code[g][i] & CAN_SFF_MASK;
+                filters[count].can_mask = (plan.mask[g] & CAN_SFF_MASK) | CAN_EFF_FLAG;
+                count++;
+            }
+        }
+    }
+    return setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, count > 0 ? filters : nullptr,
+                      count * sizeof(struct can_filter)) == 0;
+}
+
+#endif  // __linux__
@@ -0,0 +1,85 @@
+// SocketCANInterface.h
+// ===============================================================================
+// CAN-Interface über Linux-SocketCAN (Raw-Socket PF_CAN, z.B. can0 oder vcan0)
+// Damit laufen Monitor, Scanner und CANopen-Klasse unverändert auf einem Linux-
+// Gateway bzw. Testrechner. Empfang und Senden arbeiten stapelweise (recvmmsg/
+// sendmmsg, bis SOCKETCAN_BATCH Frames pro Systemaufruf); die Empfangszeitstempel
+// kommen vom Kernel (SO_TIMESTAMP) und werden auf die Zeitbasis von canTimestampUs()
+// umgerechnet. Fehlerframes des Kernels liefern Fehlerzustand, TEC/REC und Zähler.
+//
+// Die Bitrate stellt unter Linux das Netzwerkinterface ein
+// (ip link set can0 type can bitrate 500000); begin() prüft nur, ob es läuft.
+// Nur unter Linux übersetzt; im ESP32-Build bleibt die Datei leer.
+// ===============================================================================
+
+#pragma once
+
+#if defined(__linux__)
+
+#include <linux/can.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include "CANInterface.h"
+#include "CANRingBuffer.h"
+
+#define SOCKETCAN_DEFAULT_INTERFACE  "can0"
+#define SOCKETCAN_BATCH              CAN_TX_INFLIGHT_LIMIT_MAX  // Frames pro recvmmsg/sendmmsg
+#define SOCKETCAN_RCVBUF             (256 * 1024)               // Socket-Empfangspuffer (Bytes)
+
+class SocketCANInterface : public CANInterface {
+private:
+    int fd;
+    char interfaceName[IFNAMSIZ];
+
+    // Empfang: recvmmsg füllt den Ringpuffer stapelweise
+    CANRingBuffer<CanFrame, CAN_RX_RING_SIZE> rxRing;
+    struct can_frame rxFrames[SOCKETCAN_BATCH];
+    struct iovec rxIov[SOCKETCAN_BATCH];
+    struct mmsghdr rxMsgs[SOCKETCAN_BATCH];
+    char rxControl[SOCKETCAN_BATCH][CMSG_SPACE(sizeof(struct timeval)) + CMSG_SPACE(sizeof(uint32_t))];
+    uint32_t kernelDropped;  // SO_RXQ_OVFL: vom Kernel verworfene Frames
+
+    // Senden: startTransmit() sammelt, flushTx() übergibt mit einem sendmmsg
+    struct TxEntry {
+        CanFrame frame;
+        uint32_t handle;
+        CANTxStatus status;  // CAN_TX_PENDING bis zur Übergabe an den Kernel
+        bool used;
+    };
+    TxEntry txEntries[SOCKETCAN_BATCH];
+    uint32_t nextTxHandle;
+
+    // Aus Fehlerframes gesammelter Zustand
+    CANErrorCounters errorCounters;
+
+    bool fillRx(uint32_t timeoutUs);
+    void handleErrorFrame(const struct can_frame& frame);
+    void flushTx();
+    TxEntry* findTx(uint32_t handle);
+    static void toKernelFrame(const CanFrame& frame, struct can_frame& out);
+
+public:
+    explicit SocketCANInterface(const char* name = SOCKETCAN_DEFAULT_INTERFACE);
+    ~SocketCANInterface();
+
+    bool begin(uint32_t baudrate) override;
+    bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override;
+    bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override;
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0) override;
+    bool messageAvailable() override;
+    void end() override;
+    uint32_t getRxOverrunCount() const override;
+    bool getErrorCounters(CANErrorCounters& counters) override;
+
+    const char* name() const { return interfaceName; }
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override;
+    CANTxStatus pollTransmit(uint32_t handle) override;
+    void abortTransmit(uint32_t handle) override;
+    uint8_t acceptanceFilterLayout(uint8_t* groupSizes) const override;
+    bool applyAcceptanceFilter(const CANHardwareFilterPlan& plan) override;
+};
+
+#endif  // __linux__
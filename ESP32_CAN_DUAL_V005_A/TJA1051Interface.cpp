@@ -1,8 +1,10 @@
 // TJA1051Interface.cpp
 #include "TJA1051Interface.h"
+#include "CANTimestamp.h"
 
 TJA1051Interface::TJA1051Interface(uint8_t stbyPin) 
-    : initialized(false), stbyPin(stbyPin) {
+    : initialized(false), stbyPin(stbyPin), rxTaskHandle(nullptr), rxTaskActive(false),
+      txSubmitted(0), txFailedSeen(0) {
     
     // Standby-Pin konfigurieren, falls vorhanden
     if (stbyPin != 255) {
@@ -23,14 +25,14 @@ bool TJA1051Interface::begin(uint32_t baudrate) {
     gpio_reset_pin((gpio_num_t)17);  // RX Pin
 
     // Generische TWAI-Konfiguration mit expliziten Pins
-    twai_general_config_t g_config = TWAI_GENERAL_CONFIG_DEFAULT(
+    g_config = TWAI_GENERAL_CONFIG_DEFAULT(
         (gpio_num_t)18,   // TX Pin für ESP32-S3-Touch-LCD-4.3B
         (gpio_num_t)17,   // RX Pin für ESP32-S3-Touch-LCD-4.3B
         TWAI_MODE_NORMAL
     );
+    g_config.rx_queue_len = TJA1051_RX_QUEUE_LEN;
 
     // Baudrate-spezifische Timing-Konfiguration
-    twai_timing_config_t t_config;
     switch(baudrate / 1000) {
         case 1000:
             t_config = TWAI_TIMING_CONFIG_1MBITS();
@@ -49,10 +51,19 @@ bool TJA1051Interface::begin(uint32_t baudrate) {
             return false;
     }
 
-    // Filter-Konfiguration
-    twai_filter_config_t f_config = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+    // Filter-Konfiguration (zuletzt gesetzter Hardwarefilter, anfangs alles annehmen)
+    f_config = makeFilterConfig(acceptancePlan);
 
-    // Treiber-Installation
+    if (!installDriver()) {
+        return false;
+    }
+
+    Serial.println("[DEBUG] TJA1051 erfolgreich initialisiert");
+    return true;
+}
+
+// Treiber mit g_config/t_config/f_config installieren und starten
+bool TJA1051Interface::installDriver() {
     esp_err_t result = twai_driver_install(&g_config, &t_config, &f_config);
     if (result != ESP_OK) {
         Serial.printf("[FEHLER] TWAI-Treiber-Installation fehlgeschlagen: %s\n", esp_err_to_name(result));
@@ -67,51 +78,216 @@ bool TJA1051Interface::begin(uint32_t baudrate) {
         return false;
     }
 
-    Serial.println("[DEBUG] TJA1051 erfolgreich initialisiert");
+    // Neuer Treiber: Zähler des Sendepfads zurücksetzen
+    txSubmitted = 0;
+    txFailedSeen = 0;
+
+    // Empfangstask starten
+    if (!startRxTask()) {
+        twai_stop();
+        twai_driver_uninstall();
+        return false;
+    }
+
     initialized = true;
     return true;
 }
 
+// ===================================================================================
+// Hardware-Akzeptanzfilter
+// Dual Filter Mode: zwei unabhängige Muster für Standard-IDs (Bits 31-21 bzw. 15-5 von
+// Code und Maske). Single Filter Mode: ein Muster in Bits 31-21. RTR- und Datenbits
+// bleiben offen. Beim TWAI bedeutet ein gesetztes Maskenbit "nicht vergleichen".
+// ===================================================================================
+uint8_t TJA1051Interface::acceptanceFilterLayout(uint8_t* groupSizes) const {
+    groupSizes[0] = 1;
+    groupSizes[1] = 1;
+    return 2;
+}
+
+twai_filter_config_t TJA1051Interface::makeFilterConfig(const CANHardwareFilterPlan& plan) {
+    if (plan.acceptAll || plan.groupCount == 0) {
+        twai_filter_config_t acceptAll = TWAI_FILTER_CONFIG_ACCEPT_ALL();
+        return acceptAll;
+    }
+
+    // Belegte Gruppen einsammeln (eine Gruppe des Plans kann leer sein)
+    uint8_t used[CAN_HW_FILTER_MAX_GROUPS];
+    uint8_t usedCount = 0;
+    for (uint8_t g = 0; g < plan.groupCount; g++) {
+        if (plan.codeCount[g] > 0) {
+            used[usedCount++] = g;
+        }
+    }
+
+    twai_filter_config_t config;
+    uint8_t first = used[0];
+    if (usedCount == 1) {
+        config.single_filter = true;
+        config.acceptance_code = (uint32_t)plan.code[first][0] << 21;
+        config.acceptance_mask = ~((uint32_t)plan.mask[first] << 21);
+    } else {
+        uint8_t second = used[1];
+        config.single_filter = false;
+        config.acceptance_code = ((uint32_t)plan.code[first][0] << 21) | ((uint32_t)plan.code[second][0] << 5);
+        config.acceptance_mask = ~(((uint32_t)plan.mask[first] << 21) | ((uint32_t)plan.mask[second] << 5));
+    }
+    return config;
+}
+
+bool TJA1051Interface::applyAcceptanceFilter(const CANHardwareFilterPlan& plan) {
+    f_config = makeFilterConfig(plan);
+    if (!initialized) {
+        return true;  // Wird von begin() gesetzt
+    }
+
+    // Der TWAI-Treiber übernimmt Filter nur bei der Installation: neu installieren.
+    // Dabei gehen noch nicht abgeholte Frames und offene Sendungen verloren.
+    stopRxTask();
+    cancelTx();
+    twai_stop();
+    twai_driver_uninstall();
+    initialized = false;
+
+    if (!installDriver()) {
+        Serial.println("[FEHLER] TWAI-Treiber nach Filteränderung nicht wieder gestartet");
+        return false;
+    }
+    return true;
+}
+
+// Blockierendes Senden über die eigene Sendequeue: so landet jeder Frame über
+// startTransmit() in der Treiberqueue und pollTransmit() kann tx_failed_count-Inkremente
+// ohne unverfolgte Frames dazwischen zuordnen
 bool TJA1051Interface::sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) {
     if (!initialized) return false;
 
-    twai_message_t message;
-    message.identifier = id;
-    message.extd = ext ? 1 : 0;
-    message.data_length_code = len;
-    
-    memcpy(message.data, buf, len);
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext;
+    frame.len = len > 8 ? 8 : len;
+    memcpy(frame.data, buf, frame.len);
+    return transmitBlocking(frame);
+}
+
+// ===================================================================================
+// Nicht blockierender Sendepfad
+// Die TWAI-Treiberqueue arbeitet streng FIFO. Ein Frame gilt als abgeschlossen, sobald
+// mehr Frames die Queue verlassen haben, als vor ihm übergeben wurden. Alle Frames
+// (auch die von sendMessage()) kommen über startTransmit() in die Treiberqueue.
+// ===================================================================================
+CANTxStatus TJA1051Interface::startTransmit(const CanFrame& frame, uint32_t* handle) {
+    if (!initialized) return CAN_TX_FAILED;
+
+    twai_message_t message = {};
+    message.identifier = frame.id;
+    message.extd = frame.ext ? 1 : 0;
+    message.data_length_code = frame.len;
+    memcpy(message.data, frame.data, frame.len);
+
+    esp_err_t result = twai_transmit(&message, 0);
+    if (result == ESP_ERR_TIMEOUT) {
+        return CAN_TX_BUSY;  // Treiberqueue voll
+    }
+    if (result != ESP_OK) {
+        return CAN_TX_FAILED;
+    }
+
+    *handle = txSubmitted++;
+    return CAN_TX_PENDING;
+}
+
+CANTxStatus TJA1051Interface::pollTransmit(uint32_t handle) {
+    if (!initialized) return CAN_TX_FAILED;
+
+    twai_status_info_t status;
+    if (twai_get_status_info(&status) != ESP_OK) {
+        return CAN_TX_FAILED;
+    }
+
+    uint32_t completed = txSubmitted - status.msgs_to_tx;
+    if ((int32_t)(handle - completed) >= 0) {
+        return CAN_TX_PENDING;
+    }
 
-    esp_err_t result = twai_transmit(&message, pdMS_TO_TICKS(1000));
-    return result == ESP_OK;
+    // Fehlschläge in Abschlussreihenfolge zuordnen (der Aufrufer fragt FIFO ab)
+    if (status.tx_failed_count != txFailedSeen) {
+        txFailedSeen++;
+        return CAN_TX_FAILED;
+    }
+    return CAN_TX_OK;
 }
 
 bool TJA1051Interface::receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) {
     if (!initialized) return false;
 
-    twai_message_t message;
-    esp_err_t result = twai_receive(&message, pdMS_TO_TICKS(100));
-    
-    if (result != ESP_OK) return false;
+    CanFrame frame;
+    if (!rxRing.pop(frame)) return false;
 
-    *id = message.identifier;
-    *ext = message.extd;
-    *len = message.data_length_code;
+    *id = frame.id;
+    *ext = frame.ext;
+    *len = frame.len;
     
-    memcpy(buf, message.data, *len);
+    memcpy(buf, frame.data, frame.len);
     return true;
 }
 
+size_t TJA1051Interface::receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+    if (!initialized) return 0;
+
+    return popBurstWithTimeout(rxRing, frames, max, timeoutUs);
+}
+
 bool TJA1051Interface::messageAvailable() {
     if (!initialized) return false;
 
+    return !rxRing.empty();
+}
+
+uint32_t TJA1051Interface::getRxOverrunCount() const {
+    return rxRing.overrunCount();
+}
+
+bool TJA1051Interface::getErrorCounters(CANErrorCounters& counters) {
+    if (!initialized) return false;
+
     twai_status_info_t status;
-    twai_get_status_info(&status);
-    
-    return status.msgs_to_rx > 0;
+    if (twai_get_status_info(&status) != ESP_OK) {
+        return false;
+    }
+
+    counters = CANErrorCounters();
+    counters.txErrors = status.tx_error_counter > 255 ? 255 : status.tx_error_counter;
+    counters.rxErrors = status.rx_error_counter > 255 ? 255 : status.rx_error_counter;
+    counters.busErrors = status.bus_error_count;
+    counters.arbitrationLost = status.arb_lost_count;
+    counters.rxMissed = status.rx_missed_count + status.rx_overrun_count;
+
+    switch (status.state) {
+        case TWAI_STATE_BUS_OFF:
+        case TWAI_STATE_RECOVERING:
+            counters.state = CAN_BUS_OFF;
+            break;
+        case TWAI_STATE_STOPPED:
+            counters.state = CAN_BUS_STOPPED;
+            break;
+        default:
+            if (status.tx_error_counter >= 128 || status.rx_error_counter >= 128) {
+                counters.state = CAN_BUS_ERROR_PASSIVE;
+            } else if (status.tx_error_counter >= 96 || status.rx_error_counter >= 96) {
+                counters.state = CAN_BUS_ERROR_WARNING;
+            } else {
+                counters.state = CAN_BUS_ERROR_ACTIVE;
+            }
+            break;
+    }
+    return true;
 }
 
 void TJA1051Interface::end() {
+    stopRxTask();
+    cancelTx();
+
     if (initialized) {
         twai_stop();
         twai_driver_uninstall();
@@ -122,4 +298,66 @@ void TJA1051Interface::end() {
     if (stbyPin != 255) {
         digitalWrite(stbyPin, HIGH);
     }
+}
+
+// ===================================================================================
+// Empfangstask
+// Holt Frames aus der TWAI-Treiberqueue und legt sie im Ringpuffer ab, damit die
+// kleine Treiberqueue auch bei blockierter loop() nicht überläuft.
+// ===================================================================================
+bool TJA1051Interface::startRxTask() {
+    if (rxTaskHandle != nullptr) {
+        return true;
+    }
+
+    rxRing.clear();
+    rxTaskActive = true;
+    if (xTaskCreatePinnedToCore(rxTaskEntry, "twai_rx", CAN_RX_TASK_STACK, this,
+                                CAN_RX_TASK_PRIORITY, &rxTaskHandle, CAN_RX_TASK_CORE) != pdPASS) {
+        Serial.println("[FEHLER] TWAI Empfangstask konnte nicht gestartet werden");
+        rxTaskActive = false;
+        rxTaskHandle = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void TJA1051Interface::stopRxTask() {
+    if (rxTaskHandle == nullptr) {
+        return;
+    }
+
+    rxTaskActive = false;
+
+    // Der Task prüft das Flag spätestens nach dem Empfangs-Timeout
+    while (rxTaskHandle != nullptr) {
+        vTaskDelay(1);
+    }
+}
+
+void TJA1051Interface::rxTaskEntry(void* arg) {
+    static_cast<TJA1051Interface*>(arg)->rxTaskLoop();
+}
+
+void TJA1051Interface::rxTaskLoop() {
+    twai_message_t message;
+
+    while (rxTaskActive) {
+        // Auf den ersten Frame warten, danach die Treiberqueue ohne Timeout leeren
+        esp_err_t result = twai_receive(&message, pdMS_TO_TICKS(10));
+        while (result == ESP_OK) {
+            CanFrame frame;
+            frame.timestamp = canTimestampUs();  // Der Task wird direkt vom Treiber-Interrupt geweckt
+            frame.id = message.identifier;
+            frame.ext = message.extd;
+            frame.len = message.data_length_code > 8 ? 8 : message.data_length_code;
+            memcpy(frame.data, message.data, frame.len);
+            rxRing.push(frame);  // Bei vollem Puffer zählt der Ring den Überlauf
+
+            result = twai_receive(&message, 0);
+        }
+    }
+
+    rxTaskHandle = nullptr;
+    vTaskDelete(NULL);
 }
\ No newline at end of file
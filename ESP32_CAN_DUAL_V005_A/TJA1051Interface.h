@@ -3,11 +3,13 @@
 #define TJA1051_INTERFACE_H
 
 #include "CANInterface.h"
+#include "CANRingBuffer.h"
 #include "driver/twai.h"
 
 // TJA1051Interface.h
 #define TJA1051_TX_PIN 18  // Für ESP32-S3-Touch-LCD-4.3B
 #define TJA1051_RX_PIN 17  // Für ESP32-S3-Touch-LCD-4.3B
+#define TJA1051_RX_QUEUE_LEN 32  // Treiberinterne Empfangsqueue (Standard wäre 5)
 
 class TJA1051Interface : public CANInterface {
 private:
@@ -19,15 +21,41 @@ private:
     twai_timing_config_t t_config;
     twai_filter_config_t f_config;
 
+    // Empfangspfad: TWAI-Empfangstask füllt den Ringpuffer
+    CANRingBuffer<CanFrame, CAN_RX_RING_SIZE> rxRing;
+    TaskHandle_t rxTaskHandle;
+    volatile bool rxTaskActive;
+
+    // Sendepfad: Zähler für die Abschlusserkennung der TWAI-Treiberqueue (FIFO)
+    uint32_t txSubmitted;     // An twai_transmit() übergebene Frames
+    uint32_t txFailedSeen;    // Bereits zugeordnete tx_failed_count-Inkremente
+
+    bool installDriver();
+    bool startRxTask();
+    void stopRxTask();
+    void rxTaskLoop();
+    static void rxTaskEntry(void* arg);
+
+    static twai_filter_config_t makeFilterConfig(const CANHardwareFilterPlan& plan);
+
 public:
     TJA1051Interface(uint8_t stbyPin = 255);
     ~TJA1051Interface();
-    
+
     bool begin(uint32_t baudrate) override;
     bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override;
     bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override;
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0) override;
     bool messageAvailable() override;
     void end() override;
+    uint32_t getRxOverrunCount() const override;
+    bool getErrorCounters(CANErrorCounters& counters) override;
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override;
+    CANTxStatus pollTransmit(uint32_t handle) override;
+    uint8_t acceptanceFilterLayout(uint8_t* groupSizes) const override;
+    bool applyAcceptanceFilter(const CANHardwareFilterPlan& plan) override;
 };
 
 #endif
\ No newline at end of file
@@ -1,27 +1,219 @@
 // WaveshareDisplay.h
 // ===============================================================================
 // Konkrete Implementierung des DisplayInterface für Waveshare ESP32-S3 Touch LCD
+//
+// Mit PSRAM wird in einen Framebuffer (TFT_eSprite, 16 Bit) gezeichnet. display()
+// prüft nur die Kacheln, die seit dem letzten Bild bemalt wurden, vergleicht deren
+// Prüfsumme mit dem zuletzt übertragenen Stand und schiebt geänderte Kacheln per DMA
+// zum Panel. Ohne PSRAM wird wie bisher direkt auf das Panel gezeichnet.
 // ===============================================================================
 
 #pragma once
 
 #include "DisplayInterface.h"
+#include "RenderScheduler.h"
 #include <TFT_eSPI.h>
 
+#define TFT_FULL_CLEAR_PERCENT 60  // Ab diesem Anteil bemalter Fläche den ganzen Schirm löschen
+#define TFT_TILE_SIZE          32  // Kachelgröße für den Abgleich des Framebuffers (Pixel)
+#define TFT_MAX_TILES          512 // Reicht für 800x480 bei 32x32 Pixeln (375 Kacheln)
+#define TFT_BUFFERED_FPS       25  // Bildrate mit Framebuffer (ohne: RENDER_TARGET_FPS)
+
 class WaveshareDisplay : public DisplayInterface {
 private:
     TFT_eSPI tftDisplay;  // Umbenennung um Konflikte zu vermeiden
+    TFT_eSprite frame;    // Framebuffer im PSRAM
+    TFT_eSPI* canvas;     // Zeichenziel: frame oder (ohne PSRAM) direkt tftDisplay
+    bool buffered;
     bool initialized;
     uint16_t textColor;
     uint16_t bgColor;
     uint8_t textSize;
+
+    // Seit dem letzten clear() bemalte Flächen: clear() löscht nur diese statt der
+    // ganzen 800x480 Pixel (fillScreen)
+    DirtyRegion drawn;
+    // Seit dem letzten display() bemalte Flächen: nur deren Kacheln werden abgeglichen
+    DirtyRegion pending;
+
+    uint16_t tilesX, tilesY;
+    uint32_t tileHashes[TFT_MAX_TILES];          // Prüfsumme je Kachel, wie zuletzt übertragen
+    uint32_t tileCheck[(TFT_MAX_TILES + 31) / 32];
+    uint16_t* tileBuffer[2];                     // DMA-fähige Kopien (internes RAM)
+    uint8_t nextBuffer;
+
+    void markRect(int32_t x, int32_t y, int32_t w, int32_t h) {
+        drawn.add(x, y, w, h, tftDisplay.width(), tftDisplay.height());
+        if (buffered) {
+            pending.add(x, y, w, h, tftDisplay.width(), tftDisplay.height());
+        }
+    }
+
+    void markLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1) {
+        markRect(x0 < x1 ? x0 : x1, y0 < y1 ? y0 : y1, abs(x1 - x0) + 1, abs(y1 - y0) + 1);
+    }
+
+    // Text ab (x0, y0); textWidth = Breite der ersten Zeile (0 = aus dem Cursor ableiten)
+    void markText(int16_t x0, int16_t y0, int16_t textWidth) {
+        int16_t x = canvas->getCursorX();
+        int16_t y = canvas->getCursorY();
+        int16_t lineHeight = canvas->fontHeight();
+        if (y == y0) {
+            markRect(x0, y0, (x > x0 + textWidth ? x : x0 + textWidth) - x0, lineHeight);
+        } else {
+            // Zeilenumbruch: erste Zeile ab x0, Folgezeilen ab dem linken Rand
+            markRect(x0, y0, textWidth > 0 ? textWidth : tftDisplay.width() - x0, lineHeight);
+            if (y > y0 + lineHeight || x > 0) {
+                markRect(0, y0 + lineHeight, tftDisplay.width(), y - y0);
+            }
+        }
+    }
+
+    template <typename T>
+    void printMarked(const T& value, bool newline) {
+        int16_t x0 = canvas->getCursorX();
+        int16_t y0 = canvas->getCursorY();
+        if (newline) {
+            canvas->println(value);
+        } else {
+            canvas->print(value);
+        }
+        markText(x0, y0, 0);
+    }
+
+    void printTextMarked(const char* text, bool newline) {
+        int16_t x0 = canvas->getCursorX();
+        int16_t y0 = canvas->getCursorY();
+        int16_t width = strchr(text, '\n') == nullptr ? canvas->textWidth(text) : 0;
+        if (newline) {
+            canvas->println(text);
+        } else {
+            canvas->print(text);
+        }
+        markText(x0, y0, width);
+    }
+
+    static uint32_t hashTile(const uint16_t* pixels, int32_t stride, int32_t w, int32_t h) {
+        uint32_t hash = 2166136261UL;  // FNV-1a über die Pixelwerte
+        for (int32_t row = 0; row < h; row++, pixels += stride) {
+            for (int32_t col = 0; col < w; col++) {
+                hash = (hash ^ pixels[col]) * 16777619UL;
+            }
+        }
+        return hash;
+    }
+
+    // Framebuffer anlegen; false = kein PSRAM oder zu wenig Speicher, dann direkt zeichnen
+    bool beginFramebuffer() {
+        int32_t width = tftDisplay.width();
+        int32_t height = tftDisplay.height();
+        tilesX = (width + TFT_TILE_SIZE - 1) / TFT_TILE_SIZE;
+        tilesY = (height + TFT_TILE_SIZE - 1) / TFT_TILE_SIZE;
+        if (!psramFound() || (uint32_t)tilesX * tilesY > TFT_MAX_TILES) {
+            return false;
+        }
+
+        frame.setColorDepth(16);
+        frame.setAttribute(PSRAM_ENABLE, 1);
+        if (frame.createSprite(width, height) == nullptr) {
+            return false;
+        }
+        for (uint8_t i = 0; i < 2; i++) {
+            tileBuffer[i] = (uint16_t*)heap_caps_malloc(TFT_TILE_SIZE * TFT_TILE_SIZE * sizeof(uint16_t), MALLOC_CAP_DMA);
+        }
+        if (tileBuffer[0] == nullptr || tileBuffer[1] == nullptr || !tftDisplay.initDMA()) {
+            releaseFramebuffer();
+            return false;
+        }
+
+        // Panel und Framebuffer stimmen nach fillScreen() überein: Ausgangsstand der Kacheln
+        frame.fillSprite(TFT_BLACK);
+        const uint16_t* pixels = (const uint16_t*)frame.getPointer();
+        for (uint16_t ty = 0; ty < tilesY; ty++) {
+            for (uint16_t tx = 0; tx < tilesX; tx++) {
+                int32_t x = tx * TFT_TILE_SIZE;
+                int32_t y = ty * TFT_TILE_SIZE;
+                tileHashes[ty * tilesX + tx] = hashTile(pixels + y * width + x, width,
+                    min((int32_t)TFT_TILE_SIZE, width - x), min((int32_t)TFT_TILE_SIZE, height - y));
+            }
+        }
+        return true;
+    }
+
+    void releaseFramebuffer() {
+        frame.deleteSprite();
+        for (uint8_t i = 0; i < 2; i++) {
+            if (tileBuffer[i] != nullptr) {
+                heap_caps_free(tileBuffer[i]);
+                tileBuffer[i] = nullptr;
+            }
+        }
+    }
+
+    // Geänderte Kacheln zum Panel schieben. pushImageDMA() wartet selbst auf die vorige
+    // Übertragung; mit zwei Puffern läuft das Kopieren der nächsten Kachel parallel dazu.
+    void flushTiles() {
+        memset(tileCheck, 0, sizeof(tileCheck));
+        for (size_t i = 0; i < pending.size(); i++) {
+            const DirtyRect& rect = pending.rect(i);
+            for (int32_t ty = rect.y0 / TFT_TILE_SIZE; ty <= (rect.y1 - 1) / TFT_TILE_SIZE; ty++) {
+                for (int32_t tx = rect.x0 / TFT_TILE_SIZE; tx <= (rect.x1 - 1) / TFT_TILE_SIZE; tx++) {
+                    uint32_t tile = ty * tilesX + tx;
+                    tileCheck[tile / 32] |= 1UL << (tile % 32);
+                }
+            }
+        }
+        pending.clear();
+
+        const uint16_t* pixels = (const uint16_t*)frame.getPointer();
+        int32_t width = frame.width();
+        int32_t height = frame.height();
+        bool writing = false;
+        for (uint32_t tile = 0; tile < (uint32_t)tilesX * tilesY; tile++) {
+            if ((tileCheck[tile / 32] & (1UL << (tile % 32))) == 0) {
+                continue;
+            }
+            int32_t x = (tile % tilesX) * TFT_TILE_SIZE;
+            int32_t y = (tile / tilesX) * TFT_TILE_SIZE;
+            int32_t w = min((int32_t)TFT_TILE_SIZE, width - x);
+            int32_t h = min((int32_t)TFT_TILE_SIZE, height - y);
+            const uint16_t* source = pixels + y * width + x;
+
+            // Neu bemalt, aber gleicher Inhalt (z.B. unveränderter Text): nichts senden
+            uint32_t hash = hashTile(source, width, w, h);
+            if (hash == tileHashes[tile]) {
+                continue;
+            }
+            tileHashes[tile] = hash;
+
+            uint16_t* buffer = tileBuffer[nextBuffer];
+            nextBuffer ^= 1;
+            for (int32_t row = 0; row < h; row++) {
+                memcpy(buffer + row * w, source + row * width, w * sizeof(uint16_t));
+            }
+            if (!writing) {
+                tftDisplay.startWrite();
+                writing = true;
+            }
+            tftDisplay.pushImageDMA(x, y, w, h, buffer);
+        }
+        if (writing) {
+            // Chip-Select erst nach der letzten Kachel freigeben
+            tftDisplay.dmaWait();
+            tftDisplay.endWrite();
+        }
+    }
     
 public:
-    WaveshareDisplay() : tftDisplay(), initialized(false), 
-                         textColor(TFT_WHITE), bgColor(TFT_BLACK), textSize(1) {}
+    WaveshareDisplay() : tftDisplay(), frame(&tftDisplay), canvas(&tftDisplay), buffered(false),
+                         initialized(false), textColor(TFT_WHITE), bgColor(TFT_BLACK), textSize(1),
+                         tilesX(0), tilesY(0), nextBuffer(0) {
+        tileBuffer[0] = nullptr;
+        tileBuffer[1] = nullptr;
+    }
     
     ~WaveshareDisplay() {
-        // Keine spezielle Bereinigung nötig
+        releaseFramebuffer();
     }
     
     bool begin() override {
@@ -34,48 +226,80 @@ public:
         tftDisplay.setTextColor(TFT_WHITE, TFT_BLACK);
         tftDisplay.setTextSize(1);
         
+        buffered = beginFramebuffer();
+        if (buffered) {
+            canvas = &frame;
+            canvas->setTextColor(TFT_WHITE, TFT_BLACK);
+            canvas->setTextSize(1);
+            Serial.printf("[INFO] TFT: Framebuffer im PSRAM, %ux%u Kacheln per DMA\n", tilesX, tilesY);
+        } else {
+            Serial.println("[WARNUNG] TFT: Kein Framebuffer (PSRAM/DMA), zeichne direkt");
+        }
+        
         initialized = true;
         return true;
     }
     
     void clear() override {
-        tftDisplay.fillScreen(bgColor);
-        tftDisplay.setCursor(0, 0);
+        int32_t screenArea = (int32_t)tftDisplay.width() * tftDisplay.height();
+        if (drawn.area() * 100 >= screenArea * TFT_FULL_CLEAR_PERCENT) {
+            canvas->fillScreen(bgColor);
+            if (buffered) {
+                pending.add(0, 0, tftDisplay.width(), tftDisplay.height(), tftDisplay.width(), tftDisplay.height());
+            }
+        } else {
+            for (size_t i = 0; i < drawn.size(); i++) {
+                const DirtyRect& rect = drawn.rect(i);
+                canvas->fillRect(rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0, bgColor);
+                if (buffered) {
+                    pending.add(rect.x0, rect.y0, rect.x1 - rect.x0, rect.y1 - rect.y0,
+                                tftDisplay.width(), tftDisplay.height());
+                }
+            }
+        }
+        drawn.clear();
+        canvas->setCursor(0, 0);
     }
     
     void display() override {
-        // TFT_eSPI benötigt keinen expliziten display()-Aufruf
-        // Diese Funktion ist nur für die Kompatibilität mit dem Interface
+        // Ohne Framebuffer steht alles schon auf dem Panel
+        if (buffered) {
+            flushTiles();
+        }
+    }
+    
+    uint16_t frameRate() const override {
+        return buffered ? TFT_BUFFERED_FPS : RENDER_TARGET_FPS;
     }
     
     void setCursor(int16_t x, int16_t y) override {
-        tftDisplay.setCursor(x, y);
+        canvas->setCursor(x, y);
     }
     
     void setTextSize(uint8_t size) override {
         textSize = size;
-        tftDisplay.setTextSize(size);
+        canvas->setTextSize(size);
     }
     
     void setTextColor(uint16_t color) override {
         textColor = color;
-        tftDisplay.setTextColor(color, bgColor);
+        canvas->setTextColor(color, bgColor);
     }
     
     void print(const char* text) override {
-        tftDisplay.print(text);
+        printTextMarked(text, false);
     }
     
     void print(String text) override {
-        tftDisplay.print(text);
+        printTextMarked(text.c_str(), false);
     }
     
     void println(const char* text) override {
-        tftDisplay.println(text);
+        printTextMarked(text, true);
     }
     
     void println(String text) override {
-        tftDisplay.println(text);
+        printTextMarked(text.c_str(), true);
     }
     
     void printf(const char* format, ...) override {
@@ -84,44 +308,51 @@ public:
         va_start(args, format);
         vsnprintf(buf, sizeof(buf), format, args);
         va_end(args);
-        tftDisplay.print(buf);
+        printTextMarked(buf, false);
     }
     void print(int value) override {
-    tftDisplay.print(value);
+        printMarked(value, false);
     }
     void print(uint8_t value) override {
-        tftDisplay.print(value);
+        printMarked(value, false);
     }
     void print(uint32_t value) override {
-        tftDisplay.print(value);
+        printMarked(value, false);
     }
     void print(uint32_t value, int base) override {
-        tftDisplay.print(value, base);
+        printTextMarked(String(value, (unsigned char)base).c_str(), false);
     }
     void print(int value, int base) override {
-        tftDisplay.print(value, base);
+        printTextMarked(String(value, (unsigned char)base).c_str(), false);
     }
     void println(int value) override {
-        tftDisplay.println(value);
+        printMarked(value, true);
     }
     void println(uint8_t value) override {
-        tftDisplay.println(value);
+        printMarked(value, true);
     }
     void println(uint32_t value) override {
-        tftDisplay.println(value);
+        printMarked(value, true);
     }
     void println(uint32_t value, int base) override {
-        tftDisplay.println(value, base);
+        printTextMarked(String(value, (unsigned char)base).c_str(), true);
     }
     void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) override {
-        tftDisplay.drawLine(x0, y0, x1, y1, color);
+        canvas->drawLine(x0, y0, x1, y1, color);
+        markLine(x0, y0, x1, y1);
     }
     
     void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
-        tftDisplay.drawRect(x, y, w, h, color);
+        canvas->drawRect(x, y, w, h, color);
+        // Nur die vier Kanten, damit ein Rahmen nicht die ganze Fläche markiert
+        markRect(x, y, w, 1);
+        markRect(x, y + h - 1, w, 1);
+        markRect(x, y, 1, h);
+        markRect(x + w - 1, y, 1, h);
     }
     
     void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
-        tftDisplay.fillRect(x, y, w, h, color);
+        canvas->fillRect(x, y, w, h, color);
+        markRect(x, y, w, h);
     }
 };
\ No newline at end of file
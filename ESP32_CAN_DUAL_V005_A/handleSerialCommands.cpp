@@ -8,6 +8,9 @@
 #include "CANopen.h"
 #include "CANopenClass.h"
 #include "DisplayInterface.h"
+#include "CANScanEngine.h"
+#include "CANLog.h"
+#include "CANSlcan.h"
 #include "SystemProfiles.h"
 #include <Preferences.h>
 
@@ -33,9 +36,14 @@ extern Preferences preferences;
 extern void displaySerialModeScreen();
 extern void displayActionScreen(const char* title, const char* message, int timeout);
 extern void scanNodes(int startID, int endID);
+extern void setScanMode(uint16_t listenMs, bool probe);
+extern void setScanTimeout(uint16_t timeoutMs);
+extern uint16_t getScanTimeout();
 extern bool updateESP32CANBaudrate(int newBaudrate);
 extern void changeNodeId(uint8_t from, uint8_t to);
 extern bool testSingleNode(int nodeId, int maxAttempts, int timeoutMs);
+extern void startIdentityRead(uint8_t firstId, uint8_t lastId);
+extern void handleSDOCommand(String command);
 extern bool isValidBaudrate(int baudrate);
 extern void printHelpMenu();
 extern void saveSettings();
@@ -43,6 +51,17 @@ extern void changeCommunicationSettings(uint8_t targetNodeId, int newBaudrateKbp
 extern void handleModeCommand(String command);
 extern void handleTransceiverCommand(String command);
 extern void handleMonitorFilterCommand(String command);
+extern bool startMonitorLog(CANLogFormat format, uint32_t serialBaud, bool verbose);
+extern void stopMonitorLog(bool verbose);
+extern bool slcanModeActive();
+extern void enterSlcanMode();
+extern void handleSlcanCommand(const String& command);
+extern void handleStatsCommand(String command);
+extern void handleHeartbeatCommand(String command);
+extern void handleSimCommand(String command);
+extern void setMonitorTraceView(bool enabled);
+extern void clearTraceTable();
+extern void printTraceTable();
 extern void printCurrentSettings();
 extern void systemReset();
 
@@ -111,6 +130,12 @@ void handleSerialCommands() {
         activeSource = SOURCE_SERIAL;
         lastActivityTime = millis();
         
+        // SLCAN-Betrieb: alle Zeilen gehen an den Lawicel-Befehlssatz
+        if (slcanModeActive() || SLCANSession::isSessionCommand(command.c_str(), command.length())) {
+            handleSlcanCommand(command);
+            return;
+        }
+        
         // Befehl analysieren und ausführen
         if (command.equals("help")) {
             printHelpMenu();
@@ -124,6 +149,48 @@ void handleSerialCommands() {
                 displaySerialModeScreen();
             }
         }
+        else if (command.startsWith("scan listen") || command.startsWith("scan hybrid")) {
+            // Format: scan listen [ms] / scan hybrid [ms]
+            bool probe = command.startsWith("scan hybrid");
+            String params = command.substring(11);
+            params.trim();
+            
+            int listenMs = SCAN_DEFAULT_LISTEN_MS;
+            if (params.length() > 0) {
+                listenMs = params.toInt();
+            }
+            
+            if (listenMs < 100 || listenMs > 60000) {
+                Serial.println("[FEHLER] Hördauer muss 100-60000 ms sein");
+            } else {
+                Serial.printf("[CMD] Starte %s Node-Scan von %d bis %d (Hördauer %d ms)...\n",
+                              probe ? "hybriden" : "passiven", scanStart, scanEnd, listenMs);
+                setScanMode(listenMs, probe);
+                scanning = true;
+                
+                // Displayanzeige aktualisieren
+                if (displayInterface != nullptr) {
+                    displaySerialModeScreen();
+                }
+            }
+        }
+        else if (command.startsWith("scan timeout")) {
+            // Format: scan timeout [ms] (ohne Wert: aktuellen Wert anzeigen)
+            String params = command.substring(12);
+            params.trim();
+            
+            if (params.length() == 0) {
+                Serial.printf("[INFO] Scan-Antwortzeit: %u ms\n", getScanTimeout());
+            } else {
+                int timeoutMs = params.toInt();
+                if (timeoutMs < SCAN_MIN_TIMEOUT_MS || timeoutMs > SCAN_MAX_TIMEOUT_MS) {
+                    Serial.printf("[FEHLER] Antwortzeit muss %d-%d ms sein\n", SCAN_MIN_TIMEOUT_MS, SCAN_MAX_TIMEOUT_MS);
+                } else {
+                    setScanTimeout((uint16_t)timeoutMs);
+                    Serial.printf("[OK] Scan-Antwortzeit %d ms gesetzt\n", timeoutMs);
+                }
+            }
+        }
         else if (command.startsWith("range")) {
             int newStart, newEnd;
             
@@ -153,8 +220,14 @@ void handleSerialCommands() {
                 Serial.println("[FEHLER] Syntax: range <Start> <Ende> (z. B. 'range 1 125')");
             }
         }
+        else if (command.equals("slcan")) {
+            Serial.println("[INFO] SLCAN-Modus: Lawicel-Befehle (z.B. S6, O, t1232AABB, C), zurück mit 'slcan off'");
+            Serial.flush();
+            enterSlcanMode();
+        }
         else if (command.startsWith("monitor")) {
             if (command.equals("monitor on")) {
+                stopMonitorLog(true);
                 liveMonitor = true;
                 Serial.println("[INFO] Live-Monitor: Ein");
                 
@@ -164,6 +237,7 @@ void handleSerialCommands() {
                 }
             }
             else if (command.equals("monitor off")) {
+                stopMonitorLog(true);
                 liveMonitor = false;
                 Serial.println("[INFO] Live-Monitor: Aus");
                 
@@ -172,11 +246,47 @@ void handleSerialCommands() {
                     displaySerialModeScreen();
                 }
             }
+            else if (command.equals("monitor view table") || command.equals("monitor view frames")) {
+                bool table = command.endsWith("table");
+                setMonitorTraceView(table);
+                Serial.printf("[INFO] Monitor-Anzeige: %s\n", table ? "Tabelle je COB-ID" : "Einzelframes");
+            }
+            else if (command.equals("monitor table")) {
+                printTraceTable();
+            }
+            else if (command.equals("monitor table clear")) {
+                clearTraceTable();
+                Serial.println("[INFO] Trace-Tabelle geleert");
+            }
             else if (command.startsWith("monitor filter")) {
                 handleMonitorFilterCommand(command.substring(14));
             }
+            else if (command.startsWith("monitor log ")) {
+                // Format: monitor log candump|asc|slcan|binary [serielle Baudrate]
+                String params = command.substring(12);
+                params.trim();
+                int space = params.indexOf(' ');
+                String formatName = space > 0 ? params.substring(0, space) : params;
+                long serialBaud = space > 0 ? params.substring(space + 1).toInt() : 0;
+                
+                CANLogFormat format = CAN_LOG_OFF;
+                if (formatName.equals("candump")) format = CAN_LOG_CANDUMP;
+                else if (formatName.equals("asc")) format = CAN_LOG_ASC;
+                else if (formatName.equals("slcan")) format = CAN_LOG_SLCAN_TS;
+                else if (formatName.equals("binary")) format = CAN_LOG_BINARY;
+                
+                if (format == CAN_LOG_OFF || serialBaud < 0 || (serialBaud > 0 && serialBaud < 9600)) {
+                    Serial.println("[FEHLER] Syntax: monitor log candump|asc|slcan|binary [Baudrate, z.B. 921600]");
+                } else {
+                    startMonitorLog(format, serialBaud, true);
+                    
+                    if (displayInterface != nullptr) {
+                        displayActionScreen("Live-Monitor", "Log-Ausgabe...", 1000);
+                    }
+                }
+            }
             else {
-                Serial.println("[FEHLER] Falsche Syntax. Korrekt: monitor on/off oder monitor filter [parameter]");
+                Serial.println("[FEHLER] Falsche Syntax. Korrekt: monitor on/off, monitor view table|frames, monitor table [clear], monitor log <format> oder monitor filter [parameter]");
             }
         }
         else if (command.startsWith("change")) {
@@ -279,6 +389,34 @@ void handleSerialCommands() {
                 Serial.println("[FEHLER] Falsche Syntax. Korrekt: testnode <node_id> [versuche] [timeout]");
             }
         }
+        else if (command.startsWith("sdo ")) {
+            handleSDOCommand(command.substring(4));
+        }
+        else if (command.startsWith("ident")) {
+            // Format: ident [start ende]
+            int firstId = scanStart;
+            int lastId = scanEnd;
+            String params = command.substring(5);
+            params.trim();
+            
+            if (params.length() > 0 && !parseIntParams(params, firstId, lastId)) {
+                Serial.println("[FEHLER] Syntax: ident [start ende] (z. B. 'ident 1 10')");
+            } else if (firstId < 1 || lastId > 127 || firstId > lastId) {
+                Serial.println("[FEHLER] Werte müssen 1-127 sein und Start ≤ Ende");
+            } else {
+                Serial.printf("[CMD] Lese Identität (0x1018) der Nodes %d-%d...\n", firstId, lastId);
+                startIdentityRead(firstId, lastId);
+            }
+        }
+        else if (command.equals("stats") || command.startsWith("stats ")) {
+            handleStatsCommand(command.substring(5));
+        }
+        else if (command.equals("hb") || command.startsWith("hb ")) {
+            handleHeartbeatCommand(command.substring(2));
+        }
+        else if (command.equals("sim") || command.startsWith("sim ")) {
+            handleSimCommand(command.substring(3));
+        }
         else if (command.equals("auto")) {
             Serial.println("[CMD] Starte automatische Baudratenerkennung...");
             autoBaudrateRequest = true;
@@ -0,0 +1,304 @@
+// host/Arduino.h
+// ===============================================================================
+// Arduino-API für den Host-Build (POSIX)
+// Bildet den Teil der Arduino-/ESP32-API, den der Kern benutzt (String, Print/Stream,
+// Serial, millis/micros/delay, GPIO, vTaskDelay), auf die Systemfunktionen in
+// host/Platform.h ab. Die Sketch-Dateien übersetzen damit unverändert mit -Ihost.
+// Gebaut wird mit host/CMakeLists.txt.
+// ===============================================================================
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include "Platform.h"
+
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define IRAM_ATTR
+#define F(x) x
+#define PSTR(x) x
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define LOW 0
+#define HIGH 1
+#define INPUT PLATFORM_PIN_INPUT
+#define OUTPUT PLATFORM_PIN_OUTPUT
+#define INPUT_PULLUP PLATFORM_PIN_INPUT_PULLUP
+
+// ===================================================================================
+// String (auf std::string)
+// ===================================================================================
+class String {
+private:
+    std::string s;
+
+    static std::string fromNumber(unsigned long long value, unsigned char base) {
+        if (base < 2 || base > 36) base = 10;
+        char buf[66];
+        size_t pos = sizeof(buf);
+        buf[--pos] = '\0';
+        do {
+            unsigned digit = (unsigned)(value % base);
+            buf[--pos] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+            value /= base;
+        } while (value > 0);
+        return std::string(&buf[pos]);
+    }
+
+    static std::string fromSigned(long long value, unsigned char base) {
+        if (value < 0 && base == 10) {
+            return "-" + fromNumber((unsigned long long)(-(value + 1)) + 1, base);
+        }
+        return fromNumber((unsigned long long)value, base);
+    }
+
+public:
+    String() {}
+    String(const char* c) : s(c ? c : "") {}
+    String(const std::string& str) : s(str) {}
+    explicit String(char c) : s(1, c) {}
+    String(int value, unsigned char base = 10) : s(fromSigned(value, base)) {}
+    String(unsigned value, unsigned char base = 10) : s(fromNumber(value, base)) {}
+    String(long value, unsigned char base = 10) : s(fromSigned(value, base)) {}
+    String(unsigned long value, unsigned char base = 10) : s(fromNumber(value, base)) {}
+    String(unsigned char value, unsigned char base = 10) : s(fromNumber(value, base)) {}
+    String(double value, unsigned int decimals = 2) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+        s = buf;
+    }
+
+    const char* c_str() const { return s.c_str(); }
+    unsigned int length() const { return (unsigned int)s.size(); }
+    bool isEmpty() const { return s.empty(); }
+    bool reserve(unsigned int size) { s.reserve(size); return true; }
+
+    char charAt(unsigned int index) const { return index < s.size() ? s[index] : '\0'; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    void setCharAt(unsigned int index, char c) { if (index < s.size()) s[index] = c; }
+
+    int indexOf(char c, unsigned int from = 0) const { return toIndex(s.find(c, from)); }
+    int indexOf(const String& str, unsigned int from = 0) const { return toIndex(s.find(str.s, from)); }
+    int lastIndexOf(char c) const { return toIndex(s.rfind(c)); }
+    int lastIndexOf(const String& str) const { return toIndex(s.rfind(str.s)); }
+
+    String substring(unsigned int from) const {
+        return from < s.size() ? String(s.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= s.size()) return String();
+        return String(s.substr(from, to - from));
+    }
+
+    long toInt() const { return atol(s.c_str()); }
+    float toFloat() const { return (float)atof(s.c_str()); }
+    double toDouble() const { return atof(s.c_str()); }
+
+    void trim() {
+        size_t first = s.find_first_not_of(" \t\r\n\f\v");
+        if (first == std::string::npos) {
+            s.clear();
+            return;
+        }
+        size_t last = s.find_last_not_of(" \t\r\n\f\v");
+        s = s.substr(first, last - first + 1);
+    }
+    void toLowerCase() { for (char& c : s) c = (char)tolower((unsigned char)c); }
+    void toUpperCase() { for (char& c : s) c = (char)toupper((unsigned char)c); }
+
+    void replace(const String& find, const String& replacement) {
+        if (find.s.empty()) return;
+        size_t pos = 0;
+        while ((pos = s.find(find.s, pos)) != std::string::npos) {
+            s.replace(pos, find.s.size(), replacement.s);
+            pos += replacement.s.size();
+        }
+    }
+    void remove(unsigned int index) { if (index < s.size()) s.erase(index); }
+    void remove(unsigned int index, unsigned int count) { if (index < s.size()) s.erase(index, count); }
+
+    bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+    }
+    bool equals(const String& other) const { return s == other.s; }
+    bool equalsIgnoreCase(const String& other) const {
+        if (s.size() != other.s.size()) return false;
+        for (size_t i = 0; i < s.size(); i++) {
+            if (tolower((unsigned char)s[i]) != tolower((unsigned char)other.s[i])) return false;
+        }
+        return true;
+    }
+    int compareTo(const String& other) const { return s.compare(other.s); }
+
+    bool concat(const String& other) { s += other.s; return true; }
+    String& operator+=(const String& other) { s += other.s; return *this; }
+    String& operator+=(const char* other) { s += other ? other : ""; return *this; }
+    String& operator+=(char c) { s += c; return *this; }
+
+    bool operator==(const String& other) const { return s == other.s; }
+    bool operator==(const char* other) const { return s == (other ? other : ""); }
+    bool operator!=(const String& other) const { return s != other.s; }
+    bool operator!=(const char* other) const { return !(*this == other); }
+    bool operator<(const String& other) const { return s < other.s; }
+
+    friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+    friend String operator+(const String& a, const char* b) { return String(a.s + (b ? b : "")); }
+    friend String operator+(const char* a, const String& b) { return String((a ? a : "") + b.s); }
+    friend String operator+(const String& a, char b) { return String(a.s + b); }
+
+private:
+    static int toIndex(size_t pos) { return pos == std::string::npos ? -1 : (int)pos; }
+};
+
+// ===================================================================================
+// Print / Stream
+// ===================================================================================
+class Print {
+private:
+    // Wie Arduino: Hexziffern in Großbuchstaben, negative Werte nur dezimal mit Vorzeichen
+    size_t printNumber(unsigned long long value, int base) {
+        String text((unsigned long)value, (unsigned char)base);
+        text.toUpperCase();
+        return print(text);
+    }
+    size_t printSigned(long long value, int base) {
+        return base == DEC ? print(String((long)value)) : printNumber((unsigned long)value, base);
+    }
+
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char* str) { return str ? write((const uint8_t*)str, strlen(str)) : 0; }
+    size_t write(const char* buffer, size_t size) { return write((const uint8_t*)buffer, size); }
+    virtual int availableForWrite() { return 0; }
+    virtual void flush() {}
+
+    size_t print(const char* str) { return write(str); }
+    size_t print(const String& str) { return write(str.c_str(), str.length()); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return printNumber(value, base); }
+    size_t print(int value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned int value, int base = DEC) { return printNumber(value, base); }
+    size_t print(long value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned long value, int base = DEC) { return printNumber(value, base); }
+    size_t print(long long value, int base = DEC) { return printSigned(value, base); }
+    size_t print(unsigned long long value, int base = DEC) { return printNumber(value, base); }
+    size_t print(double value, int decimals = 2) { return print(String(value, (unsigned int)decimals)); }
+
+    size_t println() { return write("\r\n"); }
+    template <typename T>
+    size_t println(const T& value) { size_t n = print(value); return n + println(); }
+    template <typename T>
+    size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+        char buf[256];
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(buf, sizeof(buf), format, args);
+        va_end(args);
+        if (len < 0) return 0;
+        if ((size_t)len < sizeof(buf)) return write((const uint8_t*)buf, (size_t)len);
+
+        // Lange Ausgaben (z.B. Tabellen) in einem Heap-Puffer formatieren
+        std::string large((size_t)len + 1, '\0');
+        va_start(args, format);
+        vsnprintf(&large[0], large.size(), format, args);
+        va_end(args);
+        return write((const uint8_t*)large.data(), (size_t)len);
+    }
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() { return -1; }
+
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        size_t n = 0;
+        while (n < length && available() > 0) {
+            int c = read();
+            if (c < 0) break;
+            buffer[n++] = (uint8_t)c;
+        }
+        return n;
+    }
+    size_t readBytes(char* buffer, size_t length) { return readBytes((uint8_t*)buffer, length); }
+};
+
+// Serielle Konsole auf dem Host: platformConsole() (stdin/stdout)
+class HardwareSerial : public Stream {
+private:
+    uint32_t baud = 115200;
+
+public:
+    void begin(unsigned long rate) { baud = (uint32_t)rate; platformConsole().begin(baud); }
+    void end() {}
+    void updateBaudRate(unsigned long rate) { baud = (uint32_t)rate; }
+    uint32_t baudRate() { return baud; }
+    void setRxBufferSize(size_t) {}
+    void setTxBufferSize(size_t) {}
+    operator bool() const { return true; }
+
+    int available() override { return platformConsole().available(); }
+    int read() override { return platformConsole().read(); }
+    int availableForWrite() override { return 4096; }
+    void flush() override { platformConsole().flush(); }
+
+    using Print::write;
+    size_t write(uint8_t c) override { return platformConsole().write(&c, 1); }
+    size_t write(const uint8_t* buffer, size_t size) override { return platformConsole().write(buffer, size); }
+};
+
+extern HardwareSerial Serial;
+
+// ===================================================================================
+// Zeit, GPIO, System
+// ===================================================================================
+inline unsigned long millis() { return platformMillis(); }
+inline unsigned long micros() { return platformMicros(); }
+inline void delay(unsigned long ms) { platformSleepMs((uint32_t)ms); }
+inline void delayMicroseconds(unsigned int us) { platformSleepUs(us); }
+inline void yield() { platformYield(); }
+
+inline void pinMode(uint8_t pin, uint8_t mode) { platformPinMode(pin, (PlatformPinMode)mode); }
+inline int digitalRead(uint8_t pin) { return platformDigitalRead(pin) ? HIGH : LOW; }
+inline void digitalWrite(uint8_t pin, uint8_t level) { platformDigitalWrite(pin, level != LOW); }
+
+struct EspClass {
+    void restart() { platformRestart(); }
+    uint32_t getFreeHeap() { return 0; }
+    uint32_t getFreePsram() { return 0; }
+    uint32_t getCpuFreqMHz() { return 0; }
+};
+
+extern EspClass ESP;
+
+// FreeRTOS: der Kern wartet nur mit vTaskDelay (1 Tick = 1 ms)
+typedef uint32_t TickType_t;
+#define portTICK_PERIOD_MS 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+inline void vTaskDelay(TickType_t ticks) { platformSleepMs(ticks); }
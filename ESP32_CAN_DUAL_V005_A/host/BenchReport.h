@@ -0,0 +1,98 @@
+// host/BenchReport.h
+// ===============================================================================
+// Gemeinsame Ausgabe der Host-Benchmarks (canopen_host_bench, canopen_host_scanbench)
+// JSON im Format von Google Benchmark (--benchmark_format=json), damit vorhandene
+// Vergleichswerkzeuge die Ergebnisse lesen können. Der Bericht geht auf das
+// ursprüngliche stdout oder in eine Datei; die Serial-Ausgabe des Kerns wird während
+// der Messung nach /dev/null umgeleitet.
+// ===============================================================================
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include <unistd.h>
+
+// Berichtsdatei öffnen (outPath == nullptr: stdout) und stdout danach verwerfen.
+// Liefert nullptr, wenn die Datei nicht beschreibbar ist.
+inline FILE* benchOpenReport(const char* outPath) {
+    FILE* report = outPath != nullptr ? fopen(outPath, "w") : fdopen(dup(STDOUT_FILENO), "w");
+    if (report == nullptr) {
+        fprintf(stderr, "[FEHLER] Ausgabedatei nicht beschreibbar: %s\n", outPath);
+        return nullptr;
+    }
+    if (freopen("/dev/null", "w", stdout) == nullptr) {
+        fprintf(stderr, "[FEHLER] Serial-Ausgabe nicht umleitbar\n");
+        fclose(report);
+        return nullptr;
+    }
+    return report;
+}
+
+inline void benchJsonString(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const char* p = text; *p != '\0'; p++) {
+        if (*p == '"' || *p == '\\') fputc('\\', out);
+        fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+// Öffnet "context" mit den gemeinsamen Einträgen. Eigene Einträge des Benchmarks
+// folgen jeweils mit führendem ",\n", danach benchJsonBeginBenchmarks().
+inline void benchJsonBeginReport(FILE* out, const char* executable) {
+    char date[64];
+    time_t now = time(nullptr);
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    struct utsname host;
+    uname(&host);
+
+    fprintf(out, "{\n  \"context\": {\n    \"date\": ");
+    benchJsonString(out, date);
+    fprintf(out, ",\n    \"host_name\": ");
+    benchJsonString(out, host.nodename);
+    fprintf(out, ",\n    \"executable\": ");
+    benchJsonString(out, executable);
+    fprintf(out, ",\n    \"num_cpus\": %ld", sysconf(_SC_NPROCESSORS_ONLN));
+#ifdef NDEBUG
+    fprintf(out, ",\n    \"library_build_type\": \"release\"");
+#else
+    fprintf(out, ",\n    \"library_build_type\": \"debug\"");
+#endif
+}
+
+inline void benchJsonBeginBenchmarks(FILE* out) {
+    fprintf(out, "\n  },\n  \"benchmarks\": [");
+}
+
+// Öffnet den Eintrag eines Benchmarks mit Name und Zeiten; weitere Felder (Zähler)
+// folgen mit führendem ",\n", danach benchJsonEndBenchmark()
+inline void benchJsonBeginBenchmark(FILE* out, bool first, const char* name, size_t iterations,
+                                    double realTime, double cpuTime, const char* timeUnit) {
+    fprintf(out, "%s\n    {\n      \"name\": ", first ? "" : ",");
+    benchJsonString(out, name);
+    fprintf(out, ",\n      \"run_name\": ");
+    benchJsonString(out, name);
+    fprintf(out, ",\n      \"run_type\": \"iteration\"");
+    fprintf(out, ",\n      \"iterations\": %zu", iterations);
+    fprintf(out, ",\n      \"real_time\": %.3f", realTime);
+    fprintf(out, ",\n      \"cpu_time\": %.3f", cpuTime);
+    fprintf(out, ",\n      \"time_unit\": \"%s\"", timeUnit);
+}
+
+inline void benchJsonEndBenchmark(FILE* out) {
+    fprintf(out, "\n    }");
+}
+
+inline void benchJsonEndReport(FILE* out) {
+    fprintf(out, "\n  ]\n}\n");
+}
+
+// Verstrichene Rechenzeit des Prozesses in ns
+inline double benchCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
@@ -0,0 +1,602 @@
+// host/HostBench.cpp
+// ===============================================================================
+// Mikrobenchmarks für den Empfangspfad (canopen_host_bench)
+//   processCANMessage   Burst aus dem Empfangspuffer durch Dispatcher und Live-Monitor,
+//                       je Kombination des Anzeigefilters
+//   CANDispatcher       Verteilung allein (Frames/s): Verbraucher wie im Sketch, aber ohne
+//                       eigene Arbeit, mit und ohne Verbraucher aller Frames; zum Vergleich
+//                       dieselben Aufrufe als fest verdrahtete if-Kette
+//   decodeCANMessage    Dekodierung je Nachrichtentyp
+//   readSDO/writeSDO    Kodierung der SDO-Anfrage inkl. Antwort eines sofort
+//                       antwortenden Servers (blockierender Aufruf wie im Befehlsparser)
+//   displayCANMessage   Aufbereitung der Live-Monitor-Ansicht auf einem NullDisplay
+//
+// Gemessen wird je Element (Frame, Nachricht, SDO-Anfrage, Bild): ns/Element und
+// Elemente/s. Die Iterationszahl wird wie bei Google Benchmark kalibriert, bis ein Lauf
+// mindestens --min-time dauert; berichtet wird der Median aus --repetitions Läufen.
+// Die Ergebnisse gehen als JSON im Format von Google Benchmark (--benchmark_format=json)
+// nach stdout oder --out, damit vorhandene Vergleichswerkzeuge sie lesen können; die
+// Serial-Ausgabe des Kerns wird während der Messung verworfen, eine Übersicht geht
+// nach stderr.
+//
+//   canopen_host_bench [--filter=text] [--min-time=ms] [--repetitions=n] [--out=datei]
+// ===============================================================================
+
+#include "Arduino.h"
+#include "BenchReport.h"
+#include "CANDispatcher.h"
+#include "CANInterface.h"
+#include "CANRingBuffer.h"
+#include "CANTimestamp.h"
+#include "CANopenClass.h"
+#include "DisplayInterface.h"
+#include "NullDisplay.h"
+
+#include <time.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Kern (Sketch bzw. processCANMessage.cpp)
+extern CANInterface* canInterface;
+extern DisplayInterface* displayInterface;
+extern CANopen canopen;
+extern bool liveMonitor;
+void initCANDispatcher();
+void processCANMessage();
+void forwardCANFrame(CanFrame& frame);
+void decodeCANMessage(uint32_t rxId, uint8_t nodeId, uint16_t baseId, uint8_t* buf, uint8_t len);
+void displayCANMessage(uint32_t canId, uint8_t* data, uint8_t length);
+void handleMonitorFilterCommand(String command);
+
+// ===================================================================================
+// Benchmark-Interface: spielt eine feste Frame-Folge ab und beantwortet SDO-Anfragen
+// ===================================================================================
+class BenchCANInterface : public CANInterface {
+private:
+    std::vector<CanFrame> traffic;   // Abgespielte Busmitschnitt-Folge
+    size_t nextFrame = 0;
+    bool replay = false;
+    CANRingBuffer<CanFrame, CAN_RX_RING_SIZE> responses;  // Antworten des SDO-Servers
+
+    // Sofort antwortender SDO-Server: Upload expedited mit 4 Byte, Download bestätigt
+    void answerSDO(const CanFrame& request) {
+        CanFrame response = {};
+        response.id = COB_ID_TSDO_BASE + (request.id - COB_ID_RSDO_BASE);
+        response.len = 8;
+        memcpy(&response.data[1], &request.data[1], 3);  // Index und Subindex
+        uint8_t command = request.data[0] & 0xE0;
+        if (command == 0x40) {
+            response.data[0] = 0x43;
+            response.data[4] = 0x92;
+            response.data[5] = 0x01;
+            response.data[6] = 0x02;
+            response.data[7] = 0x00;
+        } else if (command == 0x20) {
+            response.data[0] = 0x60;
+        } else {
+            response.data[0] = 0x80;  // Abort: Kommando unbekannt
+            response.data[7] = 0x05;
+            response.data[6] = 0x04;
+            response.data[5] = 0x00;
+            response.data[4] = 0x01;
+        }
+        response.timestamp = canTimestampUs();
+        responses.push(response);
+    }
+
+public:
+    void setTraffic(const std::vector<CanFrame>& frames) {
+        traffic = frames;
+        nextFrame = 0;
+    }
+    void setReplay(bool enabled) { replay = enabled; }
+
+    bool begin(uint32_t baudrate) override { return true; }
+
+    bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override {
+        CanFrame frame = {};
+        frame.id = id;
+        frame.ext = ext;
+        frame.len = len > 8 ? 8 : len;
+        memcpy(frame.data, buf, frame.len);
+        if (!ext && id > COB_ID_RSDO_BASE && id <= COB_ID_RSDO_BASE + 0x7F) {
+            answerSDO(frame);
+        }
+        return true;
+    }
+
+    bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override {
+        CanFrame frame;
+        if (receiveBurst(&frame, 1, 0) == 0) {
+            return false;
+        }
+        *id = frame.id;
+        *ext = frame.ext;
+        *len = frame.len;
+        memcpy(buf, frame.data, frame.len);
+        return true;
+    }
+
+    // Zuerst offene SDO-Antworten, dann (falls aktiv) die Busfolge im Kreis
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs = 0) override {
+        size_t count = responses.popBurst(frames, max);
+        if (!replay || traffic.empty()) {
+            return count;
+        }
+        uint64_t now = canTimestampUs();
+        while (count < max) {
+            frames[count] = traffic[nextFrame];
+            frames[count].timestamp = now;
+            count++;
+            if (++nextFrame == traffic.size()) {
+                nextFrame = 0;
+            }
+        }
+        return count;
+    }
+
+    bool messageAvailable() override { return replay || !responses.empty(); }
+    void end() override { responses.clear(); }
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override {
+        *handle = 0;
+        return sendMessage(frame.id, frame.ext, frame.len, const_cast<uint8_t*>(frame.data)) ? CAN_TX_OK : CAN_TX_FAILED;
+    }
+};
+
+static BenchCANInterface benchInterface;
+static NullDisplay nullDisplay;
+
+static CanFrame makeFrame(uint32_t id, std::initializer_list<uint8_t> data, uint8_t ext = 0) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext;
+    frame.len = (uint8_t)data.size();
+    size_t i = 0;
+    for (uint8_t b : data) {
+        frame.data[i++] = b;
+    }
+    return frame;
+}
+
+// Typischer Verkehr eines kleinen Netzes (Nodes 1..8): PDOs überwiegen, dazu SYNC,
+// Heartbeats, einzelne SDO-Antworten/-Anfragen, EMCY, TIME, NMT und ein J1939-Frame
+static std::vector<CanFrame> mixedTraffic() {
+    std::vector<CanFrame> frames;
+    frames.push_back(makeFrame(0x080, {}));
+    for (uint8_t node = 1; node <= 8; node++) {
+        frames.push_back(makeFrame(0x180 + node, {0x37, 0x04, 0x00, 0x00, 0x10, 0x27, 0x00, 0x00}));
+        frames.push_back(makeFrame(0x280 + node, {0x12, 0x34, node, 0x00}));
+        frames.push_back(makeFrame(0x200 + node, {0x0F, 0x00}));
+        frames.push_back(makeFrame(0x700 + node, {0x05}));
+    }
+    frames.push_back(makeFrame(0x080, {}));
+    frames.push_back(makeFrame(0x602, {0x40, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00}));
+    frames.push_back(makeFrame(0x582, {0x43, 0x00, 0x10, 0x00, 0x92, 0x01, 0x02, 0x00}));
+    frames.push_back(makeFrame(0x083, {0x10, 0x81, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00}));
+    frames.push_back(makeFrame(0x100, {0x00, 0x5C, 0x26, 0x05, 0xB0, 0x3A}));
+    frames.push_back(makeFrame(0x000, {0x01, 0x00}));
+    frames.push_back(makeFrame(0x705, {0x00}));
+    frames.push_back(makeFrame(0x18FEF100, {0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, 1));
+    return frames;
+}
+
+// ===================================================================================
+// Messrahmen
+// ===================================================================================
+struct BenchCase {
+    String name;
+    void (*setup)(const void* arg);
+    size_t (*run)(size_t iterations, const void* arg);  // Liefert die bearbeiteten Elemente
+    const void* arg;
+};
+
+struct BenchResult {
+    String name;
+    size_t iterations;
+    size_t items;
+    double realNsPerItem;
+    double cpuNsPerItem;
+};
+
+static double wallNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+struct RunSample {
+    size_t items;
+    double realNs;
+    double cpuNs;
+};
+
+static RunSample runOnce(const BenchCase& bench, size_t iterations) {
+    RunSample sample;
+    double wallStart = wallNs();
+    double cpuStart = benchCpuNs();
+    sample.items = bench.run(iterations, bench.arg);
+    sample.cpuNs = benchCpuNs() - cpuStart;
+    sample.realNs = wallNs() - wallStart;
+    if (sample.items == 0) sample.items = 1;
+    return sample;
+}
+
+static BenchResult measure(const BenchCase& bench, double minTimeNs, int repetitions) {
+    if (bench.setup != nullptr) {
+        bench.setup(bench.arg);
+    }
+
+    // Kalibrieren: Iterationen vervielfachen, bis ein Lauf lang genug dauert
+    size_t iterations = 1;
+    for (;;) {
+        RunSample sample = runOnce(bench, iterations);
+        if (sample.realNs >= minTimeNs || iterations >= ((size_t)1 << 30)) {
+            break;
+        }
+        double factor = sample.realNs > 0 ? minTimeNs * 1.4 / sample.realNs : 100.0;
+        factor = std::min(std::max(factor, 2.0), 100.0);
+        iterations = (size_t)((double)iterations * factor);
+    }
+
+    std::vector<RunSample> samples;
+    for (int i = 0; i < repetitions; i++) {
+        samples.push_back(runOnce(bench, iterations));
+    }
+    std::sort(samples.begin(), samples.end(), [](const RunSample& a, const RunSample& b) {
+        return a.realNs / a.items < b.realNs / b.items;
+    });
+    const RunSample& median = samples[samples.size() / 2];
+
+    BenchResult result;
+    result.name = bench.name;
+    result.iterations = iterations;
+    result.items = median.items;
+    result.realNsPerItem = median.realNs / median.items;
+    result.cpuNsPerItem = median.cpuNs / median.items;
+    return result;
+}
+
+// ===================================================================================
+// processCANMessage: Burst durch Dispatcher und Live-Monitor
+// ===================================================================================
+struct MonitorVariant {
+    const char* name;
+    bool monitor;
+    const char* filterCommands[3];  // Nacheinander an 'filter ...' übergeben
+};
+
+static const MonitorVariant monitorVariants[] = {
+    { "monitor_off",          false, { nullptr } },
+    { "no_filter",            true,  { nullptr } },
+    { "id",                   true,  { "id 0x180-0x1FF", nullptr } },
+    { "node",                 true,  { "node 1-4", nullptr } },
+    { "type",                 true,  { "type pdo,sdo", nullptr } },
+    { "id+node",              true,  { "add include id 0x180-0x4FF node 1-4", nullptr } },
+    { "id+node+type",         true,  { "add include id 0x180-0x4FF node 1-4 type tpdo", nullptr } },
+    { "include+exclude",      true,  { "type pdo", "add exclude node 2", nullptr } },
+    { "extended",             true,  { "id 0x18FEF100-0x18FEF1FF", nullptr } },
+};
+
+static void setupMonitor(const void* arg) {
+    const MonitorVariant* variant = static_cast<const MonitorVariant*>(arg);
+    handleMonitorFilterCommand("reset");
+    for (const char* const* command = variant->filterCommands; *command != nullptr; command++) {
+        handleMonitorFilterCommand(*command);
+    }
+    liveMonitor = variant->monitor;
+    benchInterface.setTraffic(mixedTraffic());
+    benchInterface.setReplay(true);
+}
+
+static size_t runProcessCANMessage(size_t iterations, const void* arg) {
+    for (size_t i = 0; i < iterations; i++) {
+        processCANMessage();
+    }
+    return iterations * CAN_RX_BURST_SIZE;
+}
+
+// ===================================================================================
+// CANDispatcher: Kosten der Verteilung je Frame
+// Die Verbraucher tun fast nichts (noinline, ein Zähler), gemessen wird also nur die
+// Tabelle, die Schleife und der indirekte Aufruf. Abonnements wie in initCANDispatcher():
+// SDO-Client, Scan-Engine, Heartbeat-Überwachung; "all" ergänzt Busstatistik und Live-
+// Monitor (alle Frames). Verkehr: mixedTraffic() oder zufällige Standard-IDs (schlechtester
+// Fall für die Sprungvorhersage).
+// ===================================================================================
+static volatile uint32_t dispatchSink[5];
+
+__attribute__((noinline)) static void benchSDOConsumer(const CanFrame& frame, void* context) {
+    dispatchSink[0]++;
+}
+__attribute__((noinline)) static void benchScanConsumer(const CanFrame& frame, void* context) {
+    dispatchSink[1]++;
+}
+__attribute__((noinline)) static void benchHeartbeatConsumer(const CanFrame& frame, void* context) {
+    dispatchSink[2]++;
+}
+__attribute__((noinline)) static void benchStatisticsConsumer(const CanFrame& frame, void* context) {
+    dispatchSink[3]++;
+}
+__attribute__((noinline)) static void benchMonitorConsumer(const CanFrame& frame, void* context) {
+    dispatchSink[4]++;
+}
+
+static const uint16_t benchScanCodes = CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_NMT_EC) |
+                                       CAN_FC_BIT(CAN_FC_SYNC_EMCY) | CAN_FC_TPDOS;
+
+struct DispatchVariant {
+    const char* name;
+    bool allFrames;   // Busstatistik und Live-Monitor abonniert
+    bool randomIds;
+    bool ifChain;     // Vergleich: fest verdrahtete Abfragen statt Tabelle
+};
+
+static const DispatchVariant dispatchVariants[] = {
+    { "mixed",              false, false, false },
+    { "mixed+all",          true,  false, false },
+    { "random",             false, true,  false },
+    { "random+all",         true,  true,  false },
+    { "if_chain/random",    false, true,  true  },
+    { "if_chain/random+all", true, true,  true  },
+};
+
+static CANDispatcher benchDispatcher;
+static std::vector<CanFrame> dispatchFrames;
+
+static void setupDispatch(const void* arg) {
+    const DispatchVariant* variant = static_cast<const DispatchVariant*>(arg);
+    benchDispatcher = CANDispatcher();
+    benchDispatcher.subscribe(CAN_FC_BIT(CAN_FC_TSDO), false, benchSDOConsumer);
+    benchDispatcher.subscribe(benchScanCodes, false, benchScanConsumer);
+    if (variant->allFrames) {
+        benchDispatcher.subscribe(CAN_FC_ALL, true, benchStatisticsConsumer);
+    }
+    benchDispatcher.subscribe(CAN_FC_BIT(CAN_FC_NMT_EC), false, benchHeartbeatConsumer);
+    if (variant->allFrames) {
+        benchDispatcher.subscribe(CAN_FC_ALL, true, benchMonitorConsumer);
+    }
+
+    if (variant->randomIds) {
+        std::mt19937 rng(1);
+        dispatchFrames.assign(4096, makeFrame(0, {0, 0, 0, 0, 0, 0, 0, 0}));
+        for (CanFrame& frame : dispatchFrames) {
+            frame.id = rng() & 0x7FF;
+        }
+    } else {
+        dispatchFrames = mixedTraffic();
+    }
+}
+
+__attribute__((noinline)) static void dispatchIfChain(const CanFrame& frame, bool allFrames) {
+    uint8_t fc = frame.ext ? 0xFF : canFunctionCode(frame.id);
+    if (fc == CAN_FC_TSDO) benchSDOConsumer(frame, nullptr);
+    if (fc < 16 && (benchScanCodes & CAN_FC_BIT(fc))) benchScanConsumer(frame, nullptr);
+    if (allFrames) benchStatisticsConsumer(frame, nullptr);
+    if (fc == CAN_FC_NMT_EC) benchHeartbeatConsumer(frame, nullptr);
+    if (allFrames) benchMonitorConsumer(frame, nullptr);
+}
+
+static size_t runDispatch(size_t iterations, const void* arg) {
+    const DispatchVariant* variant = static_cast<const DispatchVariant*>(arg);
+    const CanFrame* frames = dispatchFrames.data();
+    const size_t count = dispatchFrames.size();
+    size_t dispatched = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        // In Bursts wie processCANMessage()
+        for (size_t first = 0; first < count; first += CAN_RX_BURST_SIZE) {
+            size_t burst = std::min((size_t)CAN_RX_BURST_SIZE, count - first);
+            if (variant->ifChain) {
+                for (size_t j = 0; j < burst; j++) {
+                    dispatchIfChain(frames[first + j], variant->allFrames);
+                }
+            } else {
+                benchDispatcher.dispatchBurst(frames + first, burst);
+            }
+        }
+        dispatched += count;
+    }
+    return dispatched;
+}
+
+// ===================================================================================
+// decodeCANMessage je Nachrichtentyp
+// ===================================================================================
+struct DecodeVariant {
+    const char* name;
+    CanFrame frame;
+};
+
+static std::vector<DecodeVariant> decodeVariants() {
+    return {
+        { "nmt",          makeFrame(0x000, {0x01, 0x05}) },
+        { "sync",         makeFrame(0x080, {}) },
+        { "emcy",         makeFrame(0x085, {0x10, 0x81, 0x11, 0x00, 0x00, 0x00, 0x00, 0x00}) },
+        { "time",         makeFrame(0x100, {0x00, 0x5C, 0x26, 0x05, 0xB0, 0x3A}) },
+        { "tpdo",         makeFrame(0x185, {0x37, 0x04, 0x00, 0x00, 0x10, 0x27, 0x00, 0x00}) },
+        { "rpdo",         makeFrame(0x205, {0x0F, 0x00}) },
+        { "sdo_response", makeFrame(0x585, {0x43, 0x00, 0x10, 0x00, 0x92, 0x01, 0x02, 0x00}) },
+        { "sdo_abort",    makeFrame(0x585, {0x80, 0x00, 0x20, 0x00, 0x00, 0x00, 0x02, 0x06}) },
+        { "sdo_request",  makeFrame(0x605, {0x40, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00}) },
+        { "bootup",       makeFrame(0x705, {0x00}) },
+        { "heartbeat",    makeFrame(0x705, {0x05}) },
+        { "extended",     makeFrame(0x18FEF100, {0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, 1) },
+    };
+}
+
+static size_t runDecode(size_t iterations, const void* arg) {
+    const DecodeVariant* variant = static_cast<const DecodeVariant*>(arg);
+    CanFrame frame = variant->frame;
+    for (size_t i = 0; i < iterations; i++) {
+        decodeCANMessage(frame.id, frame.id & 0x7F, frame.id & 0x780, frame.data, frame.len);
+    }
+    return iterations;
+}
+
+// ===================================================================================
+// SDO-Anfragen (blockierende API gegen den sofort antwortenden Server)
+// ===================================================================================
+struct SDOVariant {
+    const char* name;
+    bool write;
+    uint16_t index;
+    uint8_t subIndex;
+    uint8_t size;
+};
+
+static const SDOVariant sdoVariants[] = {
+    { "readSDO/expedited",  false, 0x1000, 0x00, 0 },
+    { "writeSDO/1byte",     true,  0x1800, 0x02, 1 },
+    { "writeSDO/2byte",     true,  0x1017, 0x00, 2 },
+    { "writeSDO/4byte",     true,  0x1400, 0x01, 4 },
+};
+
+static void setupSDO(const void* arg) {
+    benchInterface.setReplay(false);
+}
+
+static size_t runSDO(size_t iterations, const void* arg) {
+    const SDOVariant* variant = static_cast<const SDOVariant*>(arg);
+    size_t ok = 0;
+    for (size_t i = 0; i < iterations; i++) {
+        uint32_t value = 0;
+        bool success = variant->write
+            ? canopen.writeSDO(5, variant->index, variant->subIndex, (uint32_t)i & 0xFF, variant->size)
+            : canopen.readSDO(5, variant->index, variant->subIndex, value);
+        ok += success ? 1 : 0;
+    }
+    return ok;
+}
+
+// ===================================================================================
+// displayCANMessage: Ansicht vormerken und sofort zeichnen
+// ===================================================================================
+static uint32_t fakeNowMs = 0;
+
+static void setupDisplay(const void* arg) {
+    handleMonitorFilterCommand("reset");
+    liveMonitor = true;
+    displayInterface = &nullDisplay;
+}
+
+static size_t runDisplay(size_t iterations, const void* arg) {
+    CanFrame frame = *static_cast<const CanFrame*>(arg);
+    for (size_t i = 0; i < iterations; i++) {
+        frame.data[0] = (uint8_t)i;
+        displayCANMessage(frame.id, frame.data, frame.len);
+        // Synthetische Zeit: jedes Bildintervall ist abgelaufen, jede Anforderung wird gezeichnet
+        fakeNowMs += 1000;
+        displayScheduler.service(fakeNowMs);
+    }
+    return iterations;
+}
+
+static const CanFrame displayFrames[] = {
+    makeFrame(0x185, {0x37, 0x04, 0x00, 0x00, 0x10, 0x27, 0x00, 0x00}),
+    makeFrame(0x705, {0x05}),
+};
+
+// ===================================================================================
+// JSON-Ausgabe (Google-Benchmark-Format, BenchReport.h)
+// ===================================================================================
+static void writeJson(FILE* out, const std::vector<BenchResult>& results, const char* executable,
+                      double minTimeMs, int repetitions) {
+    benchJsonBeginReport(out, executable);
+    fprintf(out, ",\n    \"min_time_ms\": %.0f,\n    \"repetitions\": %d", minTimeMs, repetitions);
+    fprintf(out, ",\n    \"rx_burst_size\": %d", CAN_RX_BURST_SIZE);
+    benchJsonBeginBenchmarks(out);
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        benchJsonBeginBenchmark(out, i == 0, r.name.c_str(), r.items, r.realNsPerItem, r.cpuNsPerItem, "ns");
+        fprintf(out, ",\n      \"repetitions\": %d", repetitions);
+        fprintf(out, ",\n      \"items_per_second\": %.1f", 1e9 / r.realNsPerItem);
+        benchJsonEndBenchmark(out);
+    }
+    benchJsonEndReport(out);
+}
+
+// ===================================================================================
+// Hauptprogramm
+// ===================================================================================
+static bool optionValue(const char* arg, const char* name, const char** value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    *value = arg + length + 1;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = "";
+    const char* outPath = nullptr;
+    double minTimeMs = 200;
+    int repetitions = 3;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value;
+        if (optionValue(argv[i], "--filter", &value)) {
+            filter = value;
+        } else if (optionValue(argv[i], "--min-time", &value)) {
+            minTimeMs = std::max(1.0, atof(value));
+        } else if (optionValue(argv[i], "--repetitions", &value)) {
+            repetitions = std::max(1, atoi(value));
+        } else if (optionValue(argv[i], "--out", &value)) {
+            outPath = value;
+        } else {
+            fprintf(stderr, "Aufruf: %s [--filter=text] [--min-time=ms] [--repetitions=n] [--out=datei]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // JSON auf das ursprüngliche stdout, die Serial-Ausgabe des Kerns nach /dev/null
+    FILE* json = benchOpenReport(outPath);
+    if (json == nullptr) {
+        return 1;
+    }
+
+    // Kern wie in setup() verdrahten, nur mit dem Benchmark-Interface und ohne Display
+    canInterface = &benchInterface;
+    canopen.setCANInterface(&benchInterface);
+    canopen.setFrameHandler(forwardCANFrame);
+    initCANDispatcher();
+    displayInterface = nullptr;
+
+    std::vector<BenchCase> cases;
+    for (const MonitorVariant& variant : monitorVariants) {
+        cases.push_back({ String("processCANMessage/") + variant.name, setupMonitor, runProcessCANMessage, &variant });
+    }
+    for (const DispatchVariant& variant : dispatchVariants) {
+        cases.push_back({ String("CANDispatcher/") + variant.name, setupDispatch, runDispatch, &variant });
+    }
+    static const std::vector<DecodeVariant> decodes = decodeVariants();
+    for (const DecodeVariant& variant : decodes) {
+        cases.push_back({ String("decodeCANMessage/") + variant.name, nullptr, runDecode, &variant });
+    }
+    for (const SDOVariant& variant : sdoVariants) {
+        cases.push_back({ String("CANopen::") + variant.name, setupSDO, runSDO, &variant });
+    }
+    cases.push_back({ "displayCANMessage/tpdo_8byte", setupDisplay, runDisplay, &displayFrames[0] });
+    cases.push_back({ "displayCANMessage/heartbeat_1byte", setupDisplay, runDisplay, &displayFrames[1] });
+
+    fprintf(stderr, "%-40s %12s %12s %14s\n", "Benchmark", "ns/Element", "CPU ns", "Elemente/s");
+    std::vector<BenchResult> results;
+    for (const BenchCase& bench : cases) {
+        if (bench.name.indexOf(filter) < 0) {
+            continue;
+        }
+        BenchResult result = measure(bench, minTimeMs * 1e6, repetitions);
+        fflush(stdout);
+        displayInterface = nullptr;
+        fprintf(stderr, "%-40s %12.1f %12.1f %14.0f\n", result.name.c_str(),
+                result.realNsPerItem, result.cpuNsPerItem, 1e9 / result.realNsPerItem);
+        results.push_back(result);
+    }
+
+    writeJson(json, results, argv[0], minTimeMs, repetitions);
+    fclose(json);
+    return results.empty() ? 1 : 0;
+}
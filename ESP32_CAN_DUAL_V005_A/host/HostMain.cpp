@@ -0,0 +1,23 @@
+// host/HostMain.cpp
+// ===============================================================================
+// Einstiegspunkt für den Sketch auf dem Host: setup() einmal, dann loop() endlos
+// Konsole ist stdin/stdout, die Einstellungen liegen in $PLATFORM_STORE_DIR.
+// CAN über den simulierten Bus (Standard) oder 'transceiver can 5' für SocketCAN
+// ($CAN_INTERFACE, Standard can0). Benchmarks und Tests binden die Host-Bibliothek
+// ohne diese Datei und rufen die Kernfunktionen direkt auf.
+// ===============================================================================
+
+#include "Arduino.h"
+
+void setup();
+void loop();
+
+int main() {
+    setup();
+    for (;;) {
+        loop();
+        Serial.flush();
+        // loop() pollt; ohne Pause belegt der Prozess einen Kern vollständig
+        platformSleepUs(100);
+    }
+}
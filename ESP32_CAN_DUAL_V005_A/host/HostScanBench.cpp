@@ -0,0 +1,429 @@
+// host/HostScanBench.cpp
+// ===============================================================================
+// End-to-End-Benchmarks für Node-Scan und Baudratenerkennung (canopen_host_scanbench)
+// Jede Strategie läuft gegen eine Reihe simulierter Netze (CANSimNetwork): Anzahl
+// Nodes, Bitrate, SDO-Antwortzeit, Heartbeat, fehlende und langsame Nodes.
+//   Scan:          scanNodes() (blockierend), processCANScanning() aktiv, nur Hörphase,
+//                  Hörphase mit Abfrage der nicht gesehenen IDs (Bereich 1-127)
+//   Baudrate:      autoBaudrateDetection() (blockierend), processAutoBaudrate()
+//                  (Zustandsautomat, getaktet wie startAutoBaudrateDetection())
+// Berichtet werden Dauer, Rechenzeit des Hosts, vom Master gesendete Frames
+// (zugestellt bzw. mit Error-Frame abgebrochen), Frames und Error-Frames auf dem Bus,
+// Buslast sowie das Ergebnis (gefundene Nodes bzw. erkannte Bitrate).
+//
+// Standardmäßig läuft die Uhr simuliert (platformUseSimulatedTime): Warten kostet
+// keine Echtzeit, jeder yield() zählt --yield-us als Kosten eines Schleifendurchlaufs.
+// Die Dauer entspricht damit der Buszeit eines echten Netzes ohne Rechenzeit des
+// Controllers; --realtime misst stattdessen gegen die Uhr des Hosts.
+// Ausgabe als JSON im Format von Google Benchmark (BenchReport.h), Übersicht nach stderr.
+//
+//   canopen_host_scanbench [--filter=text] [--limit-s=s] [--yield-us=us] [--realtime]
+//                          [--display] [--out=datei]
+// ===============================================================================
+
+#include "Arduino.h"
+#include "BenchReport.h"
+#include "CANInterface.h"
+#include "CANScanEngine.h"
+#include "CANTimestamp.h"
+#include "CANopenClass.h"
+#include "DisplayInterface.h"
+#include "NullDisplay.h"
+#include "SimCANInterface.h"
+
+#include <algorithm>
+#include <vector>
+
+// Kern (Sketch, processCANScanning.cpp, processAutoBaudrate.cpp)
+extern CANInterface* canInterface;
+extern DisplayInterface* displayInterface;
+extern CANopen canopen;
+extern int currentBaudrate;
+extern uint8_t currentCANTransceiverType;
+extern uint8_t scanStart;
+extern uint8_t scanEnd;
+extern bool scanning;
+extern bool autoBaudrateRequest;
+void initCANDispatcher();
+void forwardCANFrame(CanFrame& frame);
+void scanNodes(int startID, int endID);
+bool autoBaudrateDetection();
+bool recreateCANInterface(int baudrateKbps);
+void processCANScanning();
+void processAutoBaudrate();
+void setScanMode(uint16_t listenMs, bool probe);
+uint8_t scanEngineFoundCount();
+
+// ===================================================================================
+// Simulierte Netze
+// ===================================================================================
+struct Scenario {
+    const char* name;
+    uint8_t nodes;          // Nodes 1..nodes
+    uint16_t bitrateKbps;
+    uint32_t responseUs;    // SDO-Antwortzeit
+    uint16_t heartbeatMs;   // 0 = kein Heartbeat
+    uint8_t missingEvery;   // Jeder n-te Node ausgeschaltet (0 = keiner)
+    uint8_t slowEvery;      // Jeder n-te Node antwortet erst nach slowUs (0 = keiner)
+    uint32_t slowUs;
+};
+
+static const Scenario scenarios[] = {
+    { "5n_500k",            5, 500,  200, 1000, 0, 0,     0 },
+    { "30n_500k",          30, 500,  200, 1000, 0, 0,     0 },
+    { "120n_500k",        120, 500,  200, 1000, 0, 0,     0 },
+    { "30n_125k",          30, 125,  200, 1000, 0, 0,     0 },
+    { "30n_800k",          30, 800,  200, 1000, 0, 0,     0 },
+    { "30n_500k_slow",     30, 500,  200, 1000, 0, 3, 15000 },
+    { "30n_500k_missing",  30, 500,  200, 1000, 4, 0,     0 },
+    { "30n_500k_no_hb",    30, 500,  200,    0, 0, 0,     0 },
+    { "120n_250k_slow",   120, 250, 2000, 1000, 0, 4, 15000 },
+    { "empty_500k",         0, 500,  200, 1000, 0, 0,     0 },
+};
+
+// Netz nach dem Szenario aufbauen; liefert die Anzahl eingeschalteter Nodes.
+// masterKbps = Bitrate, mit der das Interface des Masters startet.
+static uint8_t prepareNetwork(const Scenario& scenario, uint16_t masterKbps) {
+    canopen.setCANInterface(nullptr);
+    if (canInterface != nullptr) {
+        canInterface->end();
+        delete canInterface;
+        canInterface = nullptr;
+    }
+
+    CANSimNetwork& network = simNetwork();
+    network.clear();
+    network.bus().setBitrate((uint32_t)scenario.bitrateKbps * 1000UL);
+    network.bus().setErrorRate(0);
+    network.skipTo(canTimestampUs());
+    for (uint8_t id = 1; id <= scenario.nodes; id++) {
+        CANSimNode* node = network.addNode(id, scenario.heartbeatMs);
+        if (node == nullptr) continue;
+        bool slow = scenario.slowEvery > 0 && id % scenario.slowEvery == 0;
+        node->setResponseDelay(slow ? scenario.slowUs : scenario.responseUs);
+    }
+
+    currentCANTransceiverType = CAN_CONTROLLER_SIM;
+    currentBaudrate = masterKbps;
+    recreateCANInterface(masterKbps);
+
+    // Laufendes Netz: Boot-up gestaffelt, damit die Heartbeats über die Periode verteilt
+    // sind (wie bei nacheinander eingeschalteten Geräten); fehlende Nodes ausschalten
+    uint8_t present = 0;
+    uint64_t now = network.bus().now();
+    uint64_t spreadUs = scenario.nodes > 0 ? (uint64_t)scenario.heartbeatMs * 1000 / scenario.nodes : 0;
+    for (uint8_t id = 1; id <= scenario.nodes; id++) {
+        CANSimNode* node = network.node(id);
+        if (node == nullptr) continue;
+        if (scenario.missingEvery > 0 && id % scenario.missingEvery == 0) {
+            node->powerOff();
+        } else {
+            node->powerOn(now + (id - 1) * spreadUs);
+            present++;
+        }
+    }
+
+    // Einschwingen: eine Heartbeat-Periode abspielen, Empfangenes verwerfen
+    uint32_t settleMs = scenario.heartbeatMs + 50;
+    uint32_t start = millis();
+    CanFrame stale[CAN_RX_BURST_SIZE];
+    while (millis() - start < settleMs) {
+        delay(1);
+        while (canInterface->receiveBurst(stale, CAN_RX_BURST_SIZE, 0) > 0) {
+        }
+    }
+    return present;
+}
+
+// ===================================================================================
+// Zähler: Sendeversuche des Masters über den Mitschnitt des Busses
+// ===================================================================================
+static uint32_t masterSent = 0;     // Zugestellt
+static uint32_t masterFailed = 0;   // Mit Error-Frame abgebrochen (kein ACK, falsche Bitrate)
+
+static void onBusTrace(const CanFrame& frame, CANSimParticipant* sender, bool success, void* context) {
+    if (dynamic_cast<CANSimNode*>(sender) != nullptr) {
+        return;
+    }
+    if (success) {
+        masterSent++;
+    } else {
+        masterFailed++;
+    }
+}
+
+// ===================================================================================
+// Strategien
+// ===================================================================================
+static uint64_t runLimitUs = 0;  // Abbruch der getakteten Strategien (--limit-s)
+
+struct Outcome {
+    bool completed;         // Strategie von selbst beendet (nicht durch --limit-s)
+    uint8_t found;          // Scan: gefundene Nodes
+    uint16_t detectedKbps;  // Baudrate: erkannte Bitrate (0 = keine)
+};
+
+static Outcome runScanNodes() {
+    scanNodes(1, 127);
+    return { true, scanEngineFoundCount(), 0 };
+}
+
+// Wie startNodeScan(): processCANScanning() im Millisekundentakt bis zum Ende des Scans
+static Outcome runProcessCANScanning(uint16_t listenMs, bool probe) {
+    setScanMode(listenMs, probe);
+    scanStart = 1;
+    scanEnd = 127;
+    scanning = true;
+    uint64_t start = platformMicros64();
+    while (scanning && platformMicros64() - start < runLimitUs) {
+        processCANScanning();
+        delay(1);
+    }
+    bool completed = !scanning;
+    scanning = false;
+    return { completed, scanEngineFoundCount(), 0 };
+}
+
+static Outcome runScanActive() {
+    return runProcessCANScanning(0, true);
+}
+
+static Outcome runScanListen() {
+    return runProcessCANScanning(SCAN_DEFAULT_LISTEN_MS, false);
+}
+
+static Outcome runScanListenProbe() {
+    return runProcessCANScanning(SCAN_DEFAULT_LISTEN_MS, true);
+}
+
+static Outcome runAutoBaudrateDetection() {
+    bool success = autoBaudrateDetection();
+    return { true, 0, (uint16_t)(success ? currentBaudrate : 0) };
+}
+
+// Wie startAutoBaudrateDetection(): processAutoBaudrate() alle 50 ms bis zum Abschluss
+static Outcome runProcessAutoBaudrate() {
+    autoBaudrateRequest = true;
+    uint64_t start = platformMicros64();
+    while (autoBaudrateRequest && platformMicros64() - start < runLimitUs) {
+        processAutoBaudrate();
+        delay(50);
+    }
+    bool completed = !autoBaudrateRequest;
+    autoBaudrateRequest = false;
+    // Ohne Fund fällt processAutoBaudrate() auf 125 kbit/s zurück, ohne es zu melden
+    return { completed, 0, (uint16_t)(completed ? currentBaudrate : 0) };
+}
+
+struct Strategy {
+    const char* name;
+    bool autoBaud;          // Master startet mit 125 kbit/s statt mit der Busbitrate
+    Outcome (*run)();
+};
+
+static const Strategy strategies[] = {
+    { "scanNodes",                   false, runScanNodes },
+    { "processCANScanning/active",   false, runScanActive },
+    { "processCANScanning/listen",   false, runScanListen },
+    { "processCANScanning/listen+probe", false, runScanListenProbe },
+    { "autoBaudrateDetection",       true,  runAutoBaudrateDetection },
+    { "processAutoBaudrate",         true,  runProcessAutoBaudrate },
+};
+
+// ===================================================================================
+// Messung
+// ===================================================================================
+struct RunResult {
+    String name;
+    const Strategy* strategy;
+    const Scenario* scenario;
+    Outcome outcome;
+    uint8_t expected;       // Eingeschaltete Nodes
+    double elapsedMs;
+    double cpuMs;
+    uint32_t framesSent;
+    uint32_t framesFailed;
+    uint32_t busFrames;
+    uint32_t errorFrames;
+    double busLoad;         // Anteil belegter Buszeit (0..1)
+    bool correct;
+};
+
+static RunResult measure(const Strategy& strategy, const Scenario& scenario) {
+    RunResult result;
+    result.name = String(strategy.name) + "/" + scenario.name;
+    result.strategy = &strategy;
+    result.scenario = &scenario;
+    result.expected = prepareNetwork(scenario, strategy.autoBaud ? 125 : scenario.bitrateKbps);
+
+    CANSimBus& bus = simNetwork().bus();
+    masterSent = 0;
+    masterFailed = 0;
+    uint32_t deliveredStart = bus.framesDelivered();
+    uint32_t errorsStart = bus.errorFrames();
+    uint64_t busyStart = bus.busyUs();
+    uint64_t start = platformMicros64();
+    double cpuStart = benchCpuNs();
+
+    result.outcome = strategy.run();
+
+    result.cpuMs = (benchCpuNs() - cpuStart) / 1e6;
+    uint64_t elapsedUs = platformMicros64() - start;
+    if (canInterface != nullptr) {
+        canInterface->messageAvailable();  // Bus bis jetzt abspielen
+    }
+    result.elapsedMs = elapsedUs / 1000.0;
+    result.framesSent = masterSent;
+    result.framesFailed = masterFailed;
+    result.busFrames = bus.framesDelivered() - deliveredStart;
+    result.errorFrames = bus.errorFrames() - errorsStart;
+    result.busLoad = elapsedUs > 0 ? (double)(bus.busyUs() - busyStart) / (double)elapsedUs : 0;
+    if (result.busLoad > 1.0) result.busLoad = 1.0;
+
+    if (strategy.autoBaud) {
+        uint16_t expectedKbps = result.expected > 0 ? scenario.bitrateKbps : 0;
+        result.correct = result.outcome.completed && result.outcome.detectedKbps == expectedKbps;
+    } else {
+        result.correct = result.outcome.completed && result.outcome.found == result.expected;
+    }
+    return result;
+}
+
+static void writeJson(FILE* out, const std::vector<RunResult>& results, const char* executable,
+                      bool realtime, uint32_t yieldUs, uint32_t limitS) {
+    benchJsonBeginReport(out, executable);
+    fprintf(out, ",\n    \"time_base\": \"%s\"", realtime ? "realtime" : "simulated");
+    fprintf(out, ",\n    \"yield_step_us\": %lu", (unsigned long)yieldUs);
+    fprintf(out, ",\n    \"limit_s\": %lu", (unsigned long)limitS);
+    benchJsonBeginBenchmarks(out);
+
+    for (size_t i = 0; i < results.size(); i++) {
+        const RunResult& r = results[i];
+        benchJsonBeginBenchmark(out, i == 0, r.name.c_str(), 1, r.elapsedMs, r.cpuMs, "ms");
+        fprintf(out, ",\n      \"frames_sent\": %lu", (unsigned long)r.framesSent);
+        fprintf(out, ",\n      \"frames_failed\": %lu", (unsigned long)r.framesFailed);
+        fprintf(out, ",\n      \"bus_frames\": %lu", (unsigned long)r.busFrames);
+        fprintf(out, ",\n      \"error_frames\": %lu", (unsigned long)r.errorFrames);
+        fprintf(out, ",\n      \"bus_load\": %.4f", r.busLoad);
+        fprintf(out, ",\n      \"nodes_present\": %u", r.expected);
+        fprintf(out, ",\n      \"bus_kbps\": %u", r.scenario->bitrateKbps);
+        if (r.strategy->autoBaud) {
+            fprintf(out, ",\n      \"detected_kbps\": %u", r.outcome.detectedKbps);
+        } else {
+            fprintf(out, ",\n      \"nodes_found\": %u", r.outcome.found);
+        }
+        fprintf(out, ",\n      \"completed\": %d", r.outcome.completed ? 1 : 0);
+        fprintf(out, ",\n      \"correct\": %d", r.correct ? 1 : 0);
+        benchJsonEndBenchmark(out);
+    }
+    benchJsonEndReport(out);
+}
+
+// ===================================================================================
+// Hauptprogramm
+// ===================================================================================
+static bool optionValue(const char* arg, const char* name, const char** value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    *value = arg + length + 1;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* filter = "";
+    const char* outPath = nullptr;
+    uint32_t limitS = 300;
+    uint32_t yieldUs = 10;
+    bool realtime = false;
+    bool withDisplay = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value;
+        if (optionValue(argv[i], "--filter", &value)) {
+            filter = value;
+        } else if (optionValue(argv[i], "--limit-s", &value)) {
+            limitS = (uint32_t)std::max(1, atoi(value));
+        } else if (optionValue(argv[i], "--yield-us", &value)) {
+            yieldUs = (uint32_t)std::max(1, atoi(value));
+        } else if (optionValue(argv[i], "--out", &value)) {
+            outPath = value;
+        } else if (strcmp(argv[i], "--realtime") == 0) {
+            realtime = true;
+        } else if (strcmp(argv[i], "--display") == 0) {
+            withDisplay = true;
+        } else {
+            fprintf(stderr, "Aufruf: %s [--filter=text] [--limit-s=s] [--yield-us=us] [--realtime] [--display] [--out=datei]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE* json = benchOpenReport(outPath);
+    if (json == nullptr) {
+        return 1;
+    }
+
+    // Erkannte Baudraten speichert der Kern (saveSettings): nicht in die Einstellungen
+    // des Benutzers, sondern in ein temporäres Verzeichnis
+    char storeDir[] = "/tmp/canopen_scanbench.XXXXXX";
+    if (getenv("PLATFORM_STORE_DIR") == nullptr && mkdtemp(storeDir) != nullptr) {
+        setenv("PLATFORM_STORE_DIR", storeDir, 1);
+    } else {
+        storeDir[0] = '\0';
+    }
+
+    if (!realtime) {
+        platformUseSimulatedTime(yieldUs);
+    }
+    runLimitUs = (uint64_t)limitS * 1000000ULL;
+
+    // Kern wie in setup() verdrahten; das Interface legt prepareNetwork() je Lauf an
+    static NullDisplay nullDisplay;
+    displayInterface = withDisplay ? &nullDisplay : nullptr;
+    canopen.setFrameHandler(forwardCANFrame);
+    initCANDispatcher();
+    simNetwork().bus().setTrace(onBusTrace, nullptr);
+
+    fprintf(stderr, "%-48s %10s %9s %8s %8s %9s %8s %6s  %s\n", "Benchmark", "Dauer ms", "CPU ms",
+            "Gesendet", "Fehlg.", "Busframes", "Errors", "Last", "Ergebnis");
+    std::vector<RunResult> results;
+    for (const Strategy& strategy : strategies) {
+        for (const Scenario& scenario : scenarios) {
+            String name = String(strategy.name) + "/" + scenario.name;
+            if (name.indexOf(filter) < 0) {
+                continue;
+            }
+            RunResult r = measure(strategy, scenario);
+            fflush(stdout);
+
+            char outcome[48];
+            if (strategy.autoBaud) {
+                snprintf(outcome, sizeof(outcome), "%u kbit/s", r.outcome.detectedKbps);
+            } else {
+                snprintf(outcome, sizeof(outcome), "%u/%u Nodes", r.outcome.found, r.expected);
+            }
+            fprintf(stderr, "%-48s %10.1f %9.1f %8lu %8lu %9lu %8lu %5.1f%%  %s%s%s\n", r.name.c_str(),
+                    r.elapsedMs, r.cpuMs, (unsigned long)r.framesSent, (unsigned long)r.framesFailed,
+                    (unsigned long)r.busFrames, (unsigned long)r.errorFrames, r.busLoad * 100.0, outcome,
+                    r.outcome.completed ? "" : " (abgebrochen)", r.correct ? "" : " [FALSCH]");
+            results.push_back(r);
+        }
+    }
+
+    canopen.setCANInterface(nullptr);
+    if (canInterface != nullptr) {
+        canInterface->end();
+        delete canInterface;
+        canInterface = nullptr;
+    }
+    if (storeDir[0] != '\0') {
+        String settings = String(storeDir) + "/canopenscan";
+        unlink(settings.c_str());
+        rmdir(storeDir);
+    }
+
+    writeJson(json, results, argv[0], realtime, yieldUs, limitS);
+    fclose(json);
+    return results.empty() ? 1 : 0;
+}
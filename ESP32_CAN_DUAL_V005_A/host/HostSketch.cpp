@@ -0,0 +1,10 @@
+// host/HostSketch.cpp
+// ===============================================================================
+// Hauptprogramm des Sketches für den Host-Build
+// Die Arduino-IDE übersetzt die .ino als C++; auf dem Host bindet diese Datei sie ein,
+// damit Globals (canopen, canInterface, Einstellungen), setup()/loop() und die Befehle
+// des Hauptprogramms in der Host-Bibliothek liegen. Display- und MCP2515-Teile sind in
+// der .ino für den Host ausgeblendet.
+// ===============================================================================
+
+#include "../ESP32_CAN_DUAL_V005_A.ino"
@@ -0,0 +1,66 @@
+// host/NullDisplay.h
+// ===============================================================================
+// Display ohne Ausgabe für Benchmarks auf dem Host
+// Formatiert Texte wie ein echtes Display (Zahlen, printf in einen Zeilenpuffer) und
+// verwirft sie dann; Zeichenbefehle werden nur gezählt. So misst ein Benchmark die
+// Aufbereitung der Ansicht ohne die Übertragung zum Panel.
+// ===============================================================================
+
+#pragma once
+
+#include "DisplayInterface.h"
+
+class NullDisplay : public DisplayInterface {
+private:
+    char line[64];           // Zeilenpuffer wie bei Adafruit_GFX (pro Ausgabe)
+    uint32_t chars = 0;      // Formatierte Zeichen
+    uint32_t commands = 0;   // Zeichen- und Cursorbefehle
+    uint32_t frames = 0;     // display()-Aufrufe
+
+    void text(const char* s) {
+        chars += (uint32_t)strlen(s);
+    }
+
+    void number(const char* format, long value) {
+        chars += (uint32_t)snprintf(line, sizeof(line), format, value);
+    }
+
+public:
+    bool begin() override { return true; }
+    void clear() override { commands++; }
+    void display() override { frames++; }
+
+    void setCursor(int16_t x, int16_t y) override { commands++; }
+    void setTextSize(uint8_t size) override { commands++; }
+    void setTextColor(uint16_t color) override { commands++; }
+
+    void print(const char* text) override { this->text(text); }
+    void print(String text) override { this->text(text.c_str()); }
+    void print(int value) override { number("%ld", value); }
+    void print(uint8_t value) override { number("%ld", value); }
+    void print(uint32_t value) override { number("%ld", (long)value); }
+    void print(uint32_t value, int base) override { number(base == HEX ? "%lX" : "%ld", (long)value); }
+    void print(int value, int base) override { number(base == HEX ? "%lX" : "%ld", value); }
+    void println(const char* text) override { print(text); chars++; }
+    void println(String text) override { print(text); chars++; }
+    void println(int value) override { print(value); chars++; }
+    void println(uint8_t value) override { print(value); chars++; }
+    void println(uint32_t value) override { print(value); chars++; }
+    void println(uint32_t value, int base) override { print(value, base); chars++; }
+
+    void printf(const char* format, ...) override {
+        va_list args;
+        va_start(args, format);
+        int len = vsnprintf(line, sizeof(line), format, args);
+        va_end(args);
+        if (len > 0) chars += (uint32_t)len;
+    }
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) override { commands++; }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override { commands++; }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override { commands++; }
+
+    uint32_t charsFormatted() const { return chars; }
+    uint32_t drawCommands() const { return commands; }
+    uint32_t framesShown() const { return frames; }
+};
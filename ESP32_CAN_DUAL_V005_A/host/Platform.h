@@ -0,0 +1,85 @@
+// host/Platform.h
+// ===============================================================================
+// Systemfunktionen des Host-Builds: Zeit, Warten, serielle Konsole, Schlüssel-Wert-
+// Speicher, GPIO
+// Der Sketch ist gegen die Arduino-API geschrieben und benutzt sie auf dem ESP32
+// direkt. Für den Host-Build (Benchmarks, Profiling, Tests gegen SocketCAN oder den
+// simulierten Bus) bilden host/Arduino.h, Preferences.h und SPI.h den benutzten Teil
+// dieser API nach und stützen sich dabei auf die Funktionen hier; implementiert sind
+// sie in host/PlatformPosix.cpp (clock_gettime, nanosleep, stdin/stdout,
+// Schlüssel-Wert-Dateien, simulierte Pins). Die Arduino-IDE übersetzt host/ nicht mit.
+// ===============================================================================
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===================================================================================
+// Zeit und Warten
+// ===================================================================================
+uint32_t platformMillis();               // Millisekunden seit dem Start (läuft über)
+uint32_t platformMicros();               // Mikrosekunden seit dem Start (läuft über)
+uint64_t platformMicros64();             // Mikrosekunden seit dem Start (64 Bit, Zeitstempel)
+void platformSleepMs(uint32_t ms);       // Blockierend warten (gibt die CPU ab)
+void platformSleepUs(uint32_t us);
+void platformYield();                    // Anderen Tasks/Threads Rechenzeit geben
+void platformRestart();                  // Neustart (Host: Prozess beenden)
+
+// Simulierte Zeit: Warten stellt die Uhr um die Wartezeit vor, platformYield()
+// um yieldStepUs (Kosten eines Schleifendurchlaufs), statt zu schlafen. Für Benchmarks
+// gegen den simulierten Bus: reproduzierbar, unabhängig von der Rechnerlast und
+// schneller als Echtzeit. Die Uhr läuft ab der aktuellen Zeit weiter.
+void platformUseSimulatedTime(uint32_t yieldStepUs);
+bool platformSimulatedTime();
+
+// ===================================================================================
+// Serielle Konsole (stdin/stdout)
+// ===================================================================================
+class PlatformStream {
+public:
+    virtual ~PlatformStream() {}
+
+    virtual void begin(uint32_t baud) {}
+    virtual int available() = 0;                         // Lesbare Bytes (0 = nichts)
+    virtual int read() = 0;                              // Nächstes Byte oder -1
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+    virtual void flush() {}
+};
+
+PlatformStream& platformConsole();
+
+// ===================================================================================
+// Schlüssel-Wert-Speicher (Datei je Namespace, Grundlage von host/Preferences.h)
+// Ganzzahlige Werte; begin() öffnet einen Namespace, end() schreibt zurück.
+// ===================================================================================
+class PlatformStore {
+public:
+    PlatformStore();
+    ~PlatformStore();
+
+    bool begin(const char* name, bool readOnly);
+    void end();
+
+    bool isKey(const char* key);
+    bool getValue(const char* key, uint32_t& value);
+    bool putValue(const char* key, uint32_t value);
+    bool remove(const char* key);
+    bool clear();
+
+private:
+    void* impl;  // Plattformabhängiger Zustand
+};
+
+// ===================================================================================
+// GPIO (simulierte Pegel, z.B. für Tasten oder CAN_INT in Tests)
+// ===================================================================================
+enum PlatformPinMode : uint8_t {
+    PLATFORM_PIN_INPUT = 0,
+    PLATFORM_PIN_OUTPUT,
+    PLATFORM_PIN_INPUT_PULLUP
+};
+
+void platformPinMode(uint8_t pin, PlatformPinMode mode);
+bool platformDigitalRead(uint8_t pin);
+void platformDigitalWrite(uint8_t pin, bool level);
@@ -0,0 +1,288 @@
+// host/PlatformPosix.cpp
+// ===============================================================================
+// Systemfunktionen des Host-Builds (host/Platform.h) für POSIX (Linux, macOS)
+// Zeit über CLOCK_MONOTONIC (oder simuliert, siehe platformUseSimulatedTime), Konsole
+// über stdin/stdout (nicht blockierend), der Schlüssel-Wert-Speicher als Textdatei je
+// Namespace ("schlüssel=wert" pro Zeile) im Verzeichnis $PLATFORM_STORE_DIR (Standard:
+// .platform_store), GPIO als simulierte Pegel: digitalWrite setzt den Pegel auch für
+// Eingänge, so können Tests Tasten oder CAN_INT bedienen.
+// ===============================================================================
+
+#include "Arduino.h"
+#include "Preferences.h"
+#include "SPI.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sched.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <map>
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+
+// ===================================================================================
+// Zeit und Warten
+// ===================================================================================
+static uint64_t monotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+// Startzeitpunkt beim ersten Aufruf, damit millis()/micros() wie auf dem ESP32 bei 0 beginnen
+static uint64_t startUs() {
+    static const uint64_t start = monotonicUs();
+    return start;
+}
+
+// Zeit seit dem Start; Startzeit zuerst holen, sonst läge sie beim ersten Aufruf nach
+// dem Messwert und die Differenz liefe über
+static uint64_t elapsedUs() {
+    uint64_t start = startUs();
+    return monotonicUs() - start;
+}
+
+// Simulierte Zeit: nur Warten und yield() stellen die Uhr vor
+static bool simulatedTime = false;
+static uint64_t simulatedUs = 0;
+static uint32_t simulatedYieldUs = 0;
+
+void platformUseSimulatedTime(uint32_t yieldStepUs) {
+    if (!simulatedTime) {
+        simulatedUs = elapsedUs();
+        simulatedTime = true;
+    }
+    // Ohne Vorstellen bei yield() endeten Warteschleifen auf micros() nie
+    simulatedYieldUs = yieldStepUs > 0 ? yieldStepUs : 1;
+}
+
+bool platformSimulatedTime() {
+    return simulatedTime;
+}
+
+uint64_t platformMicros64() {
+    return simulatedTime ? simulatedUs : elapsedUs();
+}
+
+uint32_t platformMillis() {
+    return (uint32_t)(platformMicros64() / 1000ULL);
+}
+
+uint32_t platformMicros() {
+    return (uint32_t)platformMicros64();
+}
+
+void platformSleepUs(uint32_t us) {
+    if (simulatedTime) {
+        simulatedUs += us;
+        return;
+    }
+    struct timespec ts;
+    ts.tv_sec = us / 1000000UL;
+    ts.tv_nsec = (long)(us % 1000000UL) * 1000L;
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+void platformSleepMs(uint32_t ms) {
+    if (simulatedTime) {
+        simulatedUs += (uint64_t)ms * 1000ULL;
+        return;
+    }
+    platformSleepUs(ms * 1000UL);
+}
+
+void platformYield() {
+    if (simulatedTime) {
+        simulatedUs += simulatedYieldUs;
+        return;
+    }
+    sched_yield();
+}
+
+void platformRestart() {
+    fflush(stdout);
+    exit(0);
+}
+
+// ===================================================================================
+// Konsole: stdin/stdout
+// ===================================================================================
+class PosixConsole : public PlatformStream {
+private:
+    bool endOfInput = false;
+
+public:
+    int available() override {
+        if (endOfInput) return 0;
+
+        struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+        if (poll(&pfd, 1, 0) <= 0 || !(pfd.revents & (POLLIN | POLLHUP))) {
+            return 0;
+        }
+        int pending = 0;
+        if (ioctl(STDIN_FILENO, FIONREAD, &pending) == 0 && pending > 0) {
+            return pending;
+        }
+        // Lesbar ohne Daten: Ende der Eingabe (Pipe geschlossen, Strg+D)
+        endOfInput = true;
+        return 0;
+    }
+
+    int read() override {
+        if (available() <= 0) return -1;
+        uint8_t c;
+        return ::read(STDIN_FILENO, &c, 1) == 1 ? c : -1;
+    }
+
+    size_t write(const uint8_t* data, size_t length) override {
+        return fwrite(data, 1, length, stdout);
+    }
+
+    void flush() override {
+        fflush(stdout);
+    }
+};
+
+PlatformStream& platformConsole() {
+    static PosixConsole console;
+    return console;
+}
+
+// ===================================================================================
+// Schlüssel-Wert-Speicher: eine Datei je Namespace
+// ===================================================================================
+struct PosixStoreState {
+    std::string path;
+    std::map<std::string, uint32_t> values;
+    bool readOnly;
+    bool dirty;
+};
+
+static std::string storeDirectory() {
+    const char* dir = getenv("PLATFORM_STORE_DIR");
+    return dir != nullptr && dir[0] != '\0' ? dir : ".platform_store";
+}
+
+PlatformStore::PlatformStore() : impl(nullptr) {}
+
+PlatformStore::~PlatformStore() {
+    end();
+}
+
+bool PlatformStore::begin(const char* name, bool readOnly) {
+    end();
+    if (name == nullptr || name[0] == '\0') {
+        return false;
+    }
+
+    PosixStoreState* state = new PosixStoreState();
+    state->path = storeDirectory() + "/" + name;
+    state->readOnly = readOnly;
+    state->dirty = false;
+
+    FILE* file = fopen(state->path.c_str(), "r");
+    if (file != nullptr) {
+        char line[128];
+        while (fgets(line, sizeof(line), file) != nullptr) {
+            char* separator = strchr(line, '=');
+            if (separator == nullptr) continue;
+            *separator = '\0';
+            state->values[line] = (uint32_t)strtoul(separator + 1, nullptr, 10);
+        }
+        fclose(file);
+    }
+
+    impl = state;
+    return true;
+}
+
+void PlatformStore::end() {
+    PosixStoreState* state = static_cast<PosixStoreState*>(impl);
+    if (state == nullptr) {
+        return;
+    }
+
+    if (state->dirty && !state->readOnly) {
+        mkdir(storeDirectory().c_str(), 0755);
+        // Erst in eine temporäre Datei schreiben: ein Abbruch hinterlässt keine halbe Datei
+        std::string temp = state->path + ".tmp";
+        FILE* file = fopen(temp.c_str(), "w");
+        if (file != nullptr) {
+            for (const auto& entry : state->values) {
+                fprintf(file, "%s=%lu\n", entry.first.c_str(), (unsigned long)entry.second);
+            }
+            fclose(file);
+            rename(temp.c_str(), state->path.c_str());
+        }
+    }
+
+    delete state;
+    impl = nullptr;
+}
+
+bool PlatformStore::isKey(const char* key) {
+    PosixStoreState* state = static_cast<PosixStoreState*>(impl);
+    return state != nullptr && state->values.count(key) > 0;
+}
+
+bool PlatformStore::getValue(const char* key, uint32_t& value) {
+    PosixStoreState* state = static_cast<PosixStoreState*>(impl);
+    if (state == nullptr) return false;
+
+    auto it = state->values.find(key);
+    if (it == state->values.end()) return false;
+    value = it->second;
+    return true;
+}
+
+bool PlatformStore::putValue(const char* key, uint32_t value) {
+    PosixStoreState* state = static_cast<PosixStoreState*>(impl);
+    if (state == nullptr || state->readOnly || key == nullptr || key[0] == '\0' ||
+        strchr(key, '=') != nullptr || strchr(key, '\n') != nullptr) {
+        return false;
+    }
+    state->values[key] = value;
+    state->dirty = true;
+    return true;
+}
+
+bool PlatformStore::remove(const char* key) {
+    PosixStoreState* state = static_cast<PosixStoreState*>(impl);
+    if (state == nullptr || state->readOnly) return false;
+    state->dirty |= state->values.erase(key) > 0;
+    return true;
+}
+
+bool PlatformStore::clear() {
+    PosixStoreState* state = static_cast<PosixStoreState*>(impl);
+    if (state == nullptr || state->readOnly) return false;
+    state->values.clear();
+    state->dirty = true;
+    return true;
+}
+
+// ===================================================================================
+// GPIO: simulierte Pegel
+// ===================================================================================
+static bool pinLevels[256];
+
+void platformPinMode(uint8_t pin, PlatformPinMode mode) {
+    if (mode == PLATFORM_PIN_INPUT_PULLUP) {
+        pinLevels[pin] = true;
+    }
+}
+
+bool platformDigitalRead(uint8_t pin) {
+    return pinLevels[pin];
+}
+
+void platformDigitalWrite(uint8_t pin, bool level) {
+    pinLevels[pin] = level;
+}
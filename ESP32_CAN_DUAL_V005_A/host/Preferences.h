@@ -0,0 +1,42 @@
+// host/Preferences.h
+// ===============================================================================
+// Preferences (NVS) für den Host-Build: ganzzahlige Schlüssel über PlatformStore
+// Reicht für die Einstellungen des Sketches (Node-ID, Baudrate, Controller, Scanbereich,
+// Absturzzähler). Zeichenketten und Binärdaten speichert der Host nicht.
+// ===============================================================================
+
+#pragma once
+
+#include "Arduino.h"
+
+class Preferences {
+private:
+    PlatformStore store;
+
+    uint32_t get(const char* key, uint32_t defaultValue) {
+        uint32_t value;
+        return store.getValue(key, value) ? value : defaultValue;
+    }
+
+public:
+    bool begin(const char* name, bool readOnly = false) { return store.begin(name, readOnly); }
+    void end() { store.end(); }
+
+    bool isKey(const char* key) { return store.isKey(key); }
+    bool remove(const char* key) { return store.remove(key); }
+    bool clear() { return store.clear(); }
+
+    size_t putBool(const char* key, bool value) { return store.putValue(key, value ? 1 : 0) ? 1 : 0; }
+    size_t putUChar(const char* key, uint8_t value) { return store.putValue(key, value) ? 1 : 0; }
+    size_t putUShort(const char* key, uint16_t value) { return store.putValue(key, value) ? 2 : 0; }
+    size_t putUInt(const char* key, uint32_t value) { return store.putValue(key, value) ? 4 : 0; }
+    size_t putInt(const char* key, int32_t value) { return store.putValue(key, (uint32_t)value) ? 4 : 0; }
+    size_t putULong(const char* key, uint32_t value) { return store.putValue(key, value) ? 4 : 0; }
+
+    bool getBool(const char* key, bool defaultValue = false) { return get(key, defaultValue ? 1 : 0) != 0; }
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return (uint8_t)get(key, defaultValue); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return (uint16_t)get(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+    int32_t getInt(const char* key, int32_t defaultValue = 0) { return (int32_t)get(key, (uint32_t)defaultValue); }
+    uint32_t getULong(const char* key, uint32_t defaultValue = 0) { return get(key, defaultValue); }
+};
@@ -0,0 +1,29 @@
+// host/SPI.h
+// ===============================================================================
+// SPI für den Host-Build: ohne SPI-Hardware, nur damit der Kern übersetzt
+// (CANopenClass.cpp bindet SPI.h ein). CAN läuft auf dem Host über SocketCAN oder
+// den simulierten Bus.
+// ===============================================================================
+
+#pragma once
+
+#include "Arduino.h"
+
+#define SPI_MODE0 0
+#define MSBFIRST 1
+
+struct SPISettings {
+    SPISettings() {}
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {}
+};
+
+class SPIClass {
+public:
+    void begin() {}
+    void end() {}
+    void beginTransaction(SPISettings settings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t data) { return 0xFF; }
+};
+
+extern SPIClass SPI;
@@ -0,0 +1,193 @@
+// host/tests/CANFilterTest.cpp
+// ===============================================================================
+// Test des kompilierten Anzeigefilters (CANFilter.h)
+// Feste Fälle: leerer Filter, ID-Bereich, Node- und Typbedingung, Exclude-Regeln,
+// Löcher in 29-Bit-Bereichen. Danach zufällige Regelsätze gegen eine direkte
+// Auswertung der Regeln (Referenz): alle 2048 Standard-IDs und Stichproben aus dem
+// 29-Bit-Raum, insbesondere an den Bereichsgrenzen.
+// ===============================================================================
+
+#include "CANFilter.h"
+#include "HostTest.h"
+
+#include <random>
+
+static bool accepts(const CANFilter& filter, uint32_t id, bool ext) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext ? 1 : 0;
+    return filter.accepts(frame);
+}
+
+static void testFixedRules() {
+    CANFilter filter;
+    CHECK(accepts(filter, 0x123, false));
+    CHECK(accepts(filter, 0x1234567, true));
+    CHECK_EQ(filter.acceptedStandardCount(), 2048);
+
+    // Nur ID-Bereich 0x180-0x1FF
+    CANFilterRule range = CANFilter::makeRule(true);
+    range.idMin = 0x180;
+    range.idMax = 0x1FF;
+    filter.addRule(range);
+    filter.compile();
+    CHECK(!accepts(filter, 0x17F, false));
+    CHECK(accepts(filter, 0x185, false));
+    CHECK(!accepts(filter, 0x200, false));
+    CHECK(accepts(filter, 0x185, true));
+    CHECK_EQ(filter.acceptedStandardCount(), 0x80);
+    CHECK_EQ(filter.extendedRangeCount(), 1);
+
+    // Node-Bedingung: gilt nur für Standard-IDs, die Regel fällt für 29 Bit weg
+    CANFilter::clearNodes(filter.rule(0));
+    CANFilter::setNode(filter.rule(0), 5);
+    filter.compile();
+    CHECK(accepts(filter, 0x185, false));
+    CHECK(!accepts(filter, 0x186, false));
+    CHECK(!accepts(filter, 0x185, true));
+    CHECK_EQ(filter.acceptedStandardCount(), 1);
+
+    // Typ Heartbeat, Node 5 wieder ausblenden, 29-Bit-Bereich mit Loch
+    CANFilterRule heartbeat = CANFilter::makeRule(true);
+    heartbeat.typeMask = CAN_FC_BIT(CAN_FC_NMT_EC);
+    filter.addRule(heartbeat);
+    CANFilterRule excludeNode = CANFilter::makeRule(false);
+    excludeNode.idMin = 0x705;
+    excludeNode.idMax = 0x705;
+    filter.addRule(excludeNode);
+    CANFilterRule extRange = CANFilter::makeRule(true);
+    extRange.idMin = 0x18FF0000;
+    extRange.idMax = 0x18FFFFFF;
+    filter.addRule(extRange);
+    CANFilterRule extHole = CANFilter::makeRule(false);
+    extHole.idMin = 0x18FF1000;
+    extHole.idMax = 0x18FF10FF;
+    filter.addRule(extHole);
+    filter.compile();
+    CHECK(accepts(filter, 0x701, false));
+    CHECK(accepts(filter, 0x77F, false));
+    CHECK(!accepts(filter, 0x705, false));
+    CHECK(accepts(filter, 0x18FF0001, true));
+    CHECK(!accepts(filter, 0x18FF1050, true));
+    CHECK(accepts(filter, 0x18FF1100, true));
+    CHECK(!accepts(filter, 0x18FE0000, true));
+    CHECK_EQ(filter.extendedRangeCount(), 2);  // Bereich vor und hinter dem Loch
+
+    // Regel entfernen, vorn einfügen und Tabelle voll
+    CHECK(filter.removeRule(0));
+    CHECK_EQ(filter.ruleCount(), 4);
+    CHECK(!filter.removeRule(4));
+    CHECK(filter.insertRule(0, range));
+    CHECK_EQ(filter.ruleCount(), 5);
+    CHECK_EQ(filter.rule(0).idMin, 0x180);
+    CHECK(filter.rule(1).hasTypeCondition());
+    CHECK(!filter.insertRule(6, range));
+    filter.clear();
+    for (uint8_t i = 0; i < CAN_FILTER_MAX_RULES; i++) {
+        CHECK(filter.addRule(CANFilter::makeRule(false)));
+    }
+    CHECK(!filter.addRule(CANFilter::makeRule(true)));
+    filter.compile();
+    CHECK(!accepts(filter, 0x100, false));
+    CHECK(!accepts(filter, 0x100, true));
+}
+
+// Direkte Auswertung der Regelsemantik aus CANFilter.h
+static bool referenceAccepts(const CANFilter& filter, uint32_t id, bool ext) {
+    bool accept = true;
+    for (uint8_t r = 0; r < filter.ruleCount(); r++) {
+        if (filter.rule(r).include) {
+            accept = false;
+            break;
+        }
+    }
+    for (uint8_t r = 0; r < filter.ruleCount(); r++) {
+        const CANFilterRule& rule = filter.rule(r);
+        bool matches;
+        if (ext) {
+            matches = !rule.hasNodeCondition() && !rule.hasTypeCondition() &&
+                      id >= rule.idMin && id <= rule.idMax;
+        } else {
+            matches = rule.matchesStandard((uint16_t)id);
+        }
+        if (matches) {
+            accept = rule.include;
+        }
+    }
+    return accept;
+}
+
+static CANFilterRule randomRule(std::mt19937& rng) {
+    CANFilterRule rule = CANFilter::makeRule(rng() % 2 == 0);
+    switch (rng() % 4) {
+        case 0:  // Standard-Bereich
+            rule.idMin = rng() % 0x800;
+            rule.idMax = rule.idMin + rng() % 0x200;
+            break;
+        case 1:  // 29-Bit-Bereich
+            rule.idMin = rng() % 0x20000000;
+            rule.idMax = rule.idMin + rng() % 0x1000000;
+            if (rule.idMax > CAN_FILTER_EXT_MAX_ID) rule.idMax = CAN_FILTER_EXT_MAX_ID;
+            break;
+        case 2:  // Ganzer Raum bis zu einer Grenze
+            rule.idMax = rng() % 0x20000000;
+            break;
+        default:
+            break;
+    }
+    if (rng() % 3 == 0) {
+        CANFilter::clearNodes(rule);
+        for (int n = rng() % 4; n >= 0; n--) {
+            CANFilter::setNode(rule, rng() % 128);
+        }
+    }
+    if (rng() % 3 == 0) {
+        rule.typeMask = (uint16_t)(rng() & 0xFFFF) | CAN_FC_BIT(rng() % 16);
+    }
+    return rule;
+}
+
+static void testAgainstReference() {
+    std::mt19937 rng(7);
+    uint32_t mismatches = 0;
+    for (int round = 0; round < 500; round++) {
+        CANFilter filter;
+        int rules = rng() % (CAN_FILTER_MAX_RULES + 1);
+        for (int i = 0; i < rules; i++) {
+            filter.addRule(randomRule(rng));
+        }
+        filter.compile();
+
+        for (uint32_t id = 0; id <= CAN_FILTER_STD_MAX_ID; id++) {
+            if (accepts(filter, id, false) != referenceAccepts(filter, id, false)) {
+                mismatches++;
+            }
+        }
+
+        // Grenzen jeder Regel und ihre Nachbarn, dazu Zufallswerte
+        for (uint8_t r = 0; r < filter.ruleCount(); r++) {
+            const uint32_t edges[] = { filter.rule(r).idMin, filter.rule(r).idMax };
+            for (uint32_t edge : edges) {
+                for (int delta = -1; delta <= 1; delta++) {
+                    uint32_t id = (edge + delta) & CAN_FILTER_EXT_MAX_ID;
+                    if (accepts(filter, id, true) != referenceAccepts(filter, id, true)) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        for (int i = 0; i < 200; i++) {
+            uint32_t id = rng() & CAN_FILTER_EXT_MAX_ID;
+            if (accepts(filter, id, true) != referenceAccepts(filter, id, true)) {
+                mismatches++;
+            }
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+int main() {
+    testFixedRules();
+    testAgainstReference();
+    return hostTestResult("CANFilterTest");
+}
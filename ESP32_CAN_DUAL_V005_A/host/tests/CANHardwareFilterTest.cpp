@@ -0,0 +1,198 @@
+// host/tests/CANHardwareFilterTest.cpp
+// ===============================================================================
+// Test der Hardware-Akzeptanzfilter (CANHardwareFilter.h, CANInterface::setAcceptanceFilter)
+// Für den Aufbau des TWAI (2 Muster mit je einem Code) und des MCP2515 (2 Masken mit
+// 2 bzw. 4 Filtern) wird geprüft: jede gewünschte ID passiert die Muster, passedIds
+// stimmt mit der nachgezählten Menge überein, exakt darstellbare Mengen kosten keine
+// zusätzlichen IDs. Dazu zufällige Mengen aus Anzeigefilter und Verbraucher-Codes.
+// Zuletzt: ein unveränderter Plan lädt den Controller nicht neu (TWAI-Neuinstallation).
+// ===============================================================================
+
+#include "CANHardwareFilter.h"
+#include "CANFilter.h"
+#include "CANInterface.h"
+#include "HostTest.h"
+
+#include <random>
+
+static const uint8_t twaiLayout[2] = { 1, 1 };
+static const uint8_t mcpLayout[2] = { 2, 4 };
+
+static bool passes(const CANHardwareFilterPlan& plan, uint16_t id) {
+    if (plan.acceptAll) {
+        return true;
+    }
+    for (uint8_t g = 0; g < plan.groupCount; g++) {
+        for (uint8_t i = 0; i < plan.codeCount[g]; i++) {
+            if ((id & plan.mask[g]) == plan.code[g][i]) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Plan für beide Controller prüfen; liefert die Zahl durchgelassener IDs (TWAI, MCP2515)
+static void checkPlans(const CANAcceptanceSet& wanted, uint16_t* passedTwai, uint16_t* passedMcp) {
+    const uint8_t* layouts[2] = { twaiLayout, mcpLayout };
+    for (int k = 0; k < 2; k++) {
+        CANHardwareFilterPlan plan = wanted.plan(layouts[k], 2);
+        uint16_t passed = 0;
+        uint16_t missed = 0;
+        for (uint16_t id = 0; id < CAN_HW_FILTER_STD_IDS; id++) {
+            bool ok = passes(plan, id);
+            passed += ok ? 1 : 0;
+            if (wanted.containsStandard(id) && !ok) {
+                missed++;
+            }
+        }
+        CHECK_EQ(missed, 0);
+        CHECK_EQ(plan.passedIds, passed);
+        CHECK(plan.groupCount <= 2);
+        for (uint8_t g = 0; g < plan.groupCount; g++) {
+            CHECK(plan.codeCount[g] <= layouts[k][g]);
+        }
+        if (wanted.containsExtended()) {
+            CHECK(plan.acceptAll);
+        }
+        if (k == 0 && passedTwai != nullptr) *passedTwai = passed;
+        if (k == 1 && passedMcp != nullptr) *passedMcp = passed;
+    }
+}
+
+static void testFixedSets() {
+    uint16_t twai = 0;
+    uint16_t mcp = 0;
+
+    // SDO-Antworten und Heartbeats: zwei 128er-Blöcke, exakt darstellbar
+    CANAcceptanceSet base;
+    base.addFunctionCodes(CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_NMT_EC));
+    CHECK_EQ(base.standardCount(), 256);
+    checkPlans(base, &twai, &mcp);
+    CHECK_EQ(twai, 256);
+    CHECK_EQ(mcp, 256);
+
+    // Dazu TPDO1 aus dem Anzeigefilter
+    CANFilter filter;
+    CANFilterRule rule = CANFilter::makeRule(true);
+    rule.idMin = 0x180;
+    rule.idMax = 0x1FF;
+    filter.addRule(rule);
+    filter.compile();
+    CANAcceptanceSet withPdo = base;
+    withPdo.addBitmap(filter.standardBitmap());
+    checkPlans(withPdo, &twai, &mcp);
+    CHECK_EQ(twai, 384);
+    CHECK_EQ(mcp, 384);
+
+    // Einzelne ID
+    CANAcceptanceSet single;
+    single.addStandard(0x123);
+    checkPlans(single, &twai, &mcp);
+    CHECK_EQ(twai, 1);
+    CHECK_EQ(mcp, 1);
+
+    // Jede zweite ID: ein Muster mit Bit 0 = 0
+    CANAcceptanceSet even;
+    for (uint16_t id = 0; id < CAN_HW_FILTER_STD_IDS; id += 2) {
+        even.addStandard(id);
+    }
+    checkPlans(even, &twai, &mcp);
+    CHECK_EQ(twai, 1024);
+    CHECK_EQ(mcp, 1024);
+
+    // Extended-Frames gewünscht: Controller bleibt offen
+    CANAcceptanceSet extended = base;
+    extended.addExtended();
+    checkPlans(extended, &twai, &mcp);
+    CHECK_EQ(twai, 2048);
+
+    // acceptAll() und acceptEverything()
+    CANAcceptanceSet all;
+    all.acceptAll();
+    CHECK(all.plan(mcpLayout, 2) == CANHardwareFilterPlan::acceptEverything());
+    CHECK(base.plan(mcpLayout, 2) != CANHardwareFilterPlan::acceptEverything());
+}
+
+// Anzeigefilter mit zufälligen Nodes/Typen/Bereichen plus die festen Verbraucher-Codes
+static void testRandomSets() {
+    std::mt19937 rng(11);
+    for (int round = 0; round < 300; round++) {
+        CANFilter filter;
+        int rules = 1 + rng() % 4;
+        for (int i = 0; i < rules; i++) {
+            CANFilterRule rule = CANFilter::makeRule(true);
+            if (rng() % 2) {
+                rule.idMin = rng() % 0x800;
+                rule.idMax = rule.idMin + rng() % 0x100;
+            }
+            if (rng() % 2) {
+                CANFilter::clearNodes(rule);
+                for (int n = rng() % 5; n >= 0; n--) {
+                    CANFilter::setNode(rule, 1 + rng() % 127);
+                }
+            }
+            if (rng() % 2) {
+                rule.typeMask = CAN_FC_BIT(rng() % 16) | CAN_FC_BIT(rng() % 16);
+            }
+            filter.addRule(rule);
+        }
+        filter.compile();
+
+        CANAcceptanceSet wanted;
+        wanted.addBitmap(filter.standardBitmap());
+        if (rng() % 2) {
+            wanted.addFunctionCodes(CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_NMT_EC) |
+                                    CAN_FC_BIT(CAN_FC_SYNC_EMCY) | CAN_FC_TPDOS);
+        }
+        checkPlans(wanted, nullptr, nullptr);
+    }
+}
+
+// ===================================================================================
+// CANInterface::setAcceptanceFilter lädt den Controller nur bei geändertem Plan
+// ===================================================================================
+class FilterCountingInterface : public CANInterface {
+public:
+    int applied = 0;
+
+    bool begin(uint32_t baudrate) override { return true; }
+    bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t* buf) override { return true; }
+    bool receiveMessage(uint32_t* id, uint8_t* ext, uint8_t* len, uint8_t* buf) override { return false; }
+    bool messageAvailable() override { return false; }
+    void end() override {}
+
+protected:
+    uint8_t acceptanceFilterLayout(uint8_t* groupSizes) const override {
+        groupSizes[0] = 1;
+        groupSizes[1] = 1;
+        return 2;
+    }
+    bool applyAcceptanceFilter(const CANHardwareFilterPlan& plan) override {
+        applied++;
+        return true;
+    }
+};
+
+static void testReloadOnlyOnChange() {
+    FilterCountingInterface interface;
+    CANAcceptanceSet wanted;
+    wanted.addFunctionCodes(CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_NMT_EC));
+
+    CHECK(interface.setAcceptanceFilter(wanted));
+    CHECK_EQ(interface.applied, 1);
+    CHECK(interface.setAcceptanceFilter(wanted));
+    CHECK_EQ(interface.applied, 1);
+    CHECK_EQ(interface.getAcceptanceFilter().passedIds, 256);
+
+    wanted.addStandard(0x181);
+    CHECK(interface.setAcceptanceFilter(wanted));
+    CHECK_EQ(interface.applied, 2);
+}
+
+int main() {
+    testFixedSets();
+    testRandomSets();
+    testReloadOnlyOnChange();
+    return hostTestResult("CANHardwareFilterTest");
+}
@@ -0,0 +1,265 @@
+// host/tests/CANHeartbeatMonitorTest.cpp
+// ===============================================================================
+// Test des Heartbeat-Consumers mit Timer-Rad (CANHeartbeatMonitor.h)
+// Feste Abläufe: automatische Überwachungszeit aus der Periode, feste Consumer-Zeit,
+// Node-Guarding-Antwort mit Toggle-Bit, Boot-up, Wiederkehr nach Zeitüberschreitung,
+// Fristen länger als eine Radumdrehung und lange Pausen zwischen advance(). Danach
+// zufälliger Verkehr mit Ausfällen gegen eine Referenz, die jede Millisekunde alle
+// Nodes prüft: keine Meldung vor Ablauf der Frist, keine später als zwei Ticks danach.
+// Zuletzt der Überlauf einer 32-Bit-Millisekundenzeit und des 32-Bit-Tickzählers.
+// ===============================================================================
+
+#include "CANHeartbeatMonitor.h"
+#include "HostTest.h"
+
+#include <random>
+#include <vector>
+
+struct RecordedEvent {
+    uint8_t nodeId;
+    HeartbeatEvent event;
+    uint32_t atMs;
+};
+
+static std::vector<RecordedEvent> events;
+static uint32_t nowMs = 0;
+
+static void recordEvent(uint8_t nodeId, HeartbeatEvent event, const HeartbeatNode& node, void* context) {
+    events.push_back({ nodeId, event, nowMs });
+}
+
+static CanFrame heartbeat(uint8_t nodeId, uint8_t state, uint64_t timestampUs) {
+    CanFrame frame = {};
+    frame.id = 0x700 + nodeId;
+    frame.len = 1;
+    frame.data[0] = state;
+    frame.timestamp = timestampUs;
+    return frame;
+}
+
+static uint32_t countEvents(uint8_t nodeId, HeartbeatEvent event) {
+    uint32_t count = 0;
+    for (const RecordedEvent& e : events) {
+        if (e.nodeId == nodeId && e.event == event) {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void testFixedSequence() {
+    CANHeartbeatMonitor monitor;
+    monitor.setEventCallback(recordEvent, nullptr);
+    events.clear();
+
+    // Node 5: 100 ms bis 1,9 s; Node 6: 1 s durchgehend; Node 7: feste 3 s, Guarding-Antwort;
+    // Node 8: feste Consumer-Zeit 2 s (länger als eine Radumdrehung)
+    monitor.setConsumerTime(7, 3000);
+    monitor.setConsumerTime(8, 2000);
+    for (nowMs = 0; nowMs <= 5000; nowMs++) {
+        if (nowMs % 100 == 0 && nowMs < 2000) {
+            monitor.handleFrame(heartbeat(5, NMT_STATE_OPERATIONAL, nowMs * 1000ULL));
+        }
+        if (nowMs % 1000 == 0) {
+            monitor.handleFrame(heartbeat(6, NMT_STATE_PRE_OPERATIONAL, nowMs * 1000ULL));
+        }
+        if (nowMs == 10) {
+            monitor.handleFrame(heartbeat(7, 0x80 | NMT_STATE_OPERATIONAL, nowMs * 1000ULL));
+        }
+        if (nowMs == 20) {
+            monitor.handleFrame(heartbeat(8, NMT_STATE_BOOTUP, nowMs * 1000ULL));
+        }
+        monitor.advance(nowMs * 1000ULL);
+    }
+
+    CHECK_EQ(monitor.nodeCount(), 4);
+    CHECK_EQ(monitor.node(5).periodUs, 100000);
+    CHECK_EQ(monitor.node(5).timeoutMs(), 150);
+    CHECK_EQ(monitor.node(6).timeoutMs(), 1500);
+    CHECK_EQ(monitor.node(7).state, NMT_STATE_OPERATIONAL);  // Toggle-Bit entfernt
+    CHECK_EQ(countEvents(5, HB_EVENT_NEW_NODE), 1);
+    CHECK_EQ(countEvents(8, HB_EVENT_BOOTUP), 1);
+    CHECK_EQ(countEvents(6, HB_EVENT_TIMEOUT), 0);
+
+    for (const RecordedEvent& e : events) {
+        if (e.event != HB_EVENT_TIMEOUT) {
+            continue;
+        }
+        // Letzter Heartbeat + Überwachungszeit, auf den Tick aufgerundet
+        if (e.nodeId == 5) CHECK_EQ(e.atMs, 1900 + 150);
+        if (e.nodeId == 7) CHECK_EQ(e.atMs, 10 + 3000);
+        if (e.nodeId == 8) CHECK_EQ(e.atMs, 20 + 2000);
+    }
+    CHECK_EQ(countEvents(5, HB_EVENT_TIMEOUT), 1);
+    CHECK_EQ(countEvents(7, HB_EVENT_TIMEOUT), 1);
+    CHECK_EQ(countEvents(8, HB_EVENT_TIMEOUT), 1);
+    CHECK_EQ(monitor.timedOutCount(), 3);
+    CHECK_EQ(monitor.node(5).missed, 1);
+
+    // Wiederkehr: Ereignis, der Abstand über den Ausfall zählt nicht zur Periode
+    monitor.handleFrame(heartbeat(5, NMT_STATE_OPERATIONAL, 5100000ULL));
+    CHECK(events.back().nodeId == 5 && events.back().event == HB_EVENT_RECOVERED);
+    CHECK_EQ(monitor.node(5).periodUs, 100000);
+    CHECK_EQ(monitor.timedOutCount(), 2);
+
+    // Zustandswechsel und Boot-up (Periode beginnt von vorn)
+    monitor.handleFrame(heartbeat(5, NMT_STATE_STOPPED, 5200000ULL));
+    CHECK(events.back().event == HB_EVENT_STATE_CHANGE);
+    CHECK_EQ(monitor.node(5).previousState, NMT_STATE_OPERATIONAL);
+    monitor.handleFrame(heartbeat(5, NMT_STATE_BOOTUP, 5300000ULL));
+    CHECK(events.back().event == HB_EVENT_BOOTUP);
+    CHECK_EQ(monitor.node(5).periodUs, 0);
+    CHECK_EQ(monitor.node(5).bootups, 1);
+
+    // Lange Pause: eine Umdrehung reicht, Node 6 läuft ab; Node 5 ohne Periode nicht
+    nowMs = 60000;
+    monitor.advance(nowMs * 1000ULL);
+    CHECK_EQ(countEvents(6, HB_EVENT_TIMEOUT), 1);
+    CHECK(!monitor.node(5).timedOut);
+    CHECK_EQ(monitor.timedOutCount(), 3);
+
+    // Fremde Frames werden ignoriert
+    CanFrame other = heartbeat(9, NMT_STATE_OPERATIONAL, 60000000ULL);
+    other.ext = 1;
+    monitor.handleFrame(other);
+    monitor.handleFrame(heartbeat(0, NMT_STATE_OPERATIONAL, 60000000ULL));
+    CanFrame empty = heartbeat(9, NMT_STATE_OPERATIONAL, 60000000ULL);
+    empty.len = 0;
+    monitor.handleFrame(empty);
+    CHECK_EQ(monitor.nodeCount(), 4);
+
+    // clear() vergisst die Nodes, nicht die Consumer-Zeiten
+    monitor.clear();
+    CHECK_EQ(monitor.nodeCount(), 0);
+    CHECK_EQ(monitor.timedOutCount(), 0);
+    CHECK_EQ(monitor.node(7).consumerTimeMs, 3000);
+    CHECK_EQ(monitor.node(7).state, NMT_STATE_UNKNOWN);
+}
+
+// Zufälliger Verkehr gegen eine Prüfung aller Nodes je Millisekunde
+static void testAgainstReference() {
+    const int nodeCount = 120;
+    const uint32_t runMs = 30000;
+    CANHeartbeatMonitor monitor;
+    monitor.setEventCallback(recordEvent, nullptr);
+    events.clear();
+    std::mt19937 rng(20);
+
+    uint32_t periodMs[HB_MAX_NODES] = {};
+    uint32_t nextMs[HB_MAX_NODES] = {};
+    uint32_t silentUntil[HB_MAX_NODES] = {};
+    for (int id = 1; id <= nodeCount; id++) {
+        periodMs[id] = 20 + rng() % 2000;
+        nextMs[id] = rng() % periodMs[id];
+        if (id % 4 == 0) {
+            monitor.setConsumerTime((uint8_t)id, (uint16_t)(periodMs[id] * 2 + rng() % 3000));
+        }
+    }
+
+    uint32_t early = 0;
+    uint32_t late = 0;
+    uint32_t missing = 0;
+    size_t checkedEvents = 0;
+    for (nowMs = 1; nowMs <= runMs; nowMs++) {
+        for (int id = 1; id <= nodeCount; id++) {
+            if (nowMs < nextMs[id]) {
+                continue;
+            }
+            nextMs[id] = nowMs + periodMs[id];
+            if (nowMs < silentUntil[id]) {
+                continue;
+            }
+            if (rng() % 200 == 0) {
+                silentUntil[id] = nowMs + rng() % 6000;  // Ausfall
+                continue;
+            }
+            monitor.handleFrame(heartbeat((uint8_t)id, NMT_STATE_OPERATIONAL, nowMs * 1000ULL - rng() % 1000));
+        }
+        monitor.advance(nowMs * 1000ULL);
+
+        // Neue Zeitüberschreitungen: frühestens mit Ablauf der Frist
+        for (; checkedEvents < events.size(); checkedEvents++) {
+            const RecordedEvent& e = events[checkedEvents];
+            if (e.event != HB_EVENT_TIMEOUT) {
+                continue;
+            }
+            const HeartbeatNode& node = monitor.node(e.nodeId);
+            if ((uint64_t)e.atMs * 1000 < node.lastSeenUs + node.timeoutMs() * 1000ULL) {
+                early++;
+            }
+        }
+        // Jede seit zwei Ticks abgelaufene Frist muss gemeldet sein
+        for (int id = 1; id <= nodeCount; id++) {
+            const HeartbeatNode& node = monitor.node((uint8_t)id);
+            if (!node.seen || node.timeoutMs() == 0 || node.timedOut) {
+                continue;
+            }
+            uint64_t deadlineUs = node.lastSeenUs + node.timeoutMs() * 1000ULL;
+            if ((uint64_t)nowMs * 1000 >= deadlineUs + 2 * HB_WHEEL_TICK_MS * 1000) {
+                missing++;
+            }
+        }
+        for (int id = 1; id <= nodeCount; id++) {
+            const HeartbeatNode& node = monitor.node((uint8_t)id);
+            if (node.timedOut && (uint64_t)nowMs * 1000 < node.lastSeenUs + node.timeoutMs() * 1000ULL) {
+                late++;  // Als ausgefallen markiert, obwohl die Frist noch läuft
+            }
+        }
+    }
+
+    uint32_t timeouts = 0;
+    uint32_t missed = 0;
+    for (const RecordedEvent& e : events) {
+        timeouts += e.event == HB_EVENT_TIMEOUT ? 1 : 0;
+    }
+    for (int id = 1; id <= nodeCount; id++) {
+        missed += monitor.node((uint8_t)id).missed;
+    }
+    CHECK(timeouts > 0);
+    CHECK_EQ(missed, timeouts);
+    CHECK_EQ(early, 0);
+    CHECK_EQ(late, 0);
+    CHECK_EQ(missing, 0);
+    CHECK_EQ(monitor.nodeCount(), nodeCount);
+}
+
+// Überlauf: Fristen über 2^32 ms (49,7 Tage) bzw. 2^32 Ticks hinweg
+static void testWrap() {
+    const uint64_t starts[] = {
+        (0x100000000ULL - 3000) * 1000,              // 32-Bit-Millisekunden
+        0x100000000ULL * HB_WHEEL_TICK_US - 3000000  // 32-Bit-Ticks
+    };
+    for (uint64_t startUs : starts) {
+        CANHeartbeatMonitor monitor;
+        monitor.setEventCallback(recordEvent, nullptr);
+        events.clear();
+
+        // Node 3: 100 ms durchgehend; Node 4: 100 ms bis 4 s (nach dem Überlauf)
+        for (nowMs = 0; nowMs <= 8000; nowMs++) {
+            uint64_t nowUs = startUs + nowMs * 1000ULL;
+            if (nowMs % 100 == 0) {
+                monitor.handleFrame(heartbeat(3, NMT_STATE_OPERATIONAL, nowUs));
+                if (nowMs <= 4000) {
+                    monitor.handleFrame(heartbeat(4, NMT_STATE_OPERATIONAL, nowUs));
+                }
+            }
+            monitor.advance(nowUs);
+        }
+
+        CHECK_EQ(countEvents(3, HB_EVENT_TIMEOUT), 0);
+        CHECK_EQ(countEvents(4, HB_EVENT_TIMEOUT), 1);
+        for (const RecordedEvent& e : events) {
+            // Start nicht auf einer Tickgrenze: Meldung im Tick nach der Frist
+            if (e.event == HB_EVENT_TIMEOUT) {
+                CHECK(e.atMs >= 4000 + 150 && e.atMs < 4000 + 150 + HB_WHEEL_TICK_MS);
+            }
+        }
+    }
+}
+
+int main() {
+    testFixedSequence();
+    testAgainstReference();
+    testWrap();
+    return hostTestResult("CANHeartbeatMonitorTest");
+}
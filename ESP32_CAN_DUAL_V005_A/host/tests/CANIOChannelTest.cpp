@@ -0,0 +1,175 @@
+// host/tests/CANIOChannelTest.cpp
+// ===============================================================================
+// Test der Kopplung Anwendung <-> CAN-I/O-Task (CANIOChannel.h)
+// Ein std::thread spielt den I/O-Task und ruft ioStep() mit einem Echo-Treiber auf:
+// jeder gesendete Frame wird wieder empfangen, jeder 7. Sendeversuch schlägt fehl und
+// die Treiberqueue fasst nur wenige Aufträge (Rest wird sofort als Fehler gemeldet).
+// Die Anwendung hält bis zu CAN_IO_TX_QUEUE_SIZE - 1 Aufträge offen. Geprüft wird:
+// jedes Ergebnis kommt genau einmal, Empfang in Sendereihenfolge, und empfangene plus
+// übergelaufene Frames ergeben die erfolgreich gesendeten.
+// ===============================================================================
+
+#include "CANIOChannel.h"
+#include "HostTest.h"
+
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+typedef void (*TxDoneCallback)(const CanFrame& frame, bool success, void* context);
+
+// Echo-Treiber mit der Schnittstelle, die ioStep() erwartet (nur im I/O-Thread benutzt)
+class EchoPort {
+public:
+    bool enqueueTx(const CanFrame& frame, TxDoneCallback callback, void* context) {
+        if (pending.size() >= DRIVER_QUEUE) {
+            return false;
+        }
+        pending.push_back({ frame, callback, context });
+        return true;
+    }
+
+    void serviceTx() {
+        for (const Pending& request : pending) {
+            bool success = (attempts++ % 7) != 0;
+            if (success) {
+                echoed.push_back(request.frame);
+            }
+            request.callback(request.frame, success, request.context);
+        }
+        pending.clear();
+    }
+
+    size_t receiveBurst(CanFrame* frames, size_t max, uint32_t timeoutUs) {
+        size_t count = echoed.size() - nextEcho;
+        if (count > max) {
+            count = max;
+        }
+        for (size_t i = 0; i < count; i++) {
+            frames[i] = echoed[nextEcho + i];
+        }
+        nextEcho += count;
+        if (nextEcho == echoed.size()) {
+            echoed.clear();
+            nextEcho = 0;
+        }
+        return count;
+    }
+
+private:
+    static const size_t DRIVER_QUEUE = 8;
+
+    struct Pending {
+        CanFrame frame;
+        TxDoneCallback callback;
+        void* context;
+    };
+
+    std::vector<Pending> pending;
+    std::vector<CanFrame> echoed;
+    size_t nextEcho = 0;
+    uint32_t attempts = 0;
+};
+
+static void testThreadedEcho() {
+    static CANIOChannel channel;
+    EchoPort port;
+    std::atomic<bool> running(true);
+
+    std::thread io([&]() {
+        while (running.load(std::memory_order_acquire)) {
+            if (channel.ioStep(port) == 0) {
+                std::this_thread::yield();
+            }
+        }
+        channel.ioStep(port);
+    });
+
+    const uint32_t total = 200000;
+    std::vector<uint8_t> results(total, 0);
+    uint32_t submitted = 0;
+    uint32_t outstanding = 0;
+    uint32_t succeeded = 0;
+    uint32_t failed = 0;
+    uint32_t duplicates = 0;
+    uint32_t received = 0;
+    uint32_t outOfOrder = 0;
+    int64_t lastSeq = -1;
+
+    while (succeeded + failed < total || received + channel.received().overrunCount() < succeeded) {
+        if (submitted < total && outstanding < CAN_IO_TX_QUEUE_SIZE - 1) {
+            CanFrame frame = {};
+            frame.id = submitted & 0x7FF;
+            frame.len = 4;
+            memcpy(frame.data, &submitted, sizeof(submitted));
+            if (channel.submitTx(frame, submitted)) {
+                submitted++;
+                outstanding++;
+            }
+        }
+
+        CANIOTxResult result;
+        while (channel.popTxResult(result)) {
+            outstanding--;
+            if (result.seq >= total || results[result.seq] != 0) {
+                duplicates++;
+                continue;
+            }
+            results[result.seq] = result.success ? 1 : 2;
+            if (result.success) {
+                succeeded++;
+            } else {
+                failed++;
+            }
+        }
+
+        CanFrame frames[CAN_IO_RX_BURST];
+        size_t count = channel.received().popBurst(frames, CAN_IO_RX_BURST);
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t seq;
+            memcpy(&seq, frames[i].data, sizeof(seq));
+            if ((int64_t)seq <= lastSeq || frames[i].id != (seq & 0x7FF)) {
+                outOfOrder++;
+            }
+            lastSeq = seq;
+            received++;
+        }
+    }
+    running.store(false, std::memory_order_release);
+    io.join();
+
+    CHECK_EQ(duplicates, 0);
+    CHECK_EQ(outstanding, 0);
+    CHECK_EQ(succeeded + failed, total);
+    CHECK(failed > 0);
+    CHECK_EQ(outOfOrder, 0);
+    CHECK_EQ(received + channel.received().overrunCount(), succeeded);
+    CHECK(channel.received().empty());
+}
+
+// reset() leert alle Ringe (bei angehaltenem I/O-Task)
+static void testReset() {
+    static CANIOChannel channel;
+    EchoPort port;
+    CanFrame frame = {};
+    CHECK(channel.submitTx(frame, 1));
+    CHECK(channel.submitTx(frame, 2));
+    channel.ioStep(port);
+    channel.submitTx(frame, 3);
+    channel.reset();
+
+    CANIOTxResult result;
+    CHECK(!channel.popTxResult(result));
+    CHECK(channel.received().empty());
+    CHECK_EQ(channel.ioStep(port), 0);
+}
+
+int main() {
+    testThreadedEcho();
+    testReset();
+    return hostTestResult("CANIOChannelTest");
+}
@@ -0,0 +1,256 @@
+// host/tests/CANInterfaceTxTest.cpp
+// ===============================================================================
+// Test des Sendepfads von CANInterface (enqueueTx()/serviceTx()/transmitBlocking())
+// gegen einen Controller im RAM mit zwei Sendepuffern, der sich anhalten lässt.
+// Blockierendes Senden läuft über die Queue (txObserver sieht den Frame), ein
+// hängender blockierender Auftrag zieht nach dem Timeout nur sich selbst zurück:
+// aus der Queue und aus einem Sendepuffer. Die Frames anderer Nutzer bleiben stehen
+// und werden nach dem Anlaufen des Controllers gesendet. Zuletzt removeFirst() der
+// CANTxQueue gegen zufällige Entnahmen.
+// ===============================================================================
+
+#include "CANInterface.h"
+#include "HostTest.h"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+// Controller mit zwei Sendepuffern; stalled: nichts wird fertig, blocked: keine Annahme
+class FakeTxInterface : public CANInterface {
+public:
+    bool stalled = false;
+    bool blocked = false;
+    uint32_t timeoutMs = CAN_TX_BLOCKING_TIMEOUT_MS;
+    std::vector<CanFrame> sent;
+    std::vector<uint32_t> aborted;
+
+    FakeTxInterface() { txInFlightLimit = 2; }
+
+    bool begin(uint32_t baudrate) override { return true; }
+    bool sendMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) override {
+        CanFrame frame = {};
+        frame.id = id;
+        frame.ext = ext;
+        frame.len = len;
+        memcpy(frame.data, buf, len);
+        return transmitBlocking(frame, timeoutMs);
+    }
+    bool receiveMessage(uint32_t *id, uint8_t *ext, uint8_t *len, uint8_t *buf) override { return false; }
+    bool messageAvailable() override { return false; }
+    void end() override { cancelTx(); }
+
+protected:
+    CANTxStatus startTransmit(const CanFrame& frame, uint32_t* handle) override {
+        if (blocked || slots.size() >= 2) {
+            return CAN_TX_BUSY;
+        }
+        *handle = nextHandle++;
+        slots.push_back({ *handle, frame });
+        return CAN_TX_PENDING;
+    }
+    CANTxStatus pollTransmit(uint32_t handle) override {
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].handle != handle) {
+                continue;
+            }
+            if (stalled) {
+                return CAN_TX_PENDING;
+            }
+            sent.push_back(slots[i].frame);
+            slots.erase(slots.begin() + i);
+            return CAN_TX_OK;
+        }
+        return CAN_TX_FAILED;
+    }
+    void abortTransmit(uint32_t handle) override {
+        aborted.push_back(handle);
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (slots[i].handle == handle) {
+                slots.erase(slots.begin() + i);
+                return;
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        uint32_t handle;
+        CanFrame frame;
+    };
+    std::vector<Slot> slots;
+    uint32_t nextHandle = 1;
+};
+
+static uint32_t observed = 0;
+static uint32_t succeeded = 0;
+static uint32_t failed = 0;
+
+static void countObserved(const CanFrame& frame, bool success, void* context) {
+    observed++;
+}
+
+static void countTx(const CanFrame& frame, bool success, void* context) {
+    if (success) {
+        succeeded++;
+    } else {
+        failed++;
+    }
+}
+
+static CanFrame testFrame(uint32_t id) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.len = 2;
+    frame.data[0] = (uint8_t)id;
+    return frame;
+}
+
+static void resetCounters() {
+    observed = 0;
+    succeeded = 0;
+    failed = 0;
+}
+
+// Blockierendes Senden über die Queue; txObserver und Callbacks sehen jeden Frame
+static void testBlockingSend() {
+    FakeTxInterface can;
+    can.setTxObserver(countObserved, nullptr);
+    resetCounters();
+
+    uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    CHECK(can.sendMessage(0x601, 0, 8, data));
+    CHECK_EQ(can.sent.size(), 1);
+    CHECK_EQ(can.sent[0].id, 0x601);
+    CHECK_EQ(observed, 1);
+    CHECK_EQ(can.txPending(), 0);
+
+    // Vorher eingereihte Frames gehen mit, in Prioritätsreihenfolge
+    CHECK(can.enqueueTx(testFrame(0x700), countTx, nullptr));
+    CHECK(can.enqueueTx(testFrame(0x080), countTx, nullptr));
+    CHECK(can.sendMessage(0x000, 0, 2, data));
+    can.serviceTx();
+    CHECK_EQ(succeeded, 2);
+    CHECK_EQ(can.sent.size(), 4);
+    CHECK_EQ(can.sent[1].id, 0x000);
+    CHECK_EQ(can.sent[2].id, 0x080);
+    CHECK_EQ(observed, 4);
+}
+
+// Hängender Controller: nur der blockierende Auftrag wird zurückgezogen
+static void testWithdrawQueued() {
+    FakeTxInterface can;
+    can.timeoutMs = 30;
+    resetCounters();
+
+    can.blocked = true;
+    for (uint32_t i = 0; i < 5; i++) {
+        CHECK(can.enqueueTx(testFrame(0x180 + i), countTx, nullptr));
+    }
+    uint8_t data[2] = { 0xAA, 0xBB };
+    uint32_t start = millis();
+    CHECK(!can.sendMessage(0x100, 0, 2, data));
+    CHECK(millis() - start >= 30);
+    CHECK_EQ(can.txPending(), 5);  // Die fremden Frames warten weiter
+    CHECK_EQ(failed, 0);
+
+    can.blocked = false;
+    for (int i = 0; i < 10 && can.txPending() > 0; i++) {
+        can.serviceTx();
+    }
+    CHECK_EQ(succeeded, 5);
+    CHECK_EQ(failed, 0);
+    CHECK_EQ(can.sent.size(), 5);
+    for (const CanFrame& frame : can.sent) {
+        CHECK(frame.id != 0x100);
+    }
+}
+
+// Frame im Sendepuffer, der nicht fertig wird: Abbruch nur seines Handles. Mit einem
+// Timeout unter CAN_TX_TIMEOUT_MS zieht transmitBlocking() ihn selbst zurück.
+static void testWithdrawInFlight() {
+    FakeTxInterface can;
+    can.timeoutMs = 20;
+    resetCounters();
+
+    can.stalled = true;
+    CHECK(can.enqueueTx(testFrame(0x300), countTx, nullptr));
+    can.serviceTx();  // 0x300 im ersten Sendepuffer
+    uint8_t data[2] = { 1, 2 };
+    CHECK(!can.sendMessage(0x200, 0, 2, data));
+    CHECK_EQ(can.aborted.size(), 1);
+    CHECK_EQ(can.aborted[0], 2);  // Handle des blockierenden Frames
+    CHECK_EQ(can.txPending(), 1);
+    CHECK_EQ(failed, 0);
+
+    can.stalled = false;
+    can.serviceTx();
+    CHECK_EQ(succeeded, 1);
+    CHECK_EQ(can.sent.size(), 1);
+    CHECK_EQ(can.sent[0].id, 0x300);
+}
+
+// Volle Queue: blockierendes Senden wartet auf Platz und gibt danach auf
+static void testQueueFull() {
+    FakeTxInterface can;
+    can.timeoutMs = 20;
+    resetCounters();
+
+    can.blocked = true;
+    size_t queued = 0;
+    while (can.enqueueTx(testFrame(0x400), countTx, nullptr)) {
+        queued++;
+    }
+    CHECK_EQ(queued, CAN_TX_QUEUE_SIZE);
+    uint8_t data[2] = { 1, 2 };
+    CHECK(!can.sendMessage(0x001, 0, 2, data));
+    CHECK_EQ(can.txPending(), CAN_TX_QUEUE_SIZE);
+    CHECK_EQ(failed, 0);
+    can.end();
+    CHECK_EQ(failed, CAN_TX_QUEUE_SIZE);
+}
+
+// removeFirst(): nach zufälligen Entnahmen kommt der Rest in Schlüsselreihenfolge
+static void testRemoveFirst() {
+    std::mt19937 rng(19);
+    uint32_t misordered = 0;
+    uint32_t lost = 0;
+
+    for (int round = 0; round < 200; round++) {
+        CANTxQueue<uint32_t, 32> queue;
+        std::vector<uint32_t> expected;
+        for (uint32_t i = 0; i < 32; i++) {
+            uint32_t value = rng() % 64;
+            queue.push(value, value);
+            expected.push_back(value);
+        }
+        for (int k = 0; k < 10; k++) {
+            uint32_t victim = expected[rng() % expected.size()];
+            CHECK(queue.removeFirst([&](uint32_t value) { return value == victim; }));
+            expected.erase(std::find(expected.begin(), expected.end(), victim));
+        }
+        CHECK(!queue.removeFirst([](uint32_t value) { return value == 1000; }));
+
+        std::sort(expected.begin(), expected.end());
+        for (uint32_t value : expected) {
+            if (queue.empty()) {
+                lost++;
+                break;
+            }
+            misordered += queue.top() == value ? 0 : 1;
+            queue.pop();
+        }
+        lost += queue.size();
+    }
+    CHECK_EQ(misordered, 0);
+    CHECK_EQ(lost, 0);
+}
+
+int main() {
+    testBlockingSend();
+    testWithdrawQueued();
+    testWithdrawInFlight();
+    testQueueFull();
+    testRemoveFirst();
+    return hostTestResult("CANInterfaceTxTest");
+}
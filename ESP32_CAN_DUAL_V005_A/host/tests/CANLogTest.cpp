@@ -0,0 +1,258 @@
+// host/tests/CANLogTest.cpp
+// ===============================================================================
+// Test der Log-Ausgabe (CANLog.h)
+// Zeilenformate candump -L, Vector ASC und SLCAN gegen feste Zeilen, CRC-16 gegen den
+// Prüfwert des Verfahrens, Binär-Records über einen eigenen COBS-Decoder zurück in
+// Frames (auch mit einem verfälschten Byte im Strom), und der Writer bei einem Sink,
+// der zeitweise nichts annimmt: Frames werden verworfen und gezählt, der nächste
+// Binär-Record trägt CAN_LOG_FLAG_GAP.
+// ===============================================================================
+
+#include "CANLog.h"
+#include "HostTest.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+static CanFrame makeFrame(uint32_t id, bool ext, uint8_t len, const uint8_t* data, uint64_t timestamp) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext ? 1 : 0;
+    frame.len = len;
+    memcpy(frame.data, data, len);
+    frame.timestamp = timestamp;
+    return frame;
+}
+
+static const uint8_t deadbeef[8] = { 0xDE, 0xAD, 0xBE, 0xEF, 0, 0, 0, 0 };
+static const uint8_t counting[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+static std::string line(size_t (*format)(const CanFrame&, char*), const CanFrame& frame) {
+    char out[CAN_LOG_MAX_LINE];
+    size_t len = format(frame, out);
+    CHECK(len <= CAN_LOG_MAX_LINE);
+    return std::string(out, len);
+}
+
+static void testLineFormats() {
+    CanFrame standard = makeFrame(0x123, false, 4, deadbeef, 12345678ULL);
+    CanFrame extended = makeFrame(0x1ABCDEF0, true, 8, counting, 100000500000ULL);
+    CanFrame empty = makeFrame(0x000, false, 0, counting, 0);
+
+    CHECK(line([](const CanFrame& f, char* o) { return formatCandumpLine(f, "can0", o); }, standard) ==
+          "(0000000012.345678) can0 123#DEADBEEF\n");
+    CHECK(line([](const CanFrame& f, char* o) { return formatCandumpLine(f, "can0", o); }, extended) ==
+          "(0000100000.500000) can0 1ABCDEF0#0102030405060708\n");
+    CHECK(line([](const CanFrame& f, char* o) { return formatCandumpLine(f, "can0", o); }, empty) ==
+          "(0000000000.000000) can0 000#\n");
+
+    CHECK(line([](const CanFrame& f, char* o) { return formatAscLine(f, 2345678, o); }, standard) ==
+          "  10.000000 1  123             Rx   d 4 DE AD BE EF\n");
+    CHECK(line([](const CanFrame& f, char* o) { return formatAscLine(f, 2345678, o); }, extended) ==
+          "99998.154322 1  1ABCDEF0x       Rx   d 8 01 02 03 04 05 06 07 08\n");
+
+    CanFrame slcan = makeFrame(0x123, false, 2, deadbeef, 61234567ULL);
+    CHECK(line([](const CanFrame& f, char* o) { return formatSlcanLine(f, true, o); }, slcan) ==
+          "t1232DEAD04D2\r");  // 61234 ms mod 60000 = 0x04D2
+    CHECK(line([](const CanFrame& f, char* o) { return formatSlcanLine(f, false, o); }, extended) ==
+          "T1ABCDEF080102030405060708\r");
+}
+
+static void testCrc() {
+    const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+    CHECK_EQ(canLogCrc16(check, sizeof(check)), 0x29B1);  // Prüfwert CRC-16/CCITT-FALSE
+    CHECK_EQ(canLogCrc16(check, 0), 0xFFFF);
+}
+
+// ===================================================================================
+// Binär-Records: COBS-Decoder wie tools/can_capture.py
+// ===================================================================================
+struct DecodedRecord {
+    CanFrame frame;
+    uint8_t flags;
+};
+
+static bool decodeRecord(const std::string& packet, DecodedRecord& out) {
+    uint8_t record[CAN_LOG_RECORD_SIZE + 8];
+    size_t length = 0;
+    size_t i = 0;
+    while (i < packet.size()) {
+        uint8_t code = (uint8_t)packet[i++];
+        if (code == 0 || i + code - 1 > packet.size()) {
+            return false;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            if (length >= sizeof(record)) return false;
+            record[length++] = (uint8_t)packet[i++];
+        }
+        if (code < 0xFF && i < packet.size()) {
+            if (length >= sizeof(record)) return false;
+            record[length++] = 0;
+        }
+    }
+    if (length != CAN_LOG_RECORD_SIZE || record[0] != CAN_LOG_RECORD_FRAME) {
+        return false;
+    }
+    uint16_t crc = record[19] | (record[20] << 8);
+    if (crc != canLogCrc16(record, CAN_LOG_RECORD_SIZE - 2)) {
+        return false;
+    }
+    out.frame = {};
+    out.flags = record[1];
+    out.frame.ext = (record[1] & CAN_LOG_FLAG_EXTENDED) ? 1 : 0;
+    out.frame.len = record[2];
+    out.frame.id = record[3] | (record[4] << 8) | (record[5] << 16) | ((uint32_t)record[6] << 24);
+    out.frame.timestamp = record[7] | (record[8] << 8) | (record[9] << 16) | ((uint32_t)record[10] << 24);
+    memcpy(out.frame.data, &record[11], 8);
+    return true;
+}
+
+// Strom an 0x00 zerlegen; ungültige Pakete zählen
+static std::vector<DecodedRecord> decodeStream(const std::string& stream, uint32_t* badPackets) {
+    std::vector<DecodedRecord> records;
+    *badPackets = 0;
+    size_t start = 0;
+    for (size_t i = 0; i < stream.size(); i++) {
+        if (stream[i] != 0) {
+            continue;
+        }
+        if (i > start) {
+            DecodedRecord record;
+            if (decodeRecord(stream.substr(start, i - start), record)) {
+                records.push_back(record);
+            } else {
+                (*badPackets)++;
+            }
+        }
+        start = i + 1;
+    }
+    return records;
+}
+
+static std::string captured;
+static size_t sinkLimit = (size_t)-1;
+
+static size_t captureSink(const char* data, size_t len, void* context) {
+    if (len > sinkLimit) {
+        len = sinkLimit;
+    }
+    captured.append(data, len);
+    return len;
+}
+
+static CanFrame sampleFrame(int i) {
+    uint8_t data[8];
+    for (int k = 0; k < 8; k++) {
+        data[k] = (uint8_t)(i * 7 + k);  // enthält auch Nullbytes
+    }
+    bool ext = i % 3 == 0;
+    return makeFrame(ext ? 0x18FF0000u + i : 0x180 + (i & 0x7F), ext, i % 9, data, (uint64_t)i * 9000000ULL);
+}
+
+static void testBinaryRoundTrip() {
+    const int total = 1000;
+    const std::string preamble = "[INFO] Log-Ausgabe: Binär\n";  // Klartext vor dem Start des Logs
+    captured = preamble;
+    sinkLimit = (size_t)-1;
+
+    CANLogWriter writer;
+    writer.setSink(captureSink, nullptr);
+    writer.begin(CAN_LOG_BINARY, 0);
+    for (int i = 0; i < total; i++) {
+        if (i == 500) {
+            writer.markGap();
+        }
+        CHECK(writer.log(sampleFrame(i)));
+    }
+    writer.end();
+    CHECK_EQ(writer.flush(), 0);
+    CHECK_EQ(writer.loggedCount(), total);
+    CHECK(captured.size() <= preamble.size() + 1 + (size_t)total * (CAN_LOG_RECORD_SIZE + 2));
+
+    uint32_t bad = 0;
+    std::vector<DecodedRecord> records = decodeStream(captured, &bad);
+    CHECK_EQ(bad, 1);  // Nur der Klartext davor
+    CHECK_EQ(records.size(), total);
+    uint32_t mismatches = 0;
+    for (int i = 0; i < total && i < (int)records.size(); i++) {
+        CanFrame expected = sampleFrame(i);
+        const CanFrame& frame = records[i].frame;
+        if (frame.id != expected.id || frame.ext != expected.ext || frame.len != expected.len ||
+            memcmp(frame.data, expected.data, expected.len) != 0 ||
+            frame.timestamp != (uint32_t)expected.timestamp) {
+            mismatches++;
+        }
+        bool gap = (records[i].flags & CAN_LOG_FLAG_GAP) != 0;
+        if (gap != (i == 500)) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // Ein verfälschtes Byte kostet genau einen Record, danach synchronisiert der Empfänger neu
+    std::string damaged = captured;
+    size_t middle = damaged.size() / 2;
+    while (damaged[middle] == 0) {
+        middle++;
+    }
+    damaged[middle] ^= 0x5A;
+    records = decodeStream(damaged, &bad);
+    CHECK_EQ(records.size(), total - 1);
+    CHECK_EQ(bad, 2);
+}
+
+static void testWriterBackpressure() {
+    CANLogWriter writer;
+    CHECK(!writer.log(sampleFrame(1)));  // Ohne begin() kein Log
+
+    captured.clear();
+    sinkLimit = 0;  // Sink nimmt gerade nichts an
+    writer.setSink(captureSink, nullptr);
+    writer.begin(CAN_LOG_BINARY, 0);
+    uint32_t accepted = 0;
+    for (int i = 0; i < 1000; i++) {
+        accepted += writer.log(sampleFrame(i)) ? 1 : 0;
+    }
+    CHECK(writer.droppedCount() > 0);
+    CHECK_EQ(accepted + writer.droppedCount(), 1000);
+    CHECK_EQ(writer.loggedCount(), accepted);
+    CHECK(writer.pending() <= CAN_LOG_BUFFER_SIZE);
+    CHECK(captured.empty());
+
+    // Sink nimmt wieder in kleinen Stücken an; der nächste Record meldet die Lücke
+    sinkLimit = 100;
+    while (writer.flush() > 0) {
+    }
+    sinkLimit = (size_t)-1;
+    CHECK(writer.log(sampleFrame(2000)));
+    writer.flush();
+
+    uint32_t bad = 0;
+    std::vector<DecodedRecord> records = decodeStream(captured, &bad);
+    CHECK_EQ(bad, 0);
+    CHECK_EQ(records.size(), accepted + 1);
+    if (!records.empty()) {
+        CHECK(records.back().flags & CAN_LOG_FLAG_GAP);
+        CHECK_EQ(records.front().flags & CAN_LOG_FLAG_GAP, 0);
+    }
+
+    // ASC: Kopf bei begin(), Abschlusszeile bei end()
+    captured.clear();
+    writer.begin(CAN_LOG_ASC, 0);
+    writer.log(makeFrame(0x123, false, 4, deadbeef, 1500000));
+    writer.end();
+    writer.flush();
+    CHECK(captured.compare(0, 5, "date ") == 0);
+    CHECK(captured.find("   1.500000 1  123             Rx   d 4 DE AD BE EF\n") != std::string::npos);
+    CHECK(captured.size() > 17 && captured.compare(captured.size() - 17, 17, "End TriggerBlock\n") == 0);
+    CHECK(!writer.active());
+}
+
+int main() {
+    testLineFormats();
+    testCrc();
+    testBinaryRoundTrip();
+    testWriterBackpressure();
+    return hostTestResult("CANLogTest");
+}
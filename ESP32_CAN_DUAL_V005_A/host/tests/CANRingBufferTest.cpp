@@ -0,0 +1,150 @@
+// host/tests/CANRingBufferTest.cpp
+// ===============================================================================
+// Test des Empfangs-Ringpuffers (CANRingBuffer.h)
+// Einzelthread: Füllen, Überlauf, Burst-Entnahme, Leeren, Umlauf der Indizes.
+// Zwei Threads: ein Producer-Thread schreibt fortlaufende Zahlen so schnell er kann,
+// der Consumer entnimmt sie in Bursts. Mit Wiederholung bei vollem Puffer muss jede
+// Zahl genau einmal und in Reihenfolge ankommen; ohne Wiederholung (wie die ISR)
+// müssen empfangene plus übergelaufene Elemente die Gesamtzahl ergeben.
+// ===============================================================================
+
+#include "CANRingBuffer.h"
+#include "CANInterface.h"
+#include "HostTest.h"
+
+#include <thread>
+
+static void testSingleThread() {
+    CANRingBuffer<uint32_t, 8> ring;
+    CHECK(ring.empty());
+    CHECK_EQ(ring.capacity(), 8);
+
+    for (uint32_t i = 0; i < 8; i++) {
+        CHECK(ring.push(i));
+    }
+    CHECK_EQ(ring.size(), 8);
+    CHECK(!ring.push(99));
+    CHECK(!ring.push(100));
+    CHECK_EQ(ring.overrunCount(), 2);
+
+    uint32_t value = 0;
+    CHECK(ring.pop(value));
+    CHECK_EQ(value, 0);
+
+    uint32_t burst[16];
+    CHECK_EQ(ring.popBurst(burst, 3), 3);
+    CHECK_EQ(burst[0], 1);
+    CHECK_EQ(burst[2], 3);
+    CHECK_EQ(ring.popBurst(burst, 16), 4);
+    CHECK_EQ(burst[3], 7);
+    CHECK(ring.empty());
+    CHECK(!ring.pop(value));
+    CHECK_EQ(ring.popBurst(burst, 16), 0);
+
+    // Viele Umläufe: Indizes laufen frei, die Maske muss stimmen
+    uint32_t expected = 0;
+    for (uint32_t i = 0; i < 100000; i++) {
+        CHECK(ring.push(i));
+        if (i % 3 == 2) {
+            size_t count = ring.popBurst(burst, 16);
+            for (size_t j = 0; j < count; j++) {
+                if (burst[j] != expected) {
+                    CHECK_EQ(burst[j], expected);
+                }
+                expected++;
+            }
+        }
+    }
+
+    ring.push(1);
+    ring.clear();
+    CHECK(ring.empty());
+    CHECK_EQ(ring.resetOverrunCount(), 2);
+    CHECK_EQ(ring.overrunCount(), 0);
+}
+
+// Producer wiederholt bei vollem Puffer: nichts darf verloren gehen
+static void testProducerThreadLossless() {
+    static CANRingBuffer<CanFrame, 64> ring;
+    const uint32_t total = 2000000;
+
+    std::thread producer([&]() {
+        CanFrame frame = {};
+        frame.len = 4;
+        for (uint32_t i = 0; i < total;) {
+            frame.id = i & 0x7FF;
+            memcpy(frame.data, &i, sizeof(i));
+            if (ring.push(frame)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    CanFrame frames[CAN_RX_BURST_SIZE];
+    uint32_t expected = 0;
+    uint32_t errors = 0;
+    while (expected < total) {
+        size_t count = ring.popBurst(frames, CAN_RX_BURST_SIZE);
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < count; i++) {
+            uint32_t value;
+            memcpy(&value, frames[i].data, sizeof(value));
+            if (value != expected || frames[i].id != (expected & 0x7FF)) {
+                errors++;
+            }
+            expected++;
+        }
+    }
+    producer.join();
+
+    CHECK_EQ(errors, 0);
+    CHECK(ring.empty());
+}
+
+// Producer verwirft bei vollem Puffer (wie der Empfangstask): Zähler müssen aufgehen
+static void testProducerThreadLossy() {
+    static CANRingBuffer<uint32_t, 32> ring;
+    const uint32_t total = 2000000;
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < total; i++) {
+            ring.push(i);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    uint32_t burst[8];
+    uint32_t received = 0;
+    uint32_t outOfOrder = 0;
+    int64_t last = -1;
+    while (true) {
+        bool finished = done.load(std::memory_order_acquire);
+        size_t count = ring.popBurst(burst, 8);
+        for (size_t i = 0; i < count; i++) {
+            if ((int64_t)burst[i] <= last) {
+                outOfOrder++;
+            }
+            last = burst[i];
+            received++;
+        }
+        if (finished && count == 0) {
+            break;
+        }
+    }
+    producer.join();
+
+    CHECK_EQ(outOfOrder, 0);
+    CHECK_EQ(received + ring.overrunCount(), total);
+}
+
+int main() {
+    testSingleThread();
+    testProducerThreadLossless();
+    testProducerThreadLossy();
+    return hostTestResult("CANRingBufferTest");
+}
@@ -0,0 +1,155 @@
+// host/tests/CANSlcanTest.cpp
+// ===============================================================================
+// Test des SLCAN-Befehlssatzes (CANSlcan.h)
+// Eine Sitzung wie von slcand: Version, Bitrate, Zeitstempel, Öffnen, Senden von
+// Standard- und Extended-Frames, Status, Schließen. Dazu fehlerhafte Zeilen, Befehle im
+// falschen Zustand, Listen-Only und das Erkennen von Sitzungsbefehlen.
+// ===============================================================================
+
+#include "CANSlcan.h"
+#include "HostTest.h"
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct SessionLog {
+    bool open = false;
+    bool listenOnly = false;
+    bool timestamps = false;
+    uint16_t kbps = 0;
+    bool acceptTx = true;
+    std::vector<CanFrame> sent;
+};
+
+static bool onOpen(bool listenOnly, bool timestamps, void* context) {
+    SessionLog* log = static_cast<SessionLog*>(context);
+    log->open = true;
+    log->listenOnly = listenOnly;
+    log->timestamps = timestamps;
+    return true;
+}
+
+static void onClose(void* context) {
+    static_cast<SessionLog*>(context)->open = false;
+}
+
+static bool onBitrate(uint16_t kbps, void* context) {
+    SessionLog* log = static_cast<SessionLog*>(context);
+    if (kbps == 10) {
+        return false;  // Vom Controller nicht unterstützt
+    }
+    log->kbps = kbps;
+    return true;
+}
+
+static bool onTransmit(const CanFrame& frame, void* context) {
+    SessionLog* log = static_cast<SessionLog*>(context);
+    if (!log->acceptTx) {
+        return false;
+    }
+    log->sent.push_back(frame);
+    return true;
+}
+
+static uint8_t onStatus(void* context) {
+    return 0x08;  // Datenüberlauf
+}
+
+static std::string command(SLCANSession& session, const char* line) {
+    char reply[SLCAN_MAX_REPLY];
+    size_t len = session.handleCommand(line, strlen(line), reply);
+    CHECK(len >= 1 && len <= SLCAN_MAX_REPLY);
+    return std::string(reply, len);
+}
+
+static void testSession() {
+    SessionLog log;
+    SLCANHandlers handlers = { onOpen, onClose, onBitrate, onTransmit, onStatus };
+    SLCANSession session;
+    session.setHandlers(handlers, &log);
+
+    CHECK(command(session, "V") == "V0101\r");
+    CHECK(command(session, "N") == "NESP1\r");
+    CHECK(command(session, "S6") == "\r");
+    CHECK_EQ(log.kbps, 500);
+    CHECK(command(session, "S0") == "\a");  // Handler lehnt ab
+    CHECK(command(session, "S9") == "\a");
+    CHECK(command(session, "Z1") == "\r");
+    CHECK(command(session, "F") == "\a");   // Status nur bei offenem Kanal
+    CHECK(command(session, "t1232AABB") == "\a");  // Senden nur bei offenem Kanal
+
+    CHECK(command(session, "O") == "\r");
+    CHECK(session.isOpen());
+    CHECK(log.open && !log.listenOnly && log.timestamps);
+    CHECK(command(session, "O") == "\a");
+    CHECK(command(session, "S4") == "\a");  // Bitrate nur bei geschlossenem Kanal
+    CHECK(command(session, "Z0") == "\a");
+
+    CHECK(command(session, "t1232AABB") == "z\r");
+    CHECK(command(session, "T1ABCDEF08DEADBEEF01020304") == "Z\r");
+    CHECK(command(session, "t7FF0") == "z\r");
+    CHECK_EQ(log.sent.size(), 3);
+    if (log.sent.size() == 3) {
+        CHECK_EQ(log.sent[0].id, 0x123);
+        CHECK_EQ(log.sent[0].ext, 0);
+        CHECK_EQ(log.sent[0].len, 2);
+        CHECK_EQ(log.sent[0].data[1], 0xBB);
+        CHECK_EQ(log.sent[1].id, 0x1ABCDEF0);
+        CHECK_EQ(log.sent[1].ext, 1);
+        CHECK_EQ(log.sent[1].len, 8);
+        CHECK_EQ(log.sent[1].data[0], 0xDE);
+        CHECK_EQ(log.sent[1].data[7], 0x04);
+        CHECK_EQ(log.sent[2].len, 0);
+    }
+
+    // Fehlerhafte Frames
+    CHECK(command(session, "t12") == "\a");          // Zu kurz
+    CHECK(command(session, "t8002AABB") == "\a");    // 11-Bit-ID zu groß
+    CHECK(command(session, "t1232AAB") == "\a");     // Länge passt nicht zum DLC
+    CHECK(command(session, "t1239") == "\a");        // DLC > 8
+    CHECK(command(session, "t12G1AA") == "\a");      // Kein Hex
+    CHECK(command(session, "T200000000") == "\a");   // 29-Bit-ID zu groß
+    CHECK(command(session, "r1230") == "\a");        // Remote-Frames nicht unterstützt
+    CHECK(command(session, "s031C") == "\a");        // BTR-Register nicht unterstützt
+    CHECK(command(session, "X") == "\a");
+    CHECK_EQ(log.sent.size(), 3);
+
+    log.acceptTx = false;
+    CHECK(command(session, "t1230") == "\a");        // Sendequeue voll
+    log.acceptTx = true;
+
+    CHECK(command(session, "F") == "F08\r");
+    CHECK(command(session, "M00000000") == "\r");
+    CHECK(command(session, "mFFFFFFFF") == "\r");
+    CHECK(command(session, "") == "\r");
+
+    CHECK(command(session, "C") == "\r");
+    CHECK(!session.isOpen());
+    CHECK(!log.open);
+    CHECK(command(session, "C") == "\r");
+
+    // Listen-Only: Senden abgelehnt
+    CHECK(command(session, "L") == "\r");
+    CHECK(log.listenOnly);
+    CHECK(command(session, "t1230") == "\a");
+    session.reset();
+    CHECK(!session.isOpen());
+}
+
+static void testSessionCommands() {
+    const char* yes[] = { "S6", "O", "L", "C", "V", "N", "F", "Z0", "Z1" };
+    const char* no[] = { "S9", "scan", "Z2", "OO", "t1230", "", "help" };
+    for (const char* line : yes) {
+        CHECK(SLCANSession::isSessionCommand(line, strlen(line)));
+    }
+    for (const char* line : no) {
+        CHECK(!SLCANSession::isSessionCommand(line, strlen(line)));
+    }
+}
+
+int main() {
+    testSession();
+    testSessionCommands();
+    return hostTestResult("CANSlcanTest");
+}
@@ -0,0 +1,217 @@
+// host/tests/CANStatisticsTest.cpp
+// ===============================================================================
+// Test der Busstatistik (CANStatistics.h)
+// frameBits() gegen eine Referenz, die den Frame Bit für Bit aufbaut, die CRC-15
+// berechnet und die Stuff-Bits auf dem gesendeten Strom einfügt. Danach Raten,
+// Buslast, Spitzenlast und Empfangsabstände bei gleichmäßigem Verkehr, Fenster ohne
+// Verkehr, Zählung je Node und das Verhalten bei voller ID-Tabelle.
+// ===============================================================================
+
+#include "CANStatistics.h"
+#include "HostTest.h"
+
+#include <random>
+#include <vector>
+
+// ===================================================================================
+// Referenz für die Bitlänge
+// ===================================================================================
+static void pushBits(std::vector<uint8_t>& bits, uint32_t value, int count) {
+    for (int i = count - 1; i >= 0; i--) {
+        bits.push_back((value >> i) & 1);
+    }
+}
+
+static uint16_t crc15(const std::vector<uint8_t>& bits) {
+    uint16_t crc = 0;
+    for (uint8_t bit : bits) {
+        uint8_t feedback = bit ^ ((crc >> 14) & 1);
+        crc = (crc << 1) & 0x7FFF;
+        if (feedback) {
+            crc ^= 0x4599;
+        }
+    }
+    return crc;
+}
+
+static uint16_t referenceFrameBits(const CanFrame& frame) {
+    std::vector<uint8_t> bits;
+    bits.push_back(0);  // SOF
+    if (frame.ext) {
+        pushBits(bits, frame.id >> 18, 11);
+        pushBits(bits, 0x3, 2);  // SRR, IDE
+        pushBits(bits, frame.id & 0x3FFFF, 18);
+        pushBits(bits, 0, 3);    // RTR, r1, r0
+    } else {
+        pushBits(bits, frame.id, 11);
+        pushBits(bits, 0, 3);    // RTR, IDE, r0
+    }
+    pushBits(bits, frame.len, 4);
+    for (uint8_t i = 0; i < frame.len; i++) {
+        pushBits(bits, frame.data[i], 8);
+    }
+    pushBits(bits, crc15(bits), 15);
+
+    // Nach fünf gleichen Bits folgt ein inverses Stuff-Bit, das selbst mitzählt
+    size_t stuffed = 0;
+    int run = 0;
+    int last = -1;
+    for (uint8_t bit : bits) {
+        if (bit == last) {
+            run++;
+        } else {
+            last = bit;
+            run = 1;
+        }
+        if (run == 5) {
+            stuffed++;
+            last = !bit;
+            run = 1;
+        }
+    }
+    // CRC-Delimiter, ACK-Slot, ACK-Delimiter, EOF, Intermission
+    return (uint16_t)(bits.size() + stuffed + 1 + 2 + 7 + 3);
+}
+
+static void testFrameBits() {
+    std::mt19937 rng(3);
+    uint32_t mismatches = 0;
+    for (int k = 0; k < 20000; k++) {
+        CanFrame frame = {};
+        frame.ext = rng() % 2;
+        frame.id = frame.ext ? (rng() & 0x1FFFFFFF) : (rng() & 0x7FF);
+        frame.len = rng() % 9;
+        int mode = rng() % 3;  // Nullen und Einsen stopfen am meisten
+        for (int i = 0; i < 8; i++) {
+            frame.data[i] = mode == 0 ? 0x00 : (mode == 1 ? 0xFF : (uint8_t)rng());
+        }
+        uint16_t bits = CANStatistics::frameBits(frame);
+        if (bits != referenceFrameBits(frame)) {
+            mismatches++;
+        }
+        if (bits < 47 || bits > (frame.ext ? 160 : 135)) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+
+    // DLC > 8 zählt wie 8 Byte
+    CanFrame frame = {};
+    frame.id = 0x123;
+    frame.len = 8;
+    uint16_t eight = CANStatistics::frameBits(frame);
+    frame.len = 15;
+    CHECK_EQ(CANStatistics::frameBits(frame), eight);
+}
+
+// ===================================================================================
+// Raten, Last und Abstände
+// ===================================================================================
+static CanFrame frameWithId(uint32_t id, bool ext = false) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext ? 1 : 0;
+    frame.len = 8;
+    return frame;
+}
+
+static void testRatesAndLoad() {
+    CANStatistics stats;
+    const uint64_t start = 5000000;
+    const CanFrame tpdo = frameWithId(0x185);
+    const uint16_t bits = CANStatistics::frameBits(tpdo);
+
+    // 4000 Frames/s über drei Sekunden, jeder zehnte gesendet
+    uint64_t t = start;
+    for (int i = 0; i < 12000; i++) {
+        stats.recordFrame(tpdo, i % 10 == 0, t);
+        t += 250;
+    }
+    CHECK_EQ(stats.rxFrames() + stats.txFrames(), 12000);
+    CHECK_EQ(stats.txFrames(), 1200);
+    CHECK_EQ(stats.totalBits(), 12000ULL * bits);
+    CHECK_EQ(stats.framesPerSecond(t), 4000);
+    CHECK_EQ(stats.busLoadPermille(t, 500000), 4000ULL * bits * 1000 / 500000);
+    CHECK_EQ(stats.busLoadPermille(t, 125000), 1000);  // Überlast wird auf 100 % begrenzt
+    CHECK_EQ(stats.busLoadPermille(t, 0), 0);
+    CHECK_EQ(stats.peakLoadPermille(500000), 4000ULL * bits * 1000 / 500000);
+
+    CHECK_EQ(stats.idCount(), 1);
+    bool found = false;
+    for (size_t i = 0; i < stats.idSlots(); i++) {
+        const CANIdStatistics& entry = stats.idSlot(i);
+        if (entry.key == CANStatistics::CAN_STATS_FREE) {
+            continue;
+        }
+        found = true;
+        CHECK_EQ(entry.id(), 0x185);
+        CHECK(!entry.extended());
+        CHECK_EQ(entry.frames, 12000);
+        CHECK_EQ(entry.minGap, 250);
+        CHECK_EQ(entry.maxGap, 250);
+        CHECK_EQ(entry.averageGap(), 250);
+        CHECK_EQ(stats.idRate(entry, t), 4000);
+    }
+    CHECK(found);
+
+    CHECK_EQ(stats.nodeFrames(5), 12000);
+    CHECK_EQ(stats.nodeRate(5, t), 4000);
+    CHECK_EQ(stats.nodeFrames(6), 0);
+    CHECK_EQ(stats.nodeRate(200, t), 0);
+
+    // Zwei Sekunden Ruhe: letztes abgeschlossenes Fenster leer, Spitzenwert bleibt
+    t += 2 * CAN_STATS_WINDOW_US;
+    CHECK_EQ(stats.framesPerSecond(t), 0);
+    CHECK_EQ(stats.busLoadPermille(t, 500000), 0);
+    stats.recordFrame(tpdo, false, t);
+    CHECK_EQ(stats.framesPerSecond(t + CAN_STATS_WINDOW_US), 1);
+    CHECK_EQ(stats.peakLoadPermille(500000), 4000ULL * bits * 1000 / 500000);
+
+    stats.reset();
+    CHECK_EQ(stats.rxFrames(), 0);
+    CHECK_EQ(stats.idCount(), 0);
+    CHECK_EQ(stats.peakLoadPermille(500000), 0);
+}
+
+static void testNodesAndTableLimit() {
+    CANStatistics stats;
+    uint64_t t = 1000;
+
+    // Nur 11-Bit-IDs ab 0x080 mit Node-ID 1-127 zählen je Node
+    stats.recordFrame(frameWithId(0x080), false, t);        // SYNC
+    stats.recordFrame(frameWithId(0x000), false, t);        // NMT
+    stats.recordFrame(frameWithId(0x705, true), false, t);  // Extended
+    stats.recordFrame(frameWithId(0x705), false, t);
+    CHECK_EQ(stats.nodeFrames(0), 0);
+    CHECK_EQ(stats.nodeFrames(5), 1);
+
+    // Gleiche Nummer als Standard- und Extended-ID sind zwei Einträge
+    CHECK_EQ(stats.idCount(), 4);
+
+    // Mehr IDs als verfolgt werden: Rest zählt nur in den Summen
+    stats.reset();
+    for (uint32_t id = 0; id < 200; id++) {
+        stats.recordFrame(frameWithId(0x100 + id), false, t);
+        stats.recordFrame(frameWithId(0x100 + id), false, t + 100);
+        t += 1000;
+    }
+    CHECK_EQ(stats.idCount(), CAN_STATS_MAX_IDS);
+    CHECK_EQ(stats.untrackedFrames(), 2 * (200 - CAN_STATS_MAX_IDS));
+    CHECK_EQ(stats.rxFrames(), 400);
+    uint32_t tracked = 0;
+    for (size_t i = 0; i < stats.idSlots(); i++) {
+        const CANIdStatistics& entry = stats.idSlot(i);
+        if (entry.key != CANStatistics::CAN_STATS_FREE) {
+            tracked += entry.frames;
+            CHECK_EQ(entry.minGap, 100);
+        }
+    }
+    CHECK_EQ(tracked, 2 * CAN_STATS_MAX_IDS);
+}
+
+int main() {
+    testFrameBits();
+    testRatesAndLoad();
+    testNodesAndTableLimit();
+    return hostTestResult("CANStatisticsTest");
+}
@@ -0,0 +1,174 @@
+// host/tests/CANTraceTableTest.cpp
+// ===============================================================================
+// Test der Trace-Tabelle des Live-Monitors (CANTraceTable.h)
+// Periode, Zähler und markierte Bytes einer Zeile (auch bei geänderter Länge und nach
+// Ablauf der Markierung), Extended-IDs über die Hash-Tabelle bis zur vollen Tabelle,
+// Sortierung und der Änderungsstand für die Anzeige. Zuletzt zufälliger Verkehr gegen
+// eine einfache Referenz (Liste je ID).
+// ===============================================================================
+
+#include "CANTraceTable.h"
+#include "HostTest.h"
+
+#include <string.h>
+#include <map>
+#include <random>
+
+static CanFrame makeFrame(uint32_t id, bool ext, uint8_t len, uint64_t timestamp) {
+    CanFrame frame = {};
+    frame.id = id;
+    frame.ext = ext ? 1 : 0;
+    frame.len = len;
+    frame.timestamp = timestamp;
+    return frame;
+}
+
+static void testRowUpdates() {
+    CANTraceTable table;
+    CanFrame frame = makeFrame(0x181, false, 2, 1000);
+    frame.data[0] = 1;
+    frame.data[1] = 2;
+    uint32_t version = table.version();
+    CHECK(table.update(frame));
+    CHECK(table.version() != version);
+    CHECK_EQ(table.rowCount(), 1);
+
+    const CANTraceRow& row = table.row(0);
+    CHECK_EQ(row.count, 1);
+    CHECK_EQ(row.period, 0);
+    CHECK_EQ(row.changedMask, 0);
+
+    // Byte 1 ändert sich
+    frame.timestamp = 11000;
+    frame.data[1] = 3;
+    table.update(frame);
+    CHECK_EQ(row.count, 2);
+    CHECK_EQ(row.period, 10000);
+    CHECK_EQ(row.changedMask, 0x02);
+    CHECK_EQ(row.highlighted(11000), 0x02);
+    CHECK_EQ(row.highlighted(11000 + CAN_TRACE_HIGHLIGHT_US), 0);
+
+    // Innerhalb der Markierung sammeln sich Änderungen, danach beginnt sie neu
+    frame.timestamp = 12000;
+    frame.data[0] = 7;
+    table.update(frame);
+    CHECK_EQ(row.changedMask, 0x03);
+    frame.timestamp = 12000 + 2 * CAN_TRACE_HIGHLIGHT_US;
+    frame.data[0] = 9;
+    table.update(frame);
+    CHECK_EQ(row.changedMask, 0x01);
+
+    // Längere Daten: das neue Byte gilt als geändert
+    frame.timestamp += 10;
+    frame.len = 3;
+    table.update(frame);
+    CHECK_EQ(row.changedMask, 0x05);
+    CHECK_EQ(row.len, 3);
+    CHECK_EQ(row.period, 10);
+
+    // Gleiche Daten: Markierung läuft nur ab
+    frame.timestamp += 10;
+    table.update(frame);
+    CHECK_EQ(row.changedMask, 0x05);
+    CHECK_EQ(row.highlighted(frame.timestamp + CAN_TRACE_HIGHLIGHT_US), 0);
+
+    // DLC > 8 wird auf 8 begrenzt
+    frame.len = 12;
+    table.update(frame);
+    CHECK_EQ(row.len, 8);
+}
+
+static void testFullTableAndSorting() {
+    CANTraceTable table;
+    CHECK(table.update(makeFrame(0x181, false, 1, 0)));
+    CHECK(table.update(makeFrame(0x181, true, 1, 0)));  // Gleiche Nummer als Extended-ID: eigene Zeile
+    for (uint32_t i = 0; i < CAN_TRACE_MAX_ROWS - 2; i++) {
+        CHECK(table.update(makeFrame(0x18FF0000 + (CAN_TRACE_MAX_ROWS - i) * 977, true, 1, i)));
+    }
+    CHECK_EQ(table.rowCount(), CAN_TRACE_MAX_ROWS);
+
+    CHECK(!table.update(makeFrame(0x1234567, true, 1, 0)));
+    CHECK(!table.update(makeFrame(0x700, false, 1, 0)));
+    CHECK_EQ(table.untrackedFrames(), 2);
+    CHECK(table.update(makeFrame(0x18FF0000 + CAN_TRACE_MAX_ROWS * 977, true, 1, 0)));  // Bekannte ID
+
+    uint8_t order[CAN_TRACE_MAX_ROWS];
+    size_t count = table.sortedRows(order);
+    CHECK_EQ(count, CAN_TRACE_MAX_ROWS);
+    CHECK_EQ(table.row(order[0]).id, 0x181);
+    CHECK(!table.row(order[0]).ext);
+    CHECK(table.row(order[1]).ext);
+    for (size_t i = 2; i < count; i++) {
+        CHECK(table.row(order[i - 1]).id < table.row(order[i]).id);
+    }
+
+    uint32_t version = table.version();
+    table.clear();
+    CHECK_EQ(table.rowCount(), 0);
+    CHECK_EQ(table.untrackedFrames(), 0);
+    CHECK(table.version() != version);
+    CHECK(table.update(makeFrame(0x1234567, true, 1, 0)));
+}
+
+// Zufälliger Verkehr: Zähler, letzte Daten und Periode je ID wie in einer Referenz
+static void testAgainstReference() {
+    struct Expected {
+        uint32_t count;
+        uint64_t lastSeen;
+        uint32_t period;
+        uint8_t data[8];
+    };
+    std::map<uint64_t, Expected> expected;
+    CANTraceTable table;
+    std::mt19937 rng(5);
+    uint64_t t = 0;
+    uint32_t untracked = 0;
+
+    for (int i = 0; i < 100000; i++) {
+        bool ext = rng() % 4 == 0;
+        uint32_t id = ext ? 0x18000000 + rng() % 48 : rng() % 40;
+        CanFrame frame = makeFrame(id, ext, 8, t += 1 + rng() % 500);
+        for (int k = 0; k < 8; k++) {
+            frame.data[k] = (uint8_t)rng();
+        }
+
+        uint64_t key = ((uint64_t)ext << 32) | id;
+        bool known = expected.count(key) > 0;
+        bool stored = table.update(frame);
+        CHECK(stored == (known || expected.size() < CAN_TRACE_MAX_ROWS));
+        if (!stored) {
+            untracked++;
+            continue;
+        }
+        Expected& e = expected[key];
+        e.period = e.count > 0 ? (uint32_t)(t - e.lastSeen) : 0;
+        e.count++;
+        e.lastSeen = t;
+        memcpy(e.data, frame.data, 8);
+    }
+
+    CHECK_EQ(table.rowCount(), expected.size());
+    CHECK_EQ(table.untrackedFrames(), untracked);
+    uint32_t mismatches = 0;
+    for (size_t i = 0; i < table.rowCount(); i++) {
+        const CANTraceRow& row = table.row(i);
+        auto it = expected.find(((uint64_t)row.ext << 32) | row.id);
+        if (it == expected.end()) {
+            mismatches++;
+            continue;
+        }
+        const Expected& e = it->second;
+        if (row.count != e.count || row.lastSeen != e.lastSeen || row.period != e.period ||
+            memcmp(row.data, e.data, 8) != 0) {
+            mismatches++;
+        }
+    }
+    CHECK_EQ(mismatches, 0);
+}
+
+int main() {
+    testRowUpdates();
+    testFullTableAndSorting();
+    testAgainstReference();
+    return hostTestResult("CANTraceTableTest");
+}
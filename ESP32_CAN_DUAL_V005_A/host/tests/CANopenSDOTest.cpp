@@ -0,0 +1,212 @@
+// host/tests/CANopenSDOTest.cpp
+// ===============================================================================
+// Test des SDO-Clients (readSDOBuffer()/writeSDOBuffer() in CANopenClass.cpp) gegen
+// einen simulierten Node (CANSimNode) über SimCANInterface
+// Segmentierter Upload und Download, Block-Upload und -Download mit CRC über mehrere
+// Blöcke, verlorene Block-Segmente (Wiederholung ab der Quittung), Abbruch durch den
+// Server mitten im Transfer (das Objekt bleibt unverändert), zu kleiner Puffer und
+// der Rückfall auf segmentiert, wenn der Server Block-Transfers mit Abort ablehnt.
+// ===============================================================================
+
+#include "CANopenClass.h"
+#include "SimCANInterface.h"
+#include "CANTimestamp.h"
+#include "HostTest.h"
+
+#include <string.h>
+
+static const uint8_t NODE_ID = 5;
+
+// Vom Node gesendete SDO-Aborts mit Abortcode 0x05040001 (Befehl unbekannt)
+static uint32_t commandAborts = 0;
+
+static void traceNodeFrames(const CanFrame& frame, CANSimParticipant* sender, bool success, void* context) {
+    uint32_t code = frame.data[4] | (frame.data[5] << 8) | (frame.data[6] << 16) | ((uint32_t)frame.data[7] << 24);
+    if (success && frame.id == (uint32_t)(COB_ID_TSDO_BASE + NODE_ID) && frame.data[0] == 0x80 &&
+        code == SDO_ABORT_COMMAND) {
+        commandAborts++;
+    }
+}
+
+static void fillPattern(uint8_t* data, size_t size, uint8_t seed) {
+    for (size_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)(seed + i * 7 + (i >> 3));
+    }
+}
+
+static bool nodeHolds(const CANSimNode* node, const uint8_t* data, size_t size) {
+    return node->domainSize() == size && memcmp(node->domain(), data, size) == 0;
+}
+
+// Asynchron lesen und bis zum Abschluss pumpen (für den Abortcode)
+static SDOFuture readAsync(CANopen& canopen, SimCANInterface& can, uint16_t index,
+                           uint8_t* buffer, size_t capacity, bool block) {
+    SDOFuture future;
+    future.done = true;
+    future.result = SDO_RESULT_SEND_ERROR;
+    if (!canopen.readSDOBufferAsync(NODE_ID, index, 0, buffer, capacity, block, &future)) {
+        return future;
+    }
+    while (!future.done) {
+        can.serviceTx();
+        CanFrame frames[CAN_RX_BURST_SIZE];
+        size_t count = can.receiveBurst(frames, CAN_RX_BURST_SIZE, 1000);
+        for (size_t i = 0; i < count; i++) {
+            canopen.processFrame(frames[i]);
+        }
+        canopen.tick();
+    }
+    return future;
+}
+
+static void testCrc() {
+    const uint8_t check[] = "123456789";
+    CHECK_EQ(CANopen::sdoCrc16(check, 9), 0x31C3);  // CRC-16/XMODEM
+}
+
+static void testUpload(CANopen& canopen, CANSimNode* node) {
+    uint8_t buffer[CAN_SIM_DOMAIN_SIZE];
+    size_t received = 0;
+
+    // Gerätename: segmentiert, als Block und als Block mit Rückfall nicht nötig
+    CHECK(canopen.readSDOBuffer(NODE_ID, 0x1008, 0, buffer, sizeof(buffer), received));
+    CHECK(received == 7 && memcmp(buffer, "SimNode", 7) == 0);
+    CHECK(canopen.readSDOBuffer(NODE_ID, 0x1008, 0, buffer, sizeof(buffer), received, true));
+    CHECK(received == 7 && memcmp(buffer, "SimNode", 7) == 0);
+
+    // Zahlenwert als Block-Upload (ein Segment)
+    CHECK(canopen.readSDOBuffer(NODE_ID, 0x1018, 4, buffer, sizeof(buffer), received, true));
+    CHECK(received == 4 && buffer[0] == (uint8_t)(1000 + NODE_ID) && buffer[1] == (uint8_t)((1000 + NODE_ID) >> 8));
+
+    // Parameterblock über mehrere Segmente bzw. drei Blöcke (Client-Blockgröße 127)
+    uint8_t pattern[CAN_SIM_DOMAIN_SIZE];
+    fillPattern(pattern, sizeof(pattern), 3);
+    CHECK(node->setDomain(pattern, 300));
+    memset(buffer, 0, sizeof(buffer));
+    CHECK(canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, sizeof(buffer), received));
+    CHECK(received == 300 && memcmp(buffer, pattern, 300) == 0);
+    CHECK(node->setDomain(pattern, CAN_SIM_DOMAIN_SIZE));
+    memset(buffer, 0, sizeof(buffer));
+    CHECK(canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, sizeof(buffer), received, true));
+    CHECK(received == CAN_SIM_DOMAIN_SIZE && memcmp(buffer, pattern, CAN_SIM_DOMAIN_SIZE) == 0);
+
+    // Verlorenes Segment im Block: Quittung bis zur Lücke, Server wiederholt ab dort
+    node->dropBlockSegment(3);
+    memset(buffer, 0, sizeof(buffer));
+    CHECK(canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, sizeof(buffer), received, true));
+    CHECK(received == CAN_SIM_DOMAIN_SIZE && memcmp(buffer, pattern, CAN_SIM_DOMAIN_SIZE) == 0);
+
+    // Zu kleiner Puffer
+    CHECK(!canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, 100, received));
+    CHECK(!canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, 100, received, true));
+    CHECK_EQ(received, 0);
+
+    // Unbekanntes Objekt
+    CHECK(!canopen.readSDOBuffer(NODE_ID, 0x2200, 0, buffer, sizeof(buffer), received, true));
+}
+
+static void testDownload(CANopen& canopen, CANSimNode* node) {
+    uint8_t pattern[CAN_SIM_DOMAIN_SIZE];
+    fillPattern(pattern, sizeof(pattern), 11);
+
+    // Segmentiert, expedited (bis 4 Bytes) und als Block über mehrere Blöcke
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, pattern, 200));
+    CHECK(nodeHolds(node, pattern, 200));
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, pattern + 1, 3));
+    CHECK(nodeHolds(node, pattern + 1, 3));
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, pattern, 500, true));
+    CHECK(nodeHolds(node, pattern, 500));
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, pattern + 2, 7 * CAN_SIM_BLOCK_SIZE, true));
+    CHECK(nodeHolds(node, pattern + 2, 7 * CAN_SIM_BLOCK_SIZE));
+
+    // Verlorenes Segment: der Client wiederholt ab der Quittung des Servers
+    node->dropBlockSegment(6);
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, pattern + 4, 400, true));
+    CHECK(nodeHolds(node, pattern + 4, 400));
+
+    // Zu groß bzw. schreibgeschützt
+    uint8_t tooLarge[CAN_SIM_DOMAIN_SIZE + 1] = {0};
+    CHECK(!canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, tooLarge, sizeof(tooLarge), true));
+    CHECK(!canopen.writeSDOBuffer(NODE_ID, 0x1008, 0, pattern, 20));
+    CHECK(nodeHolds(node, pattern + 4, 400));
+}
+
+// Abbruch durch den Server mitten im Transfer; danach laufen Transfers normal weiter
+static void testAbort(CANopen& canopen, SimCANInterface& can, CANSimNode* node) {
+    uint8_t pattern[CAN_SIM_DOMAIN_SIZE];
+    uint8_t other[CAN_SIM_DOMAIN_SIZE];
+    fillPattern(pattern, sizeof(pattern), 21);
+    fillPattern(other, sizeof(other), 99);
+    CHECK(node->setDomain(pattern, 300));
+
+    uint8_t buffer[CAN_SIM_DOMAIN_SIZE];
+    node->abortTransferAt(70, 0x08000020);
+    SDOFuture future = readAsync(canopen, can, CAN_SIM_DOMAIN_INDEX, buffer, sizeof(buffer), false);
+    CHECK_EQ(future.result, SDO_RESULT_ABORT);
+    CHECK_EQ(future.abortCode, 0x08000020);
+    CHECK(!canopen.isSDOBusy(NODE_ID));
+
+    node->abortTransferAt(200, 0x08000020);
+    future = readAsync(canopen, can, CAN_SIM_DOMAIN_INDEX, buffer, sizeof(buffer), true);
+    CHECK_EQ(future.result, SDO_RESULT_ABORT);
+    CHECK_EQ(future.abortCode, 0x08000020);
+
+    // Abgebrochener Download übernimmt nichts
+    node->abortTransferAt(50, 0x08000020);
+    CHECK(!canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, other, 300));
+    CHECK(nodeHolds(node, pattern, 300));
+    node->abortTransferAt(2 * 7 * CAN_SIM_BLOCK_SIZE, 0x08000020);
+    CHECK(!canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, other, 400, true));
+    CHECK(nodeHolds(node, pattern, 300));
+
+    size_t received = 0;
+    CHECK(canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, sizeof(buffer), received, true));
+    CHECK(received == 300 && memcmp(buffer, pattern, 300) == 0);
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, other, 400, true));
+    CHECK(nodeHolds(node, other, 400));
+}
+
+// Server ohne Block-Transfer: Abort 0x05040001, der Client wiederholt segmentiert
+static void testBlockFallback(CANopen& canopen, CANSimNode* node) {
+    uint8_t pattern[CAN_SIM_DOMAIN_SIZE];
+    fillPattern(pattern, sizeof(pattern), 42);
+    node->setBlockTransfer(false);
+    commandAborts = 0;
+
+    CHECK(canopen.writeSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, pattern, 250, true));
+    CHECK(nodeHolds(node, pattern, 250));
+    CHECK_EQ(commandAborts, 1);
+
+    uint8_t buffer[CAN_SIM_DOMAIN_SIZE];
+    size_t received = 0;
+    CHECK(canopen.readSDOBuffer(NODE_ID, CAN_SIM_DOMAIN_INDEX, 0, buffer, sizeof(buffer), received, true));
+    CHECK(received == 250 && memcmp(buffer, pattern, 250) == 0);
+    CHECK_EQ(commandAborts, 2);
+
+    node->setBlockTransfer(true);
+}
+
+int main() {
+    testCrc();
+
+    CANSimNetwork network(500000);
+    network.skipTo(canTimestampUs());
+    CANSimNode* node = network.addNode(NODE_ID, 0);
+    network.bus().setTrace(traceNodeFrames, nullptr);
+    SimCANInterface can(network);
+    CHECK(can.begin(500000));
+    CANopen canopen(&can);
+
+    // Boot-up abwarten
+    delay(20);
+    CanFrame frames[CAN_RX_BURST_SIZE];
+    while (can.receiveBurst(frames, CAN_RX_BURST_SIZE) > 0) {
+    }
+
+    testUpload(canopen, node);
+    testDownload(canopen, node);
+    testAbort(canopen, can, node);
+    testBlockFallback(canopen, node);
+    CHECK_EQ(canopen.activeSDOTransfers(), 0);
+    return hostTestResult("CANopenSDOTest");
+}
@@ -0,0 +1,45 @@
+// host/tests/HostTest.h
+// ===============================================================================
+// Minimaler Testrahmen für die Host-Tests (ctest)
+// CHECK/CHECK_EQ melden einen Fehler mit Datei und Zeile und zählen ihn, der Test
+// läuft weiter. hostTestResult() liefert den Rückgabewert für main(): 0 = bestanden,
+// 1 = fehlgeschlagen; HOST_TEST_SKIP meldet ctest einen übersprungenen Test
+// (z.B. ohne vcan-Interface).
+// ===============================================================================
+
+#pragma once
+
+#include <stdio.h>
+
+#define HOST_TEST_SKIP 77
+
+static int hostTestFailures = 0;
+
+#define CHECK(condition)                                                                  \
+    do {                                                                                  \
+        if (!(condition)) {                                                               \
+            fprintf(stderr, "%s:%d: CHECK(%s) fehlgeschlagen\n", __FILE__, __LINE__,      \
+                    #condition);                                                          \
+            hostTestFailures++;                                                           \
+        }                                                                                 \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                        \
+    do {                                                                                  \
+        long long actualValue = (long long)(actual);                                      \
+        long long expectedValue = (long long)(expected);                                  \
+        if (actualValue != expectedValue) {                                               \
+            fprintf(stderr, "%s:%d: %s = %lld, erwartet %lld\n", __FILE__, __LINE__,      \
+                    #actual, actualValue, expectedValue);                                 \
+            hostTestFailures++;                                                           \
+        }                                                                                 \
+    } while (0)
+
+static inline int hostTestResult(const char* name) {
+    if (hostTestFailures > 0) {
+        fprintf(stderr, "[FEHLER] %s: %d Prüfungen fehlgeschlagen\n", name, hostTestFailures);
+        return 1;
+    }
+    fprintf(stderr, "[INFO] %s: bestanden\n", name);
+    return 0;
+}
@@ -0,0 +1,180 @@
+// host/tests/RenderSchedulerTest.cpp
+// ===============================================================================
+// Test von Bildraten-Taktung und Dirty-Regionen (RenderScheduler.h)
+// RenderScheduler: Zusammenfassen mehrerer Anforderungen, es zeichnet die zuletzt
+// angeforderte Ansicht, Bildintervall, Anforderung aus der Zeichenfunktion heraus.
+// DirtyRegion: Textzeilen verschmelzen, Rahmenkanten bleiben getrennt, Begrenzung auf
+// die Displayfläche, höchstens RENDER_DIRTY_RECTS Rechtecke. Zuletzt zufällige
+// Rechtecke: jedes bemalte Pixel muss in der Region liegen.
+// ===============================================================================
+
+#include "RenderScheduler.h"
+#include "HostTest.h"
+
+#include <random>
+#include <vector>
+
+static uint32_t renderCalls = 0;
+static void* lastContext = nullptr;
+static RenderScheduler* rerequestFrom = nullptr;
+
+static void countingRender(void* context) {
+    renderCalls++;
+    lastContext = context;
+    if (rerequestFrom != nullptr) {
+        rerequestFrom->request(countingRender, context);  // Ansicht mit Animation
+        rerequestFrom = nullptr;
+    }
+}
+
+static void testScheduler() {
+    RenderScheduler scheduler(10);
+    CHECK_EQ(scheduler.frameRate(), 10);
+    CHECK(!scheduler.service(0));  // Nichts angefordert
+    CHECK(!scheduler.pending());
+
+    int first = 0;
+    int second = 0;
+    scheduler.request(countingRender, &first);
+    scheduler.request(countingRender, &second);
+    CHECK_EQ(scheduler.requestsCoalesced(), 1);
+    CHECK(scheduler.service(5));  // Erstes Bild sofort
+    CHECK_EQ(renderCalls, 1);
+    CHECK(lastContext == &second);
+    CHECK(!scheduler.pending());
+
+    // Innerhalb des Intervalls (100 ms) wird nur vorgemerkt
+    scheduler.request(countingRender, &first);
+    CHECK(!scheduler.service(50));
+    CHECK(scheduler.pending());
+    CHECK(scheduler.service(105));
+    CHECK_EQ(renderCalls, 2);
+    CHECK_EQ(scheduler.framesRendered(), 2);
+
+    // Anforderung aus der Zeichenfunktion bleibt für das nächste Bild stehen
+    rerequestFrom = &scheduler;
+    scheduler.request(countingRender, &first);
+    CHECK(scheduler.service(205));
+    CHECK(scheduler.pending());
+    CHECK(!scheduler.service(250));
+    CHECK(scheduler.service(305));
+    CHECK_EQ(renderCalls, 4);
+
+    scheduler.request(countingRender, &first);
+    scheduler.cancel();
+    CHECK(!scheduler.service(1000));
+
+    // Bildrate 0 gilt als 1 Bild/s; Intervall auch über den Überlauf von millis()
+    scheduler.setFrameRate(0);
+    CHECK_EQ(scheduler.frameRate(), 1);
+    scheduler.request(countingRender, &first);
+    CHECK(scheduler.service(0xFFFFFF00u));
+    scheduler.request(countingRender, &first);
+    CHECK(!scheduler.service(0xFFFFFF00u + 999));
+    CHECK(scheduler.service(0xFFFFFF00u + 1000));
+    CHECK_EQ(renderCalls, 6);
+}
+
+static void testDirtyRegion() {
+    const int16_t width = 320;
+    const int16_t height = 240;
+    DirtyRegion region;
+
+    // Aufeinanderfolgende Textzeilen werden ein Rechteck
+    for (int16_t y = 0; y < 80; y += 8) {
+        region.add(0, y, 120, 8, width, height);
+    }
+    CHECK_EQ(region.size(), 1);
+    CHECK_EQ(region.area(), 120 * 80);
+
+    // Rahmenkanten berühren sich, die Hülle wäre aber der ganze Bildschirm
+    region.clear();
+    region.add(0, 0, width, 2, width, height);
+    region.add(0, height - 2, width, 2, width, height);
+    region.add(0, 0, 2, height, width, height);
+    region.add(width - 2, 0, 2, height, width, height);
+    CHECK(region.size() > 1);
+    CHECK(region.area() < width * height / 10);
+
+    // Begrenzung auf die Displayfläche; Rechtecke außerhalb fallen weg
+    region.clear();
+    region.add(-5, -5, 10, 10, width, height);
+    CHECK_EQ(region.size(), 1);
+    CHECK_EQ(region.area(), 25);
+    region.add(400, 0, 10, 10, width, height);
+    region.add(10, 10, 0, 5, width, height);
+    CHECK_EQ(region.size(), 1);
+    region.add(315, 235, 10, 10, width, height);
+    CHECK_EQ(region.size(), 2);
+    CHECK_EQ(region.area(), 25 + 25);
+
+    // Viele verstreute Rechtecke: nie mehr als RENDER_DIRTY_RECTS
+    region.clear();
+    for (int i = 0; i < 50; i++) {
+        region.add((int16_t)((i * 37) % 300), (int16_t)((i * 53) % 220), 10, 10, width, height);
+        CHECK(region.size() <= RENDER_DIRTY_RECTS);
+    }
+}
+
+// Zufällige Rechtecke: die Region deckt jedes bemalte Pixel ab
+static void testCoverage() {
+    const int16_t width = 160;
+    const int16_t height = 128;
+    std::mt19937 rng(17);
+    uint32_t uncovered = 0;
+    uint32_t overflows = 0;
+
+    for (int round = 0; round < 300; round++) {
+        DirtyRegion region;
+        std::vector<uint8_t> painted(width * height, 0);
+        int rects = 1 + rng() % 30;
+        for (int k = 0; k < rects; k++) {
+            int16_t x = (int16_t)(rng() % (width + 20)) - 10;
+            int16_t y = (int16_t)(rng() % (height + 20)) - 10;
+            int16_t w = (int16_t)(1 + rng() % 40);
+            int16_t h = (int16_t)(1 + rng() % 20);
+            region.add(x, y, w, h, width, height);
+            for (int py = y; py < y + h; py++) {
+                for (int px = x; px < x + w; px++) {
+                    if (px >= 0 && px < width && py >= 0 && py < height) {
+                        painted[py * width + px] = 1;
+                    }
+                }
+            }
+        }
+        if (region.size() > RENDER_DIRTY_RECTS) {
+            overflows++;
+        }
+
+        for (int py = 0; py < height; py++) {
+            for (int px = 0; px < width; px++) {
+                if (!painted[py * width + px]) {
+                    continue;
+                }
+                bool covered = false;
+                for (size_t i = 0; i < region.size() && !covered; i++) {
+                    const DirtyRect& r = region.rect(i);
+                    covered = px >= r.x0 && px < r.x1 && py >= r.y0 && py < r.y1;
+                }
+                if (!covered) {
+                    uncovered++;
+                }
+            }
+        }
+        for (size_t i = 0; i < region.size(); i++) {
+            const DirtyRect& r = region.rect(i);
+            if (r.x0 < 0 || r.y0 < 0 || r.x1 > width || r.y1 > height || r.area() <= 0) {
+                overflows++;
+            }
+        }
+    }
+    CHECK_EQ(uncovered, 0);
+    CHECK_EQ(overflows, 0);
+}
+
+int main() {
+    testScheduler();
+    testDirtyRegion();
+    testCoverage();
+    return hostTestResult("RenderSchedulerTest");
+}
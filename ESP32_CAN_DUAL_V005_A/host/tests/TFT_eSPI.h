@@ -0,0 +1,179 @@
+// host/tests/TFT_eSPI.h
+// ===============================================================================
+// TFT_eSPI für den Test von WaveshareDisplay.h (nur im Include-Pfad dieses Tests)
+// Panel und Sprite sind Pixelspeicher im RAM. pushImageDMA() kopiert die Kachel ins
+// Panel und zählt sie, sodass der Test das Panel mit dem Framebuffer vergleichen kann.
+// Schrift: 6x8-Zelle je Zeichen mit einem Muster aus dem Zeichencode. hostPanel und
+// hostFramebuffer zeigen auf das zuletzt initialisierte Panel bzw. Sprite.
+// Dazu psramFound()/heap_caps_malloc() aus dem ESP32-Core, per hostPsramAvailable
+// abschaltbar.
+// ===============================================================================
+
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+#define TFT_BLACK     0x0000
+#define TFT_WHITE     0xFFFF
+#define PSRAM_ENABLE  3
+#define MALLOC_CAP_DMA (1 << 3)
+
+#define TFT_HOST_WIDTH  800
+#define TFT_HOST_HEIGHT 480
+
+class TFT_eSPI;
+
+static bool hostPsramAvailable = true;
+static TFT_eSPI* hostPanel = nullptr;
+static TFT_eSPI* hostFramebuffer = nullptr;
+
+static inline bool psramFound() {
+    return hostPsramAvailable;
+}
+
+static inline void* heap_caps_malloc(size_t size, uint32_t caps) {
+    return malloc(size);
+}
+
+static inline void heap_caps_free(void* pointer) {
+    free(pointer);
+}
+
+class TFT_eSPI : public Print {
+public:
+    std::vector<uint16_t> pixels;
+    uint32_t tilesPushed = 0;
+    uint32_t writeDepth = 0;
+
+    TFT_eSPI() {}
+
+    void init() {
+        resize(TFT_HOST_WIDTH, TFT_HOST_HEIGHT);
+        hostPanel = this;
+    }
+    void setRotation(uint8_t rotation) {}
+
+    int16_t width() const { return w; }
+    int16_t height() const { return h; }
+    uint16_t pixel(int32_t x, int32_t y) const { return pixels[y * w + x]; }
+
+    void fillRect(int32_t x, int32_t y, int32_t width, int32_t height, uint32_t color) {
+        for (int32_t row = y; row < y + height; row++) {
+            for (int32_t col = x; col < x + width; col++) {
+                plot(col, row, color);
+            }
+        }
+    }
+    void fillScreen(uint32_t color) { fillRect(0, 0, w, h, color); }
+
+    void drawLine(int32_t x0, int32_t y0, int32_t x1, int32_t y1, uint32_t color) {
+        int32_t dx = abs(x1 - x0);
+        int32_t dy = -abs(y1 - y0);
+        int32_t sx = x0 < x1 ? 1 : -1;
+        int32_t sy = y0 < y1 ? 1 : -1;
+        int32_t error = dx + dy;
+        while (true) {
+            plot(x0, y0, color);
+            if (x0 == x1 && y0 == y1) {
+                break;
+            }
+            int32_t twice = 2 * error;
+            if (twice >= dy) {
+                error += dy;
+                x0 += sx;
+            }
+            if (twice <= dx) {
+                error += dx;
+                y0 += sy;
+            }
+        }
+    }
+    void drawRect(int32_t x, int32_t y, int32_t width, int32_t height, uint32_t color) {
+        fillRect(x, y, width, 1, color);
+        fillRect(x, y + height - 1, width, 1, color);
+        fillRect(x, y, 1, height, color);
+        fillRect(x + width - 1, y, 1, height, color);
+    }
+
+    void setTextColor(uint16_t color) { fg = color; }
+    void setTextColor(uint16_t color, uint16_t background) { fg = color; bg = background; }
+    void setTextSize(uint8_t size) { textSize = size == 0 ? 1 : size; }
+    void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+    int16_t getCursorX() const { return cursorX; }
+    int16_t getCursorY() const { return cursorY; }
+    int16_t fontHeight() const { return 8 * textSize; }
+    int16_t textWidth(const char* text) const { return (int16_t)(6 * textSize * strlen(text)); }
+
+    using Print::write;
+    size_t write(uint8_t c) override {
+        if (c == '\r') {
+            return 1;
+        }
+        if (c == '\n') {
+            cursorX = 0;
+            cursorY += fontHeight();
+            return 1;
+        }
+        for (int32_t row = 0; row < fontHeight(); row++) {
+            for (int32_t col = 0; col < 6 * textSize; col++) {
+                bool set = ((c * 31 + col / textSize * 7 + row / textSize) & 3) == 0;
+                plot(cursorX + col, cursorY + row, set ? fg : bg);
+            }
+        }
+        cursorX += 6 * textSize;
+        return 1;
+    }
+
+    bool initDMA(bool ctrlCS = false) { return true; }
+    void startWrite() { writeDepth++; }
+    void endWrite() { writeDepth--; }
+    void dmaWait() {}
+    void pushImageDMA(int32_t x, int32_t y, int32_t width, int32_t height, uint16_t* image, uint16_t* buffer = nullptr) {
+        for (int32_t row = 0; row < height; row++) {
+            for (int32_t col = 0; col < width; col++) {
+                plot(x + col, y + row, image[row * width + col]);
+            }
+        }
+        tilesPushed++;
+    }
+
+protected:
+    int16_t w = 0;
+    int16_t h = 0;
+
+    void resize(int16_t width, int16_t height) {
+        w = width;
+        h = height;
+        pixels.assign((size_t)w * h, 0);
+    }
+
+private:
+    int16_t cursorX = 0;
+    int16_t cursorY = 0;
+    uint16_t fg = TFT_WHITE;
+    uint16_t bg = TFT_BLACK;
+    uint8_t textSize = 1;
+
+    void plot(int32_t x, int32_t y, uint32_t color) {
+        if (x >= 0 && y >= 0 && x < w && y < h) {
+            pixels[y * w + x] = (uint16_t)color;
+        }
+    }
+};
+
+class TFT_eSprite : public TFT_eSPI {
+public:
+    explicit TFT_eSprite(TFT_eSPI* panel) {}
+
+    void setColorDepth(int8_t depth) {}
+    void setAttribute(uint8_t attribute, uint8_t value) {}
+    void* createSprite(int16_t width, int16_t height, uint8_t frames = 1) {
+        resize(width, height);
+        hostFramebuffer = this;
+        return pixels.data();
+    }
+    void deleteSprite() { resize(0, 0); }
+    void fillSprite(uint32_t color) { fillScreen(color); }
+    void* getPointer() { return pixels.empty() ? nullptr : pixels.data(); }
+};
@@ -0,0 +1,158 @@
+// host/tests/WaveshareDisplayTest.cpp
+// ===============================================================================
+// Test des TFT-Framebuffers (WaveshareDisplay.h) gegen ein TFT_eSPI im RAM
+// (tests/TFT_eSPI.h). Gezählt werden die per DMA übertragenen Kacheln: eine neue
+// Textzeile, unverändert neu gezeichneter Text, ein Rahmen, Vollbild und Löschen.
+// Nach jedem display() muss das Panel pixelgleich mit dem Framebuffer sein, auch bei
+// zufälligen Zeichenfolgen. Ohne PSRAM wird direkt auf das Panel gezeichnet.
+// ===============================================================================
+
+#include "WaveshareDisplay.h"
+#include "HostTest.h"
+
+#include <random>
+
+static const uint32_t TILES_X = (TFT_HOST_WIDTH + TFT_TILE_SIZE - 1) / TFT_TILE_SIZE;
+static const uint32_t TILES_Y = (TFT_HOST_HEIGHT + TFT_TILE_SIZE - 1) / TFT_TILE_SIZE;
+
+// Geänderte Pixel zwischen Panel und Framebuffer
+static uint32_t panelDifferences() {
+    uint32_t differences = 0;
+    for (size_t i = 0; i < hostPanel->pixels.size(); i++) {
+        if (hostPanel->pixels[i] != hostFramebuffer->pixels[i]) {
+            differences++;
+        }
+    }
+    return differences;
+}
+
+// display() und die Zahl der dabei übertragenen Kacheln
+static uint32_t flush(WaveshareDisplay& display) {
+    uint32_t before = hostPanel->tilesPushed;
+    display.display();
+    CHECK_EQ(hostPanel->writeDepth, 0);
+    return hostPanel->tilesPushed - before;
+}
+
+static void testTileFlush() {
+    hostPsramAvailable = true;
+    WaveshareDisplay display;
+    CHECK(display.begin());
+    CHECK_EQ(display.frameRate(), TFT_BUFFERED_FPS);
+    CHECK(hostFramebuffer != nullptr && hostFramebuffer->width() == TFT_HOST_WIDTH);
+    CHECK_EQ(flush(display), 0);
+
+    // Erste Textzeile: eine Kachel
+    display.clear();
+    display.setCursor(0, 0);
+    display.println("Hallo");
+    CHECK_EQ(flush(display), 1);
+    CHECK_EQ(panelDifferences(), 0);
+
+    // Gleicher Text nach clear(): bemalt, aber unverändert, nichts zu übertragen
+    display.clear();
+    display.setCursor(0, 0);
+    display.println("Hallo");
+    CHECK_EQ(flush(display), 0);
+
+    // Zusätzliche Zeile weiter unten: nur deren Kachel
+    display.clear();
+    display.setCursor(0, 0);
+    display.println("Hallo");
+    display.setCursor(0, 100);
+    display.print((uint32_t)1234);
+    CHECK_EQ(flush(display), 1);
+    CHECK_EQ(panelDifferences(), 0);
+
+    // Löschen: beide Zeilen verschwinden
+    display.clear();
+    CHECK_EQ(flush(display), 2);
+    CHECK_EQ(panelDifferences(), 0);
+
+    // Rahmen um den ganzen Schirm: nur die Randkacheln
+    display.drawRect(0, 0, TFT_HOST_WIDTH, TFT_HOST_HEIGHT, TFT_WHITE);
+    CHECK_EQ(flush(display), 2 * TILES_X + 2 * TILES_Y - 4);
+    CHECK_EQ(panelDifferences(), 0);
+
+    // Vollbild und danach Löschen über fillScreen (bemalte Fläche >= 60 %)
+    display.clear();
+    flush(display);
+    display.fillRect(0, 0, TFT_HOST_WIDTH, TFT_HOST_HEIGHT, 0x1234);
+    CHECK_EQ(flush(display), TILES_X * TILES_Y);
+    display.clear();
+    CHECK_EQ(flush(display), TILES_X * TILES_Y);
+    CHECK_EQ(panelDifferences(), 0);
+    CHECK_EQ(hostPanel->pixel(400, 240), TFT_BLACK);
+}
+
+// Zufällige Zeichenfolgen: nach jedem Bild stimmt das Panel mit dem Framebuffer überein
+static void testRandomFrames() {
+    hostPsramAvailable = true;
+    WaveshareDisplay display;
+    display.begin();
+    std::mt19937 rng(18);
+    uint32_t mismatchedFrames = 0;
+    uint32_t tiles = 0;
+
+    for (int frame = 0; frame < 200; frame++) {
+        if (rng() % 3 == 0) {
+            display.clear();
+        }
+        int operations = 1 + rng() % 12;
+        for (int k = 0; k < operations; k++) {
+            int16_t x = (int16_t)(rng() % (TFT_HOST_WIDTH + 40)) - 20;
+            int16_t y = (int16_t)(rng() % (TFT_HOST_HEIGHT + 40)) - 20;
+            uint16_t color = (uint16_t)rng();
+            switch (rng() % 5) {
+                case 0:
+                    display.fillRect(x, y, (int16_t)(1 + rng() % 120), (int16_t)(1 + rng() % 60), color);
+                    break;
+                case 1:
+                    display.drawLine(x, y, (int16_t)(rng() % TFT_HOST_WIDTH), (int16_t)(rng() % TFT_HOST_HEIGHT), color);
+                    break;
+                case 2:
+                    display.drawRect(x, y, (int16_t)(2 + rng() % 300), (int16_t)(2 + rng() % 200), color);
+                    break;
+                case 3:
+                    display.setCursor((int16_t)(rng() % 700), (int16_t)(rng() % 460));
+                    display.setTextSize((uint8_t)(1 + rng() % 2));
+                    display.setTextColor(color);
+                    display.printf("Node %d: %s", (int)(rng() % 128), rng() % 2 ? "aktiv" : "aus");
+                    break;
+                default:
+                    display.setCursor((int16_t)(rng() % 700), (int16_t)(rng() % 400));
+                    display.println("Zeile 1\nZeile 2");
+                    break;
+            }
+        }
+        tiles += flush(display);
+        if (panelDifferences() != 0) {
+            mismatchedFrames++;
+        }
+    }
+    CHECK_EQ(mismatchedFrames, 0);
+    CHECK(tiles < 200 * TILES_X * TILES_Y);
+}
+
+static void testWithoutPsram() {
+    hostPsramAvailable = false;
+    hostFramebuffer = nullptr;
+    WaveshareDisplay display;
+    CHECK(display.begin());
+    CHECK_EQ(display.frameRate(), RENDER_TARGET_FPS);
+    CHECK(hostFramebuffer == nullptr);
+
+    display.fillRect(10, 10, 20, 20, 0x00F0);
+    CHECK_EQ(hostPanel->pixel(15, 15), 0x00F0);  // Sofort auf dem Panel
+    CHECK_EQ(flush(display), 0);
+    display.clear();
+    CHECK_EQ(hostPanel->pixel(15, 15), TFT_BLACK);
+    hostPsramAvailable = true;
+}
+
+int main() {
+    testTileFlush();
+    testRandomFrames();
+    testWithoutPsram();
+    return hostTestResult("WaveshareDisplayTest");
+}
@@ -26,6 +26,7 @@ extern void displayMenu();
 extern bool buttonActivity();
 extern void handleSerialCommands();
 extern void saveSettings();
+extern bool recreateCANInterface(int baudrateKbps);
 
 // Globale Variablen für die Baudratenerkennung
 static int currentBaudrateIndex = 0;
@@ -139,22 +140,12 @@ bool initializeForBaudrate(int baudrateKbps) {
     sprintf(message, "Teste %d kbps...", baudrateKbps);
     displayActionScreen("Auto-Baudrate", message, 1000);
     
-    // CAN-Interface neu initialisieren
-    if (canInterface != nullptr) {
-        canInterface->end();
-        delete canInterface;
-        canInterface = nullptr;
-    }
-    
-    // Neues Interface erstellen und initialisieren
-    canInterface = CANInterface::createInstance(currentCANTransceiverType);
-    if (canInterface == nullptr) {
-        Serial.println("[FEHLER] Konnte kein CAN-Interface erstellen");
-        return false;
-    }
-    
-    bool success = canInterface->begin(baudrateKbps * 1000);
-    if (!success) {
+    // CAN-Interface neu anlegen, CANopen neu verknüpfen und initialisieren
+    if (!recreateCANInterface(baudrateKbps)) {
+        if (canInterface == nullptr) {
+            Serial.println("[FEHLER] Konnte kein CAN-Interface erstellen");
+            return false;
+        }
         Serial.printf("[FEHLER] Konnte Interface nicht auf %d kbps initialisieren\n", baudrateKbps);
         return false;
     }
@@ -235,16 +226,7 @@ void finalizeBaudrateDetection(bool success) {
         currentBaudrate = 125;
         
         // CAN-Interface neu initialisieren mit Standard-Baudrate
-        if (canInterface != nullptr) {
-            canInterface->end();
-            delete canInterface;
-            canInterface = nullptr;
-        }
-        
-        canInterface = CANInterface::createInstance(currentCANTransceiverType);
-        if (canInterface != nullptr) {
-            canInterface->begin(currentBaudrate * 1000);
-        }
+        recreateCANInterface(currentBaudrate);
         
         // Fehlermeldung anzeigen
         displayActionScreen("Auto-Baudrate", "Keine Baudrate\nerkannt!", 2000);
@@ -261,4 +243,4 @@ void finalizeBaudrateDetection(bool success) {
     displayMenu();
     activeSource = SOURCE_BUTTON;
     lastActivityTime = millis();
-}
\ No newline at end of file
+}
\ No newline at end of file
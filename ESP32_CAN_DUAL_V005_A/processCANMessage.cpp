@@ -6,25 +6,61 @@
 #include <Arduino.h>
 #include "OLEDMenu.h"
 #include "CANopen.h"
+#include "CANopenClass.h"
 #include "CANInterface.h"
+#include "CANDispatcher.h"
+#include "CANFilter.h"
+#include "CANLog.h"
+#include "CANTraceTable.h"
+#include "CANTimestamp.h"
 #include "DisplayInterface.h"
 
 // Externe Variablen aus Hauptprogramm
 extern DisplayInterface* displayInterface;
 extern CANInterface* canInterface;
 extern bool liveMonitor;
-extern bool scanning;
 extern bool filterEnabled;
-extern uint32_t filterIdMin;
-extern uint32_t filterIdMax;
-extern uint8_t filterNodeId;
-extern bool filterNodeEnabled;
-extern uint8_t filterType;
+extern CANFilter monitorFilter;
+extern CANopen canopen;
 
 // Vorwärtsdeklarationen externer Funktionen
-extern void nodeFound(uint8_t nodeId);  // In processCANScanning.cpp implementiert
+extern void subscribeScanEngine(CANDispatcher& dispatcher);  // In processCANScanning.cpp implementiert
+extern uint16_t scanFunctionCodes();                         // In processCANScanning.cpp implementiert
+extern void subscribeBusStatistics(CANDispatcher& dispatcher); // In processCANStatistics.cpp implementiert
+extern void subscribeHeartbeatMonitor(CANDispatcher& dispatcher); // In processHeartbeatMonitor.cpp implementiert
+extern int getDisplayWidth();
+extern int getDisplayHeight();
+
+// Verteilung der empfangenen Frames an Scan-Engine, SDO-Client, Busstatistik und Live-Monitor
+CANDispatcher canDispatcher;
+static bool monitorPrinted = false;  // Vom Monitor-Verbraucher für den aktuellen Frame gesetzt
+
+// Log-Ausgabe des Live-Monitors (candump -L, ASC, SLCAN oder binär statt Klartext)
+#define CAN_LOG_DISPLAY_INTERVAL_MS 250  // Displayaktualisierung im Log-Modus
+static CANLogWriter monitorLog;
+
+// Tabellenansicht des Live-Monitors: eine Zeile je COB-ID, Neuzeichnen mit der Bildrate
+// von displayScheduler (OLED 10, TFT mit Framebuffer 25 Bilder pro Sekunde)
+#define CAN_TRACE_PAGE_INTERVAL_MS   2000  // Seitenwechsel, wenn nicht alle Zeilen passen
+static CANTraceTable traceTable;
+static bool traceView = false;
 
 // Hilfsfunktionen für die Dekodierung
+void initCANDispatcher();
+void updateHardwareFilter(bool verbose);
+bool startMonitorLog(CANLogFormat format, uint32_t serialBaud, bool verbose);
+void stopMonitorLog(bool verbose);
+void writeMonitorLog(const char* data, size_t len);
+void serviceMonitorLog();
+bool monitorLogActive();
+void setMonitorTraceView(bool enabled);
+bool monitorTraceViewActive();
+void clearTraceTable();
+void printTraceTable();
+void serviceTraceView();
+bool processCANFrame(CanFrame& frame);
+void forwardCANFrame(CanFrame& frame);
+bool printMonitorFrame(const CanFrame& frame);
 void decodeCANMessage(uint32_t rxId, uint8_t nodeId, uint16_t baseId, uint8_t* buf, uint8_t len);
 void decodeNMTState(uint8_t state);
 void decodeNMTCommand(uint8_t* buf, uint8_t len);
@@ -32,170 +68,340 @@ void decodeSDOResponse(uint8_t* buf, uint8_t len);
 void decodeSDOAbortCode(uint32_t abortCode);
 void displayCANMessage(uint32_t canId, uint8_t* data, uint8_t length);
 
-// CAN-Nachricht empfangen und verarbeiten
-void processCANMessage() {
-    if (!canInterface->messageAvailable()) {
+// Verbraucher: Antworten auf asynchrone SDO-Anfragen zuordnen
+static void onSDOClientFrame(const CanFrame& frame, void* context) {
+    static_cast<CANopen*>(context)->processFrame(frame);
+}
+
+// Verbraucher: Live-Monitor (alle Funktionscodes und Extended-Frames)
+static void onMonitorFrame(const CanFrame& frame, void* context) {
+    monitorPrinted = printMonitorFrame(frame);
+}
+
+// Verbraucher registrieren (einmalig aus setup()). Die Reihenfolge bestimmt die
+// Aufrufreihenfolge: Protokoll-Auswertung vor der Anzeige.
+void initCANDispatcher() {
+    canDispatcher.subscribe(CAN_FC_BIT(CAN_FC_TSDO), false, onSDOClientFrame, &canopen);
+    subscribeScanEngine(canDispatcher);
+    subscribeBusStatistics(canDispatcher);
+    subscribeHeartbeatMonitor(canDispatcher);
+    canDispatcher.subscribe(CAN_FC_ALL, true, onMonitorFrame, nullptr);
+}
+
+// ===================================================================================
+// Hardware-Akzeptanzfilter
+// Bei aktivem Anzeigefilter nimmt der Controller nur noch dessen Standard-IDs an, dazu
+// die Funktionscodes der übrigen Verbraucher: SDO-Antworten (SDO-Client), Heartbeat/
+// Boot-up (Node-ID-Wechsel, Heartbeat-Überwachung) und die Codes der Scan-Engine.
+// Neu berechnen nach Änderungen am Filter und am Interface.
+// ===================================================================================
+void updateHardwareFilter(bool verbose) {
+    if (canInterface == nullptr) {
         return;
     }
     
-    uint32_t rxId;
-    uint8_t ext = 0;
-    uint8_t len = 0;
-    uint8_t buf[8];
+    CANAcceptanceSet wanted;
+    if (filterEnabled) {
+        wanted.addBitmap(monitorFilter.standardBitmap());
+        if (monitorFilter.extendedRangeCount() > 0) {
+            wanted.addExtended();
+        }
+        wanted.addFunctionCodes(CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_NMT_EC) | scanFunctionCodes());
+    } else {
+        wanted.acceptAll();
+    }
     
-    // Nachricht lesen
-    if (!canInterface->receiveMessage(&rxId, &ext, &len, buf)) {
+    bool supported = canInterface->setAcceptanceFilter(wanted);
+    if (!verbose) {
         return;
     }
     
-    // Node-ID und Basis-ID (COBID ohne Node-ID) extrahieren
-    uint8_t nodeId = rxId & 0x7F;
-    uint16_t baseId = rxId & 0x780;
+    const CANHardwareFilterPlan& plan = canInterface->getAcceptanceFilter();
+    if (!supported) {
+        Serial.println("[INFO] Hardwarefilter: nicht verfügbar, Filterung nur in Software");
+    } else if (plan.acceptAll) {
+        Serial.println("[INFO] Hardwarefilter: aus (Controller nimmt alle Frames an)");
+    } else {
+        Serial.printf("[INFO] Hardwarefilter: %d von 2048 Standard-IDs passieren den Controller (%d benötigt)\n",
+                      plan.passedIds, wanted.standardCount());
+    }
+}
+
+// ===================================================================================
+// Log-Ausgabe des Live-Monitors
+// Die Zeilen gehen nur so weit an Serial, wie dessen Sendepuffer gerade Platz hat;
+// loop() bleibt damit auch bei vollem Bus und niedriger Baudrate frei. Was nicht mehr
+// in den Zwischenpuffer passt, wird verworfen und beim Beenden gemeldet.
+// Optional läuft die serielle Schnittstelle für die Dauer des Logs mit einer höheren
+// Baudrate (z.B. 921600 für das Binärformat bei stark belastetem Bus).
+// ===================================================================================
+static uint32_t logRestoreBaud = 0;     // Vorherige Baudrate, 0 = nicht umgestellt
+static uint32_t logRxOverruns = 0;      // Stand des Überlaufzählers beim letzten Burst
+static uint32_t logDisplayTime = 0;     // Letzte Displayaktualisierung im Log-Modus
+
+static size_t serialLogSink(const char* data, size_t len, void* context) {
+    int room = Serial.availableForWrite();
+    if (room <= 0) {
+        return 0;
+    }
+    if ((size_t)room < len) {
+        len = room;
+    }
+    return Serial.write((const uint8_t*)data, len);
+}
+
+const char* monitorLogFormatName(CANLogFormat format) {
+    switch (format) {
+        case CAN_LOG_CANDUMP:  return "candump -L";
+        case CAN_LOG_ASC:      return "Vector ASC";
+        case CAN_LOG_SLCAN:
+        case CAN_LOG_SLCAN_TS: return "SLCAN";
+        case CAN_LOG_BINARY:   return "Binär (COBS, CRC-16)";
+        default:               return "aus";
+    }
+}
+
+// Serielle Baudrate 0 = unverändert lassen. verbose = Start-/Endmeldung im Klartext
+// (nicht im SLCAN-Betrieb, dort versteht die Gegenstelle nur Lawicel-Antworten).
+bool startMonitorLog(CANLogFormat format, uint32_t serialBaud, bool verbose) {
+    if (monitorLog.active()) {
+        stopMonitorLog(verbose);
+    }
+    if (format == CAN_LOG_OFF) {
+        return false;
+    }
     
-    // Filter anwenden
-    if (filterEnabled) {
-        bool passFilter = true;
-        
-        // ID-Filter
-        if (rxId < filterIdMin || rxId > filterIdMax) {
-            passFilter = false;
-        }
-        
-        // Node-Filter
-        if (filterNodeEnabled && nodeId != filterNodeId) {
-            passFilter = false;
-        }
-        
-        // Typ-Filter (PDO, SDO, EMCY, NMT, Heartbeat)
-        if (filterType > 0) {
-            switch (filterType) {
-                case 1: // PDO Filter
-                    if (!(baseId >= 0x180 && baseId <= 0x500)) {
-                        passFilter = false;
-                    }
-                    break;
-                case 2: // SDO Filter
-                    if (!(baseId == 0x580 || baseId == 0x600)) {
-                        passFilter = false;
-                    }
-                    break;
-                case 3: // EMCY Filter
-                    if (baseId != 0x080) {
-                        passFilter = false;
-                    }
-                    break;
-                case 4: // NMT Filter
-                    if (rxId != 0x000) {
-                        passFilter = false;
-                    }
-                    break;
-                case 5: // Heartbeat Filter
-                    if (baseId != 0x700) {
-                        passFilter = false;
-                    }
-                    break;
-            }
-        }
-        
-        // Wenn der Filter nicht bestanden wurde, Nachricht überspringen
-        if (!passFilter) {
-            return;
+    if (verbose) {
+        Serial.printf("[INFO] Log-Ausgabe: %s (Zeitstempel seit dem Start, monitor off beendet)\n",
+                      monitorLogFormatName(format));
+        if (serialBaud > 0) {
+            Serial.printf("[INFO] Serielle Baudrate für das Log: %lu\n", (unsigned long)serialBaud);
         }
     }
+    Serial.flush();
+    if (serialBaud > 0 && serialBaud != Serial.baudRate()) {
+        logRestoreBaud = Serial.baudRate();
+        Serial.updateBaudRate(serialBaud);
+    }
     
-    // Im Scan-Modus: Prüfen ob es eine Antwort eines gescannten Nodes ist
-    if (scanning) {
-        // Antworten, die einen Node identifizieren können:
-        
-        // 1. SDO-Antwort
-        if (baseId == 0x580) {
-            nodeFound(nodeId);
-        }
-        
-        // 2. Heartbeat
-        else if (baseId == 0x700) {
-            nodeFound(nodeId);
-        }
-        
-        // 3. Emergency
-        else if (baseId == 0x080) {
-            nodeFound(nodeId);
+    monitorLog.setSink(serialLogSink, nullptr);
+    monitorLog.begin(format, canTimestampUs());
+    logRxOverruns = canInterface != nullptr ? canInterface->getRxOverrunCount() : 0;
+    liveMonitor = true;
+    return true;
+}
+
+void stopMonitorLog(bool verbose) {
+    if (!monitorLog.active()) {
+        return;
+    }
+    
+    monitorLog.end();
+    uint32_t start = millis();
+    while (monitorLog.flush() > 0 && millis() - start < 500) {
+        delay(1);
+    }
+    Serial.flush();
+    if (logRestoreBaud > 0) {
+        Serial.updateBaudRate(logRestoreBaud);
+        logRestoreBaud = 0;
+    }
+    
+    if (verbose) {
+        Serial.printf("\n[INFO] Log-Ausgabe beendet: %lu Frames, %lu verworfen\n",
+                      (unsigned long)monitorLog.loggedCount(), (unsigned long)monitorLog.droppedCount());
+    }
+}
+
+// Daten in den Ausgabestrom einreihen (SLCAN-Antworten zwischen den Frame-Zeilen)
+void writeMonitorLog(const char* data, size_t len) {
+    monitorLog.setSink(serialLogSink, nullptr);
+    monitorLog.append(data, len);
+    monitorLog.flush();
+}
+
+// Aus loop(): Rest der Log-Zeilen ausgeben, auch wenn keine neuen Frames kommen
+void serviceMonitorLog() {
+    if (monitorLog.pending() > 0) {
+        monitorLog.flush();
+    }
+}
+
+// Serielle Ausgabe gehört dem Log (Klartextmeldungen würden die Parser stören)
+bool monitorLogActive() {
+    return monitorLog.active();
+}
+
+// CAN-Nachrichten empfangen und verarbeiten
+// Holt pro Aufruf einen ganzen Burst aus dem Empfangspuffer. Das Display wird nur
+// einmal pro Burst mit dem zuletzt angezeigten Frame aktualisiert.
+void processCANMessage() {
+    CanFrame frames[CAN_RX_BURST_SIZE];
+    size_t count = canInterface->receiveBurst(frames, CAN_RX_BURST_SIZE, 0);
+    
+    // Empfangsüberlauf vor diesem Burst im Log markieren
+    if (monitorLog.active()) {
+        uint32_t overruns = canInterface->getRxOverrunCount();
+        if (overruns != logRxOverruns) {
+            logRxOverruns = overruns;
+            monitorLog.markGap();
         }
-        
-        // 4. PDO (mit einiger Vorsicht, könnten auch andere sein)
-        else if (baseId >= 0x180 && baseId <= 0x480 && baseId % 0x100 == 0x80) {
-            nodeFound(nodeId);
+    }
+    
+    CanFrame* lastShown = nullptr;
+    for (size_t i = 0; i < count; i++) {
+        if (processCANFrame(frames[i])) {
+            lastShown = &frames[i];
         }
     }
     
-    // Im LiveMonitor-Modus: Nachricht ausgeben
-    if (liveMonitor) {
-        // Formatierte Ausgabe im seriellen Monitor
-        Serial.printf("[CAN] ID: 0x%03X Len: %d → ", rxId, len);
-        for (int i = 0; i < len; i++) {
-            Serial.printf("%02X ", buf[i]);
+    // Log-Zeilen des ganzen Bursts in einem Block ausgeben
+    if (monitorLog.pending() > 0) {
+        monitorLog.flush();
+    }
+    
+    // Tabellenansicht: gezeichnet wird unabhängig vom Empfang in serviceTraceView()
+    if (traceView) {
+        lastShown = nullptr;
+    }
+    
+    // Im Log-Modus zählt der Durchsatz: Display höchstens alle CAN_LOG_DISPLAY_INTERVAL_MS
+    if (lastShown != nullptr && monitorLog.active()) {
+        if (millis() - logDisplayTime < CAN_LOG_DISPLAY_INTERVAL_MS) {
+            lastShown = nullptr;
+        } else {
+            logDisplayTime = millis();
         }
-        
-        // Bekannte Nachrichtentypen dekodieren und interpretieren
-        decodeCANMessage(rxId, nodeId, baseId, buf, len);
-        
-        Serial.println(); // Zeilenumbruch nach der Dekodierung
-        
-        // Nachricht auf dem Display anzeigen
-        displayCANMessage(rxId, buf, len);
     }
+    
+    // Nachricht auf dem Display anzeigen
+    if (lastShown != nullptr) {
+        displayCANMessage(lastShown->id, lastShown->data, lastShown->len);
+    }
+}
+
+// Einzelnen Frame an alle interessierten Verbraucher verteilen.
+// Liefert true, wenn der Frame im Live-Monitor ausgegeben wurde.
+bool processCANFrame(CanFrame& frame) {
+    monitorPrinted = false;
+    canDispatcher.dispatch(frame);
+    return monitorPrinted;
+}
+
+// Live-Monitor: Filter anwenden und Frame seriell ausgeben.
+// Liefert true, wenn der Frame ausgegeben wurde.
+bool printMonitorFrame(const CanFrame& frame) {
+    if (!liveMonitor) {
+        return false;
+    }
+    
+    uint32_t rxId = frame.id;
+    uint8_t len = frame.len;
+    
+    // Node-ID und Basis-ID (COBID ohne Node-ID) extrahieren
+    uint8_t nodeId = rxId & 0x7F;
+    uint16_t baseId = rxId & 0x780;
+    
+    // Kompilierter Anzeigefilter: ein Bit-Zugriff pro Frame
+    if (filterEnabled && !monitorFilter.accepts(frame)) {
+        return false;
+    }
+    
+    if (traceView) {
+        traceTable.update(frame);
+    }
+    
+    // Log-Modus: eine maschinenlesbare Zeile, ausgegeben wird am Ende des Bursts
+    if (monitorLog.active()) {
+        return monitorLog.log(frame);
+    }
+    
+    // Formatierte Ausgabe im seriellen Monitor (Empfangszeit in Sekunden seit dem Start)
+    CanFrame shown = frame;
+    Serial.printf("[CAN] %lu.%06lu ID: 0x%03X Len: %d → ",
+                  (unsigned long)(frame.timestamp / 1000000), (unsigned long)(frame.timestamp % 1000000),
+                  rxId, len);
+    for (int i = 0; i < len; i++) {
+        Serial.printf("%02X ", shown.data[i]);
+    }
+    
+    // Bekannte Nachrichtentypen dekodieren und interpretieren
+    decodeCANMessage(rxId, nodeId, baseId, shown.data, len);
+    
+    Serial.println(); // Zeilenumbruch nach der Dekodierung
+    return true;
+}
+
+// Frame-Handler für blockierende SDO-Aufrufe (CANopen::setFrameHandler):
+// Frames, die während des Wartens eintreffen, laufen normal durch den Live-Monitor
+void forwardCANFrame(CanFrame& frame) {
+    processCANFrame(frame);
 }
 
-// Dekodierung einer CAN-Nachricht
+// Dekodierung einer CAN-Nachricht (Verzweigung über den Funktionscode)
 void decodeCANMessage(uint32_t rxId, uint8_t nodeId, uint16_t baseId, uint8_t* buf, uint8_t len) {
-    // Bekannte CANopen-Nachrichtentypen identifizieren und interpretieren
-    if (rxId == 0x000) {
-        Serial.print("  [NMT Broadcast]");
-        decodeNMTCommand(buf, len);
-    } 
-    else if (baseId == 0x080) {
-        Serial.printf("  [Emergency von Node %d]", nodeId);
-        if (len >= 2) {
-            uint16_t errorCode = buf[0] | (buf[1] << 8);
-            Serial.printf(" Error: 0x%04X", errorCode);
-        }
-    } 
-    else if (rxId == 0x080) {
-        Serial.print("  [SYNC]");
-    } 
-    else if (rxId == 0x100) {
-        Serial.print("  [TIME]");
-    } 
-    else if (baseId >= 0x180 && baseId <= 0x480 && baseId % 0x100 == 0x80) {
-        // TPDOs
-        int pdoNumber = (baseId - 0x180) / 0x100 + 1;
-        Serial.printf("  [PDO%d von Node %d]", pdoNumber, nodeId);
-    } 
-    else if (baseId >= 0x200 && baseId <= 0x500 && baseId % 0x100 == 0x00) {
-        // RPDOs
-        int pdoNumber = (baseId - 0x200) / 0x100 + 1;
-        Serial.printf("  [RPDO%d an Node %d]", pdoNumber, nodeId);
-    } 
-    else if (baseId == 0x580) {
-        Serial.printf("  [SDO Response von Node %d]", nodeId);
-        decodeSDOResponse(buf, len);
-    } 
-    else if (baseId == 0x600) {
-        Serial.printf("  [SDO Request an Node %d]", nodeId);
-    } 
-    else if (baseId == 0x700) {
-        if (len > 0) {
-            if (buf[0] == 0x00) {
-                Serial.printf("  [Bootup von Node %d]", nodeId);
+    if (rxId > 0x7FF) {
+        Serial.printf("  [Unbekannte Nachricht]");
+        return;
+    }
+    
+    uint8_t functionCode = canFunctionCode(rxId);
+    switch (functionCode) {
+        case CAN_FC_NMT:
+            if (rxId == 0x000) {
+                Serial.print("  [NMT Broadcast]");
+                decodeNMTCommand(buf, len);
             } else {
-                Serial.printf("  [Heartbeat von Node %d]", nodeId);
-                decodeNMTState(buf[0]);
+                Serial.printf("  [Unbekannte Nachricht]");
             }
-        }
-    } 
-    else {
-        // Unbekannter CAN-ID-Bereich
-        Serial.printf("  [Unbekannte Nachricht]");
+            break;
+        case CAN_FC_SYNC_EMCY:
+            if (nodeId == 0) {
+                Serial.print("  [SYNC]");
+            } else {
+                Serial.printf("  [Emergency von Node %d]", nodeId);
+                if (len >= 2) {
+                    uint16_t errorCode = buf[0] | (buf[1] << 8);
+                    Serial.printf(" Error: 0x%04X", errorCode);
+                }
+            }
+            break;
+        case CAN_FC_TIME:
+            Serial.print("  [TIME]");
+            break;
+        case CAN_FC_TPDO1:
+        case CAN_FC_TPDO2:
+        case CAN_FC_TPDO3:
+        case CAN_FC_TPDO4:
+            Serial.printf("  [PDO%d von Node %d]", (functionCode - CAN_FC_TPDO1) / 2 + 1, nodeId);
+            break;
+        case CAN_FC_RPDO1:
+        case CAN_FC_RPDO2:
+        case CAN_FC_RPDO3:
+        case CAN_FC_RPDO4:
+            Serial.printf("  [RPDO%d an Node %d]", (functionCode - CAN_FC_RPDO1) / 2 + 1, nodeId);
+            break;
+        case CAN_FC_TSDO:
+            Serial.printf("  [SDO Response von Node %d]", nodeId);
+            decodeSDOResponse(buf, len);
+            break;
+        case CAN_FC_RSDO:
+            Serial.printf("  [SDO Request an Node %d]", nodeId);
+            break;
+        case CAN_FC_NMT_EC:
+            if (len > 0) {
+                if (buf[0] == 0x00) {
+                    Serial.printf("  [Bootup von Node %d]", nodeId);
+                } else {
+                    Serial.printf("  [Heartbeat von Node %d]", nodeId);
+                    decodeNMTState(buf[0]);
+                }
+            }
+            break;
+        default:
+            // Unbekannter CAN-ID-Bereich
+            Serial.printf("  [Unbekannte Nachricht]");
+            break;
     }
 }
 
@@ -289,6 +495,16 @@ void decodeSDOResponse(uint8_t* buf, uint8_t len) {
                 decodeSDOAbortCode(abortCode);
             }
             break;
+        case 5: // Block download response
+            if ((buf[0] & 0x03) == 2) {
+                Serial.printf(" (Block-Download Quittung, Seq %d, Blockgröße %d)", buf[1], buf[2]);
+            } else {
+                Serial.print((buf[0] & 0x03) == 1 ? " (Block-Download Ende)" : " (Block-Download Start)");
+            }
+            break;
+        case 6: // Block upload response
+            Serial.print((buf[0] & 0x01) ? " (Block-Upload Ende)" : " (Block-Upload Start)");
+            break;
         default:
             Serial.printf(" (Unbekannter CS: %d)", commandSpecifier);
     }
@@ -371,12 +587,33 @@ void decodeSDOAbortCode(uint32_t abortCode) {
     }
 }
 
-// CAN-Nachricht auf dem Display anzeigen
+// CAN-Nachricht auf dem Display anzeigen: nur vormerken, gezeichnet wird der zuletzt
+// vorgemerkte Frame mit der Bildrate von displayScheduler
+static CanFrame displayedFrame;
+
+static void renderCANMessage(void* context);
+
 void displayCANMessage(uint32_t canId, uint8_t* data, uint8_t length) {
     if (displayInterface == nullptr || !liveMonitor) {
         return;
     }
     
+    displayedFrame.id = canId;
+    displayedFrame.len = length > 8 ? 8 : length;
+    memcpy(displayedFrame.data, data, displayedFrame.len);
+    displayScheduler.request(renderCANMessage, nullptr);
+}
+
+static void renderCANMessage(void* context) {
+    // Ansicht inzwischen verlassen (Monitor aus oder Tabellenansicht)
+    if (displayInterface == nullptr || !liveMonitor || traceView) {
+        return;
+    }
+    
+    uint32_t canId = displayedFrame.id;
+    uint8_t* data = displayedFrame.data;
+    uint8_t length = displayedFrame.len;
+    
     // Display leeren
     displayInterface->clear();
     
@@ -436,4 +673,190 @@ void displayCANMessage(uint32_t canId, uint8_t* data, uint8_t length) {
     
     // Display aktualisieren
     displayInterface->display();
-}
\ No newline at end of file
+}
+
+// ===================================================================================
+// Tabellenansicht (Trace-Tabelle)
+// Der Empfang aktualisiert nur die Tabelle; serviceTraceView() zeichnet höchstens mit der
+// Bildrate von displayScheduler neu und nur, wenn sich etwas geändert hat. Geänderte
+// Bytes werden invertiert dargestellt, bis ihre Markierung abläuft.
+// ===================================================================================
+static uint32_t traceRenderTime = 0;
+static uint32_t traceRenderedVersion = 0;
+static bool traceRenderedHighlight = false;  // Beim letzten Zeichnen war etwas markiert
+static size_t traceRenderedPage = 0;
+
+void setMonitorTraceView(bool enabled) {
+    traceView = enabled;
+    traceRenderedVersion = traceTable.version() - 1;  // Beim nächsten Aufruf zeichnen
+}
+
+bool monitorTraceViewActive() {
+    return traceView;
+}
+
+void clearTraceTable() {
+    traceTable.clear();
+}
+
+// Hex-Bytes ohne printf; out muss 3 * count + 1 Zeichen fassen
+static void formatTraceBytes(const CANTraceRow& row, uint8_t count, char* out, bool spaced) {
+    static const char hex[] = "0123456789ABCDEF";
+    for (uint8_t i = 0; i < count; i++) {
+        *out++ = hex[row.data[i] >> 4];
+        *out++ = hex[row.data[i] & 0x0F];
+        if (spaced) {
+            *out++ = ' ';
+        }
+    }
+    *out = '\0';
+}
+
+static bool drawTraceTable(size_t page) {
+    const int width = getDisplayWidth();
+    const int height = getDisplayHeight();
+    const int charWidth = 6;
+    const int lineHeight = 8;
+    const int top = 12;
+    const bool wide = width / charWidth >= 48;  // Platz für Anzahl und Periode
+    const size_t rowsPerPage = (height - top) / lineHeight;
+    
+    uint8_t order[CAN_TRACE_MAX_ROWS];
+    size_t count = traceTable.sortedRows(order);
+    size_t pages = count == 0 ? 1 : (count + rowsPerPage - 1) / rowsPerPage;
+    if (page >= pages) {
+        page = 0;
+    }
+    
+    uint64_t now = canTimestampUs();
+    bool anyHighlight = false;
+    char text[40];
+    
+    displayInterface->clear();
+    displayInterface->setTextSize(1);
+    displayInterface->setTextColor(1);
+    displayInterface->setCursor(0, 0);
+    if (pages > 1) {
+        displayInterface->printf("Trace %u IDs  %u/%u", (unsigned)count, (unsigned)(page + 1), (unsigned)pages);
+    } else {
+        displayInterface->printf("Trace %u IDs", (unsigned)count);
+    }
+    displayInterface->drawLine(0, 10, width, 10, 1);
+    
+    size_t first = page * rowsPerPage;
+    for (size_t line = 0; line < rowsPerPage && first + line < count; line++) {
+        const CANTraceRow& row = traceTable.row(order[first + line]);
+        int y = top + line * lineHeight;
+        
+        // ID: 3 Stellen (Standard) bzw. 8 Stellen (Extended)
+        if (row.ext) {
+            snprintf(text, sizeof(text), "%08lX", (unsigned long)row.id);
+        } else {
+            snprintf(text, sizeof(text), "%03lX", (unsigned long)row.id);
+        }
+        displayInterface->setCursor(0, y);
+        displayInterface->print(text);
+        
+        // Datenbytes; auf dem schmalen Display ohne Leerzeichen und nur so viele, wie in
+        // die Zeile passen (kein Umbruch)
+        int dataX = (wide ? 10 : (row.ext ? 9 : 4)) * charWidth;
+        int byteStep = (wide ? 3 : 2) * charWidth;
+        uint8_t shown = row.len;
+        if (!wide && dataX + shown * byteStep > width) {
+            shown = (width - dataX) / byteStep;
+        }
+        formatTraceBytes(row, shown, text, wide);
+        displayInterface->setCursor(dataX, y);
+        displayInterface->print(text);
+        
+        uint8_t highlighted = row.highlighted(now);
+        for (uint8_t i = 0; i < shown && highlighted != 0; i++) {
+            if (highlighted & (1 << i)) {
+                char byteText[3] = {text[i * (wide ? 3 : 2)], text[i * (wide ? 3 : 2) + 1], '\0'};
+                displayInterface->fillRect(dataX + i * byteStep, y - 1, 2 * charWidth, lineHeight, 1);
+                displayInterface->setTextColor(0);
+                displayInterface->setCursor(dataX + i * byteStep, y);
+                displayInterface->print(byteText);
+                displayInterface->setTextColor(1);
+                anyHighlight = true;
+            }
+        }
+        
+        // Anzahl und Periode (ms) nur auf breiten Displays
+        if (wide) {
+            snprintf(text, sizeof(text), "%8lu %6lu.%lu ms", (unsigned long)row.count,
+                     (unsigned long)(row.period / 1000), (unsigned long)(row.period % 1000 / 100));
+            displayInterface->setCursor(35 * charWidth, y);
+            displayInterface->print(text);
+        }
+    }
+    
+    displayInterface->display();
+    return anyHighlight;
+}
+
+static void renderTraceView(void* context) {
+    if (!traceView || !liveMonitor || displayInterface == nullptr) {
+        return;
+    }
+    traceRenderedHighlight = drawTraceTable(traceRenderedPage);
+}
+
+// Aus loop(): Tabelle mit fester Rate neu zeichnen, unabhängig von der Frame-Rate
+void serviceTraceView() {
+    if (!traceView || !liveMonitor || displayInterface == nullptr) {
+        return;
+    }
+    if (millis() - traceRenderTime < 1000U / displayScheduler.frameRate()) {
+        return;
+    }
+    
+    const size_t rowsPerPage = (getDisplayHeight() - 12) / 8;
+    size_t pages = (traceTable.rowCount() + rowsPerPage - 1) / rowsPerPage;
+    size_t page = pages > 1 ? (millis() / CAN_TRACE_PAGE_INTERVAL_MS) % pages : 0;
+    
+    // Neu zeichnen bei neuen Daten, Seitenwechsel oder ablaufenden Markierungen
+    if (traceTable.version() == traceRenderedVersion && page == traceRenderedPage && !traceRenderedHighlight) {
+        return;
+    }
+    
+    traceRenderTime = millis();
+    traceRenderedVersion = traceTable.version();
+    traceRenderedPage = page;
+    displayScheduler.request(renderTraceView, nullptr);
+}
+
+// Momentaufnahme der Tabelle auf Serial ("monitor table"); geänderte Bytes mit '*'
+void printTraceTable() {
+    uint8_t order[CAN_TRACE_MAX_ROWS];
+    size_t count = traceTable.sortedRows(order);
+    if (count == 0) {
+        Serial.println("[INFO] Trace-Tabelle ist leer (monitor view table und monitor on)");
+        return;
+    }
+    
+    uint64_t now = canTimestampUs();
+    Serial.println("[TRACE] COB-ID     DLC Daten                            Anzahl  Periode (ms)");
+    for (size_t i = 0; i < count; i++) {
+        const CANTraceRow& row = traceTable.row(order[i]);
+        if (row.ext) {
+            Serial.printf("[TRACE] 0x%08lX %u  ", (unsigned long)row.id, row.len);
+        } else {
+            Serial.printf("[TRACE] 0x%03lX      %u  ", (unsigned long)row.id, row.len);
+        }
+        uint8_t highlighted = row.highlighted(now);
+        for (uint8_t b = 0; b < 8; b++) {
+            if (b < row.len) {
+                Serial.printf("%02X%c ", row.data[b], (highlighted & (1 << b)) ? '*' : ' ');
+            } else {
+                Serial.print("    ");
+            }
+        }
+        Serial.printf("%8lu %7lu.%lu\n", (unsigned long)row.count,
+                      (unsigned long)(row.period / 1000), (unsigned long)(row.period % 1000 / 100));
+    }
+    if (traceTable.untrackedFrames() > 0) {
+        Serial.printf("[INFO] %lu Frames ohne Zeile (Tabelle voll, %d IDs)\n",
+                      (unsigned long)traceTable.untrackedFrames(), CAN_TRACE_MAX_ROWS);
+    }
+}
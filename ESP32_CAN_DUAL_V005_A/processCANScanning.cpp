@@ -8,6 +8,8 @@
 #include "CANopen.h"
 #include "CANopenClass.h"
 #include "CANInterface.h"
+#include "CANScanEngine.h"
+#include "CANDispatcher.h"
 #include "DisplayInterface.h"
 
 // Externe Variablen aus Hauptprogramm
@@ -25,130 +27,92 @@ extern void handleSerialCommands();
 extern bool buttonActivity();
 extern void displayMenu();
 extern void displayActionScreen(const char* title, const char* message, int timeout);
+extern void processCANMessage();
 
 // Globale Variablen für den Scan-Prozess
-static uint8_t currentNode = 0;
-static unsigned long lastScanTime = 0;
-static int currentAttempt = 0;
-static const int maxAttempts = 3;
-static const int nodeTimeout = 100; // ms Timeout pro Node
-static int foundNodes = 0;
+static CANScanEngine scanEngine;
+static bool scanStarted = false;
+
+// Scan-Modus für den nächsten Scan (setScanMode); nach jedem Scan wieder aktiv
+static uint16_t scanListenMs = 0;
+static bool scanProbe = true;
+
+// Antwortzeit pro SDO-Anfrage (scan timeout); gilt für alle folgenden Scans
+static uint16_t scanTimeoutMs = SCAN_DEFAULT_TIMEOUT_MS;
+
+// Funktionscodes, an denen die Engine einen Node erkennt: SDO-Antworten, Heartbeat/
+// Boot-up, EMCY und TPDOs (unabhängig vom Anzeigefilter des Live-Monitors)
+static const uint16_t scanEngineCodes = CAN_FC_BIT(CAN_FC_TSDO) | CAN_FC_BIT(CAN_FC_NMT_EC) |
+                                        CAN_FC_BIT(CAN_FC_SYNC_EMCY) | CAN_FC_TPDOS;
 
 // Vorwärtsdeklaration der internen Funktionen
 void initializeScan();
-void processSingleNode();
 void finalizeScan();
-bool sendCANMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf);
+void setScanMode(uint16_t listenMs, bool probe);
+void setScanTimeout(uint16_t timeoutMs);
+uint16_t getScanTimeout();
+void beginScanEngine(uint8_t firstId, uint8_t lastId, uint16_t listenMs = 0, bool probe = true);
+bool serviceScanEngine();
+bool onScanSendRequest(const CanFrame& frame, void* context);
+void onScanTxComplete(const CanFrame& frame, bool success, void* context);
+void onScanNodeFound(uint8_t nodeId, ScanFoundVia via, void* context);
+static void renderScanProgress(void* context);
+void subscribeScanEngine(CANDispatcher& dispatcher);
+uint16_t scanFunctionCodes();
+
+static char scanProgressMessage[32];  // Zuletzt gemeldeter Fund für die Anzeige
 
-// CAN-Scan-Prozess
+// CAN-Scan-Prozess (nicht blockierend, wird aus loop() bzw. startNodeScan() aufgerufen)
 void processCANScanning() {
     // Initialisierung beim Start des Scans
-    if (currentNode == 0) {
+    if (!scanStarted) {
         initializeScan();
     }
     
-    // Aktuelle Zeit für Timeout-Berechnung
-    unsigned long currentTime = millis();
+    serviceScanEngine();
     
-    // Prüfen, ob Timeout für den aktuellen Node abgelaufen ist
-    if (currentTime - lastScanTime > nodeTimeout) {
-        processSingleNode();
+    if (scanEngine.isDone()) {
+        finalizeScan();
     }
-    
-    // Auf Antwort warten wird in der loop() gehandhabt über processCANMessage()
 }
 
 // Initialisierung des Scans
 void initializeScan() {
-    currentNode = scanStart;
-    lastScanTime = millis();
-    currentAttempt = 0;
-    foundNodes = 0;
-    
     Serial.print("[SCAN] Starte Node-Scan von ");
     Serial.print(scanStart);
     Serial.print(" bis ");
     Serial.println(scanEnd);
     
-    // Display-Anzeige aktualisieren
-    char message[50];
-    sprintf(message, "Scanne Node %d...", currentNode);
-    displayActionScreen("Node-Scan", message, 1000);
-}
-
-// Verarbeitung eines einzelnen Knotens
-void processSingleNode() {
-    // Versuche erhöhen
-    currentAttempt++;
-    
-    // Maximale Anzahl Versuche erreicht?
-    if (currentAttempt >= maxAttempts) {
-        // Zum nächsten Node weitergehen
-        currentAttempt = 0;
-        currentNode++;
-        
-        // Display-Anzeige aktualisieren, wenn wir noch im Bereich sind
-        if (currentNode <= scanEnd) {
-            char message[50];
-            sprintf(message, "Scanne Node %d", currentNode);
-            displayActionScreen("Node-Scan", message, 1000);
-        }
-        
-        // Ende des Scan-Bereichs erreicht?
-        if (currentNode > scanEnd) {
-            finalizeScan();
-            return;
-        }
-    }
-    
-    // Zeit zurücksetzen für nächsten Versuch oder nächsten Node
-    lastScanTime = millis();
-    
-    // Node nur abfragen, wenn wir noch im Scan-Modus sind
-    if (!scanning) {
-        return;
+    if (scanListenMs > 0) {
+        Serial.printf("[SCAN] Passive Hörphase: %u ms%s\n", scanListenMs,
+                      scanProbe ? ", danach Abfrage nicht gesehener IDs" : " (kein Sendeverkehr)");
     }
     
-    // SDO-Leseanfragen für verschiedene wichtige Objekte probieren
-    uint16_t objectIndexes[] = {0x1000, 0x1001, 0x1018}; // Gerätetyp, Fehlerregister, Identität
-    uint8_t objectIndex = currentAttempt % 3; // Rotiere durch die Objekte
-    
-    // SDO-Leseanfrage vorbereiten
-    uint8_t sdo[8] = {
-        0x40, // SDO Read Request
-        (uint8_t)(objectIndexes[objectIndex] & 0xFF), // Index Low Byte
-        (uint8_t)(objectIndexes[objectIndex] >> 8),  // Index High Byte
-        0x00, // Subindex
-        0x00, 0x00, 0x00, 0x00 // Reserviert/Ungenutzt
-    };
-    
-    // Request senden
-    uint32_t cobId = 0x600 + currentNode; // SDO Transmit = 0x600 + NodeID
-    bool success = sendCANMessage(cobId, 0, 8, sdo);
-    
-    if (!success) {
-        Serial.printf("[DEBUG] Sendefehler bei Node %d, Versuch %d\n", currentNode, currentAttempt);
-    }
+    // Display-Anzeige aktualisieren
+    char message[50];
+    sprintf(message, "Scanne Nodes %d-%d...", scanStart, scanEnd);
+    displayActionScreen("Node-Scan", message, 0);
     
-    // Alternativ versuchen wir auch, ob der Knoten auf ein NMT Start Commando reagiert
-    if (currentAttempt == 0) {
-        // NMT Start Remote Node Command
-        uint8_t nmt[2] = {0x01, (uint8_t)currentNode};
-        sendCANMessage(0x000, 0, 2, nmt); // NMT COB-ID = 0x000
-    }
+    beginScanEngine(scanStart, scanEnd, scanListenMs, scanProbe);
+    scanStarted = true;
 }
 
 // Abschluss des Scans
 void finalizeScan() {
     scanning = false;
-    currentNode = 0;
+    scanStarted = false;
+    displayScheduler.cancel();  // Noch nicht gezeichneten Fortschritt verwerfen
     
-    Serial.print("[SCAN] Scan abgeschlossen. Gefundene Nodes: ");
-    Serial.println(foundNodes);
+    Serial.printf("[SCAN] Scan abgeschlossen. Gefundene Nodes: %d (%d passiv, %d Anfragen, %lu ms)\n",
+                  scanEngine.foundCount(), scanEngine.passiveFoundCount(),
+                  scanEngine.requestsSent(), (unsigned long)scanEngine.elapsedMs());
+    
+    // Nächster Scan wieder als aktiver Scan
+    setScanMode(0, true);
     
     // Erfolgsmeldung anzeigen
     char message[50];
-    sprintf(message, "Scan abgeschlossen\n%d Nodes gefunden", foundNodes);
+    sprintf(message, "Scan abgeschlossen\n%d Nodes gefunden", scanEngine.foundCount());
     displayActionScreen("Node-Scan", message, 2000);
     
     // Nach dem Scan zum Menü zurückkehren
@@ -157,47 +121,121 @@ void finalizeScan() {
     lastActivityTime = millis();
 }
 
-// Hilfsfunktion zum Senden einer CAN-Nachricht
-bool sendCANMessage(uint32_t id, uint8_t ext, uint8_t len, uint8_t *buf) {
+// ===================================================================================
+// Anbindung der Scan-Engine an das CAN-Interface
+// Wird auch vom blockierenden scanNodes() im Hauptprogramm verwendet.
+// ===================================================================================
+
+// Modus für den nächsten Scan festlegen (listenMs = 0: sofort aktiv abfragen)
+void setScanMode(uint16_t listenMs, bool probe) {
+    scanListenMs = listenMs;
+    scanProbe = probe;
+}
+
+// Antwortzeit pro SDO-Anfrage für alle folgenden Scans festlegen
+void setScanTimeout(uint16_t timeoutMs) {
+    scanTimeoutMs = timeoutMs;
+}
+
+uint16_t getScanTimeout() {
+    return scanTimeoutMs;
+}
+
+// Scan-Engine für einen Bereich starten
+void beginScanEngine(uint8_t firstId, uint8_t lastId, uint16_t listenMs, bool probe) {
+    // Alte Antworten aus dem Empfangspuffer verwerfen
+    if (canInterface != nullptr) {
+        CanFrame stale[CAN_RX_BURST_SIZE];
+        while (canInterface->receiveBurst(stale, CAN_RX_BURST_SIZE, 0) > 0) {
+        }
+    }
+    
+    scanEngine.setSender(onScanSendRequest, nullptr);
+    scanEngine.setFoundCallback(onScanNodeFound, nullptr);
+    CANScanEngine::Config config = CANScanEngine::listenConfig(firstId, lastId, listenMs, probe);
+    config.timeoutMs = scanTimeoutMs;
+    scanEngine.begin(config, millis());
+}
+
+// Einen Schritt ausführen: Sendequeue bedienen, Antworten auswerten, Fenster auffüllen.
+// Liefert true, solange der Scan läuft.
+bool serviceScanEngine() {
     if (canInterface == nullptr) {
-        Serial.println("[FEHLER] CAN-Interface nicht initialisiert");
+        scanEngine.cancel();
         return false;
     }
     
-    return canInterface->sendMessage(id, ext, len, buf);
-}
-
-// Callback-Funktion für gefundene Nodes (wird aus processCANMessage aufgerufen)
-void nodeFound(uint8_t nodeId) {
-    // Nur zählen, wenn innerhalb des Scan-Bereichs
-    if (scanning && nodeId >= scanStart && nodeId <= scanEnd) {
-        foundNodes++;
-        
-        Serial.print("[SCAN] Node gefunden: ");
-        Serial.println(nodeId);
-        
-        // Display-Anzeige aktualisieren
-        char message[50];
-        sprintf(message, "Node %d gefunden!", nodeId);
-        displayActionScreen("Node-Scan", message, 1000);
-        
-        // Zum nächsten Node weitergehen, wenn der aktuelle gefunden wurde
-        if (nodeId == currentNode) {
-            currentAttempt = 0;
-            currentNode++;
-            
-            // Ende des Scan-Bereichs erreicht?
-            if (currentNode > scanEnd) {
-                finalizeScan();
-                return;
-            }
-            
-            // Anzeige für den nächsten Node aktualisieren
-            sprintf(message, "Scanne Node %d", currentNode);
-            displayActionScreen("Node-Scan", message, 1000);
-            
-            // Zeit zurücksetzen für den nächsten Node
-            lastScanTime = millis();
-        }
+    canInterface->serviceTx();
+    
+    // Antworten abholen; processCANMessage() verteilt sie über den Dispatcher an die Engine
+    processCANMessage();
+    
+    scanEngine.poll(millis());
+    return scanEngine.isRunning();
+}
+
+// Anzahl der im letzten Scan gefundenen Nodes
+uint8_t scanEngineFoundCount() {
+    return scanEngine.foundCount();
+}
+
+// Verbraucher des Dispatchers: Frame an die Scan-Engine weitergeben
+static void onScanFrame(const CanFrame& frame, void* context) {
+    if (scanning) {
+        scanEngine.processFrame(frame, millis());
+    }
+}
+
+// Die Engine am Dispatcher für ihre Funktionscodes anmelden
+void subscribeScanEngine(CANDispatcher& dispatcher) {
+    dispatcher.subscribe(scanEngineCodes, false, onScanFrame, nullptr);
+}
+
+// Zusätzlich benötigte Funktionscodes für den Hardwarefilter. Sie bleiben auch außerhalb
+// eines Scans im Filter: ein Umladen bei Scan-Start und -Ende installiert den TWAI-Treiber
+// neu und verwirft dabei Empfangs- und Sendepuffer.
+uint16_t scanFunctionCodes() {
+    return scanEngineCodes;
+}
+
+// SDO-Anfrage der Engine in die Sendequeue einreihen
+bool onScanSendRequest(const CanFrame& frame, void* context) {
+    return canInterface->enqueueTx(frame, onScanTxComplete, nullptr);
+}
+
+// Abschluss-Callback der Sendequeue: Antwort-Timeout ab dem Sendezeitpunkt zählen
+void onScanTxComplete(const CanFrame& frame, bool success, void* context) {
+    if (!success) {
+        Serial.printf("[DEBUG] Sendefehler bei COB-ID 0x%03X\n", frame.id);
     }
-}
\ No newline at end of file
+    scanEngine.requestSent(frame.id & 0x7F, success, millis());
+}
+
+// Callback der Engine für gefundene Nodes
+void onScanNodeFound(uint8_t nodeId, ScanFoundVia via, void* context) {
+    static const char* const viaNames[] = {"SDO", "SDO-Abort", "Heartbeat", "Emergency", "TPDO"};
+    Serial.printf("[SCAN] Node gefunden: %d (%s%s)\n", nodeId, viaNames[via],
+                  scanEngine.isListening() ? ", passiv" : "");
+    
+    // Display-Anzeige vormerken (ohne Wartezeit, der Scan läuft weiter); bei vielen
+    // Antworten kurz hintereinander wird nur der letzte Stand gezeichnet
+    snprintf(scanProgressMessage, sizeof(scanProgressMessage), "Node %d gefunden!", nodeId);
+    displayScheduler.request(renderScanProgress, nullptr);
+    
+    // Wie bisher beim Scan aus dem Menü: Node per NMT Start Remote Node starten.
+    // Nicht beim blockierenden scanNodes() und nicht im reinen Hör-Scan (kein Sendeverkehr)
+    if (scanStarted && scanProbe && canInterface != nullptr) {
+        CanFrame nmt = {};
+        nmt.id = COB_ID_NMT;
+        nmt.len = 2;
+        nmt.data[0] = NMT_CMD_START_NODE;
+        nmt.data[1] = nodeId;
+        canInterface->enqueueTx(nmt);
+    }
+}
+
+static void renderScanProgress(void* context) {
+    if (scanning) {
+        displayActionScreen("Node-Scan", scanProgressMessage, 0);
+    }
+}
@@ -0,0 +1,174 @@
+// processCANSimulation.cpp
+// ===============================================================================
+// Bedienung des simulierten CAN-Busses (CAN-Controller 4 = Simulation)
+// Mit 'transceiver can 4' laufen Monitor, Scanner, SDO-Client, Statistik und
+// Heartbeat-Überwachung gegen virtuelle CANopen-Nodes statt gegen Hardware. Der
+// Befehl 'sim' legt Nodes an, simuliert Ausfälle und stellt Busfehler ein.
+// ===============================================================================
+
+#include <Arduino.h>
+#include "CANInterface.h"
+#include "CANHeartbeatMonitor.h"
+#include "SimCANInterface.h"
+
+// Externe Variablen aus Hauptprogramm
+extern uint8_t currentCANTransceiverType;
+extern int currentBaudrate;
+
+void handleSimCommand(String command);
+
+// Nächstes Wort aus params abtrennen
+static String nextToken(String& params) {
+    params.trim();
+    int space = params.indexOf(' ');
+    String token = space > 0 ? params.substring(0, space) : params;
+    params = space > 0 ? params.substring(space + 1) : String("");
+    params.trim();
+    return token;
+}
+
+// "all" oder eine Node-ID; liefert first/last, false bei ungültiger Angabe
+static bool parseNodeTarget(const String& target, uint8_t& first, uint8_t& last) {
+    if (target.equals("all")) {
+        first = 1;
+        last = 127;
+        return true;
+    }
+    long nodeId = target.toInt();
+    if (nodeId < 1 || nodeId > 127) {
+        Serial.println("[FEHLER] Node-ID muss 1-127 sein");
+        return false;
+    }
+    first = last = (uint8_t)nodeId;
+    return true;
+}
+
+static void printSimStatus(CANSimNetwork& network) {
+    CANSimBus& bus = network.bus();
+    Serial.printf("[INFO] Simulierter Bus: %lu kbit/s, %u Nodes, Fehlerrate %u Promille\n",
+                  (unsigned long)(bus.bitrate() / 1000), network.nodeCount(), bus.errorRate());
+    Serial.printf("[INFO] Frames: %lu zugestellt, %lu Error-Frames, %lu ms belegt\n",
+                  (unsigned long)bus.framesDelivered(), (unsigned long)bus.errorFrames(),
+                  (unsigned long)(bus.busyUs() / 1000));
+    if (currentCANTransceiverType != CAN_CONTROLLER_SIM) {
+        Serial.println("[INFO] Simulation nicht aktiv: 'transceiver can 4' schaltet auf den simulierten Bus");
+    } else if ((uint32_t)currentBaudrate * 1000UL != bus.bitrate()) {
+        Serial.printf("[WARNUNG] Interface mit %d kbit/s - keine Verbindung zum Bus\n", currentBaudrate);
+    }
+
+    if (network.nodeCount() == 0) {
+        return;
+    }
+    Serial.println("[INFO] Node  Zustand          Heartbeat  Antwortzeit  SDO-Anfragen");
+    for (uint8_t id = 1; id < 128; id++) {
+        CANSimNode* node = network.node(id);
+        if (node == nullptr) {
+            continue;
+        }
+        Serial.printf("[INFO] %4u  %-15s %7u ms  %8lu µs  %12lu\n", id,
+                      node->powered() ? CANHeartbeatMonitor::stateName(node->state()) : "aus",
+                      node->heartbeat(), (unsigned long)node->responseDelay(),
+                      (unsigned long)node->sdoRequests());
+    }
+}
+
+// sim [nodes a b [hb]|remove <node|all>|on|off <node>|hb <node|all> <ms>|
+//      delay <node|all> <us>|errors <promille>|inject <n>|bitrate <kbps>]
+void handleSimCommand(String command) {
+    CANSimNetwork& network = simNetwork();
+    String params = command;
+    String action = nextToken(params);
+
+    if (action.length() == 0) {
+        printSimStatus(network);
+    } else if (action.equals("nodes")) {
+        long first = nextToken(params).toInt();
+        long last = nextToken(params).toInt();
+        long heartbeatMs = params.length() > 0 ? nextToken(params).toInt() : CAN_SIM_DEFAULT_HEARTBEAT_MS;
+        if (first < 1 || last > 127 || first > last || heartbeatMs < 0 || heartbeatMs > 65535) {
+            Serial.println("[FEHLER] Verwendung: sim nodes <von> <bis> [heartbeat-ms] (1-127)");
+            return;
+        }
+        uint8_t added = network.addNodes((uint8_t)first, (uint8_t)last, (uint16_t)heartbeatMs);
+        Serial.printf("[INFO] %u simulierte Nodes angelegt (%ld-%ld, Heartbeat %ld ms)\n", added, first, last, heartbeatMs);
+    } else if (action.equals("remove")) {
+        uint8_t first, last;
+        if (!parseNodeTarget(nextToken(params), first, last)) {
+            return;
+        }
+        uint8_t removed = 0;
+        for (unsigned id = first; id <= last; id++) {
+            removed += network.removeNode((uint8_t)id) ? 1 : 0;
+        }
+        Serial.printf("[INFO] %u simulierte Nodes entfernt\n", removed);
+    } else if (action.equals("on") || action.equals("off")) {
+        long nodeId = nextToken(params).toInt();
+        CANSimNode* node = nodeId >= 1 && nodeId <= 127 ? network.node((uint8_t)nodeId) : nullptr;
+        if (node == nullptr) {
+            Serial.println("[FEHLER] Kein simulierter Node mit dieser ID");
+            return;
+        }
+        if (action.equals("off")) {
+            node->powerOff();
+            Serial.printf("[INFO] Node %ld ausgeschaltet\n", nodeId);
+        } else {
+            node->powerOn(network.bus().now());
+            Serial.printf("[INFO] Node %ld eingeschaltet (Boot-up folgt)\n", nodeId);
+        }
+    } else if (action.equals("hb") || action.equals("delay")) {
+        uint8_t first, last;
+        if (!parseNodeTarget(nextToken(params), first, last)) {
+            return;
+        }
+        long value = params.length() > 0 ? params.toInt() : -1;
+        if (value < 0 || (action.equals("hb") && value > 65535)) {
+            Serial.printf("[FEHLER] Verwendung: sim %s <node|all> <%s>\n", action.c_str(), action.equals("hb") ? "ms" : "µs");
+            return;
+        }
+        for (unsigned id = first; id <= last; id++) {
+            CANSimNode* node = network.node((uint8_t)id);
+            if (node == nullptr) {
+                continue;
+            }
+            if (action.equals("hb")) {
+                node->setHeartbeat((uint16_t)value);
+            } else {
+                node->setResponseDelay((uint32_t)value);
+            }
+        }
+        Serial.printf("[INFO] %s: %ld %s\n", action.equals("hb") ? "Heartbeat" : "SDO-Antwortzeit",
+                      value, action.equals("hb") ? "ms" : "µs");
+    } else if (action.equals("errors")) {
+        long permille = params.toInt();
+        if (params.length() == 0 || permille < 0 || permille > 1000) {
+            Serial.println("[FEHLER] Verwendung: sim errors <promille> (0-1000)");
+            return;
+        }
+        network.bus().setErrorRate((uint16_t)permille);
+        Serial.printf("[INFO] Gestörte Frames: %ld Promille\n", permille);
+    } else if (action.equals("inject")) {
+        long count = params.length() > 0 ? params.toInt() : 1;
+        if (count < 1 || count > 1000) {
+            Serial.println("[FEHLER] Verwendung: sim inject [anzahl] (1-1000)");
+            return;
+        }
+        network.bus().injectErrors((uint16_t)count);
+        Serial.printf("[INFO] Die nächsten %ld Frames werden gestört\n", count);
+    } else if (action.equals("bitrate")) {
+        long kbps = params.toInt();
+        if (kbps < 10 || kbps > 1000) {
+            Serial.println("[FEHLER] Verwendung: sim bitrate <kbps> (10-1000)");
+            return;
+        }
+        // Nodes ziehen mit, das Interface behält seine Bitrate (z.B. für 'auto')
+        network.bus().setBitrate((uint32_t)kbps * 1000UL);
+        for (uint8_t id = 1; id < 128; id++) {
+            if (network.node(id) != nullptr) {
+                network.node(id)->setBitrate((uint32_t)kbps * 1000UL);
+            }
+        }
+        Serial.printf("[INFO] Simulierter Bus auf %ld kbit/s\n", kbps);
+    } else {
+        Serial.println("[FEHLER] Verwendung: sim [nodes a b [hb]|remove <node|all>|on|off <node>|hb|delay <node|all> <wert>|errors <promille>|inject [n]|bitrate <kbps>]");
+    }
+}
@@ -0,0 +1,261 @@
+// processCANStatistics.cpp
+// ===============================================================================
+// Busstatistik: Buslast, Frame-Raten je COB-ID und Node, Empfangsabstände und
+// Fehlerzähler des Controllers
+// Gezählt werden alle Frames, die der Dispatcher verteilt (auch bei ausgeschaltetem
+// Live-Monitor), und alle über die Sendequeue erfolgreich gesendeten Frames. Bei aktivem
+// Hardwarefilter sieht die Statistik nur die Frames, die der Controller annimmt.
+// ===============================================================================
+
+#include <Arduino.h>
+#include "CANInterface.h"
+#include "CANDispatcher.h"
+#include "CANStatistics.h"
+#include "CANTimestamp.h"
+#include "DisplayInterface.h"
+
+// Externe Variablen aus Hauptprogramm
+extern DisplayInterface* displayInterface;
+extern CANInterface* canInterface;
+extern int currentBaudrate;
+extern bool filterEnabled;
+
+// Externe Funktionen
+extern int getDisplayWidth();
+
+static CANStatistics busStats;
+bool busStatsEnabled = true;  // Statistik aktiv (loop() leert dafür den Empfangspuffer)
+
+void subscribeBusStatistics(CANDispatcher& dispatcher);
+void attachBusStatistics(CANInterface* interface);
+void handleStatsCommand(String command);
+void displayBusStatistics();
+
+// ===================================================================================
+// Erfassung
+// ===================================================================================
+static void onStatisticsFrame(const CanFrame& frame, void* context) {
+    if (busStatsEnabled) {
+        busStats.recordFrame(frame, false, frame.timestamp);
+    }
+}
+
+static void onStatisticsTx(const CanFrame& frame, bool success, void* context) {
+    if (busStatsEnabled) {
+        busStats.recordFrame(frame, true, canTimestampUs());
+    }
+}
+
+// Alle Funktionscodes und Extended-Frames (einmalig aus initCANDispatcher())
+void subscribeBusStatistics(CANDispatcher& dispatcher) {
+    dispatcher.subscribe(CAN_FC_ALL, true, onStatisticsFrame, nullptr);
+}
+
+// Gesendete Frames zählen (nach jedem Anlegen des CAN-Interfaces)
+void attachBusStatistics(CANInterface* interface) {
+    if (interface != nullptr) {
+        interface->setTxObserver(onStatisticsTx, nullptr);
+    }
+}
+
+// ===================================================================================
+// Ausgabe
+// ===================================================================================
+static const char* busStateName(CANBusState state) {
+    switch (state) {
+        case CAN_BUS_ERROR_ACTIVE:  return "Error-Active";
+        case CAN_BUS_ERROR_WARNING: return "Warnung";
+        case CAN_BUS_ERROR_PASSIVE: return "Error-Passive";
+        case CAN_BUS_OFF:           return "Bus-Off";
+        case CAN_BUS_STOPPED:       return "Gestoppt";
+        default:                    return "Unbekannt";
+    }
+}
+
+static void printBusSummary() {
+    uint64_t now = canTimestampUs();
+    uint32_t bitrate = currentBaudrate * 1000UL;
+    uint16_t load = busStats.busLoadPermille(now, bitrate);
+    uint16_t peak = busStats.peakLoadPermille(bitrate);
+
+    Serial.printf("[STATS] Buslast: %u.%u %% (Spitze %u.%u %%) bei %d kbps\n",
+                  load / 10, load % 10, peak / 10, peak % 10, currentBaudrate);
+    Serial.printf("[STATS] Frames/s: %lu, empfangen: %lu, gesendet: %lu\n",
+                  (unsigned long)busStats.framesPerSecond(now),
+                  (unsigned long)busStats.rxFrames(), (unsigned long)busStats.txFrames());
+    Serial.printf("[STATS] COB-IDs: %u erfasst", (unsigned)busStats.idCount());
+    if (busStats.untrackedFrames() > 0) {
+        Serial.printf(", %lu Frames ohne Eintrag (Tabelle voll)", (unsigned long)busStats.untrackedFrames());
+    }
+    Serial.println();
+
+    if (canInterface == nullptr) {
+        return;
+    }
+    CANErrorCounters errors;
+    if (canInterface->getErrorCounters(errors)) {
+        Serial.printf("[STATS] Controller: %s, TEC %u, REC %u, Busfehler %lu, Arbitrierung verloren %lu, verloren %lu\n",
+                      busStateName(errors.state), errors.txErrors, errors.rxErrors,
+                      (unsigned long)errors.busErrors, (unsigned long)errors.arbitrationLost,
+                      (unsigned long)errors.rxMissed);
+    } else {
+        Serial.println("[STATS] Controller: Fehlerzähler nicht verfügbar");
+    }
+    Serial.printf("[STATS] Software: Empfangsüberlauf %lu, Sendequeue voll %lu\n",
+                  (unsigned long)canInterface->getRxOverrunCount(),
+                  (unsigned long)canInterface->getTxDropCount());
+    if (filterEnabled) {
+        Serial.println("[STATS] Hinweis: Anzeigefilter aktiv, der Hardwarefilter verbirgt ggf. Frames");
+    }
+}
+
+// Erfasste COB-IDs nach Rate absteigend; limit = 0 für alle
+static void printIdStatistics(size_t limit) {
+    uint64_t now = canTimestampUs();
+    uint8_t order[CAN_STATS_TABLE_SIZE];
+    uint32_t rates[CAN_STATS_TABLE_SIZE];
+    size_t count = 0;
+
+    // Einfügesortierung: nur im Befehlspfad, höchstens CAN_STATS_MAX_IDS Einträge
+    for (size_t slot = 0; slot < busStats.idSlots(); slot++) {
+        const CANIdStatistics& entry = busStats.idSlot(slot);
+        if (entry.key == CANStatistics::CAN_STATS_FREE) {
+            continue;
+        }
+        uint32_t rate = busStats.idRate(entry, now);
+        size_t pos = count++;
+        while (pos > 0 && (rates[pos - 1] < rate ||
+               (rates[pos - 1] == rate && busStats.idSlot(order[pos - 1]).frames < entry.frames))) {
+            order[pos] = order[pos - 1];
+            rates[pos] = rates[pos - 1];
+            pos--;
+        }
+        order[pos] = slot;
+        rates[pos] = rate;
+    }
+
+    if (count == 0) {
+        Serial.println("[STATS] Noch keine Frames erfasst");
+        return;
+    }
+    if (limit == 0 || limit > count) {
+        limit = count;
+    }
+
+    Serial.println("[STATS] COB-ID      Frames   1/s   Abstand min/avg/max (ms)");
+    for (size_t i = 0; i < limit; i++) {
+        const CANIdStatistics& entry = busStats.idSlot(order[i]);
+        if (entry.extended()) {
+            Serial.printf("[STATS] 0x%08lX", (unsigned long)entry.id());
+        } else {
+            Serial.printf("[STATS] 0x%03lX     ", (unsigned long)entry.id());
+        }
+        Serial.printf(" %8lu %5lu", (unsigned long)entry.frames, (unsigned long)rates[i]);
+        if (entry.gapCount > 0) {
+            Serial.printf("   %lu.%03lu / %lu.%03lu / %lu.%03lu\n",
+                          (unsigned long)(entry.minGap / 1000), (unsigned long)(entry.minGap % 1000),
+                          (unsigned long)(entry.averageGap() / 1000), (unsigned long)(entry.averageGap() % 1000),
+                          (unsigned long)(entry.maxGap / 1000), (unsigned long)(entry.maxGap % 1000));
+        } else {
+            Serial.println("   -");
+        }
+    }
+    if (limit < count) {
+        Serial.printf("[STATS] ... %u weitere (stats ids zeigt alle)\n", (unsigned)(count - limit));
+    }
+}
+
+static void printNodeStatistics() {
+    uint64_t now = canTimestampUs();
+    bool any = false;
+    for (uint8_t node = 1; node < CAN_STATS_NODES; node++) {
+        uint32_t frames = busStats.nodeFrames(node);
+        if (frames == 0) {
+            continue;
+        }
+        if (!any) {
+            Serial.println("[STATS] Node   Frames   1/s");
+            any = true;
+        }
+        Serial.printf("[STATS] %4u %8lu %5lu\n", node, (unsigned long)frames,
+                      (unsigned long)busStats.nodeRate(node, now));
+    }
+    if (!any) {
+        Serial.println("[STATS] Noch keine Frames von CANopen-Nodes erfasst");
+    }
+}
+
+// stats [ids|nodes|reset|on|off]
+void handleStatsCommand(String command) {
+    command.trim();
+
+    if (command.length() == 0) {
+        if (!busStatsEnabled) {
+            Serial.println("[INFO] Busstatistik ist ausgeschaltet (stats on)");
+        }
+        printBusSummary();
+        printIdStatistics(10);
+    } else if (command.equals("ids")) {
+        printIdStatistics(0);
+    } else if (command.equals("nodes")) {
+        printNodeStatistics();
+    } else if (command.equals("reset")) {
+        busStats.reset();
+        Serial.println("[INFO] Busstatistik zurückgesetzt");
+    } else if (command.equals("on")) {
+        busStatsEnabled = true;
+        Serial.println("[INFO] Busstatistik eingeschaltet");
+    } else if (command.equals("off")) {
+        busStatsEnabled = false;
+        Serial.println("[INFO] Busstatistik ausgeschaltet");
+    } else {
+        Serial.println("[FEHLER] Verwendung: stats [ids|nodes|reset|on|off]");
+    }
+}
+
+// ===================================================================================
+// Displayseite (aus dem Monitor-Menü, Aktualisierung aus menuLoop())
+// ===================================================================================
+void displayBusStatistics() {
+    if (displayInterface == nullptr) {
+        return;
+    }
+
+    uint64_t now = canTimestampUs();
+    uint32_t bitrate = currentBaudrate * 1000UL;
+    uint16_t load = busStats.busLoadPermille(now, bitrate);
+    const int displayWidth = getDisplayWidth();
+    char line[32];
+
+    displayInterface->clear();
+    displayInterface->setCursor(0, 0);
+    displayInterface->setTextSize(1);
+    displayInterface->println("Busstatistik");
+    displayInterface->drawLine(0, 10, displayWidth, 10, 1);
+
+    snprintf(line, sizeof(line), "Last: %u.%u%% @%dk", load / 10, load % 10, currentBaudrate);
+    displayInterface->setCursor(0, 15);
+    displayInterface->println(line);
+
+    // Lastbalken
+    displayInterface->drawRect(0, 25, displayWidth, 6, 1);
+    displayInterface->fillRect(0, 25, (int)((uint32_t)displayWidth * load / 1000), 6, 1);
+
+    snprintf(line, sizeof(line), "Frames/s: %lu", (unsigned long)busStats.framesPerSecond(now));
+    displayInterface->setCursor(0, 35);
+    displayInterface->println(line);
+
+    CANErrorCounters errors;
+    displayInterface->setCursor(0, 45);
+    if (canInterface != nullptr && canInterface->getErrorCounters(errors)) {
+        snprintf(line, sizeof(line), "TEC %u REC %u", errors.txErrors, errors.rxErrors);
+        displayInterface->println(line);
+        displayInterface->setCursor(0, 55);
+        displayInterface->println(busStateName(errors.state));
+    } else {
+        snprintf(line, sizeof(line), "IDs: %u", (unsigned)busStats.idCount());
+        displayInterface->println(line);
+    }
+
+    displayInterface->display();
+}
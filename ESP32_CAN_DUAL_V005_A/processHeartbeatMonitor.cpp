@@ -0,0 +1,237 @@
+// processHeartbeatMonitor.cpp
+// ===============================================================================
+// Heartbeat-Überwachung: NMT-Zustand, Periode und Ausfälle je Node
+// Der Dispatcher liefert alle Frames 0x700+ID (Heartbeat, Boot-up, Node-Guarding-
+// Antworten), loop() dreht das Timer-Rad weiter. Ereignisse gehen an Serial (nicht
+// während Log-Ausgabe und SLCAN-Betrieb) und als kurze Meldung ans Display; die
+// Node-Liste gibt es im Menü unter Monitor → Heartbeats.
+// ===============================================================================
+
+#include <Arduino.h>
+#include "CANDispatcher.h"
+#include "CANHeartbeatMonitor.h"
+#include "CANTimestamp.h"
+#include "DisplayInterface.h"
+
+// Externe Variablen aus Hauptprogramm
+extern DisplayInterface* displayInterface;
+extern bool showingHeartbeats;
+
+// Externe Funktionen
+extern int getDisplayWidth();
+extern int getDisplayHeight();
+extern void displayActionScreen(const char* title, const char* message, int timeout);
+extern bool monitorLogActive();
+extern bool slcanModeActive();
+
+#define HB_PAGE_INTERVAL_MS 2000  // Seitenwechsel der Node-Liste, wenn nicht alle Zeilen passen
+
+static CANHeartbeatMonitor heartbeatMonitor;
+bool heartbeatMonitorEnabled = true;  // Überwachung aktiv (loop() leert dafür den Empfangspuffer)
+static bool heartbeatNotify = true;   // Ausfälle/Neustarts als Meldung auf dem Display
+static char heartbeatNotice[32];
+
+void subscribeHeartbeatMonitor(CANDispatcher& dispatcher);
+void serviceHeartbeatMonitor();
+void handleHeartbeatCommand(String command);
+void displayHeartbeatNodes();
+
+// ===================================================================================
+// Erfassung und Ereignisse
+// ===================================================================================
+static void onHeartbeatFrame(const CanFrame& frame, void* context) {
+    if (heartbeatMonitorEnabled) {
+        heartbeatMonitor.handleFrame(frame);
+    }
+}
+
+static void renderHeartbeatNotice(void* context) {
+    // Die Node-Liste zeigt den Ausfall selbst an
+    if (displayInterface != nullptr && !showingHeartbeats) {
+        displayActionScreen("Heartbeat", heartbeatNotice, 0);
+    }
+}
+
+static void onHeartbeatEvent(uint8_t nodeId, HeartbeatEvent event, const HeartbeatNode& node, void* context) {
+    const char* notice = nullptr;
+    // Im Log- und SLCAN-Betrieb liest ein Programm die serielle Ausgabe: dann nur aufs Display
+    bool print = !monitorLogActive() && !slcanModeActive();
+    switch (event) {
+        case HB_EVENT_NEW_NODE:
+            if (print) Serial.printf("[HB] Node %u: erster Heartbeat (%s)\n", nodeId, CANHeartbeatMonitor::stateName(node.state));
+            break;
+        case HB_EVENT_BOOTUP:
+            if (print) Serial.printf("[HB] Node %u: Boot-up (Neustart Nr. %lu)\n", nodeId, (unsigned long)node.bootups);
+            notice = "Boot-up";
+            break;
+        case HB_EVENT_STATE_CHANGE:
+            if (print) Serial.printf("[HB] Node %u: %s -> %s\n", nodeId,
+                                     CANHeartbeatMonitor::stateName(node.previousState), CANHeartbeatMonitor::stateName(node.state));
+            break;
+        case HB_EVENT_TIMEOUT:
+            if (print) Serial.printf("[WARNUNG] Node %u: kein Heartbeat seit %lu ms (Überwachungszeit %lu ms, Ausfall Nr. %lu)\n",
+                                     nodeId, (unsigned long)((canTimestampUs() - node.lastSeenUs) / 1000),
+                                     (unsigned long)node.timeoutMs(), (unsigned long)node.missed);
+            notice = "Ausfall!";
+            break;
+        case HB_EVENT_RECOVERED:
+            if (print) Serial.printf("[HB] Node %u: wieder da (%s)\n", nodeId, CANHeartbeatMonitor::stateName(node.state));
+            notice = "wieder da";
+            break;
+    }
+
+    if (notice != nullptr && heartbeatNotify) {
+        snprintf(heartbeatNotice, sizeof(heartbeatNotice), "Node %u: %s", nodeId, notice);
+        displayScheduler.request(renderHeartbeatNotice, nullptr);
+    }
+}
+
+// Heartbeat/Boot-up/Node Guarding (einmalig aus initCANDispatcher())
+void subscribeHeartbeatMonitor(CANDispatcher& dispatcher) {
+    heartbeatMonitor.setEventCallback(onHeartbeatEvent, nullptr);
+    dispatcher.subscribe(CAN_FC_BIT(CAN_FC_NMT_EC), false, onHeartbeatFrame, nullptr);
+}
+
+// Aus loop(): abgelaufene Überwachungszeiten melden
+void serviceHeartbeatMonitor() {
+    if (heartbeatMonitorEnabled) {
+        heartbeatMonitor.advance(canTimestampUs());
+    }
+}
+
+// ===================================================================================
+// Befehle
+// ===================================================================================
+static void printHeartbeatNodes() {
+    if (heartbeatMonitor.nodeCount() == 0) {
+        Serial.println("[HB] Noch keine Heartbeats empfangen");
+        return;
+    }
+
+    uint64_t now = canTimestampUs();
+    Serial.println("[HB] Node  Zustand          Periode  Überwachung  zuletzt  Heartbeats  Ausfälle  Boot-ups");
+    for (uint8_t id = 1; id < HB_MAX_NODES; id++) {
+        const HeartbeatNode& node = heartbeatMonitor.node(id);
+        if (!node.seen) {
+            continue;
+        }
+        uint32_t timeout = node.timeoutMs();
+        Serial.printf("[HB] %4u  %-15s %5lu ms  ", id, CANHeartbeatMonitor::stateName(node.state),
+                      (unsigned long)(node.periodUs / 1000));
+        if (timeout > 0) {
+            Serial.printf("%6lu ms%s", (unsigned long)timeout, node.consumerTimeMs > 0 ? " " : "a");
+        } else {
+            Serial.print("       -  ");
+        }
+        Serial.printf("  %5lu ms  %10lu  %8lu  %8lu%s\n", (unsigned long)((now - node.lastSeenUs) / 1000),
+                      (unsigned long)node.heartbeats, (unsigned long)node.missed,
+                      (unsigned long)node.bootups, node.timedOut ? "  AUSFALL" : "");
+    }
+    Serial.println("[HB] a = automatisch aus der Periode; 'hb timeout <node|all> <ms>' setzt eine feste Zeit");
+}
+
+// hb [clear|on|off|notify on|off|timeout <node|all> <ms>]
+void handleHeartbeatCommand(String command) {
+    command.trim();
+
+    if (command.length() == 0) {
+        if (!heartbeatMonitorEnabled) {
+            Serial.println("[INFO] Heartbeat-Überwachung ist ausgeschaltet (hb on)");
+        }
+        printHeartbeatNodes();
+    } else if (command.equals("clear")) {
+        heartbeatMonitor.clear();
+        Serial.println("[INFO] Heartbeat-Tabelle geleert");
+    } else if (command.equals("on")) {
+        heartbeatMonitorEnabled = true;
+        Serial.println("[INFO] Heartbeat-Überwachung eingeschaltet");
+    } else if (command.equals("off")) {
+        heartbeatMonitorEnabled = false;
+        Serial.println("[INFO] Heartbeat-Überwachung ausgeschaltet");
+    } else if (command.startsWith("notify ")) {
+        String value = command.substring(7);
+        value.trim();
+        heartbeatNotify = value.equals("on");
+        Serial.printf("[INFO] Displaymeldungen bei Ausfall/Boot-up: %s\n", heartbeatNotify ? "an" : "aus");
+    } else if (command.startsWith("timeout ")) {
+        String params = command.substring(8);
+        params.trim();
+        int space = params.indexOf(' ');
+        String target = space > 0 ? params.substring(0, space) : String("");
+        long timeMs = space > 0 ? params.substring(space + 1).toInt() : -1;
+        if (timeMs < 0 || timeMs > 65535) {
+            Serial.println("[FEHLER] Verwendung: hb timeout <node|all> <ms> (0 = automatisch, max. 65535)");
+            return;
+        }
+        if (target.equals("all")) {
+            for (uint8_t id = 1; id < HB_MAX_NODES; id++) {
+                heartbeatMonitor.setConsumerTime(id, (uint16_t)timeMs);
+            }
+            Serial.printf("[INFO] Überwachungszeit aller Nodes: %s\n", timeMs == 0 ? "automatisch" : (String(timeMs) + " ms").c_str());
+        } else {
+            long nodeId = target.toInt();
+            if (nodeId < 1 || nodeId > 127) {
+                Serial.println("[FEHLER] Node-ID muss 1-127 sein");
+                return;
+            }
+            heartbeatMonitor.setConsumerTime((uint8_t)nodeId, (uint16_t)timeMs);
+            Serial.printf("[INFO] Überwachungszeit Node %ld: %s\n", nodeId, timeMs == 0 ? "automatisch" : (String(timeMs) + " ms").c_str());
+        }
+    } else {
+        Serial.println("[FEHLER] Verwendung: hb [clear|on|off|notify on|off|timeout <node|all> <ms>]");
+    }
+}
+
+// ===================================================================================
+// Displayseite (aus dem Monitor-Menü, Aktualisierung aus menuLoop())
+// Ausgefallene Nodes werden invertiert dargestellt.
+// ===================================================================================
+void displayHeartbeatNodes() {
+    if (displayInterface == nullptr) {
+        return;
+    }
+
+    const int displayWidth = getDisplayWidth();
+    const size_t rowsPerPage = (getDisplayHeight() - 12) / 8;
+    uint8_t ids[HB_MAX_NODES];
+    size_t count = 0;
+    for (uint8_t id = 1; id < HB_MAX_NODES; id++) {
+        if (heartbeatMonitor.node(id).seen) {
+            ids[count++] = id;
+        }
+    }
+    size_t pages = (count + rowsPerPage - 1) / rowsPerPage;
+    size_t page = pages > 1 ? (millis() / HB_PAGE_INTERVAL_MS) % pages : 0;
+    char line[40];
+
+    displayInterface->clear();
+    displayInterface->setTextSize(1);
+    displayInterface->setCursor(0, 0);
+    snprintf(line, sizeof(line), "Heartbeats %u/%u", (unsigned)(count - heartbeatMonitor.timedOutCount()), (unsigned)count);
+    displayInterface->print(line);
+    displayInterface->drawLine(0, 9, displayWidth, 9, 1);
+
+    if (count == 0) {
+        displayInterface->setCursor(0, 14);
+        displayInterface->print("Keine Heartbeats");
+    }
+    for (size_t row = 0; row < rowsPerPage && page * rowsPerPage + row < count; row++) {
+        uint8_t id = ids[page * rowsPerPage + row];
+        const HeartbeatNode& node = heartbeatMonitor.node(id);
+        int y = 12 + row * 8;
+        snprintf(line, sizeof(line), "%3u %-8.8s %5lums", id, CANHeartbeatMonitor::stateName(node.state),
+                 (unsigned long)(node.periodUs / 1000));
+        if (node.timedOut) {
+            displayInterface->fillRect(0, y, displayWidth, 8, 1);
+            displayInterface->setTextColor(0);
+        }
+        displayInterface->setCursor(0, y);
+        displayInterface->print(node.timedOut ? "!" : " ");
+        displayInterface->print(line);
+        if (node.timedOut) {
+            displayInterface->setTextColor(1);
+        }
+    }
+
+    displayInterface->display();
+}
@@ -0,0 +1,149 @@
+// processSLCAN.cpp
+// ===============================================================================
+// SLCAN-Betrieb (Lawicel): Das Gerät verhält sich an der seriellen Schnittstelle wie ein
+// Standard-CAN-Adapter. Der Modus beginnt mit dem Befehl "slcan" oder automatisch mit
+// der ersten typischen SLCAN-Zeile (z.B. "S6", "O", "C") und endet mit "slcan off".
+// Empfangene Frames laufen über die Log-Ausgabe des Live-Monitors (inklusive
+// Anzeigefilter), Antworten werden in denselben Ausgabestrom eingereiht.
+// ===============================================================================
+
+#include <Arduino.h>
+#include "CANInterface.h"
+#include "CANLog.h"
+#include "CANSlcan.h"
+#include "DisplayInterface.h"
+
+// Externe Variablen aus Hauptprogramm
+extern DisplayInterface* displayInterface;
+extern CANInterface* canInterface;
+extern bool liveMonitor;
+extern int currentBaudrate;
+
+// Externe Funktionen
+extern bool isValidBaudrate(int baudrate);
+extern void updateHardwareFilter(bool verbose);
+extern bool startMonitorLog(CANLogFormat format, uint32_t serialBaud, bool verbose);
+extern void stopMonitorLog(bool verbose);
+extern void writeMonitorLog(const char* data, size_t len);
+extern void displayActionScreen(const char* title, const char* message, int timeout);
+extern void displaySerialModeScreen();
+
+static SLCANSession slcan;
+static bool slcanMode = false;
+static uint32_t slcanRxOverruns = 0;  // Stand des Überlaufzählers bei der letzten F-Abfrage
+
+bool slcanModeActive();
+void enterSlcanMode();
+void leaveSlcanMode();
+void handleSlcanCommand(const String& command);
+
+// ===================================================================================
+// Callbacks der SLCAN-Sitzung
+// ===================================================================================
+static bool slcanOpen(bool listenOnly, bool timestamps, void* context) {
+    if (canInterface == nullptr) {
+        return false;
+    }
+    slcanRxOverruns = canInterface->getRxOverrunCount();
+    return startMonitorLog(timestamps ? CAN_LOG_SLCAN_TS : CAN_LOG_SLCAN, 0, false);
+}
+
+static void slcanClose(void* context) {
+    stopMonitorLog(false);
+    liveMonitor = false;
+}
+
+// Bitrate nur für die Sitzung umstellen, nicht speichern
+static bool slcanSetBitrate(uint16_t kbps, void* context) {
+    if (canInterface == nullptr || !isValidBaudrate(kbps)) {
+        return false;
+    }
+    if (kbps == currentBaudrate) {
+        return true;
+    }
+
+    canInterface->end();
+    if (!canInterface->begin(kbps * 1000UL)) {
+        canInterface->begin(currentBaudrate * 1000UL);
+        return false;
+    }
+    currentBaudrate = kbps;
+    updateHardwareFilter(false);
+    return true;
+}
+
+static bool slcanTransmit(const CanFrame& frame, void* context) {
+    return canInterface != nullptr && canInterface->enqueueTx(frame);
+}
+
+// Lawicel-Statusbits: Bit 3 = Datenüberlauf seit der letzten Abfrage
+static uint8_t slcanStatus(void* context) {
+    if (canInterface == nullptr) {
+        return 0;
+    }
+    uint32_t overruns = canInterface->getRxOverrunCount();
+    uint8_t flags = overruns != slcanRxOverruns ? 0x08 : 0x00;
+    slcanRxOverruns = overruns;
+    return flags;
+}
+
+// ===================================================================================
+// Moduswechsel und Befehlsverarbeitung
+// ===================================================================================
+bool slcanModeActive() {
+    return slcanMode;
+}
+
+void enterSlcanMode() {
+    if (slcanMode) {
+        return;
+    }
+
+    SLCANHandlers handlers;
+    handlers.open = slcanOpen;
+    handlers.close = slcanClose;
+    handlers.setBitrate = slcanSetBitrate;
+    handlers.transmit = slcanTransmit;
+    handlers.status = slcanStatus;
+    slcan.setHandlers(handlers, nullptr);
+    slcan.reset();
+
+    // Eine laufende Klartext-/Log-Ausgabe würde den Lawicel-Strom stören
+    stopMonitorLog(false);
+    liveMonitor = false;
+    slcanMode = true;
+
+    if (displayInterface != nullptr) {
+        displayActionScreen("SLCAN", "CAN-Adapter-Modus", 1000);
+    }
+}
+
+void leaveSlcanMode() {
+    if (!slcanMode) {
+        return;
+    }
+
+    if (slcan.isOpen()) {
+        slcanClose(nullptr);
+    }
+    slcan.reset();
+    slcanMode = false;
+    Serial.println("\n[INFO] SLCAN-Modus beendet");
+
+    if (displayInterface != nullptr) {
+        displaySerialModeScreen();
+    }
+}
+
+// Eine Zeile im SLCAN-Modus (ohne '\r'); "slcan off" kehrt zum Befehlsmodus zurück
+void handleSlcanCommand(const String& command) {
+    if (command.equals("slcan off")) {
+        leaveSlcanMode();
+        return;
+    }
+
+    enterSlcanMode();
+    char reply[SLCAN_MAX_REPLY];
+    size_t len = slcan.handleCommand(command.c_str(), command.length(), reply);
+    writeMonitorLog(reply, len);
+}
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+# can_capture.py
+# ===============================================================================
+# Dekoder für die binäre Log-Ausgabe des Live-Monitors ("monitor log binary")
+# Liest COBS-kodierte Records von der seriellen Schnittstelle, aus einer Datei oder von
+# stdin, prüft die CRC und gibt die Frames als candump -L-Zeilen aus. Damit lässt sich
+# der Mitschnitt direkt an can-utils (canplayer, log2asc) oder SavvyCAN weitergeben.
+#
+# Beispiele:
+#   python3 tools/can_capture.py --port /dev/ttyUSB0 --baud 921600 > mitschnitt.log
+#   python3 tools/can_capture.py roh.bin | canplayer -I - vcan0=can0
+#
+# Record-Aufbau siehe ESP32_CAN_DUAL_V005_A/CANLog.h. Für --port wird pyserial benötigt.
+# ===============================================================================
+
+import argparse
+import struct
+import sys
+
+RECORD_SIZE = 21
+RECORD_FRAME = 0x01
+FLAG_EXTENDED = 0x01
+FLAG_GAP = 0x04
+
+
+def crc16_ccitt(data):
+    """CRC-16/CCITT-FALSE (Polynom 0x1021, Startwert 0xFFFF)"""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def cobs_decode(packet):
+    """COBS-Paket (ohne abschließendes 0x00) dekodieren; None bei ungültiger Kodierung"""
+    out = bytearray()
+    i = 0
+    while i < len(packet):
+        code = packet[i]
+        if code == 0 or i + code > len(packet):
+            return None
+        out += packet[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(packet):
+            out.append(0)
+    return bytes(out)
+
+
+class CaptureDecoder:
+    """Zerlegt den Bytestrom an 0x00 und liefert gültige Frames"""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.synced = False       # Erst ab dem ersten gültigen Record zählen Fehler
+        self.frames = 0
+        self.errors = 0
+        self.gaps = 0
+        self.last_raw = None      # Untere 32 Bit des letzten Zeitstempels
+        self.wraps = 0
+
+    def feed(self, data):
+        self.pending += data
+        while True:
+            end = self.pending.find(b"\x00")
+            if end < 0:
+                break
+            packet = bytes(self.pending[:end])
+            del self.pending[:end + 1]
+            frame = self.decode(packet)
+            if frame is not None:
+                yield frame
+
+    def decode(self, packet):
+        record = cobs_decode(packet) if packet else None
+        if (record is None or len(record) != RECORD_SIZE or record[0] != RECORD_FRAME
+                or crc16_ccitt(record[:-2]) != struct.unpack_from("<H", record, 19)[0]):
+            if self.synced:
+                self.errors += 1
+            return None
+
+        self.synced = True
+        flags, dlc, can_id, raw_time = struct.unpack_from("<BBII", record, 1)
+        if flags & FLAG_GAP:
+            self.gaps += 1
+
+        # 32-Bit-Zeitstempel (µs) fortlaufend erweitern
+        if self.last_raw is not None and raw_time < self.last_raw:
+            self.wraps += 1
+        self.last_raw = raw_time
+        timestamp = (self.wraps << 32) + raw_time
+
+        self.frames += 1
+        return timestamp, can_id, bool(flags & FLAG_EXTENDED), record[11:11 + min(dlc, 8)]
+
+
+def candump_line(frame, interface):
+    timestamp, can_id, extended, data = frame
+    ident = "%08X" % can_id if extended else "%03X" % can_id
+    return "(%010d.%06d) %s %s#%s" % (timestamp // 1000000, timestamp % 1000000,
+                                       interface, ident, data.hex().upper())
+
+
+def open_input(args):
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("pyserial fehlt: pip install pyserial")
+        port = serial.Serial(args.port, args.baud, timeout=0.1)
+        return lambda: port.read(4096)
+    stream = sys.stdin.buffer if args.file in (None, "-") else open(args.file, "rb")
+    return lambda: stream.read1(4096) if hasattr(stream, "read1") else stream.read(4096)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Binär-Mitschnitt des ESP32 CANopen Masters dekodieren")
+    parser.add_argument("file", nargs="?", help="Datei mit Rohdaten (Standard: stdin)")
+    parser.add_argument("--port", help="Serielle Schnittstelle, z.B. /dev/ttyUSB0 oder COM3")
+    parser.add_argument("--baud", type=int, default=115200, help="Baudrate der Schnittstelle")
+    parser.add_argument("--interface", default="can0", help="Interfacename in den candump-Zeilen")
+    args = parser.parse_args()
+
+    read = open_input(args)
+    decoder = CaptureDecoder()
+    try:
+        while True:
+            data = read()
+            if not data:
+                if args.port:
+                    continue
+                break
+            for frame in decoder.feed(data):
+                print(candump_line(frame, args.interface))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+    print("# %d Frames, %d fehlerhafte Records, %d Lücken (verworfene Frames)"
+          % (decoder.frames, decoder.errors, decoder.gaps), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()